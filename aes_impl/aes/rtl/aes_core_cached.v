@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer:
+//
+// Create Date:
+// Design Name:
+// Module Name: aes_core_cached
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description: Encryption-only AES core that takes its round keys from
+//              aes_key_cache instead of expanding the key for every block.
+//              load_key expands key into key_slot; init binds the core to
+//              key_slot, after which every next encrypts one block with the
+//              round keys of that slot.
+//
+// Dependencies: aes_encipher_block_fly, aes_key_cache
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments: ready is low while a key is being loaded.
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module aes_core_cached #(parameter KEY_SLOT_BITS = 2, parameter SBOX_WORDS = 4)(
+                       input wire                         clk,
+                       input wire                         reset_n,
+
+                       input wire                         init,
+                       input wire                         next,
+                       output wire                        ready,
+
+                       input wire                         load_key,
+                       input wire [KEY_SLOT_BITS - 1 : 0] key_slot,
+                       input wire [255 : 0]               key,
+                       input wire                         keylen,
+
+                       input wire [127 : 0]               block,
+                       output wire [127 : 0]              result,
+                       output wire                        result_valid
+                       );
+
+    //----------------------------------------------------------------
+    // Wires.
+    //----------------------------------------------------------------
+    wire [127 : 0] round_key;
+    wire           slot_keylen;
+    wire           load_ready;
+
+    wire [127 : 0] enc_new_block;
+    wire           enc_ready;
+
+    wire           init_key;
+    wire           next_key;
+
+    //----------------------------------------------------------------
+    // Concurrent connectivity for ports etc.
+    //----------------------------------------------------------------
+    assign ready        = enc_ready && load_ready;
+    assign result       = enc_new_block;
+    assign result_valid = enc_ready;
+
+    //----------------------------------------------------------------
+    // Instantiations.
+    //----------------------------------------------------------------
+    aes_encipher_block_fly #(.SBOX_WORDS(SBOX_WORDS)) enc_block(
+                                     .clk(clk),
+                                     .reset_n(reset_n),
+
+                                     .init(init),
+                                     .next(next),
+
+                                     .keylen(slot_keylen),
+                                     .round_key(round_key),
+                                     .init_key(init_key),
+                                     .next_key(next_key),
+
+                                     .block(block),
+                                     .new_block(enc_new_block),
+                                     .ready(enc_ready)
+                                     );
+
+    aes_key_cache #(.KEY_SLOT_BITS(KEY_SLOT_BITS)) key_cache(
+                                                            .clk(clk),
+                                                            .reset_n(reset_n),
+
+                                                            .load(load_key),
+                                                            .load_slot(key_slot),
+                                                            .key(key),
+                                                            .keylen(keylen),
+                                                            .load_ready(load_ready),
+
+                                                            .init(init_key),
+                                                            .next(next_key),
+                                                            .slot(key_slot),
+                                                            .round_key(round_key),
+                                                            .slot_keylen(slot_keylen)
+                                                            );
+
+endmodule // aes_core_cached
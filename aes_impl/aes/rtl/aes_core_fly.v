@@ -39,7 +39,7 @@
 
 `default_nettype none
 
-module aes_core_fly(
+module aes_core_fly #(parameter SBOX_WORDS = 4)(
                 input wire            clk,
                 input wire            reset_n,
 
@@ -81,7 +81,7 @@ module aes_core_fly(
   //----------------------------------------------------------------
   // Instantiations.
   //----------------------------------------------------------------
-  aes_encipher_block_fly enc_block(
+  aes_encipher_block_fly #(.SBOX_WORDS(SBOX_WORDS)) enc_block(
                                .clk(clk),
                                .reset_n(reset_n),
 
@@ -6,6 +6,11 @@
 // the initial round, main round and final round logic for
 // enciper operations.
 //
+// SBOX_WORDS sets the number of 32-bit S-box words per cycle. With 1
+// or 2, SubBytes takes 4 or 2 cycles per round. With 4, SubBytes is
+// merged into the main round, giving one round per clock cycle. The
+// key schedule has its own S-box in aes_key_mem_fly.
+//
 //
 // Author: Joachim Strombergson
 // Copyright (c) 2013, 2014, Secworks Sweden AB
@@ -40,7 +45,7 @@
 
 `default_nettype none
 
-module aes_encipher_block_fly(
+module aes_encipher_block_fly #(parameter SBOX_WORDS = 4)(
                           input wire            clk,
                           input wire            reset_n,
 
@@ -78,6 +83,9 @@ module aes_encipher_block_fly(
   localparam CTRL_SBOX  = 3'h2;
   localparam CTRL_MAIN  = 3'h3;
 
+  // Last value of the SubBytes word counter (SBOX_WORDS 1 and 2)
+  localparam SWORD_LAST = (4 / SBOX_WORDS) - 1;
+
 
   //----------------------------------------------------------------
   // Round functions with sub functions.
@@ -195,8 +203,8 @@ module aes_encipher_block_fly(
   reg [2 : 0] update_type;
 
 /* verilator lint_off UNOPTFLAT */
-  reg [31 : 0]  muxed_sboxw;
-  wire [31 : 0] new_sboxw;
+  reg [(32 * SBOX_WORDS) - 1 : 0]  muxed_sboxw;
+  wire [(32 * SBOX_WORDS) - 1 : 0] new_sboxw;
 /* verilator lint_on UNOPTFLAT */
 
   reg tmp_init_key;
@@ -206,7 +214,14 @@ module aes_encipher_block_fly(
   //----------------------------------------------------------------
   // Instatiations.
   //----------------------------------------------------------------
-  aes_sbox sbox_inst(.sboxw(muxed_sboxw), .new_sboxw(new_sboxw));
+  genvar i;
+  generate
+    for (i = 0; i < SBOX_WORDS; i = i + 1)
+      begin : sbox_gen
+        aes_sbox sbox_inst(.sboxw(muxed_sboxw[(32 * i) + 31 : 32 * i]),
+                           .new_sboxw(new_sboxw[(32 * i) + 31 : 32 * i]));
+      end
+  endgenerate
 
 
   //----------------------------------------------------------------
@@ -274,18 +289,28 @@ module aes_encipher_block_fly(
   //----------------------------------------------------------------
   always @*
     begin : round_logic
-      reg [127 : 0] old_block, shiftrows_block, mixcolumns_block;
+      reg [127 : 0] old_block, sub_block, shiftrows_block, mixcolumns_block;
       reg [127 : 0] addkey_init_block, addkey_main_block, addkey_final_block;
 
       block_new   = 128'h0;
-      muxed_sboxw = 32'h0;
+      muxed_sboxw = {SBOX_WORDS{32'h0}};
       block_w0_we = 1'b0;
       block_w1_we = 1'b0;
       block_w2_we = 1'b0;
       block_w3_we = 1'b0;
 
       old_block          = {block_w0_reg, block_w1_reg, block_w2_reg, block_w3_reg};
-      shiftrows_block    = shiftrows(old_block);
+
+      // With four S-box words, SubBytes is part of the main and final round.
+      if (SBOX_WORDS == 4)
+        begin
+          muxed_sboxw = old_block;
+          sub_block   = new_sboxw;
+        end
+      else
+        sub_block = old_block;
+
+      shiftrows_block    = shiftrows(sub_block);
       mixcolumns_block   = mixcolumns(shiftrows_block);
       addkey_init_block  = addroundkey(block, round_key);
       addkey_main_block  = addroundkey(mixcolumns_block, round_key);
@@ -303,33 +328,51 @@ module aes_encipher_block_fly(
 
         SBOX_UPDATE:
           begin
-            block_new = {new_sboxw, new_sboxw, new_sboxw, new_sboxw};
-
-            case (sword_ctr_reg)
-              2'h0:
-                begin
-                  muxed_sboxw = block_w0_reg;
-                  block_w0_we = 1'b1;
-                end
-
-              2'h1:
-                begin
-                  muxed_sboxw = block_w1_reg;
-                  block_w1_we = 1'b1;
-                end
-
-              2'h2:
-                begin
-                  muxed_sboxw = block_w2_reg;
-                  block_w2_we = 1'b1;
-                end
-
-              2'h3:
-                begin
-                  muxed_sboxw = block_w3_reg;
-                  block_w3_we = 1'b1;
-                end
-            endcase // case (sbox_mux_ctrl_reg)
+            block_new = {(4 / SBOX_WORDS){new_sboxw}};
+
+            if (SBOX_WORDS == 2)
+              begin
+                if (sword_ctr_reg[0] == 1'b0)
+                  begin
+                    muxed_sboxw = {block_w0_reg, block_w1_reg};
+                    block_w0_we = 1'b1;
+                    block_w1_we = 1'b1;
+                  end
+                else
+                  begin
+                    muxed_sboxw = {block_w2_reg, block_w3_reg};
+                    block_w2_we = 1'b1;
+                    block_w3_we = 1'b1;
+                  end
+              end
+            else
+              begin
+                case (sword_ctr_reg)
+                  2'h0:
+                    begin
+                      muxed_sboxw = block_w0_reg;
+                      block_w0_we = 1'b1;
+                    end
+
+                  2'h1:
+                    begin
+                      muxed_sboxw = block_w1_reg;
+                      block_w1_we = 1'b1;
+                    end
+
+                  2'h2:
+                    begin
+                      muxed_sboxw = block_w2_reg;
+                      block_w2_we = 1'b1;
+                    end
+
+                  2'h3:
+                    begin
+                      muxed_sboxw = block_w3_reg;
+                      block_w3_we = 1'b1;
+                    end
+                endcase // case (sbox_mux_ctrl_reg)
+              end
           end
 
         MAIN_UPDATE:
@@ -452,14 +495,22 @@ module aes_encipher_block_fly(
               end
           end
 
+        // The key schedule delivers one round key per next_key, and
+        // accepts them back to back. The round key of the following
+        // round is requested in the cycle before it is needed.
         CTRL_INIT:
           begin
-            tmp_next_key  = 1'h1;
             round_ctr_inc = 1'b1;
             sword_ctr_rst = 1'b1;
             update_type   = INIT_UPDATE;
-            enc_ctrl_new  = CTRL_SBOX;
             enc_ctrl_we   = 1'b1;
+            if (SBOX_WORDS == 4)
+              begin
+                tmp_next_key = 1'h1;
+                enc_ctrl_new = CTRL_MAIN;
+              end
+            else
+              enc_ctrl_new = CTRL_SBOX;
           end
 
 
@@ -467,7 +518,7 @@ module aes_encipher_block_fly(
           begin
             sword_ctr_inc = 1'b1;
             update_type   = SBOX_UPDATE;
-            if (sword_ctr_reg == 2'h3)
+            if (sword_ctr_reg == SWORD_LAST)
               begin
                 tmp_next_key  = 1'h1;
                 enc_ctrl_new  = CTRL_MAIN;
@@ -483,8 +534,13 @@ module aes_encipher_block_fly(
             if (round_ctr_reg < num_rounds)
               begin
                 update_type   = MAIN_UPDATE;
-                enc_ctrl_new  = CTRL_SBOX;
-                enc_ctrl_we   = 1'b1;
+                if (SBOX_WORDS == 4)
+                  tmp_next_key = 1'h1;
+                else
+                  begin
+                    enc_ctrl_new = CTRL_SBOX;
+                    enc_ctrl_we  = 1'b1;
+                  end
               end
             else
               begin
@@ -0,0 +1,319 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer:
+//
+// Create Date:
+// Design Name:
+// Module Name: aes_key_cache
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description: Round-key store with 2**KEY_SLOT_BITS slots. A load expands
+//              the given key once with aes_key_mem_fly and stores all of its
+//              round keys in the selected slot. The read side has the same
+//              init/next interface as aes_key_mem_fly, so that it can drive
+//              aes_encipher_block_fly directly: init binds a slot, and every
+//              next returns the following round key of that slot. After the
+//              last round key the round counter wraps around, so consecutive
+//              blocks under the same key do not need a new init.
+//
+// Dependencies: aes_key_mem_fly
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments: The store has no reset so that it can be mapped onto
+//                      distributed RAM.
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module aes_key_cache #(parameter KEY_SLOT_BITS = 2)(
+                     input wire                         clk,
+                     input wire                         reset_n,
+
+                       // Key expansion
+                     input wire                         load,
+                     input wire [KEY_SLOT_BITS - 1 : 0] load_slot,
+                     input wire [255 : 0]               key,
+                     input wire                         keylen,
+                     output wire                        load_ready,
+
+                       // Round key sequencing
+                     input wire                         init,
+                     input wire                         next,
+                     input wire [KEY_SLOT_BITS - 1 : 0] slot,
+                     output wire [127 : 0]              round_key,
+                     output wire                        slot_keylen
+                     );
+
+    //----------------------------------------------------------------
+    // Internal constant and parameter definitions.
+    //----------------------------------------------------------------
+    localparam NUM_SLOTS = 1 << KEY_SLOT_BITS;
+
+    localparam AES128_LAST_ROUND = 4'ha;
+    localparam AES256_LAST_ROUND = 4'he;
+
+      // Load FSM
+    localparam CTRL_IDLE  = 2'h0;
+    localparam CTRL_INIT  = 2'h1;
+    localparam CTRL_NEXT  = 2'h2;
+    localparam CTRL_STORE = 2'h3;
+
+      // Read FSM
+    localparam RD_IDLE = 1'b0;
+    localparam RD_DONE = 1'b1;
+
+    //----------------------------------------------------------------
+    // Registers + update variables and write enable.
+    //----------------------------------------------------------------
+    reg [127 : 0]               key_mem [0 : (NUM_SLOTS * 16) - 1];
+    reg                         key_mem_we;
+
+    reg [NUM_SLOTS - 1 : 0]     keylen_reg;
+    reg                         keylen_we;
+
+    reg [1 : 0]                 load_ctrl_reg;
+    reg [1 : 0]                 load_ctrl_new;
+    reg                         load_ctrl_we;
+
+    reg [KEY_SLOT_BITS - 1 : 0] load_slot_reg;
+    reg                         load_slot_we;
+
+    reg [3 : 0]                 load_round_reg;
+    reg [3 : 0]                 load_round_new;
+    reg                         load_round_we;
+
+    reg                         load_ready_reg;
+    reg                         load_ready_new;
+    reg                         load_ready_we;
+
+    reg                         rd_ctrl_reg;
+    reg                         rd_ctrl_new;
+    reg                         rd_ctrl_we;
+
+    reg [KEY_SLOT_BITS - 1 : 0] rd_slot_reg;
+    reg                         rd_slot_we;
+
+    reg [3 : 0]                 rd_round_reg;
+    reg [3 : 0]                 rd_round_new;
+    reg                         rd_round_we;
+
+    reg [127 : 0]               round_key_reg;
+    reg                         round_key_we;
+
+    //----------------------------------------------------------------
+    // Wires.
+    //----------------------------------------------------------------
+    reg            keymem_init;
+    reg            keymem_next;
+    wire [127 : 0] keymem_round_key;
+    wire           keymem_ready;
+
+    wire [3 : 0]   load_last_round;
+    wire [3 : 0]   rd_last_round;
+
+    //----------------------------------------------------------------
+    // Instantiations.
+    //----------------------------------------------------------------
+    aes_key_mem_fly keymem(
+                           .clk(clk),
+                           .reset_n(reset_n),
+
+                           .key(key),
+                           .keylen(keylen),
+                           .init(keymem_init),
+                           .next(keymem_next),
+                           .round_key(keymem_round_key),
+
+                           .ready(keymem_ready)
+                           );
+
+    //----------------------------------------------------------------
+    // Concurrent connectivity for ports etc.
+    //----------------------------------------------------------------
+    assign load_ready      = load_ready_reg;
+    assign round_key       = round_key_reg;
+    assign slot_keylen     = keylen_reg[rd_slot_reg];
+
+    assign load_last_round = keylen ? AES256_LAST_ROUND : AES128_LAST_ROUND;
+    assign rd_last_round   = keylen_reg[rd_slot_reg] ? AES256_LAST_ROUND : AES128_LAST_ROUND;
+
+    //----------------------------------------------------------------
+    // reg_update
+    //
+    // Update functionality for all registers in the core.
+    // All registers are positive edge triggered with asynchronous
+    // active low reset.
+    //----------------------------------------------------------------
+    always @ (posedge clk or negedge reset_n)
+      begin: reg_update
+        if (!reset_n)
+          begin
+            keylen_reg     <= {NUM_SLOTS{1'b0}};
+            load_ctrl_reg  <= CTRL_IDLE;
+            load_slot_reg  <= {KEY_SLOT_BITS{1'b0}};
+            load_round_reg <= 4'h0;
+            load_ready_reg <= 1'b1;
+            rd_ctrl_reg    <= RD_IDLE;
+            rd_slot_reg    <= {KEY_SLOT_BITS{1'b0}};
+            rd_round_reg   <= 4'h0;
+            round_key_reg  <= 128'h0;
+          end
+        else
+          begin
+            if (keylen_we)
+              keylen_reg[load_slot] <= keylen;
+            if (load_ctrl_we)
+              load_ctrl_reg <= load_ctrl_new;
+            if (load_slot_we)
+              load_slot_reg <= load_slot;
+            if (load_round_we)
+              load_round_reg <= load_round_new;
+            if (load_ready_we)
+              load_ready_reg <= load_ready_new;
+            if (rd_ctrl_we)
+              rd_ctrl_reg <= rd_ctrl_new;
+            if (rd_slot_we)
+              rd_slot_reg <= slot;
+            if (rd_round_we)
+              rd_round_reg <= rd_round_new;
+            if (round_key_we)
+              round_key_reg <= key_mem[{rd_slot_reg, rd_round_reg}];
+          end
+      end // reg_update
+
+    //----------------------------------------------------------------
+    // key_mem_update
+    //
+    // Write port of the round-key store, without reset.
+    //----------------------------------------------------------------
+    always @ (posedge clk)
+      begin: key_mem_update
+        if (key_mem_we)
+          key_mem[{load_slot_reg, load_round_reg}] <= keymem_round_key;
+      end // key_mem_update
+
+    //----------------------------------------------------------------
+    // load_ctrl
+    //
+    // Expands a key into its slot: one init and one next per round key
+    // of aes_key_mem_fly, which needs a cycle to return to idle after
+    // each of them.
+    //----------------------------------------------------------------
+    always @*
+      begin: load_ctrl
+        load_ctrl_new  = CTRL_IDLE;
+        load_ctrl_we   = 1'b0;
+        load_slot_we   = 1'b0;
+        load_round_new = 4'h0;
+        load_round_we  = 1'b0;
+        load_ready_new = 1'b0;
+        load_ready_we  = 1'b0;
+        keylen_we      = 1'b0;
+        key_mem_we     = 1'b0;
+        keymem_init    = 1'b0;
+        keymem_next    = 1'b0;
+
+        case (load_ctrl_reg)
+          CTRL_IDLE:
+            if (load)
+              begin
+                load_slot_we   = 1'b1;
+                keylen_we      = 1'b1;
+                load_round_we  = 1'b1;
+                load_ready_new = 1'b0;
+                load_ready_we  = 1'b1;
+                keymem_init    = 1'b1;
+                load_ctrl_new  = CTRL_INIT;
+                load_ctrl_we   = 1'b1;
+              end
+          CTRL_INIT:
+            begin
+              load_ctrl_new = CTRL_NEXT;
+              load_ctrl_we  = 1'b1;
+            end
+          CTRL_NEXT:
+            begin
+              keymem_next   = 1'b1;
+              load_ctrl_new = CTRL_STORE;
+              load_ctrl_we  = 1'b1;
+            end
+          CTRL_STORE:
+            begin
+              key_mem_we    = 1'b1;
+              load_round_we = 1'b1;
+              if (load_round_reg == load_last_round)
+                begin
+                  load_ready_new = 1'b1;
+                  load_ready_we  = 1'b1;
+                  load_ctrl_new  = CTRL_IDLE;
+                  load_ctrl_we   = 1'b1;
+                end
+              else
+                begin
+                  load_round_new = load_round_reg + 1'b1;
+                  load_ctrl_new  = CTRL_NEXT;
+                  load_ctrl_we   = 1'b1;
+                end
+            end
+          default:
+            begin
+            end
+        endcase // case (load_ctrl_reg)
+      end // load_ctrl
+
+    //----------------------------------------------------------------
+    // rd_ctrl
+    //
+    // Round key sequencing with the timing of aes_key_mem_fly: every
+    // next returns the following round key one cycle later, also when
+    // the nexts are given back to back.
+    //----------------------------------------------------------------
+    always @*
+      begin: rd_ctrl
+        rd_ctrl_new  = RD_IDLE;
+        rd_ctrl_we   = 1'b0;
+        rd_slot_we   = 1'b0;
+        rd_round_new = 4'h0;
+        rd_round_we  = 1'b0;
+        round_key_we = 1'b0;
+
+        case (rd_ctrl_reg)
+          RD_IDLE:
+            begin
+              if (init)
+                begin
+                  rd_slot_we  = 1'b1;
+                  rd_round_we = 1'b1;
+                end
+              else if (next)
+                begin
+                  round_key_we = 1'b1;
+                  rd_round_we  = 1'b1;
+                  if (rd_round_reg != rd_last_round)
+                    rd_round_new = rd_round_reg + 1'b1;
+                  rd_ctrl_new  = RD_DONE;
+                  rd_ctrl_we   = 1'b1;
+                end
+            end
+          RD_DONE:
+            begin
+              if (next)
+                begin
+                  round_key_we = 1'b1;
+                  rd_round_we  = 1'b1;
+                  if (rd_round_reg != rd_last_round)
+                    rd_round_new = rd_round_reg + 1'b1;
+                end
+              else
+                begin
+                  rd_ctrl_new = RD_IDLE;
+                  rd_ctrl_we  = 1'b1;
+                end
+            end
+        endcase // case (rd_ctrl_reg)
+      end // rd_ctrl
+
+endmodule // aes_key_cache
@@ -390,12 +390,22 @@ module aes_key_mem_fly(
           end
 
 
+        // A next right after the previous one is accepted as well, so
+        // that one round key per cycle can be generated.
         CTRL_DONE:
           begin
-            ready_new        = 1'b1;
-            ready_we         = 1'b1;
-            key_mem_ctrl_new = CTRL_IDLE;
-            key_mem_ctrl_we  = 1'b1;
+            if (next)
+              begin
+                round_ctr_inc    = 1'b1;
+                round_key_update = 1'b1;
+              end
+            else
+              begin
+                ready_new        = 1'b1;
+                ready_we         = 1'b1;
+                key_mem_ctrl_new = CTRL_IDLE;
+                key_mem_ctrl_we  = 1'b1;
+              end
           end
 
         default:
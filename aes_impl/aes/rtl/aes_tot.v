@@ -20,7 +20,7 @@
 
 `default_nettype none
 
-module aes_tot(
+module aes_tot #(parameter KEY_SLOT_BITS = 2)(
            input wire            clk,
            input wire            reset_n,
            
@@ -29,24 +29,40 @@ module aes_tot(
            input wire            finalize,
            input wire            enc_auth,  // 0: Encrypt, 1: Authenticate
            input wire [127 : 0]  counter,
+           input wire            load_key,  // Expand key into key_slot
+           input wire [KEY_SLOT_BITS - 1 : 0] key_slot, // Slot that is loaded, or that init binds the message to
            input wire [255 : 0]  key,
            input wire            keylen,
            input wire [7 : 0]    final_size, // Only used to process the final block of the message for both CMAC and CTR-mode
            input wire [127 : 0]  block_i,
            
+           input wire            ctx_load,  // Restore the message state from ctx_i, only when idle
+           input wire [519 : 0]  ctx_i,
+           output wire [519 : 0] ctx_o,     // {key slot, CMAC k1, k2 and chaining value, CTR counter}
+           
            output reg [127 : 0]  block_o,
-           output reg            ready
+           output reg            ready,
+           output wire           key_ready
           );
   
+  //----------------------------------------------------------------
+  // Registers.
+  //----------------------------------------------------------------
+  
+  // Key slot that the last init bound the AES core to. It is part of
+  // the context, so that a restored message is bound to its slot again.
+  reg [KEY_SLOT_BITS - 1 : 0] bound_slot_reg;
+  
   //----------------------------------------------------------------
   // Wires.
   //----------------------------------------------------------------
   
   // AES Core
-  wire           core_encdec;
   reg            core_init;
   reg            core_next;
   wire           core_ready;
+  wire           core_load_key;
+  wire [KEY_SLOT_BITS - 1 : 0] core_key_slot;
   wire [255 : 0] core_key;
   wire           core_keylen;
   reg  [127 : 0] core_block;
@@ -62,6 +78,7 @@ module aes_tot(
   wire [7 : 0]   ctr_core_len_i;
   wire [127 : 0] ctr_core_block_o;
   wire           ctr_core_ready;
+  wire [127 : 0] ctr_core_ctx_o;
   
   wire           ctr_core_core_init;
   wire           ctr_core_core_next;
@@ -76,6 +93,7 @@ module aes_tot(
   wire [127 : 0] cmac_core_result;
   wire           cmac_core_ready;
   wire           cmac_core_valid;
+  wire [383 : 0] cmac_core_ctx_o;
   
   wire           cmac_core_core_init;
   wire           cmac_core_core_next;
@@ -84,15 +102,16 @@ module aes_tot(
   //----------------------------------------------------------------
   // Instantiations.
   //----------------------------------------------------------------
-  aes_core aes(
+  aes_core_cached #(.KEY_SLOT_BITS(KEY_SLOT_BITS)) aes(
                .clk(clk),
                .reset_n(reset_n),
   
-               .encdec(core_encdec),
                .init(core_init),
                .next(core_next),
                .ready(core_ready),
                  
+               .load_key(core_load_key),
+               .key_slot(core_key_slot),
                .key(core_key),
                .keylen(core_keylen),
                  
@@ -112,6 +131,10 @@ module aes_tot(
                    .block_i(ctr_core_block_i),
                    .len_i(ctr_core_len_i),
                    
+                   .ctx_load(ctx_load),
+                   .ctx_i(ctx_i[127 : 0]),
+                   .ctx_o(ctr_core_ctx_o),
+                   
                    .core_init(ctr_core_core_init),
                    .core_next(ctr_core_core_next),
                    .core_block(ctr_core_core_block),
@@ -133,6 +156,10 @@ module aes_tot(
                      .finalize(cmac_core_finalize),
                      .block(cmac_core_block),
                      
+                     .ctx_load(ctx_load),
+                     .ctx_i(ctx_i[511 : 128]),
+                     .ctx_o(cmac_core_ctx_o),
+                     
                      .core_init(cmac_core_core_init),
                      .core_next(cmac_core_core_next),
                      .core_block(cmac_core_core_block),
@@ -150,10 +177,16 @@ module aes_tot(
   //----------------------------------------------------------------
   
   // AES Core
-  assign core_encdec           = 1'b1;    // Only encryption is needed for CTR-mode and CMAC
+  assign core_load_key         = load_key;
+  assign core_key_slot         = ctx_load ? ctx_i[512 + KEY_SLOT_BITS - 1 : 512] : key_slot;
   assign core_key              = key;
   assign core_keylen           = keylen;  // Keylen: 0 for 128-bit, 1 for 256-bit
   
+  assign key_ready             = core_ready;  // Only used after load_key, when the core is otherwise idle
+  
+  // Context
+  assign ctx_o                 = {{(8 - KEY_SLOT_BITS){1'b0}}, bound_slot_reg, cmac_core_ctx_o, ctr_core_ctx_o};
+  
   // CTR Core
   assign ctr_core_init         = init && (!enc_auth);
   assign ctr_core_next         = next && (!enc_auth);
@@ -169,6 +202,17 @@ module aes_tot(
   assign cmac_core_finalize    = finalize && enc_auth;
   assign cmac_core_block       = block_i;
       
+  //----------------------------------------------------------------
+  // reg_update
+  //----------------------------------------------------------------
+  always @ (posedge clk or negedge reset_n)
+    begin : reg_update
+      if (!reset_n)
+        bound_slot_reg <= {KEY_SLOT_BITS{1'b0}};
+      else if (core_init)
+        bound_slot_reg <= core_key_slot;
+    end // reg_update
+  
   //----------------------------------------------------------------
   // Logic
   //----------------------------------------------------------------
@@ -190,6 +234,10 @@ module aes_tot(
           core_next   = ctr_core_core_next;
           core_block  = ctr_core_core_block;
         end
+      
+      // A restored context binds the AES core to its key slot again
+      if (ctx_load)
+        core_init = 1'b1;
     end // aes_tot_logic
     
   
@@ -0,0 +1,526 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer: Ryan De Koninck
+//
+// Create Date:
+// Design Name:
+// Module Name: aes_tot_array_wrapper
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description: aes_tot_wrapper with NUM_CORES aes_tot cores, one per lane.
+//              A lane keeps one message. The normal commands work as in
+//              aes_tot_wrapper, on the lane in the ctx_id field of the
+//              frame read last. CMD_COMPUTE_BATCH carries a block for
+//              every lane in one frame, runs them on all cores in
+//              parallel and returns all results in the same command.
+//
+// Dependencies: aes_tot, wrapper_stats
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments:
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module aes_tot_array_wrapper #(parameter NUM_CORES = 4)(  // 1 to 7
+                   input wire             clk,
+                   input wire             resetn,
+
+                   input wire [31 : 0]    arm_to_fpga_cmd,
+                   input wire             arm_to_fpga_cmd_valid,
+                   output wire            fpga_to_arm_done,
+                   input wire             fpga_to_arm_done_read,
+
+                   input wire             arm_to_fpga_data_valid,
+                   output wire            arm_to_fpga_data_ready,
+                   input wire [1023 : 0]  arm_to_fpga_data,
+
+                   output wire            fpga_to_arm_data_valid,
+                   input wire             fpga_to_arm_data_ready,
+                   output wire [1023 : 0] fpga_to_arm_data,
+
+                   output wire [3 : 0]    leds
+                   );
+
+    //----------------------------------------------------------------
+    // Internal constant and parameter definitions.
+    //----------------------------------------------------------------
+    localparam KEY_SLOT_BITS      = 2;  // Number of round-key slots per core: 4
+    localparam LANE_BITS          = 3;
+
+      // States
+    localparam CTRL_WAIT_FOR_CMD  = 4'h0;
+    localparam CTRL_READ          = 4'h1;
+    localparam CTRL_LOAD          = 4'h2;
+    localparam CTRL_START         = 4'h3;
+    localparam CTRL_BUSY          = 4'h4;
+    localparam CTRL_WRITE         = 4'h5;
+    localparam CTRL_ASSERT_DONE   = 4'h6;
+    localparam CTRL_STATS_WRITE   = 4'h7;
+    localparam CTRL_KEY_BUSY      = 4'h8;
+    localparam CTRL_BATCH_WAIT    = 4'h9;
+    localparam CTRL_BATCH_READ    = 4'ha;
+    localparam CTRL_BATCH_START   = 4'hb;
+    localparam CTRL_BATCH_BUSY    = 4'hc;
+    localparam CTRL_BATCH_WRITE   = 4'hd;
+
+      // Operation started in CTRL_START
+    localparam OP_INIT            = 2'h0;
+    localparam OP_NEXT            = 2'h1;
+    localparam OP_FINAL           = 2'h2;
+    localparam OP_LOAD_KEY        = 2'h3;
+
+      // Wrapper commands, the same codes as aes_tot_wrapper
+    localparam CMD_READ           = 32'h0;
+    localparam CMD_COMPUTE_INIT   = 32'h1;
+    localparam CMD_COMPUTE_NEXT   = 32'h2;
+    localparam CMD_COMPUTE_FINAL  = 32'h3;
+    localparam CMD_WRITE          = 32'h4;
+    localparam CMD_LOAD_KEY       = 32'h5;
+    localparam CMD_READ_STATS     = 32'h7;
+    localparam CMD_READ_STATS_HI  = 32'hf;  // CMD_READ_STATS with bit 3 set
+    localparam CMD_COMPUTE_BATCH  = 32'hb;
+
+    //----------------------------------------------------------------
+    // Registers + update variables and write enable.
+    //----------------------------------------------------------------
+    reg [3 : 0]    aes_tot_array_wrapper_ctrl_reg;
+    reg [3 : 0]    aes_tot_array_wrapper_ctrl_new;
+    reg            aes_tot_array_wrapper_ctrl_we;
+
+      // Inputs of every lane, loaded from in_buf_reg by a compute command
+      // for the lane, or from the batch frame
+    reg [NUM_CORES - 1 : 0] enc_auth_reg;
+    reg [NUM_CORES - 1 : 0] keylen_reg;
+    reg [255 : 0]  key_reg [0 : NUM_CORES - 1];
+    reg [127 : 0]  counter_reg [0 : NUM_CORES - 1];
+    reg [7 : 0]    key_slot_reg [0 : NUM_CORES - 1];
+    reg [7 : 0]    final_size_reg [0 : NUM_CORES - 1];
+    reg [127 : 0]  block_i_reg [0 : NUM_CORES - 1];
+    reg            inputs_we;
+
+    reg [537 : 0]  in_buf_reg;
+    reg            in_buf_we;
+
+    reg [1 : 0]    start_op_reg;
+    reg [1 : 0]    start_op_new;
+    reg            start_op_we;
+
+      // Lanes that run in the background, until the ready of their core
+    reg [NUM_CORES - 1 : 0] lane_busy_reg;
+    reg [NUM_CORES - 1 : 0] lane_busy_new;
+
+    reg [127 : 0]  result_reg [0 : NUM_CORES - 1];
+    reg [NUM_CORES - 1 : 0] result_we;
+
+    reg [NUM_CORES - 1 : 0] batch_mask_reg;
+    reg [NUM_CORES - 1 : 0] batch_final_reg;
+    reg            batch_we;
+
+    reg            batch_mode_reg;
+    reg            batch_mode_new;
+    reg            batch_mode_we;
+
+    reg            stats_mode_reg;
+    reg            stats_mode_new;
+    reg            stats_mode_we;
+
+    reg            fpga_to_arm_data_valid_reg;
+    wire           fpga_to_arm_data_valid_new;
+
+    reg            arm_to_fpga_data_ready_reg;
+    wire           arm_to_fpga_data_ready_new;
+
+    reg            fpga_to_arm_done_reg;
+    wire           fpga_to_arm_done_new;
+
+    //----------------------------------------------------------------
+    // Wires.
+    //----------------------------------------------------------------
+      // Core I/O
+    reg [NUM_CORES - 1 : 0] core_init;
+    reg [NUM_CORES - 1 : 0] core_next;
+    reg [NUM_CORES - 1 : 0] core_finalize;
+    reg [NUM_CORES - 1 : 0] core_load_key;
+    wire [128 * NUM_CORES - 1 : 0] core_result;
+    wire [NUM_CORES - 1 : 0] core_ready;
+    wire [NUM_CORES - 1 : 0] core_key_ready;
+
+      // Lane of the frame read last
+    wire [LANE_BITS - 1 : 0] lane;
+    wire           lane_ok;
+    wire [NUM_CORES - 1 : 0] lane_sel;
+
+      // Batch frame
+    wire [NUM_CORES - 1 : 0] batch_mask_new;
+    wire [NUM_CORES - 1 : 0] batch_final_new;
+    reg [1023 : 0] batch_out;
+
+      // Statistics
+    wire           stats_cmd_accept;
+    wire [1023 : 0] stats;
+
+    //----------------------------------------------------------------
+    // Instantiations.
+    //----------------------------------------------------------------
+    wrapper_stats wrapper_stats(
+                                .clk(clk),
+                                .reset_n(resetn),
+                                .state(aes_tot_array_wrapper_ctrl_reg),
+                                .cmd_accept(stats_cmd_accept),
+                                .cmd(arm_to_fpga_cmd[3 : 0]),
+                                .stats(stats)
+                                );
+
+    genvar k;
+    generate
+      for (k = 0; k < NUM_CORES; k = k + 1)
+        begin : lane_gen
+          aes_tot #(.KEY_SLOT_BITS(KEY_SLOT_BITS)) tot(
+                      .clk(clk),
+                      .reset_n(resetn),
+                      .init(core_init[k]),
+                      .next(core_next[k]),
+                      .finalize(core_finalize[k]),
+                      .enc_auth(enc_auth_reg[k]),
+                      .counter(counter_reg[k]),
+                      .load_key(core_load_key[k]),
+                      .key_slot(key_slot_reg[k][KEY_SLOT_BITS - 1 : 0]),
+                      .key_ready(core_key_ready[k]),
+                      .key(key_reg[k]),
+                      .keylen(keylen_reg[k]),
+                      .final_size(final_size_reg[k]),
+                      .block_i(block_i_reg[k]),
+
+                      .ctx_load(1'b0),
+                      .ctx_i(520'h0),
+                      .ctx_o(),
+
+                      .block_o(core_result[128 * k +: 128]),
+                      .ready(core_ready[k])
+                      );
+        end
+    endgenerate
+
+    //----------------------------------------------------------------
+    // Concurrent connectivity for ports etc.
+    //----------------------------------------------------------------
+      // ARM to FPGA data decomposition: the frame of aes_tot_wrapper, with
+      // the lane in the ctx_id field
+    assign lane     = in_buf_reg[530 + LANE_BITS - 1 : 530];
+    assign lane_ok  = (lane < NUM_CORES) && (in_buf_reg[537 : 530 + LANE_BITS] == 0);
+    assign lane_sel = lane_ok ? ({{NUM_CORES{1'b0}}, 1'b1} << lane) : {NUM_CORES{1'b0}};
+
+      // Batch frame: the block of lane i in bits 128 * i + 127 to 128 * i,
+      // the lanes that get a block in bits 903 to 896, the lanes for which
+      // it is the final block in bits 911 to 904, and the final_size of
+      // lane i in bits 912 + 8 * i + 7 to 912 + 8 * i. The result frame has
+      // the result of lane i in the same place as its block.
+    assign batch_mask_new  = arm_to_fpga_data[896 +: NUM_CORES];
+    assign batch_final_new = arm_to_fpga_data[904 +: NUM_CORES] & batch_mask_new;
+
+    always @*
+      begin: batch_frame
+        integer j;
+
+        batch_out = 1024'h0;
+        for (j = 0; j < NUM_CORES; j = j + 1)
+          if (batch_mask_reg[j])
+            batch_out[128 * j +: 128] = result_reg[j];
+        batch_out[896 +: NUM_CORES] = batch_mask_reg;
+      end
+
+      // Wrapper I/O
+    assign fpga_to_arm_data       = stats_mode_reg ? stats :
+                                    batch_mode_reg ? batch_out :
+                                    {896'h0, lane_ok ? result_reg[lane] : 128'h0};
+    assign fpga_to_arm_data_valid = fpga_to_arm_data_valid_reg;
+    assign arm_to_fpga_data_ready = arm_to_fpga_data_ready_reg;
+    assign fpga_to_arm_done       = fpga_to_arm_done_reg;
+
+      // Statistics: every command that leaves CTRL_WAIT_FOR_CMD is counted
+    assign stats_cmd_accept = (aes_tot_array_wrapper_ctrl_reg == CTRL_WAIT_FOR_CMD) && aes_tot_array_wrapper_ctrl_we;
+
+      // The four LEDs on the board are used as debug signals.
+    assign leds = aes_tot_array_wrapper_ctrl_reg;
+
+    //----------------------------------------------------------------
+    // reg_update
+    //
+    // Update functionality for all registers in the core.
+    // All registers are positive edge triggered with asynchronous
+    // active low reset. All registers have write enable.
+    //----------------------------------------------------------------
+    always @ (posedge clk or negedge resetn)
+      begin: reg_update
+        integer i;
+
+        if (!resetn)
+          begin
+            for (i = 0; i < NUM_CORES; i = i + 1)
+              begin
+                key_reg[i]        <= 256'h0;
+                counter_reg[i]    <= 128'h0;
+                key_slot_reg[i]   <= 8'h0;
+                final_size_reg[i] <= 8'h0;
+                block_i_reg[i]    <= 128'h0;
+                result_reg[i]     <= 128'h0;
+              end
+            aes_tot_array_wrapper_ctrl_reg <= CTRL_WAIT_FOR_CMD;
+            enc_auth_reg                   <= {NUM_CORES{1'b0}};
+            keylen_reg                     <= {NUM_CORES{1'b0}};
+            in_buf_reg                     <= 538'h0;
+            start_op_reg                   <= OP_INIT;
+            lane_busy_reg                  <= {NUM_CORES{1'b0}};
+            batch_mask_reg                 <= {NUM_CORES{1'b0}};
+            batch_final_reg                <= {NUM_CORES{1'b0}};
+            batch_mode_reg                 <= 1'b0;
+            stats_mode_reg                 <= 1'b0;
+            fpga_to_arm_data_valid_reg     <= 1'b0;
+            arm_to_fpga_data_ready_reg     <= 1'b0;
+            fpga_to_arm_done_reg           <= 1'b0;
+          end
+        else
+          begin
+            if (aes_tot_array_wrapper_ctrl_we)
+              aes_tot_array_wrapper_ctrl_reg <= aes_tot_array_wrapper_ctrl_new;
+            for (i = 0; i < NUM_CORES; i = i + 1)
+              begin
+                if (inputs_we && lane_sel[i])
+                  begin
+                    key_slot_reg[i]   <= in_buf_reg[529 : 522];
+                    enc_auth_reg[i]   <= in_buf_reg[521];
+                    counter_reg[i]    <= in_buf_reg[520 : 393];
+                    key_reg[i]        <= in_buf_reg[392 : 137];
+                    keylen_reg[i]     <= in_buf_reg[136];
+                    final_size_reg[i] <= in_buf_reg[135 : 128];
+                    block_i_reg[i]    <= in_buf_reg[127 : 0];
+                  end
+                if (batch_we && batch_mask_new[i])
+                  block_i_reg[i] <= arm_to_fpga_data[128 * i +: 128];
+                if (batch_we && batch_final_new[i])
+                  final_size_reg[i] <= arm_to_fpga_data[912 + 8 * i +: 8];
+                if (result_we[i])
+                  result_reg[i] <= core_result[128 * i +: 128];
+              end
+            if (in_buf_we)
+              in_buf_reg <= arm_to_fpga_data[537 : 0];
+            if (start_op_we)
+              start_op_reg <= start_op_new;
+            lane_busy_reg <= lane_busy_new;
+            if (batch_we)
+              begin
+                batch_mask_reg  <= batch_mask_new;
+                batch_final_reg <= batch_final_new;
+              end
+            if (batch_mode_we)
+              batch_mode_reg <= batch_mode_new;
+            if (stats_mode_we)
+              stats_mode_reg <= stats_mode_new;
+
+            // Wrapper control signals don't have a write enable
+            fpga_to_arm_data_valid_reg <= fpga_to_arm_data_valid_new;
+            arm_to_fpga_data_ready_reg <= arm_to_fpga_data_ready_new;
+            fpga_to_arm_done_reg <= fpga_to_arm_done_new;
+          end
+      end // reg_update
+
+    //----------------------------------------------------------------
+    // aes_tot_array_wrapper_ctrl
+    //
+    // Control FSM for aes_tot_array_wrapper.
+    //----------------------------------------------------------------
+    always @*
+      begin: aes_tot_array_wrapper_ctrl
+        aes_tot_array_wrapper_ctrl_new = CTRL_WAIT_FOR_CMD;
+        aes_tot_array_wrapper_ctrl_we  = 1'b0;
+        core_init                      = {NUM_CORES{1'b0}};
+        core_next                      = {NUM_CORES{1'b0}};
+        core_finalize                  = {NUM_CORES{1'b0}};
+        core_load_key                  = {NUM_CORES{1'b0}};
+        inputs_we                      = 1'b0;
+        in_buf_we                      = 1'b0;
+        start_op_new                   = OP_INIT;
+        start_op_we                    = 1'b0;
+        batch_we                       = 1'b0;
+        batch_mode_new                 = 1'b0;
+        batch_mode_we                  = 1'b0;
+        stats_mode_new                 = 1'b0;
+        stats_mode_we                  = 1'b0;
+
+        // The results of the cores are captured whatever command the FSM
+        // is handling in the meantime
+        result_we     = lane_busy_reg & core_ready;
+        lane_busy_new = lane_busy_reg & ~core_ready;
+
+        case (aes_tot_array_wrapper_ctrl_reg)
+          CTRL_WAIT_FOR_CMD:
+            begin
+              if (arm_to_fpga_cmd_valid)
+                begin
+                  aes_tot_array_wrapper_ctrl_we  = 1'b1;
+                  batch_mode_we                  = 1'b1;
+                  stats_mode_we                  = 1'b1;
+                  start_op_we                    = 1'b1;
+                  aes_tot_array_wrapper_ctrl_new = CTRL_LOAD;
+                  case (arm_to_fpga_cmd)
+                    CMD_READ:
+                      aes_tot_array_wrapper_ctrl_new = CTRL_READ;
+                    CMD_COMPUTE_INIT:
+                      start_op_new                   = OP_INIT;
+                    CMD_COMPUTE_NEXT:
+                      start_op_new                   = OP_NEXT;
+                    CMD_COMPUTE_FINAL:
+                      start_op_new                   = OP_FINAL;
+                    CMD_LOAD_KEY:
+                      start_op_new                   = OP_LOAD_KEY;
+                    CMD_WRITE:
+                      aes_tot_array_wrapper_ctrl_new = CTRL_BUSY;
+                    CMD_COMPUTE_BATCH:
+                      begin
+                        aes_tot_array_wrapper_ctrl_new = CTRL_BATCH_WAIT;
+                        batch_mode_new                 = 1'b1;
+                      end
+                    CMD_READ_STATS, CMD_READ_STATS_HI:
+                      begin
+                        aes_tot_array_wrapper_ctrl_new = CTRL_STATS_WRITE;
+                        stats_mode_new                 = 1'b1;
+                      end
+                    default:
+                      begin
+                        aes_tot_array_wrapper_ctrl_we  = 1'b0;
+                        batch_mode_we                  = 1'b0;
+                        stats_mode_we                  = 1'b0;
+                        start_op_we                    = 1'b0;
+                      end
+                  endcase
+                end
+            end
+          CTRL_READ:
+            if (arm_to_fpga_data_valid)
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+                in_buf_we                      = 1'b1;
+              end
+          CTRL_LOAD:
+              // A frame for a lane that does not exist is dropped
+            if (!lane_ok)
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+              end
+            else if (!(lane_busy_reg & lane_sel))
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_START;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+                inputs_we                      = 1'b1;
+              end
+          CTRL_START:
+            begin
+              aes_tot_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+              aes_tot_array_wrapper_ctrl_we  = 1'b1;
+              case (start_op_reg)
+                OP_INIT:
+                  core_init     = lane_sel;
+                OP_NEXT:
+                  core_next     = lane_sel;
+                OP_FINAL:
+                  core_finalize = lane_sel;
+                default:
+                  begin
+                    core_load_key                  = lane_sel;
+                    aes_tot_array_wrapper_ctrl_new = CTRL_KEY_BUSY;
+                  end
+              endcase
+              if (start_op_reg != OP_LOAD_KEY)
+                lane_busy_new = lane_busy_new | lane_sel;
+            end
+          CTRL_KEY_BUSY:
+            if (core_key_ready & lane_sel)
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_BUSY:
+            if (!(lane_busy_reg & lane_sel))
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_WRITE;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_WRITE:
+            if (fpga_to_arm_data_ready)
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+              end
+            // The blocks of a batch go straight into the inputs of the
+            // lanes, so all lanes have to be done first
+          CTRL_BATCH_WAIT:
+            if (lane_busy_reg == {NUM_CORES{1'b0}})
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_BATCH_READ;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_BATCH_READ:
+            if (arm_to_fpga_data_valid)
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_BATCH_START;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+                batch_we                       = 1'b1;
+              end
+          CTRL_BATCH_START:
+            begin
+              core_next                      = batch_mask_reg & ~batch_final_reg;
+              core_finalize                  = batch_final_reg;
+              lane_busy_new                  = lane_busy_new | batch_mask_reg;
+              aes_tot_array_wrapper_ctrl_new = CTRL_BATCH_BUSY;
+              aes_tot_array_wrapper_ctrl_we  = 1'b1;
+            end
+          CTRL_BATCH_BUSY:
+            if (lane_busy_reg == {NUM_CORES{1'b0}})
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_BATCH_WRITE;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_BATCH_WRITE:
+            if (fpga_to_arm_data_ready)
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_STATS_WRITE:
+            if (fpga_to_arm_data_ready)
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_ASSERT_DONE:
+            if (fpga_to_arm_done_read)
+              begin
+                aes_tot_array_wrapper_ctrl_new = CTRL_WAIT_FOR_CMD;
+                aes_tot_array_wrapper_ctrl_we  = 1'b1;
+              end
+          default:
+            begin
+
+            end
+          endcase // case (aes_tot_array_wrapper_ctrl_reg)
+        end // aes_tot_array_wrapper_ctrl
+
+    //----------------------------------------------------------------
+    // Wrapper control signals
+    //
+    // Set the control signals based on the current state of the FSM.
+    //----------------------------------------------------------------
+    assign fpga_to_arm_data_valid_new = (aes_tot_array_wrapper_ctrl_reg == CTRL_WRITE) ||
+                                        (aes_tot_array_wrapper_ctrl_reg == CTRL_BATCH_WRITE) ||
+                                        (aes_tot_array_wrapper_ctrl_reg == CTRL_STATS_WRITE);
+    assign arm_to_fpga_data_ready_new = (aes_tot_array_wrapper_ctrl_reg == CTRL_READ) ||
+                                        (aes_tot_array_wrapper_ctrl_reg == CTRL_BATCH_READ);
+    assign fpga_to_arm_done_new       = (aes_tot_array_wrapper_ctrl_reg == CTRL_ASSERT_DONE);
+
+endmodule
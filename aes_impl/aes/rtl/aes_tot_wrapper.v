@@ -43,6 +43,10 @@ module aes_tot_wrapper(
     //----------------------------------------------------------------
     // Internal constant and parameter definitions.
     //----------------------------------------------------------------
+    localparam KEY_SLOT_BITS      = 2;  // Number of round-key slots: 4
+    localparam CTX_BITS           = 2;  // Number of message contexts: 4
+    localparam CTX_WIDTH          = 520;
+    
       // States
     localparam CTRL_WAIT_FOR_CMD  = 4'h0;  
     localparam CTRL_READ          = 4'h1;
@@ -52,6 +56,14 @@ module aes_tot_wrapper(
     localparam CTRL_BUSY          = 4'h5;
     localparam CTRL_WRITE         = 4'h6;
     localparam CTRL_ASSERT_DONE   = 4'h7;
+    localparam CTRL_STATS_WRITE   = 4'h8;
+    localparam CTRL_LOAD_KEY      = 4'h9;
+    localparam CTRL_KEY_BUSY      = 4'ha;
+    localparam CTRL_LOAD          = 4'hb;
+    localparam CTRL_OS_START      = 4'hc;
+    localparam CTRL_OS_KEY        = 4'hd;
+    localparam CTRL_OS_NEXT       = 4'he;
+    localparam CTRL_OS_BUSY       = 4'hf;
     
       // Wrapper commands
     localparam CMD_READ           = 32'h0;
@@ -59,6 +71,13 @@ module aes_tot_wrapper(
     localparam CMD_COMPUTE_NEXT   = 32'h2;
     localparam CMD_COMPUTE_FINAL  = 32'h3;
     localparam CMD_WRITE          = 32'h4;
+    localparam CMD_LOAD_KEY       = 32'h5;
+    localparam CMD_COMPUTE_ONESHOT = 32'h6;
+    localparam CMD_WRITE_PREV     = 32'hc;  // CMD_WRITE with bit 3 set
+    localparam CMD_READ_STATS     = 32'h7;
+    localparam CMD_READ_STATS_HI  = 32'hf;  // CMD_READ_STATS with bit 3 set
+    localparam CMD_RESTORE_CTX    = 32'h8;  // CMD_READ with bit 3 set
+    localparam CMD_SAVE_CTX       = 32'h9;
 
     //----------------------------------------------------------------
     // Registers + update variables and write enable.
@@ -79,18 +98,91 @@ module aes_tot_wrapper(
     reg [127 : 0]  counter_reg;
     wire [127 : 0] counter_new;
     
+    reg [7 : 0]    key_slot_reg;
+    wire [7 : 0]   key_slot_new;
+    
     reg [7 : 0]    final_size_reg;
     wire [7 : 0]   final_size_new;
     
     reg [127 : 0]  block_i_reg;
     wire [127 : 0] block_i_new;
     
+    reg [7 : 0]    ctx_id_reg;
+    wire [7 : 0]   ctx_id_new;
+    
     reg            inputs_we;
+    reg            key_inputs_we;
+    
+      // Double buffering: READ fills in_buf_reg, which is copied into the
+      // registers above when the next command starts on the core. The core
+      // runs in the background (core_busy_reg), so the host can upload the
+      // next frame and fetch the previous result (out_buf_reg, saved when
+      // a new compute starts) while it computes.
+    reg [931 : 0]  in_buf_reg;
+    reg            in_buf_we;
+    
+    reg [3 : 0]    start_state_reg;
+    reg [3 : 0]    start_state_new;
+    reg            start_state_we;
+    
+    reg            core_busy_reg;
+    reg            core_busy_new;
+    reg            core_busy_we;
     
     reg [127 : 0]  result_reg;
     wire [127 : 0] result_new;
     reg            result_we;
     
+    reg [127 : 0]  out_buf_reg;
+    reg            out_buf_we;
+    
+    reg            write_prev_reg;
+    reg            write_prev_new;
+    reg            write_prev_we;
+    
+      // One-shot messages: the frame holds up to four blocks, which are
+      // run through init, next and finalize without further commands. The
+      // ciphertext blocks (or the CMAC tag) are collected in os_out_reg,
+      // which is cleared when a one-shot frame is read.
+    reg            os_mode_reg;
+    reg            os_mode_new;
+    reg            os_mode_we;
+    
+    reg [1 : 0]    os_ctr_reg;
+    reg [1 : 0]    os_ctr_new;
+    reg            os_ctr_we;
+    
+    reg [127 : 0]  os_out_reg [0 : 3];
+    reg            os_out_we;
+    reg            os_out_clear;
+    
+    reg            stats_mode_reg;
+    reg            stats_mode_new;
+    reg            stats_mode_we;
+    
+      // Contexts: the state of up to 2**CTX_BITS messages, selected by the
+      // ctx_id of the frame. The core holds the state of context
+      // ctx_cur_reg (while ctx_live_reg), ctx_mem that of the others. A
+      // compute command for another context first swaps the two, so
+      // messages can be interleaved without running init again.
+      // CMD_SAVE_CTX and CMD_RESTORE_CTX move a context to and from the
+      // host, to keep more messages than there are contexts.
+    reg [CTX_WIDTH - 1 : 0] ctx_mem [0 : (1 << CTX_BITS) - 1];
+    reg [CTX_WIDTH - 1 : 0] ctx_mem_new;
+    reg [CTX_BITS - 1 : 0]  ctx_mem_addr;
+    reg            ctx_mem_we;
+    
+    reg [CTX_BITS - 1 : 0]  ctx_cur_reg;
+    reg            ctx_cur_we;
+    
+    reg            ctx_live_reg;
+    reg            ctx_live_new;
+    reg            ctx_live_we;
+    
+    reg            ctx_mode_reg;
+    reg            ctx_mode_new;
+    reg            ctx_mode_we;
+    
     reg            fpga_to_arm_data_valid_reg;
     wire           fpga_to_arm_data_valid_new;
     
@@ -107,6 +199,8 @@ module aes_tot_wrapper(
     reg            core_init;
     reg            core_next;
     reg            core_finalize;
+    reg            core_load_key;
+    wire           core_key_ready;
     wire           core_enc_auth;
     wire [127 : 0] core_counter;
     wire [255 : 0] core_key;
@@ -117,10 +211,40 @@ module aes_tot_wrapper(
     wire [127 : 0] core_result;
     wire           core_ready;
     
+    reg            core_ctx_load;
+    wire [519 : 0] core_ctx_i;
+    wire [519 : 0] core_ctx_o;
+    
+      // Contexts
+    wire           ctx_swap;
+    wire [CTX_BITS - 1 : 0] ctx_save_slot;
+    wire [CTX_WIDTH - 1 : 0] ctx_save;
+    wire [CTX_BITS - 1 : 0] ctx_restore_slot;
+    
+      // One-shot frame
+    wire [127 : 0] os_block [0 : 3];
+    wire [2 : 0]   os_len;
+    wire           os_cached;
+    wire           os_last;
+    wire           os_len_ok;
+    
+      // Statistics
+    wire           stats_cmd_accept;
+    wire [1023 : 0] stats;
+    
     //----------------------------------------------------------------
     // Instantiations.
     //----------------------------------------------------------------
-    aes_tot tot(
+    wrapper_stats wrapper_stats(
+                                .clk(clk),
+                                .reset_n(resetn),
+                                .state(aes_tot_wrapper_ctrl_reg),
+                                .cmd_accept(stats_cmd_accept),
+                                .cmd(arm_to_fpga_cmd[3 : 0]),
+                                .stats(stats)
+                                );
+    
+    aes_tot #(.KEY_SLOT_BITS(KEY_SLOT_BITS)) tot(
                 .clk(clk),
                 .reset_n(resetn),
                 .init(core_init),
@@ -128,11 +252,18 @@ module aes_tot_wrapper(
                 .finalize(core_finalize),
                 .enc_auth(core_enc_auth),
                 .counter(core_counter),
+                .load_key(core_load_key),
+                .key_slot(key_slot_reg[KEY_SLOT_BITS - 1 : 0]),
+                .key_ready(core_key_ready),
                 .key(core_key),
                 .keylen(core_keylen),
                 .final_size(core_final_size),
                 .block_i(core_block_i),
                 
+                .ctx_load(core_ctx_load),
+                .ctx_i(core_ctx_i),
+                .ctx_o(core_ctx_o),
+                
                 .block_o(core_result),
                 .ready(core_ready)
                 );
@@ -145,24 +276,60 @@ module aes_tot_wrapper(
     assign core_key        = key_reg;
     assign core_keylen     = keylen_reg;
     assign core_counter    = counter_reg;
-    assign core_block_i    = block_i_reg;
+    assign core_block_i    = os_mode_reg ? os_block[os_ctr_reg] : block_i_reg;
     assign core_final_size = final_size_reg;
+    assign core_ctx_i      = ctx_mem[ctx_id_reg[CTX_BITS - 1 : 0]];
     assign result_new      = core_result;
     
       // ARM to FPGA data decomposition
-    assign enc_auth_new   = arm_to_fpga_data[521];
-    assign counter_new    = arm_to_fpga_data[520 : 393];
-    assign key_new        = arm_to_fpga_data[392 : 137];
-    assign keylen_new     = arm_to_fpga_data[136];
-    assign final_size_new = arm_to_fpga_data[135 : 128];
-    assign block_i_new    = arm_to_fpga_data[127 : 0];
+    assign ctx_id_new     = in_buf_reg[537 : 530];
+    assign key_slot_new   = in_buf_reg[529 : 522];
+    assign enc_auth_new   = in_buf_reg[521];
+    assign counter_new    = in_buf_reg[520 : 393];
+    assign key_new        = in_buf_reg[392 : 137];
+    assign keylen_new     = in_buf_reg[136];
+    assign final_size_new = in_buf_reg[135 : 128];
+    assign block_i_new    = in_buf_reg[127 : 0];
+    
+      // One-shot frame: the fields above, with blocks 1 to 3 in words 17 to
+      // 28, the number of blocks in word 29 and whether the round keys
+      // already in key_slot are used instead of the key field. The last
+      // block is final_size bits.
+    assign os_block[0]    = in_buf_reg[127 : 0];
+    assign os_block[1]    = in_buf_reg[671 : 544];
+    assign os_block[2]    = in_buf_reg[799 : 672];
+    assign os_block[3]    = in_buf_reg[927 : 800];
+    assign os_len         = in_buf_reg[930 : 928];
+    assign os_cached      = in_buf_reg[931];
+    assign os_last        = ({1'b0, os_ctr_reg} + 3'h1 >= os_len);
+      // A frame with 0 or more than 4 blocks is dropped: nothing is
+      // computed and the frame returned is all zeros.
+    assign os_len_ok      = (arm_to_fpga_data[930 : 928] != 3'h0) && (arm_to_fpga_data[930 : 928] <= 3'h4);
+    
+      // Contexts: a compute command swaps first if its frame is for
+      // another context than the live one. CMD_LOAD_KEY only takes the key
+      // fields of its frame and never swaps. CMD_COMPUTE_ONESHOT ignores the
+      // ctx_id of its frame and saves the live context before it runs. CMD_SAVE_CTX returns the context
+      // named in the last frame read, from the core if it is the live one.
+      // A context frame holds the state in its lower CTX_WIDTH bits and
+      // the ctx_id in bits 1023 to 1016.
+    assign ctx_swap         = (ctx_id_reg[CTX_BITS - 1 : 0] != ctx_cur_reg) || !ctx_live_reg;
+    assign ctx_save_slot    = ctx_id_new[CTX_BITS - 1 : 0];
+    assign ctx_save         = (ctx_live_reg && (ctx_save_slot == ctx_cur_reg)) ? core_ctx_o : ctx_mem[ctx_save_slot];
+    assign ctx_restore_slot = arm_to_fpga_data[1016 + CTX_BITS - 1 : 1016];
     
       // Wrapper I/O
-    assign fpga_to_arm_data       = {896'h0, result_reg};
+    assign fpga_to_arm_data       = stats_mode_reg ? stats :
+                                    ctx_mode_reg ? {ctx_id_new, {(1016 - CTX_WIDTH){1'b0}}, ctx_save} :
+                                    os_mode_reg ? {512'h0, os_out_reg[3], os_out_reg[2], os_out_reg[1], os_out_reg[0]} :
+                                    {896'h0, write_prev_reg ? out_buf_reg : result_reg};
     assign fpga_to_arm_data_valid = fpga_to_arm_data_valid_reg;
     assign arm_to_fpga_data_ready = arm_to_fpga_data_ready_reg;
     assign fpga_to_arm_done       = fpga_to_arm_done_reg;
     
+      // Statistics: every command that leaves CTRL_WAIT_FOR_CMD is counted
+    assign stats_cmd_accept = (aes_tot_wrapper_ctrl_reg == CTRL_WAIT_FOR_CMD) && aes_tot_wrapper_ctrl_we;
+    
       // The four LEDs on the board are used as debug signals.
     assign leds = aes_tot_wrapper_ctrl_reg;
 
@@ -175,35 +342,95 @@ module aes_tot_wrapper(
     //----------------------------------------------------------------
     always @ (posedge clk or negedge resetn)
       begin: reg_update
+        integer i;
+        
         if (!resetn)
           begin
+            for (i = 0; i < (1 << CTX_BITS); i = i + 1)
+              ctx_mem[i] <= {CTX_WIDTH{1'b0}};
             aes_tot_wrapper_ctrl_reg    <= CTRL_WAIT_FOR_CMD;
             enc_auth_reg                <= 1'b0;
             counter_reg                 <= 128'h0;
             key_reg                     <= 256'h0;
             keylen_reg                  <= 1'b0;
+            key_slot_reg                <= 8'h0;
             final_size_reg              <= 8'b0;
             block_i_reg                 <= 128'h0;
+            ctx_id_reg                  <= 8'h0;
+            in_buf_reg                  <= 932'h0;
+            start_state_reg             <= CTRL_WAIT_FOR_CMD;
+            core_busy_reg               <= 1'b0;
             result_reg                  <= 128'h0;
+            out_buf_reg                 <= 128'h0;
+            write_prev_reg              <= 1'b0;
+            os_mode_reg                 <= 1'b0;
+            os_ctr_reg                  <= 2'h0;
+            os_out_reg[0]               <= 128'h0;
+            os_out_reg[1]               <= 128'h0;
+            os_out_reg[2]               <= 128'h0;
+            os_out_reg[3]               <= 128'h0;
             fpga_to_arm_data_valid_reg  <= 1'b0;
             arm_to_fpga_data_ready_reg  <= 1'b0;
+            stats_mode_reg              <= 1'b0;
+            ctx_cur_reg                 <= {CTX_BITS{1'b0}};
+            ctx_live_reg                <= 1'b0;
+            ctx_mode_reg                <= 1'b0;
             fpga_to_arm_done_reg        <= 1'b0;
           end
         else
           begin
             if (aes_tot_wrapper_ctrl_we)
               aes_tot_wrapper_ctrl_reg <= aes_tot_wrapper_ctrl_new;
+            if (inputs_we || key_inputs_we)
+              begin
+                key_slot_reg   <= key_slot_new;
+                key_reg        <= key_new;
+                keylen_reg     <= keylen_new;
+              end
             if (inputs_we)
               begin
                 enc_auth_reg   <= enc_auth_new;
                 counter_reg    <= counter_new;
-                key_reg        <= key_new;
-                keylen_reg     <= keylen_new;
                 final_size_reg <= final_size_new;
                 block_i_reg    <= block_i_new;
+                ctx_id_reg     <= ctx_id_new;
               end
+            if (in_buf_we)
+              in_buf_reg <= arm_to_fpga_data[931 : 0];
+            if (start_state_we)
+              start_state_reg <= start_state_new;
+            if (core_busy_we)
+              core_busy_reg <= core_busy_new;
             if (result_we)
               result_reg   <= result_new;
+            if (out_buf_we)
+              out_buf_reg <= result_reg;
+            if (stats_mode_we)
+              stats_mode_reg <= stats_mode_new;
+            if (write_prev_we)
+              write_prev_reg <= write_prev_new;
+            if (os_mode_we)
+              os_mode_reg <= os_mode_new;
+            if (os_ctr_we)
+              os_ctr_reg <= os_ctr_new;
+              // CMAC only keeps the tag
+            if (os_out_clear)
+              begin
+                os_out_reg[0] <= 128'h0;
+                os_out_reg[1] <= 128'h0;
+                os_out_reg[2] <= 128'h0;
+                os_out_reg[3] <= 128'h0;
+              end
+            else if (os_out_we)
+              os_out_reg[enc_auth_reg ? 2'h0 : os_ctr_reg] <= result_new;
+            if (ctx_mem_we)
+              ctx_mem[ctx_mem_addr] <= ctx_mem_new;
+            if (ctx_cur_we)
+              ctx_cur_reg <= ctx_id_reg[CTX_BITS - 1 : 0];
+            if (ctx_live_we)
+              ctx_live_reg <= ctx_live_new;
+            if (ctx_mode_we)
+              ctx_mode_reg <= ctx_mode_new;
             
             // Wrapper control signals don't have a write enable
             fpga_to_arm_data_valid_reg <= fpga_to_arm_data_valid_new;
@@ -224,8 +451,44 @@ module aes_tot_wrapper(
         core_init                = 1'b0;
         core_next                = 1'b0;
         core_finalize            = 1'b0;
+        core_load_key            = 1'b0;
         inputs_we                = 1'b0;
+        key_inputs_we            = 1'b0;
+        in_buf_we                = 1'b0;
+        start_state_new          = CTRL_WAIT_FOR_CMD;
+        start_state_we           = 1'b0;
+        core_busy_new            = 1'b0;
+        core_busy_we             = 1'b0;
         result_we                = 1'b0;
+        out_buf_we               = 1'b0;
+        stats_mode_new           = 1'b0;
+        stats_mode_we            = 1'b0;
+        write_prev_new           = 1'b0;
+        write_prev_we            = 1'b0;
+        os_mode_new              = 1'b0;
+        os_mode_we               = 1'b0;
+        os_ctr_new               = 2'h0;
+        os_ctr_we                = 1'b0;
+        os_out_we                = 1'b0;
+        os_out_clear             = 1'b0;
+        core_ctx_load            = 1'b0;
+        ctx_mem_new              = core_ctx_o;
+        ctx_mem_addr             = ctx_cur_reg;
+        ctx_mem_we               = 1'b0;
+        ctx_cur_we               = 1'b0;
+        ctx_live_new             = 1'b0;
+        ctx_live_we              = 1'b0;
+        ctx_mode_new             = 1'b0;
+        ctx_mode_we              = 1'b0;
+        
+        // The result of the core is captured whatever command the FSM
+        // is handling in the meantime
+        if (core_busy_reg && core_ready)
+          begin
+            result_we     = 1'b1;
+            core_busy_new = 1'b0;
+            core_busy_we  = 1'b1;
+          end
         
         case (aes_tot_wrapper_ctrl_reg)
           CTRL_WAIT_FOR_CMD:
@@ -233,53 +496,224 @@ module aes_tot_wrapper(
               if (arm_to_fpga_cmd_valid)
                 begin
                   aes_tot_wrapper_ctrl_we  = 1'b1;
+                  stats_mode_we            = 1'b1;
+                  write_prev_we            = 1'b1;
+                  os_mode_we               = 1'b1;
+                  ctx_mode_we              = 1'b1;
+                  start_state_we           = 1'b1;
+                  aes_tot_wrapper_ctrl_new = CTRL_LOAD;
                   case (arm_to_fpga_cmd)
                     CMD_READ:
                       aes_tot_wrapper_ctrl_new = CTRL_READ;
                     CMD_COMPUTE_INIT:
-                      aes_tot_wrapper_ctrl_new = CTRL_INIT;
+                      start_state_new          = CTRL_INIT;
                     CMD_COMPUTE_NEXT:
-                      aes_tot_wrapper_ctrl_new = CTRL_NEXT;
+                      start_state_new          = CTRL_NEXT;
                     CMD_COMPUTE_FINAL:
-                      aes_tot_wrapper_ctrl_new = CTRL_FINAL;
+                      start_state_new          = CTRL_FINAL;
                     CMD_WRITE:
-                      aes_tot_wrapper_ctrl_new = CTRL_WRITE;
+                      aes_tot_wrapper_ctrl_new = CTRL_BUSY;
+                    CMD_LOAD_KEY:
+                      start_state_new          = CTRL_LOAD_KEY;
+                    CMD_COMPUTE_ONESHOT:
+                      begin
+                        aes_tot_wrapper_ctrl_new = CTRL_READ;
+                        start_state_new          = CTRL_OS_START;
+                        os_mode_new              = 1'b1;
+                      end
+                    CMD_WRITE_PREV:
+                      begin
+                        aes_tot_wrapper_ctrl_new = CTRL_WRITE;
+                        write_prev_new           = 1'b1;
+                      end
+                    CMD_READ_STATS, CMD_READ_STATS_HI:
+                      begin
+                        aes_tot_wrapper_ctrl_new = CTRL_STATS_WRITE;
+                        stats_mode_new           = 1'b1;
+                      end
+                    CMD_RESTORE_CTX:
+                      begin
+                        aes_tot_wrapper_ctrl_new = CTRL_READ;
+                        ctx_mode_new             = 1'b1;
+                      end
+                    CMD_SAVE_CTX:
+                      begin
+                        aes_tot_wrapper_ctrl_new = CTRL_BUSY;
+                        ctx_mode_new             = 1'b1;
+                      end
                     default:
-                      aes_tot_wrapper_ctrl_we  = 1'b0;
+                      begin
+                        aes_tot_wrapper_ctrl_we  = 1'b0;
+                        stats_mode_we            = 1'b0;
+                        write_prev_we            = 1'b0;
+                        os_mode_we               = 1'b0;
+                        ctx_mode_we              = 1'b0;
+                        start_state_we           = 1'b0;
+                      end
                   endcase
                 end
             end
           CTRL_READ:
             if (arm_to_fpga_data_valid)
               begin
-                aes_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                  // A one-shot frame is started right away
+                if (start_state_reg == CTRL_OS_START)
+                  begin
+                    os_out_clear = 1'b1;
+                    if (os_len_ok)
+                      aes_tot_wrapper_ctrl_new = CTRL_LOAD;
+                    else
+                      aes_tot_wrapper_ctrl_new = CTRL_WRITE;
+                  end
+                else
+                  aes_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 aes_tot_wrapper_ctrl_we  = 1'b1;
-                inputs_we                = 1'b1;
+                  // A context frame goes straight into the context table.
+                  // Restoring the live context drops the state in the core.
+                if (ctx_mode_reg)
+                  begin
+                    ctx_mem_new  = arm_to_fpga_data[CTX_WIDTH - 1 : 0];
+                    ctx_mem_addr = ctx_restore_slot;
+                    ctx_mem_we   = 1'b1;
+                    if (ctx_restore_slot == ctx_cur_reg)
+                      ctx_live_we = 1'b1;
+                  end
+                else
+                  in_buf_we                = 1'b1;
+              end
+          CTRL_LOAD:
+            if (!core_busy_reg)
+              begin
+                  // The inputs are loaded first. A frame for another
+                  // context than the live one then swaps the contexts and
+                  // loads the inputs again, two cycles more.
+                if (start_state_reg == CTRL_LOAD_KEY)
+                  begin
+                    key_inputs_we            = 1'b1;
+                    aes_tot_wrapper_ctrl_new = CTRL_LOAD_KEY;
+                    aes_tot_wrapper_ctrl_we  = 1'b1;
+                  end
+                  // A one-shot frame belongs to no context: the live one
+                  // is put back in ctx_mem and the core is left without one
+                else if (start_state_reg == CTRL_OS_START)
+                  begin
+                    inputs_we                = 1'b1;
+                    ctx_mem_we               = ctx_live_reg;
+                    ctx_live_we              = 1'b1;
+                    aes_tot_wrapper_ctrl_new = CTRL_OS_START;
+                    aes_tot_wrapper_ctrl_we  = 1'b1;
+                  end
+                else if (ctx_swap)
+                  begin
+                    core_ctx_load = 1'b1;
+                    ctx_mem_we    = ctx_live_reg;
+                    ctx_cur_we    = 1'b1;
+                    ctx_live_new  = 1'b1;
+                    ctx_live_we   = 1'b1;
+                  end
+                else
+                  begin
+                    inputs_we = 1'b1;
+                    if (ctx_id_new[CTX_BITS - 1 : 0] == ctx_cur_reg)
+                      begin
+                        aes_tot_wrapper_ctrl_new = start_state_reg;
+                        aes_tot_wrapper_ctrl_we  = 1'b1;
+                      end
+                  end
               end
           CTRL_INIT:
             begin
-              core_init                   = 1'b1;
-              aes_tot_wrapper_ctrl_new = CTRL_BUSY;
+              core_init                = 1'b1;
+              core_busy_new            = 1'b1;
+              core_busy_we             = 1'b1;
+              out_buf_we               = 1'b1;
+              aes_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               aes_tot_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_NEXT:
             begin
               core_next                = 1'b1;
-              aes_tot_wrapper_ctrl_new = CTRL_BUSY;
+              core_busy_new            = 1'b1;
+              core_busy_we             = 1'b1;
+              out_buf_we               = 1'b1;
+              aes_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               aes_tot_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_FINAL:
             begin
               core_finalize            = 1'b1;
-              aes_tot_wrapper_ctrl_new = CTRL_BUSY;
+              core_busy_new            = 1'b1;
+              core_busy_we             = 1'b1;
+              out_buf_we               = 1'b1;
+              aes_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               aes_tot_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_BUSY:
-            if (core_ready)
+            if (!core_busy_reg)
+              begin
+                aes_tot_wrapper_ctrl_new = CTRL_WRITE;
+                aes_tot_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_LOAD_KEY:
+            begin
+              core_load_key            = 1'b1;
+              aes_tot_wrapper_ctrl_new = CTRL_KEY_BUSY;
+              aes_tot_wrapper_ctrl_we  = 1'b1;
+            end
+          CTRL_KEY_BUSY:
+            if (core_key_ready)
               begin
                 aes_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 aes_tot_wrapper_ctrl_we  = 1'b1;
-                result_we                = 1'b1;
+              end
+          CTRL_OS_START:
+            begin
+              os_ctr_new               = 2'h0;
+              os_ctr_we                = 1'b1;
+              if (os_cached)
+                begin
+                  core_init                = 1'b1;
+                  aes_tot_wrapper_ctrl_new = CTRL_OS_NEXT;
+                end
+              else
+                begin
+                  core_load_key            = 1'b1;
+                  aes_tot_wrapper_ctrl_new = CTRL_OS_KEY;
+                end
+              aes_tot_wrapper_ctrl_we  = 1'b1;
+            end
+          CTRL_OS_KEY:
+            if (core_key_ready)
+              begin
+                core_init                = 1'b1;
+                aes_tot_wrapper_ctrl_new = CTRL_OS_NEXT;
+                aes_tot_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_OS_NEXT:
+              // Only init is waited for here. The ready of the CTR core is
+              // a pulse, which CTRL_OS_BUSY already took for the last block.
+            if (core_ready || (os_ctr_reg != 2'h0))
+              begin
+                if (os_last)
+                  core_finalize            = 1'b1;
+                else
+                  core_next                = 1'b1;
+                aes_tot_wrapper_ctrl_new = CTRL_OS_BUSY;
+                aes_tot_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_OS_BUSY:
+            if (core_ready)
+              begin
+                os_out_we                = !enc_auth_reg || os_last;
+                if (os_last)
+                  aes_tot_wrapper_ctrl_new = CTRL_WRITE;
+                else
+                  begin
+                    os_ctr_new               = os_ctr_reg + 2'h1;
+                    os_ctr_we                = 1'b1;
+                    aes_tot_wrapper_ctrl_new = CTRL_OS_NEXT;
+                  end
+                aes_tot_wrapper_ctrl_we  = 1'b1;
               end
           CTRL_WRITE:
             if (fpga_to_arm_data_ready)
@@ -287,6 +721,12 @@ module aes_tot_wrapper(
                 aes_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 aes_tot_wrapper_ctrl_we  = 1'b1;
               end
+          CTRL_STATS_WRITE:
+            if (fpga_to_arm_data_ready)
+              begin
+                aes_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                aes_tot_wrapper_ctrl_we  = 1'b1;
+              end
           CTRL_ASSERT_DONE:
             if (fpga_to_arm_done_read)
               begin
@@ -305,7 +745,8 @@ module aes_tot_wrapper(
     //
     // Set the control signals based on the current state of the FSM.
     //----------------------------------------------------------------
-    assign fpga_to_arm_data_valid_new = (aes_tot_wrapper_ctrl_reg == CTRL_WRITE);
+    assign fpga_to_arm_data_valid_new = (aes_tot_wrapper_ctrl_reg == CTRL_WRITE) ||
+                                        (aes_tot_wrapper_ctrl_reg == CTRL_STATS_WRITE);
     assign arm_to_fpga_data_ready_new = (aes_tot_wrapper_ctrl_reg == CTRL_READ);
     assign fpga_to_arm_done_new       = (aes_tot_wrapper_ctrl_reg == CTRL_ASSERT_DONE);
 
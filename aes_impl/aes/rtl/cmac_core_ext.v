@@ -49,6 +49,10 @@ module cmac_core_ext(
                  input wire            finalize,
 
                  input wire [127 : 0]  block,
+
+                 input wire            ctx_load,  // Load k1, k2 and the chaining value from ctx_i, only when idle
+                 input wire [383 : 0]  ctx_i,
+                 output wire [383 : 0] ctx_o,
                  
                  output reg            core_init,
                  output reg            core_next,
@@ -102,6 +106,8 @@ module cmac_core_ext(
   reg [127 : 0] k2_new;
   reg           k1_k2_we;
 
+  reg           ctx_we;
+
   reg [3 : 0]   cmac_ctrl_reg;
   reg [3 : 0]   cmac_ctrl_new;
   reg           cmac_ctrl_we;
@@ -115,6 +121,7 @@ module cmac_core_ext(
   assign result = result_reg;
   assign ready  = ready_reg;
   assign valid  = valid_reg;
+  assign ctx_o  = {k1_reg, k2_reg, result_reg};
 
   //----------------------------------------------------------------
   // reg_update
@@ -152,6 +159,13 @@ module cmac_core_ext(
 
           if (cmac_ctrl_we)
             cmac_ctrl_reg <= cmac_ctrl_new;
+
+          if (ctx_we)
+            begin
+              k1_reg     <= ctx_i[383 : 256];
+              k2_reg     <= ctx_i[255 : 128];
+              result_reg <= ctx_i[127 : 0];
+            end
         end
     end // reg_update
 
@@ -266,10 +280,14 @@ module cmac_core_ext(
       valid_we          = 1'h0;
       cmac_ctrl_new     = CTRL_IDLE;
       cmac_ctrl_we      = 1'h0;
+      ctx_we            = 1'h0;
 
       case (cmac_ctrl_reg)
         CTRL_IDLE:
           begin
+            if (ctx_load)
+              ctx_we = 1'h1;
+
             if (init)
               begin
                 ready_new        = 1'h0;
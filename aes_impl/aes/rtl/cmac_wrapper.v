@@ -52,6 +52,8 @@ module cmac_wrapper(
     localparam CTRL_BUSY          = 4'h5;
     localparam CTRL_WRITE         = 4'h6;
     localparam CTRL_ASSERT_DONE   = 4'h7;
+    localparam CTRL_STATS_WRITE   = 4'h8;
+    localparam CTRL_LOAD          = 4'h9;
     
       // Wrapper commands
     localparam CMD_READ_KEY       = 32'h0;
@@ -59,6 +61,9 @@ module cmac_wrapper(
     localparam CMD_COMPUTE_INIT   = 32'h2;
     localparam CMD_COMPUTE_NEXT   = 32'h3;
     localparam CMD_WRITE          = 32'h4;
+    localparam CMD_WRITE_PREV     = 32'hc;  // CMD_WRITE with bit 3 set
+    localparam CMD_READ_STATS     = 32'h7;
+    localparam CMD_READ_STATS_HI  = 32'hf;  // CMD_READ_STATS with bit 3 set
 
     //----------------------------------------------------------------
     // Registers + update variables and write enable.
@@ -87,10 +92,41 @@ module cmac_wrapper(
     wire [127 : 0] block_i_new;
     reg            block_i_we;
     
+      // Double buffering: READ_KEY and READ_BLOCK fill key_buf_reg and
+      // block_buf_reg, which are copied into the registers above when the
+      // next command starts on the core. The core runs in the background
+      // (core_busy_reg), so the host can upload the next block and fetch
+      // the previous result (out_buf_reg, saved when a new compute starts)
+      // while it computes.
+    reg [256 : 0]  key_buf_reg;
+    reg            key_buf_we;
+    
+    reg [136 : 0]  block_buf_reg;
+    reg            block_buf_we;
+    
+    reg [3 : 0]    start_state_reg;
+    reg [3 : 0]    start_state_new;
+    reg            start_state_we;
+    
+    reg            core_busy_reg;
+    reg            core_busy_new;
+    reg            core_busy_we;
+    
     reg [127 : 0]  result_reg;
     wire [127 : 0] result_new;
     reg            result_we;
     
+    reg [127 : 0]  out_buf_reg;
+    reg            out_buf_we;
+    
+    reg            write_prev_reg;
+    reg            write_prev_new;
+    reg            write_prev_we;
+    
+    reg            stats_mode_reg;
+    reg            stats_mode_new;
+    reg            stats_mode_we;
+    
     reg            fpga_to_arm_data_valid_reg;
     wire           fpga_to_arm_data_valid_new;
     
@@ -109,15 +145,28 @@ module cmac_wrapper(
     wire [7 : 0]   core_final_size;
     reg            core_init;
     reg            core_next;
-    wire           core_finalize;
+    reg            core_finalize;
     wire [127 : 0] core_block_i;
     wire [127 : 0] core_result;
     wire           core_ready;
     wire           core_valid;
     
+      // Statistics
+    wire           stats_cmd_accept;
+    wire [1023 : 0] stats;
+    
     //----------------------------------------------------------------
     // Instantiations.
     //----------------------------------------------------------------
+    wrapper_stats wrapper_stats(
+                                .clk(clk),
+                                .reset_n(resetn),
+                                .state(cmac_wrapper_ctrl_reg),
+                                .cmd_accept(stats_cmd_accept),
+                                .cmd(arm_to_fpga_cmd[3 : 0]),
+                                .stats(stats)
+                                );
+    
     cmac_core cmac(
                    .clk(clk),
                    .reset_n(resetn),
@@ -139,24 +188,27 @@ module cmac_wrapper(
       // Core I/O
     assign core_key        = key_reg;
     assign core_keylen     = keylen_reg;
-    assign core_finalize   = finalize_reg;
     assign core_final_size = final_size_reg;
     assign core_block_i    = block_i_reg;
     assign result_new      = core_result;
     
       // ARM to FPGA data decomposition
-    assign key_new        = arm_to_fpga_data[255 : 0];
-    assign keylen_new     = arm_to_fpga_data[256];
-    assign finalize_new   = (cmac_wrapper_ctrl_reg == CTRL_WAIT_FOR_CMD) ? 1'b0 : arm_to_fpga_data[136];
-    assign final_size_new = arm_to_fpga_data[135 : 128];
-    assign block_i_new    = arm_to_fpga_data[127 : 0];
+    assign key_new        = key_buf_reg[255 : 0];
+    assign keylen_new     = key_buf_reg[256];
+    assign finalize_new   = block_buf_reg[136];
+    assign final_size_new = block_buf_reg[135 : 128];
+    assign block_i_new    = block_buf_reg[127 : 0];
     
       // Wrapper I/O
-    assign fpga_to_arm_data       = {896'h0, result_reg};
+    assign fpga_to_arm_data       = stats_mode_reg ? stats :
+                                    {896'h0, write_prev_reg ? out_buf_reg : result_reg};
     assign fpga_to_arm_data_valid = fpga_to_arm_data_valid_reg;
     assign arm_to_fpga_data_ready = arm_to_fpga_data_ready_reg;
     assign fpga_to_arm_done       = fpga_to_arm_done_reg;
     
+      // Statistics: every command that leaves CTRL_WAIT_FOR_CMD is counted
+    assign stats_cmd_accept = (cmac_wrapper_ctrl_reg == CTRL_WAIT_FOR_CMD) && cmac_wrapper_ctrl_we;
+    
       // The four LEDs on the board are used as debug signals.
     assign leds = cmac_wrapper_ctrl_reg;
 
@@ -177,9 +229,16 @@ module cmac_wrapper(
             finalize_reg               <= 1'b0;
             final_size_reg             <= 8'b0;
             block_i_reg                <= 128'h0;
+            key_buf_reg                <= 257'h0;
+            block_buf_reg              <= 137'h0;
+            start_state_reg            <= CTRL_WAIT_FOR_CMD;
+            core_busy_reg              <= 1'b0;
             result_reg                 <= 128'h0;
+            out_buf_reg                <= 128'h0;
+            write_prev_reg             <= 1'b0;
             fpga_to_arm_data_valid_reg <= 1'b0;
             arm_to_fpga_data_ready_reg <= 1'b0;
+            stats_mode_reg             <= 1'b0;
             fpga_to_arm_done_reg       <= 1'b0;
           end
         else
@@ -196,8 +255,22 @@ module cmac_wrapper(
                 final_size_reg <= final_size_new;
             if (block_i_we)
                 block_i_reg <= block_i_new;
+            if (key_buf_we)
+              key_buf_reg <= arm_to_fpga_data[256 : 0];
+            if (block_buf_we)
+              block_buf_reg <= arm_to_fpga_data[136 : 0];
+            if (start_state_we)
+              start_state_reg <= start_state_new;
+            if (core_busy_we)
+              core_busy_reg <= core_busy_new;
             if (result_we)
               result_reg <= result_new;
+            if (out_buf_we)
+              out_buf_reg <= result_reg;
+            if (stats_mode_we)
+              stats_mode_reg <= stats_mode_new;
+            if (write_prev_we)
+              write_prev_reg <= write_prev_new;
             
             // Wrapper control signals don't have a write enable
             fpga_to_arm_data_valid_reg <= fpga_to_arm_data_valid_new;
@@ -221,29 +294,68 @@ module cmac_wrapper(
         final_size_we         = 1'b0;
         core_init             = 1'b0;
         core_next             = 1'b0;
+        core_finalize         = 1'b0;
         block_i_we            = 1'b0;
+        key_buf_we            = 1'b0;
+        block_buf_we          = 1'b0;
+        start_state_new       = CTRL_WAIT_FOR_CMD;
+        start_state_we        = 1'b0;
+        core_busy_new         = 1'b0;
+        core_busy_we          = 1'b0;
         result_we             = 1'b0;
+        out_buf_we            = 1'b0;
+        stats_mode_new        = 1'b0;
+        stats_mode_we         = 1'b0;
+        write_prev_new        = 1'b0;
+        write_prev_we         = 1'b0;
+        
+        // The result of the core is captured whatever command the FSM
+        // is handling in the meantime
+        if (core_busy_reg && core_ready)
+          begin
+            result_we     = core_valid;
+            core_busy_new = 1'b0;
+            core_busy_we  = 1'b1;
+          end
         
         case (cmac_wrapper_ctrl_reg)
           CTRL_WAIT_FOR_CMD:
             begin
-              finalize_we = 1'b1;
               if (arm_to_fpga_cmd_valid)
                 begin
                   cmac_wrapper_ctrl_we  = 1'b1;
+                  stats_mode_we         = 1'b1;
+                  write_prev_we         = 1'b1;
+                  start_state_we        = 1'b1;
+                  cmac_wrapper_ctrl_new = CTRL_LOAD;
                   case (arm_to_fpga_cmd)
                     CMD_READ_KEY:
                       cmac_wrapper_ctrl_new = CTRL_READ_KEY;
                     CMD_READ_BLOCK:
                       cmac_wrapper_ctrl_new = CTRL_READ_BLOCK;
                     CMD_COMPUTE_INIT:
-                      cmac_wrapper_ctrl_new = CTRL_INIT;
+                      start_state_new       = CTRL_INIT;
                     CMD_COMPUTE_NEXT:
-                      cmac_wrapper_ctrl_new = CTRL_NEXT;
+                      start_state_new       = CTRL_NEXT;
                     CMD_WRITE:
-                      cmac_wrapper_ctrl_new = CTRL_WRITE;
+                      cmac_wrapper_ctrl_new = CTRL_BUSY;
+                    CMD_WRITE_PREV:
+                      begin
+                        cmac_wrapper_ctrl_new = CTRL_WRITE;
+                        write_prev_new        = 1'b1;
+                      end
+                    CMD_READ_STATS, CMD_READ_STATS_HI:
+                      begin
+                        cmac_wrapper_ctrl_new = CTRL_STATS_WRITE;
+                        stats_mode_new        = 1'b1;
+                      end
                     default:
-                      cmac_wrapper_ctrl_we  = 1'b0;
+                      begin
+                        cmac_wrapper_ctrl_we  = 1'b0;
+                        stats_mode_we         = 1'b0;
+                        write_prev_we         = 1'b0;
+                        start_state_we        = 1'b0;
+                      end
                   endcase
                 end
             end
@@ -252,14 +364,22 @@ module cmac_wrapper(
               begin
                 cmac_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 cmac_wrapper_ctrl_we  = 1'b1;
-                key_we                = 1'b1;
-                keylen_we             = 1'b1;
+                key_buf_we            = 1'b1;
               end
           CTRL_READ_BLOCK:
             if (arm_to_fpga_data_valid)
               begin
                 cmac_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 cmac_wrapper_ctrl_we  = 1'b1;
+                block_buf_we          = 1'b1;
+              end
+          CTRL_LOAD:
+            if (!core_busy_reg)
+              begin
+                cmac_wrapper_ctrl_new = start_state_reg;
+                cmac_wrapper_ctrl_we  = 1'b1;
+                key_we                = 1'b1;
+                keylen_we             = 1'b1;
                 block_i_we            = 1'b1;
                 finalize_we           = 1'b1;
                 final_size_we         = 1'b1;
@@ -267,24 +387,28 @@ module cmac_wrapper(
           CTRL_INIT:
             begin
               core_init = 1'b1;
-              cmac_wrapper_ctrl_new = CTRL_BUSY;
+              core_busy_new         = 1'b1;
+              core_busy_we          = 1'b1;
+              out_buf_we            = 1'b1;
+              cmac_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               cmac_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_NEXT:
             begin
-              core_next = 1'b1;
-              cmac_wrapper_ctrl_new = CTRL_BUSY;
+              // The final block of the message is given with finalize
+              core_next             = !finalize_reg;
+              core_finalize         = finalize_reg;
+              core_busy_new         = 1'b1;
+              core_busy_we          = 1'b1;
+              out_buf_we            = 1'b1;
+              cmac_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               cmac_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_BUSY:
-            if (core_ready)
+            if (!core_busy_reg)
               begin
-                cmac_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                cmac_wrapper_ctrl_new = CTRL_WRITE;
                 cmac_wrapper_ctrl_we  = 1'b1;
-                if (core_valid)
-                  begin
-                    result_we = 1'b1;
-                  end
               end
           CTRL_WRITE:
             if (fpga_to_arm_data_ready)
@@ -292,6 +416,12 @@ module cmac_wrapper(
                 cmac_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 cmac_wrapper_ctrl_we  = 1'b1;
               end
+          CTRL_STATS_WRITE:
+            if (fpga_to_arm_data_ready)
+              begin
+                cmac_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                cmac_wrapper_ctrl_we  = 1'b1;
+              end
           CTRL_ASSERT_DONE:
             if (fpga_to_arm_done_read)
               begin
@@ -310,8 +440,10 @@ module cmac_wrapper(
     //
     // Set the control signals based on the current state of the FSM.
     //----------------------------------------------------------------
-    assign fpga_to_arm_data_valid_new = (cmac_wrapper_ctrl_reg == CTRL_WRITE);
-    assign arm_to_fpga_data_ready_new = (cmac_wrapper_ctrl_reg == CTRL_READ_KEY || CTRL_READ_BLOCK);
+    assign fpga_to_arm_data_valid_new = (cmac_wrapper_ctrl_reg == CTRL_WRITE) ||
+                                        (cmac_wrapper_ctrl_reg == CTRL_STATS_WRITE);
+    assign arm_to_fpga_data_ready_new = (cmac_wrapper_ctrl_reg == CTRL_READ_KEY) ||
+                                        (cmac_wrapper_ctrl_reg == CTRL_READ_BLOCK);
     assign fpga_to_arm_done_new       = (cmac_wrapper_ctrl_reg == CTRL_ASSERT_DONE);
 
 endmodule
\ No newline at end of file
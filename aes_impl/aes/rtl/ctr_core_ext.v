@@ -31,6 +31,10 @@ module ctr_core_ext(
            input wire [127 : 0]  block_i,
            input wire [7 : 0]    len_i,
            
+           input wire            ctx_load,  // Load the counter from ctx_i, only when idle
+           input wire [127 : 0]  ctx_i,
+           output wire [127 : 0] ctx_o,
+           
            output reg            core_init,
            output reg            core_next,
            output wire [127 : 0] core_block,
@@ -76,6 +80,7 @@ module ctr_core_ext(
   //----------------------------------------------------------------
   assign core_block  = counter_reg;
   assign ready = ready_reg;
+  assign ctx_o = counter_reg;
   
     //----------------------------------------------------------------
   // reg_update
@@ -124,6 +129,8 @@ module ctr_core_ext(
     begin
       if ((ctr_ctrl_reg == CTRL_IDLE) && init)
         counter_new = init_counter;
+      else if ((ctr_ctrl_reg == CTRL_IDLE) && ctx_load)
+        counter_new = ctx_i;
       else
         counter_new = {counter_reg[127 : 64], counter_reg[63 : 0] + 64'h1};
     end
@@ -173,6 +180,8 @@ module ctr_core_ext(
                 ctr_ctrl_we  = 1'b1;
                 core_next    = 1'b1;
               end
+            else if (ctx_load)
+              counter_we = 1'b1;
           end
         CTRL_INIT:
           begin
@@ -0,0 +1,338 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer:
+//
+// Create Date:
+// Design Name:
+// Module Name: ctr_core_pipe
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description: Fully unrolled AES-256-CTR engine, an alternative to ctr_core
+//              for bulk encryption. The 14 rounds are separate pipeline
+//              stages with their own round key register, so a new block
+//              can be given every clock cycle with next (or finalize for
+//              the last, possibly partial, block of len_i bits). The
+//              counter starts at init_counter and is increased for every
+//              block. Each block comes out of the pipeline 15 cycles
+//              later with block_o_valid, and block_o_last for the final
+//              block. The ports are those of ctr_core plus block_o_valid
+//              and block_o_last, so ctr_wrapper can use it instead
+//              (PIPE_CORE). Only AES-256 is supported: keylen must be 1.
+//
+// Dependencies: aes_key_mem_fly, aes_sbox
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments: init expands the key into the stage key registers,
+//                      which takes 17 cycles. It may only be given when
+//                      no blocks are in the pipeline.
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module ctr_core_pipe(
+           input wire            clk,
+           input wire            reset_n,
+
+           input wire            init,
+           input wire            next,
+           input wire            finalize,
+           input wire [127 : 0]  init_counter,
+           input wire [255 : 0]  key,
+           input wire            keylen,
+           input wire [127 : 0]  block_i,
+           input wire [7 : 0]    len_i,
+
+           output wire [127 : 0] block_o,
+           output wire           block_o_valid,
+           output wire           block_o_last,
+           output wire           ready
+          );
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  localparam AES256_ROUNDS = 14;
+
+  localparam CTRL_IDLE     = 1'b0;
+  localparam CTRL_EXPAND   = 1'b1;
+
+  //----------------------------------------------------------------
+  // Round functions with sub functions.
+  //----------------------------------------------------------------
+  function [7 : 0] gm2(input [7 : 0] op);
+    begin
+      gm2 = {op[6 : 0], 1'b0} ^ (8'h1b & {8{op[7]}});
+    end
+  endfunction // gm2
+
+  function [7 : 0] gm3(input [7 : 0] op);
+    begin
+      gm3 = gm2(op) ^ op;
+    end
+  endfunction // gm3
+
+  function [31 : 0] mixw(input [31 : 0] w);
+    reg [7 : 0] b0, b1, b2, b3;
+    reg [7 : 0] mb0, mb1, mb2, mb3;
+    begin
+      b0 = w[31 : 24];
+      b1 = w[23 : 16];
+      b2 = w[15 : 08];
+      b3 = w[07 : 00];
+
+      mb0 = gm2(b0) ^ gm3(b1) ^ b2      ^ b3;
+      mb1 = b0      ^ gm2(b1) ^ gm3(b2) ^ b3;
+      mb2 = b0      ^ b1      ^ gm2(b2) ^ gm3(b3);
+      mb3 = gm3(b0) ^ b1      ^ b2      ^ gm2(b3);
+
+      mixw = {mb0, mb1, mb2, mb3};
+    end
+  endfunction // mixw
+
+  function [127 : 0] mixcolumns(input [127 : 0] data);
+    begin
+      mixcolumns = {mixw(data[127 : 096]), mixw(data[095 : 064]),
+                    mixw(data[063 : 032]), mixw(data[031 : 000])};
+    end
+  endfunction // mixcolumns
+
+  function [127 : 0] shiftrows(input [127 : 0] data);
+    reg [31 : 0] w0, w1, w2, w3;
+    reg [31 : 0] ws0, ws1, ws2, ws3;
+    begin
+      w0 = data[127 : 096];
+      w1 = data[095 : 064];
+      w2 = data[063 : 032];
+      w3 = data[031 : 000];
+
+      ws0 = {w0[31 : 24], w1[23 : 16], w2[15 : 08], w3[07 : 00]};
+      ws1 = {w1[31 : 24], w2[23 : 16], w3[15 : 08], w0[07 : 00]};
+      ws2 = {w2[31 : 24], w3[23 : 16], w0[15 : 08], w1[07 : 00]};
+      ws3 = {w3[31 : 24], w0[23 : 16], w1[15 : 08], w2[07 : 00]};
+
+      shiftrows = {ws0, ws1, ws2, ws3};
+    end
+  endfunction // shiftrows
+
+  //----------------------------------------------------------------
+  // Registers + update variables and write enable.
+  //----------------------------------------------------------------
+  reg           ctr_ctrl_reg;
+  reg           ctr_ctrl_new;
+  reg           ctr_ctrl_we;
+
+  reg           ready_reg;
+  reg           ready_new;
+  reg           ready_we;
+
+  reg [127 : 0] counter_reg;
+  reg [127 : 0] counter_new;
+  reg           counter_we;
+
+  // Round keys, one per pipeline stage
+  reg [127 : 0] rk_reg [0 : AES256_ROUNDS];
+  reg           rk_we;
+
+  reg [3 : 0]   rk_ctr_reg;
+  reg [3 : 0]   rk_ctr_new;
+  reg           rk_ctr_we;
+
+  // Pipeline: AES state, input block, valid, last and length per stage
+  reg [127 : 0] state_reg [0 : AES256_ROUNDS];
+  reg [127 : 0] data_reg [0 : AES256_ROUNDS];
+  reg [7 : 0]   len_reg [0 : AES256_ROUNDS];
+  reg [AES256_ROUNDS : 0] valid_reg;
+  reg [AES256_ROUNDS : 0] last_reg;
+
+  //----------------------------------------------------------------
+  // Wires.
+  //----------------------------------------------------------------
+  reg            keymem_init;
+  reg            keymem_next;
+  wire [127 : 0] keymem_round_key;
+  wire           keymem_ready;
+
+  wire           accept;
+  wire [127 : 0] keystream;
+
+  // Output of the S-boxes of every round
+  wire [127 : 0] sub_state [1 : AES256_ROUNDS];
+
+  //----------------------------------------------------------------
+  // Instantiations.
+  //----------------------------------------------------------------
+  aes_key_mem_fly keymem(
+                         .clk(clk),
+                         .reset_n(reset_n),
+
+                         .key(key),
+                         .keylen(1'b1),
+                         .init(keymem_init),
+                         .next(keymem_next),
+                         .round_key(keymem_round_key),
+
+                         .ready(keymem_ready)
+                         );
+
+  genvar r, w;
+  generate
+    for (r = 1; r <= AES256_ROUNDS; r = r + 1)
+      begin : round_gen
+        for (w = 0; w < 4; w = w + 1)
+          begin : sbox_gen
+            aes_sbox sbox_inst(.sboxw(state_reg[r - 1][(32 * w) + 31 : 32 * w]),
+                               .new_sboxw(sub_state[r][(32 * w) + 31 : 32 * w]));
+          end
+      end
+  endgenerate
+
+  //----------------------------------------------------------------
+  // Concurrent connectivity for ports etc.
+  //----------------------------------------------------------------
+  assign ready         = ready_reg;
+  assign accept        = ready_reg && (next || finalize);
+
+  assign keystream     = state_reg[AES256_ROUNDS];
+  assign block_o       = last_reg[AES256_ROUNDS] ?
+                         data_reg[AES256_ROUNDS] ^ (keystream << (128 - len_reg[AES256_ROUNDS])) >> (128 - len_reg[AES256_ROUNDS]) :
+                         data_reg[AES256_ROUNDS] ^ keystream;
+  assign block_o_valid = valid_reg[AES256_ROUNDS];
+  assign block_o_last  = valid_reg[AES256_ROUNDS] && last_reg[AES256_ROUNDS];
+
+  //----------------------------------------------------------------
+  // reg_update
+  //
+  // Update functionality for all registers in the core.
+  // All registers are positive edge triggered with asynchronous
+  // active low reset. All registers have write enable.
+  //----------------------------------------------------------------
+  always @ (posedge clk or negedge reset_n)
+    begin: reg_update
+      if (!reset_n)
+        begin
+          ctr_ctrl_reg <= CTRL_IDLE;
+          ready_reg    <= 1'b0;
+          counter_reg  <= 128'h0;
+          rk_ctr_reg   <= 4'h0;
+          valid_reg    <= {(AES256_ROUNDS + 1){1'b0}};
+          last_reg     <= {(AES256_ROUNDS + 1){1'b0}};
+        end
+      else
+        begin
+          if (ctr_ctrl_we)
+            ctr_ctrl_reg <= ctr_ctrl_new;
+          if (ready_we)
+            ready_reg <= ready_new;
+          if (counter_we)
+            counter_reg <= counter_new;
+          if (rk_ctr_we)
+            rk_ctr_reg <= rk_ctr_new;
+
+          valid_reg <= {valid_reg[AES256_ROUNDS - 1 : 0], accept};
+          last_reg  <= {last_reg[AES256_ROUNDS - 1 : 0], finalize};
+        end
+    end // reg_update
+
+  //----------------------------------------------------------------
+  // pipe_update
+  //
+  // Round key store and pipeline datapath, without reset. Stage 0
+  // holds the counter after the initial AddRoundKey, stage r the
+  // state after round r.
+  //----------------------------------------------------------------
+  always @ (posedge clk)
+    begin: pipe_update
+      integer i;
+
+      if (rk_we)
+        rk_reg[rk_ctr_reg - 1'b1] <= keymem_round_key;
+
+      state_reg[0] <= counter_reg ^ rk_reg[0];
+      data_reg[0]  <= block_i;
+      len_reg[0]   <= len_i;
+
+      for (i = 1; i < AES256_ROUNDS; i = i + 1)
+        begin
+          state_reg[i] <= mixcolumns(shiftrows(sub_state[i])) ^ rk_reg[i];
+          data_reg[i]  <= data_reg[i - 1];
+          len_reg[i]   <= len_reg[i - 1];
+        end
+
+      state_reg[AES256_ROUNDS] <= shiftrows(sub_state[AES256_ROUNDS]) ^ rk_reg[AES256_ROUNDS];
+      data_reg[AES256_ROUNDS]  <= data_reg[AES256_ROUNDS - 1];
+      len_reg[AES256_ROUNDS]   <= len_reg[AES256_ROUNDS - 1];
+    end // pipe_update
+
+  //----------------------------------------------------------------
+  // counter_reg logic
+  //----------------------------------------------------------------
+  always @*
+    begin
+      if ((ctr_ctrl_reg == CTRL_IDLE) && init)
+        counter_new = init_counter;
+      else
+        counter_new = {counter_reg[127 : 64], counter_reg[63 : 0] + 64'h1};
+    end
+
+  //----------------------------------------------------------------
+  // ctr_ctrl
+  //
+  // Control FSM for ctr_core_pipe. init expands the key with one
+  // next per cycle; the round key of a next is stored a cycle later.
+  //----------------------------------------------------------------
+  always @*
+    begin: ctr_ctrl
+      ctr_ctrl_new = CTRL_IDLE;
+      ctr_ctrl_we  = 1'b0;
+      ready_new    = 1'b0;
+      ready_we     = 1'b0;
+      counter_we   = 1'b0;
+      rk_we        = 1'b0;
+      rk_ctr_new   = 4'h0;
+      rk_ctr_we    = 1'b0;
+      keymem_init  = 1'b0;
+      keymem_next  = 1'b0;
+
+      case (ctr_ctrl_reg)
+        CTRL_IDLE:
+          begin
+            if (init)
+              begin
+                ready_new    = 1'b0;
+                ready_we     = 1'b1;
+                counter_we   = 1'b1;
+                rk_ctr_new   = 4'h0;
+                rk_ctr_we    = 1'b1;
+                keymem_init  = 1'b1;
+                ctr_ctrl_new = CTRL_EXPAND;
+                ctr_ctrl_we  = 1'b1;
+              end
+            else if (accept)
+              counter_we = 1'b1;
+          end
+        CTRL_EXPAND:
+          begin
+            rk_we      = (rk_ctr_reg != 4'h0);
+            rk_ctr_new = rk_ctr_reg + 1'b1;
+            rk_ctr_we  = 1'b1;
+            if (rk_ctr_reg == AES256_ROUNDS + 1)
+              begin
+                ready_new    = 1'b1;
+                ready_we     = 1'b1;
+                ctr_ctrl_new = CTRL_IDLE;
+                ctr_ctrl_we  = 1'b1;
+              end
+            else
+              keymem_next = 1'b1;
+          end
+        default:
+          begin
+
+          end
+      endcase // case (ctr_ctrl_reg)
+    end // ctr_ctrl
+
+endmodule // ctr_core_pipe
@@ -1,5 +1,3 @@
-// NOT UP-TO-DATE
-
 //////////////////////////////////////////////////////////////////////////////////
 // Company: 
 // Engineer: Ryan De Koninck
@@ -16,13 +14,17 @@
 // 
 // Revision:
 // Revision 0.01 - File Created
-// Additional Comments:
+// Additional Comments: Every CMD_COMPUTE frame is a single block: ctr_core
+//                      is initialized with the key and counter of the
+//                      frame and then encrypts its block with next.
+//                      PIPE_CORE = 1 uses the unrolled ctr_core_pipe
+//                      instead, which only supports 256-bit keys.
 // 
 //////////////////////////////////////////////////////////////////////////////////
 
 `default_nettype none
 
-module ctr_wrapper(
+module ctr_wrapper #(parameter PIPE_CORE = 0)(
                    input wire             clk,
                    input wire             resetn,
                    
@@ -52,11 +54,16 @@ module ctr_wrapper(
     localparam CTRL_BUSY          = 4'h3;
     localparam CTRL_WRITE         = 4'h4;
     localparam CTRL_ASSERT_DONE   = 4'h5;
+    localparam CTRL_STATS_WRITE   = 4'h6;
+    localparam CTRL_LOAD          = 4'h7;
     
       // Wrapper commands
     localparam CMD_READ           = 32'h0;
     localparam CMD_COMPUTE        = 32'h1;
     localparam CMD_WRITE          = 32'h2;
+    localparam CMD_WRITE_PREV     = 32'ha;  // CMD_WRITE with bit 3 set
+    localparam CMD_READ_STATS     = 32'h7;
+    localparam CMD_READ_STATS_HI  = 32'hf;  // CMD_READ_STATS with bit 3 set
 
     //----------------------------------------------------------------
     // Registers + update variables and write enable.
@@ -81,10 +88,39 @@ module ctr_wrapper(
     wire [127 : 0] block_i_new;
     reg            block_i_we;
     
+      // Double buffering: READ fills in_buf_reg, which is copied into the
+      // registers above when the core is started. The core runs in the
+      // background (core_busy_reg), so the host can upload the next frame
+      // and fetch the previous result (out_buf_reg, saved when a new
+      // computation starts) while it computes.
+    reg [512 : 0]  in_buf_reg;
+    reg            in_buf_we;
+    
+    reg            core_busy_reg;
+    reg            core_busy_new;
+    reg            core_busy_we;
+    
+      // Set once the init of a frame is done and its block is given to
+      // the core with next
+    reg            core_next_reg;
+    reg            core_next_new;
+    reg            core_next_we;
+    
     reg [127 : 0]  block_o_reg;
     wire [127 : 0] block_o_new;
     reg            block_o_we;
     
+    reg [127 : 0]  out_buf_reg;
+    reg            out_buf_we;
+    
+    reg            write_prev_reg;
+    reg            write_prev_new;
+    reg            write_prev_we;
+    
+    reg            stats_mode_reg;
+    reg            stats_mode_new;
+    reg            stats_mode_we;
+    
     reg            fpga_to_arm_data_valid_reg;
     wire           fpga_to_arm_data_valid_new;
     
@@ -98,28 +134,79 @@ module ctr_wrapper(
     // Wires.
     //----------------------------------------------------------------
       // Core I/O
-    reg            core_start;
+    reg            core_init;
+    reg            core_next;
     wire [127 : 0] core_counter;
     wire [255 : 0] core_key;
     wire           core_keylen;
     wire [127 : 0] core_block_i;
     wire [127 : 0] core_block_o;
     wire           core_ready;
+    wire           core_pipe_ready;
+    wire           core_pipe_valid;
+    
+      // Statistics
+    wire           stats_cmd_accept;
+    wire [1023 : 0] stats;
     
     //----------------------------------------------------------------
     // Instantiations.
     //----------------------------------------------------------------
-    ctr_core ctr(
-                 .clk(clk),
-                 .reset_n(resetn),
-                 .start(core_start),
-                 .counter(core_counter),
-                 .key(core_key),
-                 .keylen(core_keylen),
-                 .block_i(core_block_i),
-                 .block_o(core_block_o),
-                 .ready(core_ready)
-                 );
+    wrapper_stats wrapper_stats(
+                                .clk(clk),
+                                .reset_n(resetn),
+                                .state(ctr_wrapper_ctrl_reg),
+                                .cmd_accept(stats_cmd_accept),
+                                .cmd(arm_to_fpga_cmd[3 : 0]),
+                                .stats(stats)
+                                );
+    
+    // PIPE_CORE: 0 = ctr_core, 1 = unrolled ctr_core_pipe
+    generate
+      if (PIPE_CORE)
+        begin : core_gen
+          ctr_core_pipe ctr(
+                            .clk(clk),
+                            .reset_n(resetn),
+                            .init(core_init),
+                            .next(core_next),
+                            .finalize(1'b0),
+                            .init_counter(core_counter),
+                            .key(core_key),
+                            .keylen(core_keylen),
+                            .block_i(core_block_i),
+                            .len_i(8'h80),
+                            .block_o(core_block_o),
+                            .block_o_valid(core_pipe_valid),
+                            .block_o_last(),
+                            .ready(core_pipe_ready)
+                            );
+
+          // ready of ctr_core_pipe stays high while it accepts blocks,
+          // so the end of the block is given by block_o_valid
+          assign core_ready = core_next_reg ? core_pipe_valid : core_pipe_ready;
+        end
+      else
+        begin : core_gen
+          ctr_core ctr(
+                       .clk(clk),
+                       .reset_n(resetn),
+                       .init(core_init),
+                       .next(core_next),
+                       .finalize(1'b0),
+                       .init_counter(core_counter),
+                       .key(core_key),
+                       .keylen(core_keylen),
+                       .block_i(core_block_i),
+                       .len_i(8'h80),
+                       .block_o(core_block_o),
+                       .ready(core_ready)
+                       );
+
+          assign core_pipe_ready = 1'b0;
+          assign core_pipe_valid = 1'b0;
+        end
+    endgenerate
 
     //----------------------------------------------------------------
     // Concurrent connectivity for ports etc.
@@ -131,18 +218,22 @@ module ctr_wrapper(
     assign core_block_i = block_i_reg;
     
       // ARM to FPGA data decomposition
-    assign counter_new  = arm_to_fpga_data[512 : 385];
-    assign key_new      = arm_to_fpga_data[384 : 129];
-    assign keylen_new   = arm_to_fpga_data[128];
-    assign block_i_new  = arm_to_fpga_data[127 : 0];
+    assign counter_new  = in_buf_reg[512 : 385];
+    assign key_new      = in_buf_reg[384 : 129];
+    assign keylen_new   = in_buf_reg[128];
+    assign block_i_new  = in_buf_reg[127 : 0];
     
       // Wrapper I/O
-    assign fpga_to_arm_data       = {896'h0, block_o_reg};
+    assign fpga_to_arm_data       = stats_mode_reg ? stats :
+                                    {896'h0, write_prev_reg ? out_buf_reg : block_o_reg};
     assign fpga_to_arm_data_valid = fpga_to_arm_data_valid_reg;
     assign arm_to_fpga_data_ready = arm_to_fpga_data_ready_reg;
     assign fpga_to_arm_done       = fpga_to_arm_done_reg;
     assign block_o_new            = core_block_o;
     
+      // Statistics: every command that leaves CTRL_WAIT_FOR_CMD is counted
+    assign stats_cmd_accept = (ctr_wrapper_ctrl_reg == CTRL_WAIT_FOR_CMD) && ctr_wrapper_ctrl_we;
+    
       // The four LEDs on the board are used as debug signals.
     //assign leds = ~ctr_wrapper_ctrl_reg;
     assign leds = ctr_wrapper_ctrl_reg;
@@ -163,9 +254,15 @@ module ctr_wrapper(
             key_reg                    <= 256'h0;
             keylen_reg                 <= 1'b0;
             block_i_reg                <= 128'h0;
+            in_buf_reg                 <= 513'h0;
+            core_busy_reg              <= 1'b0;
+            core_next_reg              <= 1'b0;
             block_o_reg                <= 128'h0;
+            out_buf_reg                <= 128'h0;
+            write_prev_reg             <= 1'b0;
             fpga_to_arm_data_valid_reg <= 1'b0;
             arm_to_fpga_data_ready_reg <= 1'b0;
+            stats_mode_reg             <= 1'b0;
             fpga_to_arm_done_reg       <= 1'b0;
           end
         else
@@ -180,8 +277,20 @@ module ctr_wrapper(
               keylen_reg <= keylen_new;
             if (block_i_we)
               block_i_reg <= block_i_new;
+            if (in_buf_we)
+              in_buf_reg <= arm_to_fpga_data[512 : 0];
+            if (core_busy_we)
+              core_busy_reg <= core_busy_new;
+            if (core_next_we)
+              core_next_reg <= core_next_new;
             if (block_o_we)
               block_o_reg <= block_o_new;
+            if (out_buf_we)
+              out_buf_reg <= block_o_reg;
+            if (stats_mode_we)
+              stats_mode_reg <= stats_mode_new;
+            if (write_prev_we)
+              write_prev_reg <= write_prev_new;
             
             // Wrapper control signals don't have a write enable
             fpga_to_arm_data_valid_reg <= fpga_to_arm_data_valid_new;
@@ -199,12 +308,41 @@ module ctr_wrapper(
       begin: ctr_wrapper_ctrl
         ctr_wrapper_ctrl_new = CTRL_WAIT_FOR_CMD;
         ctr_wrapper_ctrl_we  = 1'b0;
-        core_start           = 1'b0;
+        core_init            = 1'b0;
+        core_next            = 1'b0;
         counter_we           = 1'b0;
         key_we               = 1'b0;
         keylen_we            = 1'b0;
         block_i_we           = 1'b0;
+        in_buf_we            = 1'b0;
+        core_busy_new        = 1'b0;
+        core_busy_we         = 1'b0;
+        core_next_new        = 1'b0;
+        core_next_we         = 1'b0;
         block_o_we           = 1'b0;
+        out_buf_we           = 1'b0;
+        stats_mode_new       = 1'b0;
+        stats_mode_we        = 1'b0;
+        write_prev_new       = 1'b0;
+        write_prev_we        = 1'b0;
+        
+        // The core is stepped from init to next and its result is
+        // captured whatever command the FSM is handling in the meantime
+        if (core_busy_reg && core_ready)
+          begin
+            if (!core_next_reg)
+              begin
+                core_next     = 1'b1;
+                core_next_new = 1'b1;
+                core_next_we  = 1'b1;
+              end
+            else
+              begin
+                block_o_we    = 1'b1;
+                core_busy_new = 1'b0;
+                core_busy_we  = 1'b1;
+              end
+          end
         
         case (ctr_wrapper_ctrl_reg)
           CTRL_WAIT_FOR_CMD:
@@ -212,15 +350,31 @@ module ctr_wrapper(
               if (arm_to_fpga_cmd_valid)
                 begin
                   ctr_wrapper_ctrl_we  = 1'b1;
+                  stats_mode_we        = 1'b1;
+                  write_prev_we        = 1'b1;
                   case (arm_to_fpga_cmd)
                     CMD_READ:
                       ctr_wrapper_ctrl_new = CTRL_READ;
                     CMD_COMPUTE:
-                      ctr_wrapper_ctrl_new = CTRL_START;
+                      ctr_wrapper_ctrl_new = CTRL_LOAD;
                     CMD_WRITE:
-                      ctr_wrapper_ctrl_new = CTRL_WRITE;
+                      ctr_wrapper_ctrl_new = CTRL_BUSY;
+                    CMD_WRITE_PREV:
+                      begin
+                        ctr_wrapper_ctrl_new = CTRL_WRITE;
+                        write_prev_new       = 1'b1;
+                      end
+                    CMD_READ_STATS, CMD_READ_STATS_HI:
+                      begin
+                        ctr_wrapper_ctrl_new = CTRL_STATS_WRITE;
+                        stats_mode_new       = 1'b1;
+                      end
                     default:
-                      ctr_wrapper_ctrl_we  = 1'b0;
+                      begin
+                        ctr_wrapper_ctrl_we  = 1'b0;
+                        stats_mode_we        = 1'b0;
+                        write_prev_we        = 1'b0;
+                      end
                   endcase
                 end
             end
@@ -229,6 +383,13 @@ module ctr_wrapper(
               begin
                 ctr_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 ctr_wrapper_ctrl_we  = 1'b1;
+                in_buf_we            = 1'b1;
+              end
+          CTRL_LOAD:
+            if (!core_busy_reg)
+              begin
+                ctr_wrapper_ctrl_new = CTRL_START;
+                ctr_wrapper_ctrl_we  = 1'b1;
                 counter_we           = 1'b1;
                 key_we               = 1'b1;
                 keylen_we            = 1'b1;
@@ -236,16 +397,20 @@ module ctr_wrapper(
               end
           CTRL_START:
             begin
-              core_start = 1'b1;
-              ctr_wrapper_ctrl_new = CTRL_BUSY;
+              core_init            = 1'b1;
+              core_busy_new        = 1'b1;
+              core_busy_we         = 1'b1;
+              core_next_new        = 1'b0;
+              core_next_we         = 1'b1;
+              out_buf_we           = 1'b1;
+              ctr_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               ctr_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_BUSY:
-            if (core_ready)
+            if (!core_busy_reg)
               begin
-                ctr_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                ctr_wrapper_ctrl_new = CTRL_WRITE;
                 ctr_wrapper_ctrl_we  = 1'b1;
-                block_o_we           = 1'b1;
               end
           CTRL_WRITE:
             if (fpga_to_arm_data_ready)
@@ -253,6 +418,12 @@ module ctr_wrapper(
                 ctr_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 ctr_wrapper_ctrl_we  = 1'b1;
               end
+          CTRL_STATS_WRITE:
+            if (fpga_to_arm_data_ready)
+              begin
+                ctr_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                ctr_wrapper_ctrl_we  = 1'b1;
+              end
           CTRL_ASSERT_DONE:
             if (fpga_to_arm_done_read)
               begin
@@ -271,7 +442,8 @@ module ctr_wrapper(
     //
     // Set the control signals based on the current state of the FSM.
     //----------------------------------------------------------------
-    assign fpga_to_arm_data_valid_new = (ctr_wrapper_ctrl_reg == CTRL_WRITE);
+    assign fpga_to_arm_data_valid_new = (ctr_wrapper_ctrl_reg == CTRL_WRITE) ||
+                                        (ctr_wrapper_ctrl_reg == CTRL_STATS_WRITE);
     assign arm_to_fpga_data_ready_new = (ctr_wrapper_ctrl_reg == CTRL_READ);
     assign fpga_to_arm_done_new       = (ctr_wrapper_ctrl_reg == CTRL_ASSERT_DONE);
 
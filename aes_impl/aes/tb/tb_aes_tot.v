@@ -54,6 +54,9 @@ module tb_aes_tot();
   reg            tb_keylen;
   reg [127 : 0]  tb_counter;
   reg [7 : 0]    tb_final_size;
+  reg            tb_load_key;
+  reg [1 : 0]    tb_key_slot;
+  wire           tb_key_ready;
   reg            tb_init;
   reg            tb_next;
   reg            tb_finalize;
@@ -70,6 +73,8 @@ module tb_aes_tot();
            .reset_n(tb_reset_n),
            
            .enc_auth(tb_enc_auth),
+           .load_key(tb_load_key),
+           .key_slot(tb_key_slot),
            .key(tb_key),
            .keylen(tb_keylen),
            .counter(tb_counter),
@@ -78,8 +83,12 @@ module tb_aes_tot();
            .next(tb_next),
            .finalize(tb_finalize),
            .block_i(tb_block_i),
+           .ctx_load(1'b0),
+           .ctx_i(520'h0),
+           .ctx_o(),
            .block_o(tb_block_o),
-           .ready(tb_ready)
+           .ready(tb_ready),
+           .key_ready(tb_key_ready)
           );
 
   //----------------------------------------------------------------
@@ -189,6 +198,8 @@ module tb_aes_tot();
       tb_keylen     = 1'h0;
       tb_counter    = 128'h0;
       tb_final_size = 8'h0;
+      tb_load_key   = 1'h0;
+      tb_key_slot   = 2'h0;
       tb_init       = 1'h0;
       tb_next       = 1'h0;
       tb_finalize   = 1'h0;
@@ -240,6 +251,24 @@ module tb_aes_tot();
   endtask // wait_ready
 
 
+  //----------------------------------------------------------------
+  // load_key()
+  //
+  // Expand tb_key into round-key slot tb_key_slot and wait until
+  // all round keys are stored.
+  //----------------------------------------------------------------
+  task load_key;
+    begin : lkey
+      tb_load_key = 1'h1;
+      #(CLK_PERIOD);
+      tb_load_key = 1'h0;
+      #(CLK_PERIOD);
+      while (tb_key_ready == 0)
+        #(CLK_PERIOD);
+    end
+  endtask // load_key
+
+
   //----------------------------------------------------------------
   // tc1_reset_state
   //
@@ -274,6 +303,7 @@ module tb_aes_tot();
 
       tb_key    = 256'h2b7e1516_28aed2a6_abf71588_09cf4f3c_00000000_00000000_00000000_00000000;
       tb_keylen = 1'h0;
+      load_key();
       tb_init   = 1'h1;
       #(2 * CLK_PERIOD);
       tb_init   = 1'h0;
@@ -326,6 +356,7 @@ module tb_aes_tot();
 
       tb_key    = 256'h2b7e1516_28aed2a6_abf71588_09cf4f3c_00000000_00000000_00000000_00000000;
       tb_keylen = 1'h0;
+      load_key();
       tb_init   = 1'h1;
       #(2 * CLK_PERIOD);
       tb_init   = 1'h0;
@@ -379,6 +410,7 @@ module tb_aes_tot();
       $display("TC5: Check that correct ICV is generated for a two and a half block message.");
       tb_key    = 256'h2b7e1516_28aed2a6_abf71588_09cf4f3c_00000000_00000000_00000000_00000000;
       tb_keylen = 1'h0;
+      load_key();
       tb_init   = 1'h1;
       #(2 * CLK_PERIOD);
       tb_init   = 1'h0;
@@ -445,6 +477,7 @@ module tb_aes_tot();
       $display("TC6: Check that correct ICV is generated for a four block message.");
       tb_key    = 256'h2b7e1516_28aed2a6_abf71588_09cf4f3c_00000000_00000000_00000000_00000000;
       tb_keylen = 1'h0;
+      load_key();
       tb_init   = 1'h1;
       #(2 * CLK_PERIOD);
       tb_init   = 1'h0;
@@ -514,6 +547,7 @@ module tb_aes_tot();
       $display("TC7: Check that correct ICV is generated for a four block message usint a 256 bit key.");
       tb_key    = 256'h603deb10_15ca71be_2b73aef0_857d7781_1f352c07_3b6108d7_2d9810a3_0914dff4;
       tb_keylen = 1'h1;
+      load_key();
       tb_init   = 1'h1;
       #(2 * CLK_PERIOD);
       tb_init   = 1'h0;
@@ -582,6 +616,7 @@ module tb_aes_tot();
 
       tb_key    = 256'hfffefdfc_fbfaf9f8_f7f6f5f4_f3f2f1f0_f0f1f2f3_f4f5f6f7_f8f9fafb_fcfdfeff;
       tb_keylen = 1'h0;
+      load_key();
       tb_init   = 1'h1;
       #(2 * CLK_PERIOD);
       tb_init   = 1'h0;
@@ -632,6 +667,7 @@ module tb_aes_tot();
      tb_counter = 128'hf0f1f2f3f4f5f6f7f8f9fafbfcfdfeff;
      tb_final_size = 8'd128;
      
+     load_key();
      tb_init = 1;
      #(2 * CLK_PERIOD);
      tb_init = 0;
@@ -716,6 +752,7 @@ module tb_aes_tot();
      tb_counter = 128'hf0f1f2f3f4f5f6f7f8f9fafbfcfdfeff;
      tb_final_size = 8'd128;
      
+     load_key();
      tb_init = 1;
      #(2 * CLK_PERIOD);
      tb_init = 0;
@@ -785,6 +822,79 @@ module tb_aes_tot();
      end
     endtask // ctr_mode_enc128_test
     
+  //----------------------------------------------------------------
+  // key_slot_test()
+  //
+  // Load a CTR-mode and a CMAC key into different round-key slots
+  // first, then process one message under each of them.
+  //----------------------------------------------------------------
+  task key_slot_test();
+   begin : key_slot_test
+     $display("*** TC key slot test started.");
+     tc_ctr = tc_ctr + 1;
+
+     tb_key = 256'h603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4;
+     tb_keylen = 1'b1;
+     tb_key_slot = 2'h2;
+     load_key();
+
+     tb_key = 256'h2b7e1516_28aed2a6_abf71588_09cf4f3c_00000000_00000000_00000000_00000000;
+     tb_keylen = 1'b0;
+     tb_key_slot = 2'h1;
+     load_key();
+
+     // CTR-mode, one block under the key in slot 2
+     tb_enc_auth = 0;
+     tb_key = 256'h0;
+     tb_key_slot = 2'h2;
+     tb_counter = 128'hf0f1f2f3f4f5f6f7f8f9fafbfcfdfeff;
+     tb_init = 1;
+     #(2 * CLK_PERIOD);
+     tb_init = 0;
+     wait_ready();
+
+     tb_final_size = 8'd128;
+     tb_block_i = 128'h6bc1bee22e409f96e93d7e117393172a;
+     tb_finalize = 1;
+     #(2 * CLK_PERIOD);
+     tb_finalize = 0;
+     wait_ready();
+
+     if (tb_block_o != 128'h601ec313775789a5b7a7f504bbf3d228)
+       begin
+         $display("*** ERROR: CTR-mode block under slot 2 NOT successful, got 0x%032x", tb_block_o);
+         error_ctr = error_ctr + 1;
+       end
+     else
+       $display("*** CTR-mode block under slot 2 successful.");
+
+     // CMAC, single block message under the key in slot 1
+     tb_enc_auth = 1;
+     tb_key_slot = 2'h1;
+     tb_init = 1;
+     #(2 * CLK_PERIOD);
+     tb_init = 0;
+     wait_ready();
+
+     tb_key_slot = 2'h0;
+     tb_final_size = 8'h80;
+     tb_block_i = 128'h6bc1bee2_2e409f96_e93d7e11_7393172a;
+     tb_finalize = 1;
+     #(2 * CLK_PERIOD);
+     tb_finalize = 0;
+     wait_ready();
+
+     if (tb_block_o != 128'h070a16b4_6b4d4144_f79bdd9d_d04a287c)
+       begin
+         $display("*** ERROR: CMAC under slot 1 NOT successful, got 0x%032x", tb_block_o);
+         error_ctr = error_ctr + 1;
+       end
+     else
+       $display("*** CMAC under slot 1 successful.");
+     $display("");
+   end
+  endtask // key_slot_test
+    
   //----------------------------------------------------------------
   // main
   //
@@ -819,6 +929,11 @@ module tb_aes_tot();
       ctr_mode_enc256_test();
       ctr_mode_enc128_test();
 
+      $display("*** Tests for the round-key slots ***");
+      $display("");
+
+      key_slot_test();
+
       display_test_results();
 
       $display("*** AES TOT simulation done. ***");
@@ -0,0 +1,543 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company: 
+// Engineer: Ryan De Koninck
+// 
+// Create Date: 
+// Design Name: 
+// Module Name: tb_aes_tot_array_wrapper
+// Project Name: 
+// Target Devices: 
+// Tool Versions: 
+// Description: 
+// 
+// Dependencies: 
+// 
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments:
+// 
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module tb_aes_tot_array_wrapper();
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  parameter DEBUG            = 0;
+  parameter DUMP_WAIT        = 0;
+    
+  parameter CLK_HALF_PERIOD  = 5;
+  parameter CLK_PERIOD       = 2 * CLK_HALF_PERIOD;
+  parameter RESET_TIME       = 25;
+  
+  parameter NUM_CORES        = 4;
+  
+  parameter AES_128_BIT_KEY  = 1'b0;
+  parameter AES_256_BIT_KEY  = 1'b1;
+  
+  parameter AES_BLOCK_SIZE   = 128;
+  
+  // Wrapper commands
+  parameter CMD_READ            = 32'h0;
+  parameter CMD_COMPUTE_INIT    = 32'h1;
+  parameter CMD_COMPUTE_NEXT    = 32'h2;
+  parameter CMD_COMPUTE_FINAL   = 32'h3;
+  parameter CMD_WRITE           = 32'h4;
+  parameter CMD_LOAD_KEY        = 32'h5;
+  parameter CMD_READ_STATS      = 32'h7;
+  parameter CMD_COMPUTE_BATCH   = 32'hb;
+  
+  //----------------------------------------------------------------
+  // Register and Wire declarations.
+  //----------------------------------------------------------------
+  reg [31 : 0]    cycle_ctr;
+  reg [31 : 0]    error_ctr;
+  reg [31 : 0]    tc_ctr;  
+  reg             tc_correct;
+  
+  reg             tb_clk;
+  reg             tb_resetn;
+  reg  [31 : 0]   tb_arm_to_fpga_cmd;
+  reg             tb_arm_to_fpga_cmd_valid;
+  wire            tb_fpga_to_arm_done;
+  reg             tb_fpga_to_arm_done_read;
+
+  reg             tb_arm_to_fpga_data_valid;
+  wire            tb_arm_to_fpga_data_ready;
+  reg  [1023 : 0] tb_arm_to_fpga_data;
+
+  wire            tb_fpga_to_arm_data_valid;
+  reg             tb_fpga_to_arm_data_ready;
+  wire [1023 : 0] tb_fpga_to_arm_data;
+
+  wire [3 : 0]    tb_leds;
+
+  wire [1023 : 0] tb_input_data;
+  reg  [1023 : 0] tb_output_data;
+  
+  reg  [7 : 0]    tb_lane;
+  reg             tb_enc_auth;
+  reg  [127 : 0]  tb_counter;
+  reg  [255 : 0]  tb_key;
+  reg             tb_keylen;
+  reg  [7 : 0]    tb_final_size;
+  reg  [127 : 0]  tb_block_i;
+  
+  assign tb_input_data = {486'h0, tb_lane, 8'h0, tb_enc_auth, tb_counter, tb_key,
+                          tb_keylen, tb_final_size, tb_block_i};
+
+  //----------------------------------------------------------------
+  // Device Under Test.
+  //----------------------------------------------------------------
+  aes_tot_array_wrapper #(.NUM_CORES(NUM_CORES)) dut(
+                   .clk                    (tb_clk                    ),
+                   .resetn                 (tb_resetn                 ),
+             
+                   .arm_to_fpga_cmd        (tb_arm_to_fpga_cmd        ),
+                   .arm_to_fpga_cmd_valid  (tb_arm_to_fpga_cmd_valid  ),
+                   .fpga_to_arm_done       (tb_fpga_to_arm_done       ),
+                   .fpga_to_arm_done_read  (tb_fpga_to_arm_done_read  ),
+            
+                   .arm_to_fpga_data_valid (tb_arm_to_fpga_data_valid ),
+                   .arm_to_fpga_data_ready (tb_arm_to_fpga_data_ready ),
+                   .arm_to_fpga_data       (tb_arm_to_fpga_data       ),
+            
+                   .fpga_to_arm_data_valid (tb_fpga_to_arm_data_valid ),
+                   .fpga_to_arm_data_ready (tb_fpga_to_arm_data_ready ),
+                   .fpga_to_arm_data       (tb_fpga_to_arm_data       ),
+            
+                   .leds                   (tb_leds                   )
+                   );
+
+  //----------------------------------------------------------------
+  // clk_gen
+  //
+  // Always running clock generator process.
+  //----------------------------------------------------------------
+  always
+    begin : clk_gen
+      #CLK_HALF_PERIOD;
+      tb_clk = !tb_clk;
+    end // clk_gen
+  
+  //----------------------------------------------------------------
+  // sys_monitor()
+  //
+  // An always running process that creates a cycle counter and
+  // conditionally displays information about the DUT.
+  //----------------------------------------------------------------
+  always
+    begin : sys_monitor
+      cycle_ctr = cycle_ctr + 1;
+      #(CLK_PERIOD);
+      if (DEBUG)
+        begin
+          dump_dut_state();
+        end
+    end
+    
+  //----------------------------------------------------------------
+  // dump_dut_state()
+  //
+  // Dump the state of the dump when needed.
+  //----------------------------------------------------------------
+  task dump_dut_state;
+    begin
+      $display("cycle: 0x%016x", cycle_ctr);
+      $display("State of DUT");
+      $display("------------");
+      $display("ctrl_reg = 0x%01x", dut.aes_tot_array_wrapper_ctrl_reg);
+      $display("");
+      $display("lane_busy = 0x%02x", dut.lane_busy_reg);
+      $display("batch_mask = 0x%02x", dut.batch_mask_reg);
+      $display("");
+    end
+  endtask // dump_dut_state
+
+  //----------------------------------------------------------------
+  // reset_dut()
+  //
+  // Toggle reset to put the DUT into a well known state.
+  //----------------------------------------------------------------
+  task reset_dut;
+    begin
+      $display("*** Toggle reset.");
+      tb_resetn = 0;
+      #(RESET_TIME);
+      tb_resetn = 1;
+    end
+  endtask // reset_dut
+
+  //----------------------------------------------------------------
+  // init_sim()
+  //
+  // Initialize all counters and testbed functionality as well
+  // as setting the DUT inputs to defined values.
+  //----------------------------------------------------------------
+  task init_sim;
+    begin
+      cycle_ctr                 = 0;
+      error_ctr                 = 0;
+      tc_ctr                    = 0;
+
+      tb_clk                    = 0;
+      tb_resetn                 = 1;
+      tb_arm_to_fpga_cmd        = {32'h00000000};
+      tb_arm_to_fpga_cmd_valid  = 0;
+      tb_fpga_to_arm_done_read  = 0;
+      tb_arm_to_fpga_data_valid = 0;
+      tb_arm_to_fpga_data       = {32{32'h00000000}};
+      tb_fpga_to_arm_data_ready = 0;
+      
+      tb_output_data            = {32{32'h00000000}};
+      
+      tb_lane                   = 8'h0;
+      tb_enc_auth               = 1'b1;
+      tb_counter                = {4{32'h00000000}};
+      tb_key                    = {8{32'h00000000}};
+      tb_keylen                 = 1'b0;
+      tb_final_size             = 8'h00;
+      tb_block_i                = {4{32'h00000000}};
+    end
+  endtask // init_sim
+
+  //----------------------------------------------------------------
+  // inc_tc_ctr
+  //----------------------------------------------------------------
+  task inc_tc_ctr;
+    tc_ctr = tc_ctr + 1;
+  endtask // inc_tc_ctr
+
+
+  //----------------------------------------------------------------
+  // inc_error_ctr
+  //----------------------------------------------------------------
+  task inc_error_ctr;
+    error_ctr = error_ctr + 1;
+  endtask // inc_error_ctr
+
+  //----------------------------------------------------------------
+  // display_test_result()
+  //
+  // Display the accumulated test results.
+  //----------------------------------------------------------------
+  task display_test_result;
+    begin
+      if (error_ctr == 0)
+        begin
+          $display("*** All %02d test cases completed successfully", tc_ctr);
+        end
+      else
+        begin
+          $display("*** %02d tests completed - %02d test cases did not complete successfully.",
+                   tc_ctr, error_ctr);
+        end
+    end
+  endtask // display_test_result
+
+  //----------------------------------------------------------------
+  // send_cmd_to_hw()
+  //
+  // Send the given command to the FPGA.
+  //----------------------------------------------------------------
+  task send_cmd_to_hw(input [31 : 0] command);
+    begin
+        // Assert the command and valid
+        tb_arm_to_fpga_cmd <= command;
+        tb_arm_to_fpga_cmd_valid <= 1'b1;
+        #(CLK_PERIOD);
+        // Desassert the valid signal after one cycle
+        tb_arm_to_fpga_cmd_valid <= 1'b0;
+        #(CLK_PERIOD);
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // send_data_to_hw()
+  //
+  // Send the given data to the FPGA.
+  //----------------------------------------------------------------
+  task send_data_to_hw(input [1023 : 0] data);
+    begin
+        // Assert data and valid
+        tb_arm_to_fpga_data <= data;
+        tb_arm_to_fpga_data_valid <= 1'b1;
+        #(CLK_PERIOD);
+        // Wait till accelerator is ready to read it
+        wait(tb_arm_to_fpga_data_ready == 1'b1);
+        // It is read, do not continue asserting valid
+        tb_arm_to_fpga_data_valid <= 1'b0;
+        #(CLK_PERIOD);
+    end
+  endtask
+
+  //----------------------------------------------------------------
+  // read_data_from_hw()
+  //
+  // Read data from the FPGA.
+  //----------------------------------------------------------------
+  task read_data_from_hw(output [1023:0] odata);
+    begin
+        // Assert ready signal
+        tb_fpga_to_arm_data_ready <= 1'b1;
+        #(CLK_PERIOD);
+        // Wait for valid signal
+        wait(tb_fpga_to_arm_data_valid == 1'b1);
+        // If valid read the output data
+        odata <= tb_fpga_to_arm_data;
+        // Do not continue asserting ready
+        tb_fpga_to_arm_data_ready <= 1'b0;
+        #(CLK_PERIOD);
+    end
+    endtask
+
+  //----------------------------------------------------------------
+  // wait_done()
+  //
+  // Wait until accelerator is done.
+  //----------------------------------------------------------------
+  task wait_done;
+    begin
+      // Wait for accelerator's done
+      wait(tb_fpga_to_arm_done == 1'b1);
+      // Signal that it is read
+      tb_fpga_to_arm_done_read <= 1'b1;
+      #(CLK_PERIOD);
+      // Desassert the signal after one cycle
+      tb_fpga_to_arm_done_read <= 1'b0;
+      #(CLK_PERIOD);
+    end
+  endtask
+
+
+  //----------------------------------------------------------------
+  // load_and_init()
+  //
+  // Load inputs, expand the key into its slot, initialize, and
+  // wait until done.
+  //----------------------------------------------------------------
+  task load_and_init(input [1023 : 0] in);
+    begin
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(in);
+      wait_done();
+      
+      $display("Sending LOAD_KEY command");
+      send_cmd_to_hw(CMD_LOAD_KEY);
+      wait_done();
+      
+      $display("Sending COMPUTE_INIT command");
+      send_cmd_to_hw(CMD_COMPUTE_INIT);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // load_and_next()
+  //
+  // Load inputs, process next block, and wait until done.
+  //----------------------------------------------------------------
+  task load_and_next(input  [1023 : 0] in,
+                     output [1023 : 0] out);
+    begin
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(in);
+      wait_done();
+        
+      $display("Sending COMPUTE_NEXT command");
+      send_cmd_to_hw(CMD_COMPUTE_NEXT);
+      wait_done();
+        
+      $display("Sending WRITE command");
+      send_cmd_to_hw(CMD_WRITE);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // batch()
+  //
+  // Send a batch frame, process the blocks of all its lanes, and read
+  // back their results in a single command.
+  //----------------------------------------------------------------
+  task batch(input  [1023 : 0] in,
+             output [1023 : 0] out);
+    begin
+      $display("Sending COMPUTE_BATCH command");
+      send_cmd_to_hw(CMD_COMPUTE_BATCH);
+      send_data_to_hw(in);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // batch_add()
+  //
+  // Add a block for the given lane to a batch frame.
+  //----------------------------------------------------------------
+  task batch_add(inout [1023 : 0] frame,
+                 input [2 : 0]    lane,
+                 input [127 : 0]  block,
+                 input            last,
+                 input [7 : 0]    final_size);
+    begin
+      frame[128 * lane +: 128]   = block;
+      frame[896 + lane]          = 1'b1;
+      frame[904 + lane]          = last;
+      frame[912 + 8 * lane +: 8] = final_size;
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // batch_test()
+  //
+  // CTR-mode encryption with a 256 bit key on lane 0 and the CMAC of
+  // TC6 on lane 1, both initialized with single commands. The four
+  // blocks of both messages then go in four batch frames, the last
+  // one finalizing both lanes.
+  //----------------------------------------------------------------
+  task batch_test;
+    begin : batch_test
+      reg [127 : 0]  blocks [0 : 3];
+      reg [127 : 0]  expected [0 : 3];
+      reg [1023 : 0] frame;
+      integer i;
+
+      $display("*** TC Batch started.");
+      inc_tc_ctr();
+      tc_correct = 1;
+
+      blocks[0]   = 128'h6bc1bee22e409f96e93d7e117393172a;
+      blocks[1]   = 128'hae2d8a571e03ac9c9eb76fac45af8e51;
+      blocks[2]   = 128'h30c81c46a35ce411e5fbc1191a0a52ef;
+      blocks[3]   = 128'hf69f2445df4f9b17ad2b417be66c3710;
+      expected[0] = 128'h601ec313775789a5b7a7f504bbf3d228;
+      expected[1] = 128'hf443e3ca4d62b59aca84e990cacaf5c5;
+      expected[2] = 128'h2b0930daa23de94ce87017ba2d84988d;
+      expected[3] = 128'hdfc9c58db67aada613c2dd08457941a6;
+
+      tb_lane       = 8'h0;
+      tb_enc_auth   = 1'b0;
+      tb_key        = 256'h603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4;
+      tb_keylen     = AES_256_BIT_KEY;
+      tb_counter    = 128'hf0f1f2f3f4f5f6f7f8f9fafbfcfdfeff;
+      tb_final_size = 8'd128;
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+
+      tb_lane       = 8'h1;
+      tb_enc_auth   = 1'b1;
+      tb_key        = 256'h2b7e1516_28aed2a6_abf71588_09cf4f3c_00000000_00000000_00000000_00000000;
+      tb_keylen     = AES_128_BIT_KEY;
+      tb_counter    = 128'h0;
+      tb_final_size = 8'h00;
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+
+      for (i = 0 ; i < 4 ; i = i + 1)
+        begin
+          frame = 1024'h0;
+          batch_add(frame, 3'h0, blocks[i], i == 3, AES_BLOCK_SIZE);
+          batch_add(frame, 3'h1, blocks[i], i == 3, i == 3 ? AES_BLOCK_SIZE : 8'h00);
+          #(CLK_PERIOD);
+          batch(frame, tb_output_data);
+
+          if (tb_output_data[127 : 0] != expected[i])
+            begin
+              tc_correct = 0;
+              $display("Batch: Error - Block %0d expected 0x%032x, got 0x%032x",
+                       i + 1, expected[i], tb_output_data[127 : 0]);
+            end
+          if (tb_output_data[903 : 896] != 8'h03)
+            begin
+              tc_correct = 0;
+              $display("Batch: Error - Wrong lanes 0x%02x", tb_output_data[903 : 896]);
+            end
+        end
+
+      if (tb_output_data[255 : 128] != 128'h51f0bebf_7e3b9d92_fc497417_79363cfe)
+        begin
+          tc_correct = 0;
+          $display("Batch: Error - Expected ICV 0x51f0bebf_7e3b9d92_fc497417_79363cfe, got 0x%032x",
+                   tb_output_data[255 : 128]);
+        end
+
+      if (tc_correct)
+        $display("*** Batch successful.");
+      else
+        begin
+          $display("*** ERROR: Batch NOT successful.");
+          inc_error_ctr();
+        end
+      $display("");
+    end
+  endtask // batch_test
+  
+  //----------------------------------------------------------------
+  // single_lane_test()
+  //
+  // The first block of CTR-mode encryption with a 256 bit key on the
+  // last lane, with the single commands.
+  //----------------------------------------------------------------
+  task single_lane_test;
+    begin : single_lane_test
+      reg [127 : 0] expected;
+
+      $display("*** TC Single lane started.");
+      inc_tc_ctr();
+
+      tb_lane       = NUM_CORES - 1;
+      tb_enc_auth   = 1'b0;
+      tb_key        = 256'h603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4;
+      tb_keylen     = AES_256_BIT_KEY;
+      tb_counter    = 128'hf0f1f2f3f4f5f6f7f8f9fafbfcfdfeff;
+      tb_final_size = 8'd128;
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+
+      tb_block_i = 128'h6bc1bee22e409f96e93d7e117393172a;
+      expected   = 128'h601ec313775789a5b7a7f504bbf3d228;
+      #(CLK_PERIOD);
+      load_and_next(tb_input_data, tb_output_data);
+
+      if (tb_output_data[127 : 0] == expected)
+        $display("*** Single lane successful.");
+      else
+        begin
+          $display("*** ERROR: Single lane NOT successful.");
+          $display("Expected: 0x%032x", expected);
+          $display("Got:      0x%032x", tb_output_data[127 : 0]);
+          inc_error_ctr();
+        end
+      $display("");
+    end
+  endtask // single_lane_test
+
+  //----------------------------------------------------------------
+  // CMAC tests come from https://nvlpubs.nist.gov/nistpubs/SpecialPublications/NIST.SP.800-38B.pdf
+  // CTR-mode tests come from http://csrc.nist.gov/publications/nistpubs/800-38a/sp800-38a.pdf
+  //----------------------------------------------------------------
+  initial
+    begin : aes_tot_array_wrapper_test
+      $display("*** Testbench for AES TOT ARRAY WRAPPER started ***");
+      $display("");
+
+      init_sim();
+      reset_dut();
+
+      single_lane_test();
+      batch_test();
+
+      display_test_result();
+
+      $display("*** AES TOT ARRAY WRAPPER simulation done. ***");
+      $finish;
+    end // aes_tot_array_wrapper_test
+    
+endmodule // tb_aes_tot_array_wrapper
@@ -43,6 +43,13 @@ module tb_aes_tot_wrapper();
   parameter CMD_COMPUTE_NEXT    = 32'h2;
   parameter CMD_COMPUTE_FINAL   = 32'h3;
   parameter CMD_WRITE           = 32'h4;
+  parameter CMD_LOAD_KEY        = 32'h5;
+  parameter CMD_COMPUTE_ONESHOT = 32'h6;
+  parameter CMD_WRITE_PREV      = 32'hc;
+  parameter CMD_READ_STATS      = 32'h7;
+  parameter CMD_READ_STATS_HI   = 32'hf;
+  parameter CMD_RESTORE_CTX     = 32'h8;
+  parameter CMD_SAVE_CTX        = 32'h9;
   
   //----------------------------------------------------------------
   // Register and Wire declarations.
@@ -308,7 +315,8 @@ module tb_aes_tot_wrapper();
   //----------------------------------------------------------------
   // load_and_init()
   //
-  // Load inputs, initialize, and wait until done.
+  // Load inputs, expand the key into its slot, initialize, and
+  // wait until done.
   //----------------------------------------------------------------
   task load_and_init(input [1023 : 0] in);
     begin
@@ -317,6 +325,10 @@ module tb_aes_tot_wrapper();
       send_data_to_hw(in);
       wait_done();
       
+      $display("Sending LOAD_KEY command");
+      send_cmd_to_hw(CMD_LOAD_KEY);
+      wait_done();
+      
       $display("Sending COMPUTE_INIT command");
       send_cmd_to_hw(CMD_COMPUTE_INIT);
       wait_done();
@@ -370,6 +382,125 @@ module tb_aes_tot_wrapper();
     end
   endtask
   
+  //----------------------------------------------------------------
+  // load_and_compute_pipelined()
+  //
+  // Load inputs and start the given compute command, then fetch the
+  // result of the previous compute command while the core is busy.
+  //----------------------------------------------------------------
+  task load_and_compute_pipelined(input  [31 : 0]   command,
+                                  input  [1023 : 0] in,
+                                  output [1023 : 0] prev_out);
+    begin
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(in);
+      wait_done();
+        
+      $display("Sending COMPUTE command 0x%01x", command);
+      send_cmd_to_hw(command);
+      wait_done();
+        
+      $display("Sending WRITE_PREV command");
+      send_cmd_to_hw(CMD_WRITE_PREV);
+      read_data_from_hw(prev_out);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // compute_oneshot()
+  //
+  // Send a one-shot frame and read back all its results.
+  //----------------------------------------------------------------
+  task compute_oneshot(input [1023 : 0] in, output [1023 : 0] out);
+    begin
+      $display("Sending COMPUTE_ONESHOT command");
+      send_cmd_to_hw(CMD_COMPUTE_ONESHOT);
+      send_data_to_hw(in);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // oneshot_frame()
+  //
+  // The normal input frame with block 0 in block_i, followed by
+  // blocks 1 to 3, the number of blocks and the cached-key flag.
+  //----------------------------------------------------------------
+  function [1023 : 0] oneshot_frame(input [1023 : 0] in,
+                                    input [2 : 0]    nblocks,
+                                    input            cached,
+                                    input [127 : 0]  block1,
+                                    input [127 : 0]  block2,
+                                    input [127 : 0]  block3);
+    begin
+      oneshot_frame = {92'h0, cached, nblocks, block3, block2, block1,
+                       14'h0, in[529 : 0]};
+    end
+  endfunction
+  
+  //----------------------------------------------------------------
+  // ctx_frame()
+  //
+  // The normal input frame for the given key slot and context.
+  //----------------------------------------------------------------
+  function [1023 : 0] ctx_frame(input [1023 : 0] in,
+                                input [7 : 0]    key_slot,
+                                input [7 : 0]    ctx_id);
+    begin
+      ctx_frame = {486'h0, ctx_id, key_slot, in[521 : 0]};
+    end
+  endfunction
+  
+  //----------------------------------------------------------------
+  // save_ctx()
+  //
+  // Fetch context ctx_id from the accelerator.
+  //----------------------------------------------------------------
+  task save_ctx(input [7 : 0] ctx_id, output [1023 : 0] out);
+    begin
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(ctx_frame(1024'h0, 8'h0, ctx_id));
+      wait_done();
+      
+      $display("Sending SAVE_CTX command");
+      send_cmd_to_hw(CMD_SAVE_CTX);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // restore_ctx()
+  //
+  // Load a saved context into context ctx_id.
+  //----------------------------------------------------------------
+  task restore_ctx(input [7 : 0] ctx_id, input [1023 : 0] in);
+    begin
+      $display("Sending RESTORE_CTX command");
+      send_cmd_to_hw(CMD_RESTORE_CTX);
+      send_data_to_hw({ctx_id, in[1015 : 0]});
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // write_result()
+  //
+  // Wait for the last compute command and fetch its result.
+  //----------------------------------------------------------------
+  task write_result(output [1023 : 0] out);
+    begin
+      $display("Sending WRITE command");
+      send_cmd_to_hw(CMD_WRITE);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+  
   
   //----------------------------------------------------------------
   // tc3_empty_message
@@ -681,6 +812,61 @@ module tb_aes_tot_wrapper();
     end
   endtask // tc8_single_block_all_zero_message
   
+  //----------------------------------------------------------------
+  // cmac_oneshot_test()
+  //
+  // The messages of TC5 and TC4 with a single command each. The
+  // second message reuses the round keys expanded by the first.
+  //----------------------------------------------------------------
+  task cmac_oneshot_test();
+    begin : cmac_oneshot_test
+      inc_tc_ctr();
+      tc_correct = 1;
+
+      $display("TC one-shot CMAC: two and a half block message.");
+      tb_key        = 256'h2b7e1516_28aed2a6_abf71588_09cf4f3c_00000000_00000000_00000000_00000000;
+      tb_keylen     = 1'h0;
+      tb_block_i    = 128'h6bc1bee2_2e409f96_e93d7e11_7393172a;
+      tb_final_size = 8'h40;
+      #(CLK_PERIOD);
+      compute_oneshot(oneshot_frame(tb_input_data, 3'd3, 1'b0,
+                                    128'hae2d8a57_1e03ac9c_9eb76fac_45af8e51,
+                                    128'h30c81c46_a35ce411_00000000_00000000,
+                                    128'h0),
+                      tb_output_data);
+
+      if (tb_output_data[127:0] != 128'hdfa66747_de9ae630_30ca3261_1497c827)
+        begin
+          tc_correct = 0;
+          $display("Error - Expected 0xdfa66747_de9ae630_30ca3261_1497c827, got 0x%032x",
+                   tb_output_data[127:0]);
+        end
+
+      $display("TC one-shot CMAC: single block message with the cached key.");
+      tb_key        = {8{32'h00000000}};
+      tb_final_size = AES_BLOCK_SIZE;
+      #(CLK_PERIOD);
+      compute_oneshot(oneshot_frame(tb_input_data, 3'd1, 1'b1, 128'h0, 128'h0, 128'h0),
+                      tb_output_data);
+
+      if (tb_output_data[127:0] != 128'h070a16b4_6b4d4144_f79bdd9d_d04a287c)
+        begin
+          tc_correct = 0;
+          $display("Error - Expected 0x070a16b4_6b4d4144_f79bdd9d_d04a287c, got 0x%032x",
+                   tb_output_data[127:0]);
+        end
+
+      if (tc_correct)
+        $display("TC one-shot CMAC: SUCCESS - ICVs correctly generated.");
+      else
+        begin
+          $display("TC one-shot CMAC: NO SUCCESS - ICVs not correctly generated.");
+          inc_error_ctr();
+        end
+      $display("");
+    end
+  endtask // cmac_oneshot_test
+  
   //----------------------------------------------------------------
   // ctr_mode_enc256_test()
   //
@@ -755,6 +941,183 @@ module tb_aes_tot_wrapper();
      end
   endtask // ctr_mode_enc256_test
   
+  //----------------------------------------------------------------
+  // ctr_mode_pipelined_test()
+  //
+  // CTR-mode encryption of four blocks where every block is uploaded
+  // and started before the result of the previous one is read.
+  //----------------------------------------------------------------
+  task ctr_mode_pipelined_test();
+   begin : ctr_mode_pipelined_test
+     reg [127 : 0] blocks [0 : 3];
+     reg [127 : 0] expected [0 : 3];
+     reg [127 : 0] got [0 : 3];
+     integer i;
+     reg ok;
+
+     $display("*** TC pipelined CTR-mode encryption test started.");
+     tc_ctr = tc_ctr + 1;
+
+     blocks[0]   = 128'h6bc1bee22e409f96e93d7e117393172a;
+     blocks[1]   = 128'hae2d8a571e03ac9c9eb76fac45af8e51;
+     blocks[2]   = 128'h30c81c46a35ce411e5fbc1191a0a52ef;
+     blocks[3]   = 128'hf69f2445df4f9b17ad2b417be66c3710;
+     expected[0] = 128'h601ec313775789a5b7a7f504bbf3d228;
+     expected[1] = 128'hf443e3ca4d62b59aca84e990cacaf5c5;
+     expected[2] = 128'h2b0930daa23de94ce87017ba2d84988d;
+     expected[3] = 128'hdfc9c58db67aada613c2dd08457941a6;
+
+     tb_key = 256'h603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4;
+     tb_keylen = 1'b1;
+     tb_counter = 128'hf0f1f2f3f4f5f6f7f8f9fafbfcfdfeff;
+     tb_final_size = 8'd128;
+
+     #(CLK_PERIOD);
+     load_and_init(tb_input_data);
+
+     for (i = 0; i < 4; i = i + 1)
+       begin
+         tb_block_i = blocks[i];
+         #(CLK_PERIOD);
+         load_and_compute_pipelined((i == 3) ? CMD_COMPUTE_FINAL : CMD_COMPUTE_NEXT,
+                                    tb_input_data, tb_output_data);
+         if (i > 0)
+           got[i - 1] = tb_output_data[127 : 0];
+       end
+     write_result(tb_output_data);
+     got[3] = tb_output_data[127 : 0];
+
+     ok = 1;
+     for (i = 0; i < 4; i = i + 1)
+       if (got[i] != expected[i])
+         begin
+           $display("*** Block %0d - Expected: 0x%032x, got: 0x%032x", i + 1, expected[i], got[i]);
+           ok = 0;
+         end
+
+     if (ok)
+       $display("*** TC pipelined CTR-mode encryption successful.");
+     else
+       begin
+         $display("*** ERROR: TC pipelined CTR-mode encryption NOT successful.");
+         error_ctr = error_ctr + 1;
+       end
+     $display("");
+   end
+  endtask // ctr_mode_pipelined_test
+  
+  //----------------------------------------------------------------
+  // ctr_mode_oneshot_test()
+  //
+  // CTR-mode encryption of four blocks with a single command.
+  //----------------------------------------------------------------
+  task ctr_mode_oneshot_test();
+   begin : ctr_mode_oneshot_test
+     reg [127 : 0] expected [0 : 3];
+     integer i;
+     reg ok;
+
+     $display("*** TC one-shot CTR-mode encryption test started.");
+     tc_ctr = tc_ctr + 1;
+
+     expected[0] = 128'h601ec313775789a5b7a7f504bbf3d228;
+     expected[1] = 128'hf443e3ca4d62b59aca84e990cacaf5c5;
+     expected[2] = 128'h2b0930daa23de94ce87017ba2d84988d;
+     expected[3] = 128'hdfc9c58db67aada613c2dd08457941a6;
+
+     tb_key = 256'h603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4;
+     tb_keylen = 1'b1;
+     tb_counter = 128'hf0f1f2f3f4f5f6f7f8f9fafbfcfdfeff;
+     tb_final_size = 8'd128;
+     tb_block_i = 128'h6bc1bee22e409f96e93d7e117393172a;
+
+     #(CLK_PERIOD);
+     compute_oneshot(oneshot_frame(tb_input_data, 3'd4, 1'b0,
+                                   128'hae2d8a571e03ac9c9eb76fac45af8e51,
+                                   128'h30c81c46a35ce411e5fbc1191a0a52ef,
+                                   128'hf69f2445df4f9b17ad2b417be66c3710),
+                     tb_output_data);
+
+     ok = 1;
+     for (i = 0; i < 4; i = i + 1)
+       if (tb_output_data[128 * i +: 128] != expected[i])
+         begin
+           $display("*** Block %0d - Expected: 0x%032x, got: 0x%032x", i + 1, expected[i],
+                    tb_output_data[128 * i +: 128]);
+           ok = 0;
+         end
+
+     if (ok)
+       $display("*** TC one-shot CTR-mode encryption successful.");
+     else
+       begin
+         $display("*** ERROR: TC one-shot CTR-mode encryption NOT successful.");
+         error_ctr = error_ctr + 1;
+       end
+     $display("");
+   end
+  endtask // ctr_mode_oneshot_test
+  
+  //----------------------------------------------------------------
+  // ctr_mode_oneshot_len_test()
+  //
+  // A one-block one-shot right after the four-block one must not
+  // return the blocks of the previous message, and frames with 0 or
+  // more than four blocks are dropped with an all-zero result.
+  //----------------------------------------------------------------
+  task ctr_mode_oneshot_len_test();
+   begin : ctr_mode_oneshot_len_test
+     reg ok;
+
+     $display("*** TC one-shot CTR-mode block count test started.");
+     tc_ctr = tc_ctr + 1;
+     ok = 1;
+
+     tb_key = 256'h603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4;
+     tb_keylen = 1'b1;
+     tb_counter = 128'hf0f1f2f3f4f5f6f7f8f9fafbfcfdfeff;
+     tb_final_size = 8'd128;
+     tb_block_i = 128'h6bc1bee22e409f96e93d7e117393172a;
+
+     #(CLK_PERIOD);
+     compute_oneshot(oneshot_frame(tb_input_data, 3'd1, 1'b0, 128'h0, 128'h0, 128'h0),
+                     tb_output_data);
+     if (tb_output_data != {896'h0, 128'h601ec313775789a5b7a7f504bbf3d228})
+       begin
+         $display("*** One block - got: 0x%0256x", tb_output_data);
+         ok = 0;
+       end
+
+     compute_oneshot(oneshot_frame(tb_input_data, 3'd5, 1'b0,
+                                   128'hae2d8a571e03ac9c9eb76fac45af8e51,
+                                   128'h30c81c46a35ce411e5fbc1191a0a52ef,
+                                   128'hf69f2445df4f9b17ad2b417be66c3710),
+                     tb_output_data);
+     if (tb_output_data != 1024'h0)
+       begin
+         $display("*** Five blocks - got: 0x%0256x", tb_output_data);
+         ok = 0;
+       end
+
+     compute_oneshot(oneshot_frame(tb_input_data, 3'd0, 1'b0, 128'h0, 128'h0, 128'h0),
+                     tb_output_data);
+     if (tb_output_data != 1024'h0)
+       begin
+         $display("*** No blocks - got: 0x%0256x", tb_output_data);
+         ok = 0;
+       end
+
+     if (ok)
+       $display("*** TC one-shot CTR-mode block count successful.");
+     else
+       begin
+         $display("*** ERROR: TC one-shot CTR-mode block count NOT successful.");
+         error_ctr = error_ctr + 1;
+       end
+     $display("");
+   end
+  endtask // ctr_mode_oneshot_len_test
+  
   //----------------------------------------------------------------
   // ctr_mode_enc128_test()
   //
@@ -830,6 +1193,249 @@ module tb_aes_tot_wrapper();
      end
   endtask // ctr_mode_enc128_test
   
+  //----------------------------------------------------------------
+  // ctx_interleave_test()
+  //
+  // The CTR-mode message of ctr_mode_enc256_test() in context 1 and
+  // the CMAC message of TC5 in context 2, a block of each in turn.
+  // Halfway, context 2 is saved to the host and restored into
+  // context 3, which finishes the CMAC message.
+  //----------------------------------------------------------------
+  task ctx_interleave_test();
+   begin : ctx_interleave_test
+     reg [127 : 0]  expected [0 : 3];
+     reg [1023 : 0] saved;
+     reg ok;
+
+     $display("*** TC interleaved contexts test started.");
+     tc_ctr = tc_ctr + 1;
+     ok = 1;
+
+     expected[0] = 128'h601ec313775789a5b7a7f504bbf3d228;
+     expected[1] = 128'hf443e3ca4d62b59aca84e990cacaf5c5;
+     expected[2] = 128'h2b0930daa23de94ce87017ba2d84988d;
+     expected[3] = 128'hdfc9c58db67aada613c2dd08457941a6;
+
+     // CTR-mode in context 1 with the key in slot 0
+     tb_enc_auth   = 1'b0;
+     tb_key        = 256'h603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4;
+     tb_keylen     = 1'b1;
+     tb_counter    = 128'hf0f1f2f3f4f5f6f7f8f9fafbfcfdfeff;
+     tb_final_size = 8'd128;
+     #(CLK_PERIOD);
+     load_and_init(ctx_frame(tb_input_data, 8'h0, 8'h1));
+
+     // CMAC in context 2 with the key in slot 1
+     tb_enc_auth   = 1'b1;
+     tb_key        = 256'h2b7e1516_28aed2a6_abf71588_09cf4f3c_00000000_00000000_00000000_00000000;
+     tb_keylen     = 1'b0;
+     #(CLK_PERIOD);
+     load_and_init(ctx_frame(tb_input_data, 8'h1, 8'h2));
+
+     tb_enc_auth   = 1'b0;
+     tb_block_i    = 128'h6bc1bee22e409f96e93d7e117393172a;
+     #(CLK_PERIOD);
+     load_and_next(ctx_frame(tb_input_data, 8'h0, 8'h1), tb_output_data);
+     if (tb_output_data[127 : 0] != expected[0])
+       begin
+         $display("*** Block 1 - Expected: 0x%032x, got: 0x%032x", expected[0], tb_output_data[127 : 0]);
+         ok = 0;
+       end
+
+     // A key load with a frame for context 3 keeps context 1 in the core
+     $display("Sending READ command");
+     send_cmd_to_hw(CMD_READ);
+     send_data_to_hw(ctx_frame(tb_input_data, 8'h2, 8'h3));
+     wait_done();
+     $display("Sending LOAD_KEY command");
+     send_cmd_to_hw(CMD_LOAD_KEY);
+     wait_done();
+     if (dut.ctx_cur_reg != 2'h1)
+       begin
+         $display("*** Key load swapped to context %0d", dut.ctx_cur_reg);
+         ok = 0;
+       end
+
+     // A one-shot frame naming context 1, with its key for slot 3, runs
+     // beside the message in context 1 and leaves it alone
+     tb_enc_auth   = 1'b0;
+     tb_final_size = 8'd128;
+     #(CLK_PERIOD);
+     compute_oneshot(oneshot_frame(ctx_frame(tb_input_data, 8'h3, 8'h0), 3'd1, 1'b0,
+                                   128'h0, 128'h0, 128'h0) | ({1016'h0, 8'h1} << 530),
+                     tb_output_data);
+     if (tb_output_data[127 : 0] != 128'h874d6191b620e3261bef6864990db6ce)
+       begin
+         $display("*** One-shot - Expected: 0x874d6191b620e3261bef6864990db6ce, got: 0x%032x",
+                  tb_output_data[127 : 0]);
+         ok = 0;
+       end
+
+     tb_enc_auth   = 1'b1;
+     tb_final_size = 8'h00;
+     #(CLK_PERIOD);
+     load_and_next(ctx_frame(tb_input_data, 8'h1, 8'h2), tb_output_data);
+
+     tb_enc_auth   = 1'b0;
+     tb_block_i    = 128'hae2d8a571e03ac9c9eb76fac45af8e51;
+     tb_final_size = 8'd128;
+     #(CLK_PERIOD);
+     load_and_next(ctx_frame(tb_input_data, 8'h0, 8'h1), tb_output_data);
+     if (tb_output_data[127 : 0] != expected[1])
+       begin
+         $display("*** Block 2 - Expected: 0x%032x, got: 0x%032x", expected[1], tb_output_data[127 : 0]);
+         ok = 0;
+       end
+
+     tb_enc_auth   = 1'b1;
+     tb_final_size = 8'h00;
+     #(CLK_PERIOD);
+     load_and_next(ctx_frame(tb_input_data, 8'h1, 8'h2), tb_output_data);
+
+     // Move the CMAC message to the host and on to context 3
+     save_ctx(8'h2, saved);
+
+     tb_enc_auth   = 1'b0;
+     tb_block_i    = 128'h30c81c46a35ce411e5fbc1191a0a52ef;
+     tb_final_size = 8'd128;
+     #(CLK_PERIOD);
+     load_and_next(ctx_frame(tb_input_data, 8'h0, 8'h1), tb_output_data);
+     if (tb_output_data[127 : 0] != expected[2])
+       begin
+         $display("*** Block 3 - Expected: 0x%032x, got: 0x%032x", expected[2], tb_output_data[127 : 0]);
+         ok = 0;
+       end
+
+     restore_ctx(8'h3, saved);
+
+     tb_enc_auth   = 1'b1;
+     tb_block_i    = 128'h30c81c46_a35ce411_00000000_00000000;
+     tb_final_size = 8'h40;
+     #(CLK_PERIOD);
+     load_and_finalize(ctx_frame(tb_input_data, 8'h1, 8'h3), tb_output_data);
+     if (tb_output_data[127 : 0] != 128'hdfa66747_de9ae630_30ca3261_1497c827)
+       begin
+         $display("*** ICV - Expected: 0xdfa66747_de9ae630_30ca3261_1497c827, got: 0x%032x",
+                  tb_output_data[127 : 0]);
+         ok = 0;
+       end
+
+     tb_enc_auth   = 1'b0;
+     tb_block_i    = 128'hf69f2445df4f9b17ad2b417be66c3710;
+     tb_final_size = 8'd128;
+     #(CLK_PERIOD);
+     load_and_finalize(ctx_frame(tb_input_data, 8'h0, 8'h1), tb_output_data);
+     if (tb_output_data[127 : 0] != expected[3])
+       begin
+         $display("*** Block 4 - Expected: 0x%032x, got: 0x%032x", expected[3], tb_output_data[127 : 0]);
+         ok = 0;
+       end
+
+     if (ok)
+       $display("*** TC interleaved contexts successful.");
+     else
+       begin
+         $display("*** ERROR: TC interleaved contexts NOT successful.");
+         error_ctr = error_ctr + 1;
+       end
+     $display("");
+   end
+  endtask // ctx_interleave_test
+  
+  //----------------------------------------------------------------
+  // read_stats()
+  //
+  // Read the cycle counters of the wrapper.
+  //----------------------------------------------------------------
+  task read_stats(output [1023 : 0] out);
+    begin
+      $display("Sending READ_STATS command");
+      send_cmd_to_hw(CMD_READ_STATS);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+
+  //----------------------------------------------------------------
+  // read_stats_hi()
+  //
+  // Read the counters of the commands 8 to 15.
+  //----------------------------------------------------------------
+  task read_stats_hi(output [1023 : 0] out);
+    begin
+      $display("Sending READ_STATS_HI command");
+      send_cmd_to_hw(CMD_READ_STATS_HI);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+
+  //----------------------------------------------------------------
+  // test_stats
+  //
+  // Check that the cycle counters account for one init sequence, and
+  // that saving a context is counted on its own command code.
+  // Word i of the stats frame holds counter i, see wrapper_stats.v.
+  //----------------------------------------------------------------
+  task test_stats;
+    begin : test_stats
+      reg [1023 : 0] stats_before, stats_after;
+      reg [1023 : 0] stats_hi_before, stats_hi_after;
+      reg [1023 : 0] ctx_frame_out;
+
+      $display("*** Statistics BEGIN");
+      inc_tc_ctr();
+
+      read_stats(stats_before);
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+      #(CLK_PERIOD);
+      read_stats(stats_after);
+
+      // Command counters: READ, LOAD_KEY, COMPUTE_INIT and READ_STATS once each
+      if ((stats_after[(24 + CMD_READ) * 32 +: 32] - stats_before[(24 + CMD_READ) * 32 +: 32] != 32'd1) ||
+          (stats_after[(24 + CMD_LOAD_KEY) * 32 +: 32] - stats_before[(24 + CMD_LOAD_KEY) * 32 +: 32] != 32'd1) ||
+          (stats_after[(24 + CMD_COMPUTE_INIT) * 32 +: 32] - stats_before[(24 + CMD_COMPUTE_INIT) * 32 +: 32] != 32'd1) ||
+          (stats_after[(24 + CMD_READ_STATS) * 32 +: 32] - stats_before[(24 + CMD_READ_STATS) * 32 +: 32] != 32'd1))
+        begin
+          $display("Command counters incorrect - got 0x%064x", stats_after[1023 : 768]);
+          inc_error_ctr();
+        end
+      else
+        $display("Command counters correct!");
+
+      // The init command and the idle state both took cycles
+      if ((stats_after[(16 + CMD_COMPUTE_INIT) * 32 +: 32] == stats_before[(16 + CMD_COMPUTE_INIT) * 32 +: 32]) ||
+          (stats_after[31 : 0] == stats_before[31 : 0]))
+        begin
+          $display("Cycle counters incorrect - got 0x%0128x", stats_after[511 : 0]);
+          inc_error_ctr();
+        end
+      else
+        $display("Cycle counters correct!");
+
+      // SAVE_CTX only move their own counters on the upper page
+      read_stats(stats_before);
+      read_stats_hi(stats_hi_before);
+      save_ctx(8'h1, ctx_frame_out);
+      read_stats(stats_after);
+      read_stats_hi(stats_hi_after);
+
+      if ((stats_hi_after[(24 + CMD_SAVE_CTX - 8) * 32 +: 32] - stats_hi_before[(24 + CMD_SAVE_CTX - 8) * 32 +: 32] != 32'd1) ||
+          (stats_after[(24 + CMD_COMPUTE_INIT) * 32 +: 32] != stats_before[(24 + CMD_COMPUTE_INIT) * 32 +: 32]) ||
+          (stats_hi_after[511 : 0] != 512'h0))
+        begin
+          $display("Context command counters incorrect - got 0x%064x", stats_hi_after[1023 : 768]);
+          inc_error_ctr();
+        end
+      else
+        $display("Context command counters correct!");
+
+      $display("*** Statistics END");
+      $display("");
+    end
+  endtask // test_stats
+
   //----------------------------------------------------------------
   // aes_test
   // The main test functionality.
@@ -854,6 +1460,7 @@ module tb_aes_tot_wrapper();
       tc6_four_block_message();
       tc7_key256_four_block_message();
       tc8_single_block_all_zero_message();
+      cmac_oneshot_test();
       
       $display("*** Tests for CTR-mode ***");
       $display("");
@@ -862,7 +1469,13 @@ module tb_aes_tot_wrapper();
 
       ctr_mode_enc256_test();
       ctr_mode_enc128_test();
+      ctr_mode_pipelined_test();
+      ctr_mode_oneshot_test();
+      ctr_mode_oneshot_len_test();
+      ctx_interleave_test();
                                  
+      test_stats();
+
       display_test_result();
 
       $display("*** AES TOT WRAPPER simulation done. ***");
@@ -0,0 +1,313 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer:
+//
+// Create Date:
+// Design Name:
+// Module Name: tb_ctr_core_pipe
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description:
+//
+// Dependencies:
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments:
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module tb_ctr_core_pipe();
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  parameter DEBUG     = 0;
+
+  parameter CLK_HALF_PERIOD = 1;
+  parameter CLK_PERIOD = 2 * CLK_HALF_PERIOD;
+
+  parameter NUM_BLOCKS = 5;
+
+  //----------------------------------------------------------------
+  // Register and Wire declarations.
+  //----------------------------------------------------------------
+  reg [31 : 0] cycle_ctr;
+  reg [31 : 0] error_ctr;
+  reg [31 : 0] tc_ctr;
+
+  reg            tb_clk;
+  reg            tb_reset_n;
+  reg            tb_init;
+  reg            tb_next;
+  reg            tb_finalize;
+  reg [127 : 0]  tb_init_counter;
+  reg [255 : 0]  tb_key;
+  reg [127 : 0]  tb_block_i;
+  reg [7 : 0]    tb_len_i;
+  wire [127 : 0] tb_block_o;
+  wire           tb_block_o_valid;
+  wire           tb_block_o_last;
+  wire           tb_ready;
+
+  reg [127 : 0]  received [0 : NUM_BLOCKS - 1];
+  reg [31 : 0]   received_ctr;
+  reg            received_last;
+
+  //----------------------------------------------------------------
+  // Device Under Test.
+  //----------------------------------------------------------------
+  ctr_core_pipe dut(
+                    .clk(tb_clk),
+                    .reset_n(tb_reset_n),
+
+                    .init(tb_init),
+                    .next(tb_next),
+                    .finalize(tb_finalize),
+                    .init_counter(tb_init_counter),
+                    .key(tb_key),
+                   .keylen(1'b1),
+                    .block_i(tb_block_i),
+                    .len_i(tb_len_i),
+
+                    .block_o(tb_block_o),
+                    .block_o_valid(tb_block_o_valid),
+                    .block_o_last(tb_block_o_last),
+                    .ready(tb_ready)
+                    );
+
+  //----------------------------------------------------------------
+  // clk_gen
+  //
+  // Always running clock generator process.
+  //----------------------------------------------------------------
+  always
+    begin : clk_gen
+      #CLK_HALF_PERIOD;
+      tb_clk = !tb_clk;
+    end // clk_gen
+
+  //----------------------------------------------------------------
+  // sys_monitor()
+  //
+  // An always running process that creates a cycle counter and
+  // conditionally displays information about the DUT.
+  //----------------------------------------------------------------
+  always
+    begin : sys_monitor
+      cycle_ctr = cycle_ctr + 1;
+      #(CLK_PERIOD);
+      if (DEBUG)
+        begin
+          dump_dut_state();
+        end
+    end
+
+  //----------------------------------------------------------------
+  // out_collect
+  //
+  // Stores every block that leaves the pipeline.
+  //----------------------------------------------------------------
+  always @ (posedge tb_clk)
+    begin : out_collect
+      if (tb_block_o_valid)
+        begin
+          if (received_ctr < NUM_BLOCKS)
+            received[received_ctr] <= tb_block_o;
+          received_ctr  <= received_ctr + 1;
+          received_last <= tb_block_o_last;
+        end
+    end // out_collect
+
+  //----------------------------------------------------------------
+  // dump_dut_state()
+  //
+  // Dump the state of the dump when needed.
+  //----------------------------------------------------------------
+  task dump_dut_state;
+    begin
+      $display("State of DUT");
+      $display("------------");
+      $display("init = 0x%01x, next = 0x%01x, finalize = 0x%01x, ready = 0x%01x",
+               dut.init, dut.next, dut.finalize, dut.ready);
+      $display("counter  = 0x%032x", dut.counter_reg);
+      $display("block_i  = 0x%032x", dut.block_i);
+      $display("valid    = 0x%04x", dut.valid_reg);
+      $display("block_o  = 0x%032x, valid = 0x%01x, last = 0x%01x",
+               dut.block_o, dut.block_o_valid, dut.block_o_last);
+      $display("");
+    end
+  endtask // dump_dut_state
+
+  //----------------------------------------------------------------
+  // reset_dut()
+  //
+  // Toggle reset to put the DUT into a well known state.
+  //----------------------------------------------------------------
+  task reset_dut;
+    begin
+      $display("*** Toggle reset.");
+      tb_reset_n = 0;
+      #(2 * CLK_PERIOD);
+      tb_reset_n = 1;
+    end
+  endtask // reset_dut
+
+  //----------------------------------------------------------------
+  // init_sim()
+  //
+  // Initialize all counters and testbed functionality as well
+  // as setting the DUT inputs to defined values.
+  //----------------------------------------------------------------
+  task init_sim;
+    begin
+      cycle_ctr = 0;
+      error_ctr = 0;
+      tc_ctr    = 0;
+
+      received_ctr  = 0;
+      received_last = 0;
+
+      tb_clk          = 0;
+      tb_reset_n      = 1;
+      tb_init         = 0;
+      tb_next         = 0;
+      tb_finalize     = 0;
+      tb_init_counter = {4{32'h00000000}};
+      tb_key          = {8{32'h00000000}};
+      tb_block_i      = {4{32'h00000000}};
+      tb_len_i        = 8'h0;
+    end
+  endtask // init_sim
+
+  //----------------------------------------------------------------
+  // display_test_result()
+  //
+  // Display the accumulated test results.
+  //----------------------------------------------------------------
+  task display_test_result;
+    begin
+      if (error_ctr == 0)
+        begin
+          $display("*** All %02d test cases completed successfully", tc_ctr);
+        end
+      else
+        begin
+          $display("*** %02d tests completed - %02d test cases did not complete successfully.",
+                   tc_ctr, error_ctr);
+        end
+    end
+  endtask // display_test_result
+
+  //----------------------------------------------------------------
+  // wait_ready()
+  //
+  // Wait for the ready flag in the dut to be set.
+  //----------------------------------------------------------------
+  task wait_ready;
+    begin
+      while (!tb_ready)
+        #(CLK_PERIOD);
+    end
+  endtask // wait_ready
+
+  //----------------------------------------------------------------
+  // ctr_pipe_enc256_test()
+  //
+  // Streams the blocks of the AES-256 CTR test vectors into the
+  // pipeline, one per cycle, followed by a partial block of 8 bits.
+  //----------------------------------------------------------------
+  task ctr_pipe_enc256_test();
+   begin : ctr_pipe_enc256_test
+     reg [127 : 0] blocks [0 : NUM_BLOCKS - 1];
+     reg [127 : 0] expected [0 : NUM_BLOCKS - 1];
+     integer i;
+     reg ok;
+
+     $display("*** TC pipelined CTR-mode encryption test started.");
+     tc_ctr = tc_ctr + 1;
+
+     blocks[0]   = 128'h6bc1bee22e409f96e93d7e117393172a;
+     blocks[1]   = 128'hae2d8a571e03ac9c9eb76fac45af8e51;
+     blocks[2]   = 128'h30c81c46a35ce411e5fbc1191a0a52ef;
+     blocks[3]   = 128'hf69f2445df4f9b17ad2b417be66c3710;
+     blocks[4]   = 128'h01;
+     expected[0] = 128'h601ec313775789a5b7a7f504bbf3d228;
+     expected[1] = 128'hf443e3ca4d62b59aca84e990cacaf5c5;
+     expected[2] = 128'h2b0930daa23de94ce87017ba2d84988d;
+     expected[3] = 128'hdfc9c58db67aada613c2dd08457941a6;
+     expected[4] = 128'hb6; // 0x01 ^ low byte of keystream 8b77ffe0d97c0992d7f70e1ce9cfc3b7
+
+     tb_key = 256'h603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4;
+     tb_init_counter = 128'hf0f1f2f3f4f5f6f7f8f9fafbfcfdfeff;
+
+     tb_init = 1;
+     #(CLK_PERIOD);
+     tb_init = 0;
+     #(CLK_PERIOD);
+     wait_ready();
+
+     received_ctr = 0;
+     for (i = 0; i < NUM_BLOCKS; i = i + 1)
+       begin
+         tb_block_i  = blocks[i];
+         tb_len_i    = (i == NUM_BLOCKS - 1) ? 8'd8 : 8'd128;
+         tb_next     = (i != NUM_BLOCKS - 1);
+         tb_finalize = (i == NUM_BLOCKS - 1);
+         #(CLK_PERIOD);
+       end
+     tb_next     = 0;
+     tb_finalize = 0;
+
+     while (received_ctr < NUM_BLOCKS)
+       #(CLK_PERIOD);
+
+     ok = received_last;
+     for (i = 0; i < NUM_BLOCKS; i = i + 1)
+       if (received[i] != expected[i])
+         begin
+           $display("*** Block %0d - Expected: 0x%032x, got: 0x%032x", i, expected[i], received[i]);
+           ok = 0;
+         end
+
+     if (ok)
+       $display("*** TC pipelined CTR-mode encryption successful.");
+     else
+       begin
+         $display("*** ERROR: TC pipelined CTR-mode encryption NOT successful.");
+         error_ctr = error_ctr + 1;
+       end
+     $display("");
+   end
+  endtask // ctr_pipe_enc256_test
+
+    //----------------------------------------------------------------
+    // ctr_pipe_test
+    // The main test functionality.
+    // Test vectors copied from the following NIST document.
+    //
+    // NIST SP 800-38A:
+    // http://csrc.nist.gov/publications/nistpubs/800-38a/sp800-38a.pdf
+    //----------------------------------------------------------------
+    initial
+      begin : ctr_pipe_test
+
+        $display("   -= Testbench for pipelined ctr-mode started =-");
+        $display("     ==========================================");
+        $display("");
+
+        init_sim();
+        reset_dut();
+
+        ctr_pipe_enc256_test();
+
+        display_test_result();
+        $display("");
+        $display("*** Pipelined CTR simulation done. ***");
+        $finish;
+      end // ctr_pipe_test
+
+endmodule // tb_ctr_core_pipe
@@ -32,6 +32,10 @@ module tb_ctr_wrapper();
   parameter CLK_PERIOD      = 2 * CLK_HALF_PERIOD;
   parameter RESET_TIME      = 25;
   
+  // Core of the DUT, e.g. iverilog -Ptb_ctr_wrapper.PIPE_CORE=1. The
+  // 128-bit key tests are skipped for ctr_core_pipe, which is AES-256 only.
+  parameter PIPE_CORE       = 0;
+
   parameter AES_128_BIT_KEY = 1'b0;
   parameter AES_256_BIT_KEY = 1'b1;
   
@@ -39,6 +43,7 @@ module tb_ctr_wrapper();
   parameter CMD_READ        = 32'h0;
   parameter CMD_COMPUTE     = 32'h1;
   parameter CMD_WRITE       = 32'h2;
+  parameter CMD_WRITE_PREV  = 32'ha;
   
   //----------------------------------------------------------------
   // Register and Wire declarations.
@@ -70,7 +75,7 @@ module tb_ctr_wrapper();
   //----------------------------------------------------------------
   // Device Under Test.
   //----------------------------------------------------------------
-  ctr_wrapper dut(
+  ctr_wrapper #(.PIPE_CORE(PIPE_CORE)) dut(
                   .clk                    (tb_clk                    ),
                   .resetn                 (tb_resetn                 ),
             
@@ -320,6 +325,79 @@ module tb_ctr_wrapper();
     end
   endtask // ctr_wrapper_test
   
+  //----------------------------------------------------------------
+  // ctr_wrapper_pipelined_test()
+  //
+  // Perform two CTR-mode block tests back to back, where the second
+  // block is uploaded and started before the first result is read.
+  //----------------------------------------------------------------
+  task ctr_wrapper_pipelined_test(input [7 : 0]   tc_number,
+                                  input [255 : 0] key,
+                                  input           key_length,
+                                  input [127 : 0] counter0,
+                                  input [127 : 0] block_i0,
+                                  input [127 : 0] expected0,
+                                  input [127 : 0] counter1,
+                                  input [127 : 0] block_i1,
+                                  input [127 : 0] expected1);
+    begin : ctr_wrapper_pipelined_test
+      reg [127 : 0] got0, got1;
+      
+      $display("*** TC %0d pipelined CTR-mode test started.", tc_number);
+      tc_ctr = tc_ctr + 1;
+      tb_input_data = {511'h0 ,counter0, key, key_length, block_i0};
+      
+      #(CLK_PERIOD);
+      
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(tb_input_data);
+      wait_done();
+      
+      $display("Sending COMPUTE command");
+      send_cmd_to_hw(CMD_COMPUTE);
+      wait_done();
+      
+      tb_input_data = {511'h0 ,counter1, key, key_length, block_i1};
+      
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(tb_input_data);
+      wait_done();
+      
+      $display("Sending COMPUTE command");
+      send_cmd_to_hw(CMD_COMPUTE);
+      wait_done();
+      
+      $display("Sending WRITE_PREV command");
+      send_cmd_to_hw(CMD_WRITE_PREV);
+      read_data_from_hw(tb_output_data);
+      wait_done();
+      got0 = tb_output_data[127 : 0];
+      
+      $display("Sending WRITE command");
+      send_cmd_to_hw(CMD_WRITE);
+      read_data_from_hw(tb_output_data);
+      wait_done();
+      got1 = tb_output_data[127 : 0];
+ 
+      if ((got0 == expected0) && (got1 == expected1))
+        begin
+          $display("*** TC %0d successful.", tc_number);
+          $display("");
+        end
+        else
+          begin
+            $display("*** ERROR: TC %0d NOT successful.", tc_number);
+            $display("Expected: 0x%032x 0x%032x", expected0, expected1);
+            $display("Got:      0x%032x 0x%032x", got0, got1);
+            $display("");
+   
+            error_ctr = error_ctr + 1;
+         end
+    end
+  endtask // ctr_wrapper_pipelined_test
+  
   //----------------------------------------------------------------
   // ctr_test
   // The main test functionality.
@@ -394,20 +472,23 @@ module tb_ctr_wrapper();
       reset_dut();
       dump_dut_state();
 
-      $display("");
-      $display("ECB 128 bit key tests");
-      $display("---------------------");
-      ctr_wrapper_test(8'h0, nist_counter0, nist_aes128_key1, AES_128_BIT_KEY,
-                                 nist_plaintext0, nist_ctr_128_enc_expected0);
+      if (!PIPE_CORE)
+        begin
+          $display("");
+          $display("ECB 128 bit key tests");
+          $display("---------------------");
+          ctr_wrapper_test(8'h0, nist_counter0, nist_aes128_key1, AES_128_BIT_KEY,
+                                     nist_plaintext0, nist_ctr_128_enc_expected0);
 
-      ctr_wrapper_test(8'h1, nist_counter1, nist_aes128_key1, AES_128_BIT_KEY,
-                                 nist_plaintext1, nist_ctr_128_enc_expected1);
-                                
-      ctr_wrapper_test(8'h2, nist_counter2, nist_aes128_key1, AES_128_BIT_KEY,
-                                 nist_plaintext2, nist_ctr_128_enc_expected2);
-      
-      ctr_wrapper_test(8'h3, nist_counter3, nist_aes128_key1, AES_128_BIT_KEY,
-                                 nist_plaintext3, nist_ctr_128_enc_expected3);
+          ctr_wrapper_test(8'h1, nist_counter1, nist_aes128_key1, AES_128_BIT_KEY,
+                                     nist_plaintext1, nist_ctr_128_enc_expected1);
+
+          ctr_wrapper_test(8'h2, nist_counter2, nist_aes128_key1, AES_128_BIT_KEY,
+                                     nist_plaintext2, nist_ctr_128_enc_expected2);
+
+          ctr_wrapper_test(8'h3, nist_counter3, nist_aes128_key1, AES_128_BIT_KEY,
+                                     nist_plaintext3, nist_ctr_128_enc_expected3);
+        end
 
       $display("");
       $display("ECB 256 bit key tests");
@@ -428,6 +509,10 @@ module tb_ctr_wrapper();
       ctr_wrapper_test(8'h8, nist_counter0, nist_aes256_key1, AES_256_BIT_KEY,
                                  nist_ciphertext0, nist_ctr_256_dec_expected0);
 
+      ctr_wrapper_pipelined_test(8'h9, nist_aes256_key1, AES_256_BIT_KEY,
+                                 nist_counter2, nist_plaintext2, nist_ctr_256_enc_expected2,
+                                 nist_counter3, nist_plaintext3, nist_ctr_256_enc_expected3);
+
       display_test_result();
       $display("");
       $display("*** AES core simulation done. ***");
@@ -10,6 +10,14 @@
 #define CMD_COMPUTE_NEXT    2
 #define CMD_COMPUTE_FINAL   3
 #define CMD_WRITE           4
+#define CMD_LOAD_KEY        5
+#define CMD_COMPUTE_ONESHOT 6
+#define CMD_WRITE_PREV      (CMD_WRITE | 8)
+#define CMD_READ_STATS      7
+#define CMD_READ_STATS_HI   (CMD_READ_STATS | 8)
+#define CMD_RESTORE_CTX     (CMD_READ | 8)
+#define CMD_SAVE_CTX        9
+#define CMD_COMPUTE_BATCH   11  // aes_tot_array_wrapper.v only
 
 void init_HW_access(void)
 {
@@ -35,6 +43,47 @@ int check_correctness(uint32_t *expected, uint32_t *calculated, int size)
 	return 0;
 }
 
+// The key slot is in bits 529..522 of the input frame
+static void set_key_slot(uint32_t *input, uint32_t slot)
+{
+	input[16] = (input[16] & ~(0xffu << 10)) | ((slot & 0xffu) << 10);
+}
+
+// Expands the key and keylen of input into a round-key slot. Messages that
+// are started with aes_tot_HW_init_key() on the handle then use these round
+// keys, the key field of their input is ignored.
+void aes_tot_HW_load_key(aes_key_handle_t *handle, uint32_t slot, uint32_t *input)
+{
+	handle->slot = slot % AES_TOT_KEY_SLOTS;
+	set_key_slot(input, handle->slot);
+
+	//// --- Send the read command and transfer input data to FPGA
+	send_cmd_to_hw(CMD_READ);
+	send_data_to_hw(input);
+	while(!is_done());
+
+	//// --- Expand the key into its slot
+	send_cmd_to_hw(CMD_LOAD_KEY);
+	while(!is_done());
+}
+
+// Starts a message under the key of handle
+void aes_tot_HW_init_key(const aes_key_handle_t *handle, uint32_t *input)
+{
+	set_key_slot(input, handle->slot);
+
+	//// --- Send the read command and transfer input data to FPGA
+	send_cmd_to_hw(CMD_READ);
+	send_data_to_hw(input);
+	while(!is_done());
+
+	//// --- Perform the compute operation
+	send_cmd_to_hw(CMD_COMPUTE_INIT);
+	while(!is_done());
+}
+
+// Starts a message under the key of input, which is loaded into the slot
+// given in input first
 void aes_tot_HW_init(uint32_t *input)
 {
 	//// --- Send the read command and transfer input data to FPGA
@@ -42,6 +91,10 @@ void aes_tot_HW_init(uint32_t *input)
 	send_data_to_hw(input);
 	while(!is_done());
 
+	//// --- Expand the key into its slot
+	send_cmd_to_hw(CMD_LOAD_KEY);
+	while(!is_done());
+
 	//// --- Perform the compute operation
 	send_cmd_to_hw(CMD_COMPUTE_INIT);
 	while(!is_done());
@@ -80,3 +133,231 @@ void aes_tot_HW_finalize(uint32_t *input, uint32_t *output)
 	read_data_from_hw(output);
 	while(!is_done());
 }
+
+// Runs aes_tot_HW_next() on nblocks input frames of 32 words. The wrapper
+// computes in the background, so the upload of block i and the download of
+// block i-1 overlap the computation of block i-1 and block i respectively.
+void aes_tot_HW_next_pipelined(uint32_t *input, uint32_t *output, int nblocks)
+{
+	int i;
+
+	for (i = 0; i < nblocks; i++) {
+		//// --- Send the read command and transfer input data to FPGA
+		send_cmd_to_hw(CMD_READ);
+		send_data_to_hw(input + 32*i);
+		while(!is_done());
+
+		//// --- Start the compute operation, once the previous block is done
+		send_cmd_to_hw(CMD_COMPUTE_NEXT);
+		while(!is_done());
+
+		//// --- Transfer the output data of the previous block from FPGA
+		if (i > 0) {
+			send_cmd_to_hw(CMD_WRITE_PREV);
+			read_data_from_hw(output + 32*(i-1));
+			while(!is_done());
+		}
+	}
+
+	//// --- Wait for the last block and transfer its output data from FPGA
+	if (nblocks > 0) {
+		send_cmd_to_hw(CMD_WRITE);
+		read_data_from_hw(output + 32*(nblocks-1));
+		while(!is_done());
+	}
+}
+
+// Encrypts or authenticates a message of 1 to AES_TOT_ONESHOT_MAX_BLOCKS
+// blocks with a single command. input is a normal input frame, whose block
+// field is ignored and whose final_size gives the bits of the last block.
+// blocks holds the message, 4 words per block in the order of the block
+// field. With a handle the round keys of its slot are used, without one the
+// key of input is expanded first. output receives the ciphertext blocks, 4
+// words each, or the CMAC tag in words 0..3. Returns -1 without touching the
+// hardware when nblocks is out of range, 0 otherwise.
+int aes_tot_HW_oneshot(const aes_key_handle_t *handle, uint32_t *input, uint32_t *blocks, int nblocks, uint32_t *output)
+{
+	uint32_t frame[32];
+	int i;
+
+	if (nblocks < 1 || nblocks > AES_TOT_ONESHOT_MAX_BLOCKS) return -1;
+
+	// Blocks 1 to 3 follow the key slot in words 17 to 28, the number of
+	// blocks and the cached-key flag are in word 29
+	for (i = 0; i < 32; i++) frame[i] = (i < 17) ? input[i] : 0;
+	for (i = 0; i < 4*nblocks; i++) frame[(i < 4) ? i : 13+i] = blocks[i];
+	frame[29] = nblocks;
+	if (handle) {
+		set_key_slot(frame, handle->slot);
+		frame[29] |= 8;
+	}
+
+	//// --- Send the one-shot command and transfer input data to FPGA
+	send_cmd_to_hw(CMD_COMPUTE_ONESHOT);
+	send_data_to_hw(frame);
+
+	//// --- Transfer output data from FPGA once all blocks are done
+	read_data_from_hw(output);
+	while(!is_done());
+	return 0;
+}
+
+// Contexts in use, context 0 is never handed out
+static uint32_t ctx_used = 1;
+
+// Reserves an on-chip message context. Returns -1 if all are in use.
+int aes_tot_HW_ctx_alloc(aes_ctx_handle_t *ctx)
+{
+	uint32_t id;
+
+	for (id = 1; id < AES_TOT_CTX_SLOTS; id++) {
+		if (!(ctx_used & (1u << id))) {
+			ctx_used |= 1u << id;
+			ctx->id = id;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+void aes_tot_HW_ctx_free(aes_ctx_handle_t *ctx)
+{
+	ctx_used &= ~(1u << ctx->id);
+	ctx->id = 0;
+}
+
+// Makes input a frame of the message in ctx. The ctx_id is in bits 537..530
+// of the input frame. The wrapper switches contexts by itself, so messages
+// in different contexts can be interleaved frame by frame.
+void aes_tot_HW_set_ctx(const aes_ctx_handle_t *ctx, uint32_t *input)
+{
+	input[16] = (input[16] & ~(0xffu << 18)) | ((ctx->id & 0xffu) << 18);
+}
+
+// Copies the state of the message in ctx to state, 32 words. The message
+// can then be continued in any context with aes_tot_HW_ctx_restore().
+void aes_tot_HW_ctx_save(const aes_ctx_handle_t *ctx, uint32_t *state)
+{
+	uint32_t frame[32] = {0};
+
+	aes_tot_HW_set_ctx(ctx, frame);
+
+	//// --- Select the context
+	send_cmd_to_hw(CMD_READ);
+	send_data_to_hw(frame);
+	while(!is_done());
+
+	//// --- Transfer the context from FPGA
+	send_cmd_to_hw(CMD_SAVE_CTX);
+	read_data_from_hw(state);
+	while(!is_done());
+}
+
+// Loads a state saved by aes_tot_HW_ctx_save() into ctx. The ctx_id is in
+// the top byte of the state.
+void aes_tot_HW_ctx_restore(const aes_ctx_handle_t *ctx, uint32_t *state)
+{
+	state[31] = (state[31] & 0x00ffffffu) | ((ctx->id & 0xffu) << 24);
+
+	//// --- Send the restore command and transfer the context to FPGA
+	send_cmd_to_hw(CMD_RESTORE_CTX);
+	send_data_to_hw(state);
+	while(!is_done());
+}
+
+// Batch frames of aes_tot_array_wrapper.v, where the ctx_id of a frame is
+// the core (lane) it runs on. A batch frame holds one block per lane in
+// words 4*lane to 4*lane+3, the lanes with a block in bits 903..896, the
+// lanes for which it is the final block in bits 911..904 and the
+// final_size of every lane in bits 912+8*lane+7..912+8*lane.
+void aes_tot_HW_batch_clear(uint32_t *frame)
+{
+	int i;
+
+	for (i = 0; i < 32; i++) frame[i] = 0;
+}
+
+// Adds block to frame for lane. Returns -1 if the array has no such lane.
+int aes_tot_HW_batch_add(uint32_t *frame, int lane, const uint32_t *block, int final, uint8_t final_size)
+{
+	uint32_t bit;
+	int i;
+
+	if (lane < 0 || lane >= AES_TOT_BATCH_LANES) return -1;
+	bit = 912 + 8*lane;
+
+	for (i = 0; i < 4; i++) frame[4*lane+i] = block[i];
+	frame[28] |= 1u << lane;
+	if (final) frame[28] |= 1u << (8+lane);
+	frame[bit/32] = (frame[bit/32] & ~(0xffu << (bit%32))) | ((uint32_t)final_size << (bit%32));
+	return 0;
+}
+
+// Runs the blocks of all lanes in frame in parallel. The result of a lane
+// is in the words of its block in output, the lanes in bits 903..896.
+void aes_tot_HW_batch(uint32_t *frame, uint32_t *output)
+{
+	//// --- Send the batch command and transfer input data to FPGA
+	send_cmd_to_hw(CMD_COMPUTE_BATCH);
+	send_data_to_hw(frame);
+
+	//// --- Transfer output data from FPGA once all lanes are done
+	read_data_from_hw(output);
+	while(!is_done());
+}
+
+// Descriptor ring in front of the wrapper, see hw_queue.h. The frames of
+// the descriptors are read from and written to mem.
+void aes_tot_HW_queue_init(hw_queue_t *q, uint32_t *mem)
+{
+	hw_queue_init(q, mem, CMD_READ, CMD_WRITE);
+}
+
+void aes_tot_HW_read_stats(hw_stats_t *stats)
+{
+	uint32_t frame[32];
+	int i;
+
+	//// --- Send read stats command and transfer the counters from FPGA
+	send_cmd_to_hw(CMD_READ_STATS);
+	read_data_from_hw(frame);
+	while(!is_done());
+
+	for (i = 0; i < 16; i++) stats->state_cycles[i] = frame[i];
+	for (i = 0; i < 8; i++) {
+		stats->cmd_cycles[i] = frame[16+i];
+		stats->cmd_count[i]  = frame[24+i];
+	}
+
+	//// --- Same for the counters of the commands 8 to 15
+	send_cmd_to_hw(CMD_READ_STATS_HI);
+	read_data_from_hw(frame);
+	while(!is_done());
+
+	for (i = 0; i < 8; i++) {
+		stats->cmd_cycles[8+i] = frame[16+i];
+		stats->cmd_count[8+i]  = frame[24+i];
+	}
+}
+
+// Names of the wrapper commands, indexed by the command code
+static const char *cmd_names[16] = {
+	"READ", "COMPUTE_INIT", "COMPUTE_NEXT", "COMPUTE_FINAL",
+	"WRITE", "LOAD_KEY", "COMPUTE_ONESHOT", "READ_STATS",
+	"RESTORE_CTX", "SAVE_CTX", NULL, "COMPUTE_BATCH",
+	"WRITE_PREV", NULL, NULL, "READ_STATS_HI"
+};
+
+void print_HW_stats(hw_stats_t *stats)
+{
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		if (stats->state_cycles[i]) xil_printf("    state %d: %u cycles\n\r", i, stats->state_cycles[i]);
+	}
+	for (i = 0; i < 16; i++) {
+		if (!stats->cmd_count[i]) continue;
+		if (cmd_names[i]) xil_printf("    %s: %u times, %u cycles\n\r", cmd_names[i], stats->cmd_count[i], stats->cmd_cycles[i]);
+		else xil_printf("    cmd %d: %u times, %u cycles\n\r", i, stats->cmd_count[i], stats->cmd_cycles[i]);
+	}
+}
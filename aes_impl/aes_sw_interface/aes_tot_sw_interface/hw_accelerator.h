@@ -1,11 +1,69 @@
 #ifndef _HW_ACCEL_H_
 #define _HW_ACCEL_H_
 
+#include "hw_queue.h"
+
+// Number of on-chip round-key slots, 2**KEY_SLOT_BITS in aes_tot_wrapper.v
+#define AES_TOT_KEY_SLOTS 4
+
+// Round-key slot that holds an expanded key, see aes_tot_HW_load_key()
+typedef struct {
+	uint32_t slot;
+} aes_key_handle_t;
+
+// Number of on-chip message contexts, 2**CTX_BITS in aes_tot_wrapper.v.
+// Context 0 is used by the frames that don't name a context.
+#define AES_TOT_CTX_SLOTS 4
+
+// Message context, see aes_tot_HW_ctx_alloc()
+typedef struct {
+	uint32_t id;
+} aes_ctx_handle_t;
+
+// Lanes of aes_tot_array_wrapper.v, its NUM_CORES. A lane is named by the
+// ctx_id of a frame, lane 0 also by the frames that don't name a context.
+// aes_tot_HW_batch_add() takes the lane itself, 0..AES_TOT_BATCH_LANES-1.
+#define AES_TOT_BATCH_LANES 4
+
+// Blocks of a message for aes_tot_HW_oneshot()
+#define AES_TOT_ONESHOT_MAX_BLOCKS 4
+
+// Descriptor opcodes for hw_submit(), the compute commands of the wrapper
+#define AES_TOT_HW_OP_INIT     1  // CMD_COMPUTE_INIT
+#define AES_TOT_HW_OP_NEXT     2  // CMD_COMPUTE_NEXT
+#define AES_TOT_HW_OP_FINAL    3  // CMD_COMPUTE_FINAL
+#define AES_TOT_HW_OP_LOAD_KEY 5  // CMD_LOAD_KEY
+
+// Cycle counters of the wrapper, as returned by CMD_READ_STATS and, for
+// the commands 8 to 15, CMD_READ_STATS_HI. cmd_cycles and cmd_count are
+// indexed by the command code. The counters wrap around and are only
+// cleared by a reset of the FPGA.
+typedef struct {
+	uint32_t state_cycles[16];  // Cycles spent in every state of the wrapper FSM
+	uint32_t cmd_cycles[16];    // Cycles between accepting a command and returning to idle
+	uint32_t cmd_count[16];     // Number of times every command was accepted
+} hw_stats_t;
+
 void init_HW_access(void);
 void customprint(uint32_t *large_number, char *str, int size);
 int check_correctness(uint32_t *expected, uint32_t *calculated, int size);
+void aes_tot_HW_load_key(aes_key_handle_t *handle, uint32_t slot, uint32_t *input);
+void aes_tot_HW_init_key(const aes_key_handle_t *handle, uint32_t *input);
 void aes_tot_HW_init(uint32_t *input);
 void aes_tot_HW_next(uint32_t *input, uint32_t *output);
+void aes_tot_HW_next_pipelined(uint32_t *input, uint32_t *output, int nblocks);
 void aes_tot_HW_finalize(uint32_t *input, uint32_t *output);
+int aes_tot_HW_oneshot(const aes_key_handle_t *handle, uint32_t *input, uint32_t *blocks, int nblocks, uint32_t *output);
+int aes_tot_HW_ctx_alloc(aes_ctx_handle_t *ctx);
+void aes_tot_HW_ctx_free(aes_ctx_handle_t *ctx);
+void aes_tot_HW_set_ctx(const aes_ctx_handle_t *ctx, uint32_t *input);
+void aes_tot_HW_ctx_save(const aes_ctx_handle_t *ctx, uint32_t *state);
+void aes_tot_HW_ctx_restore(const aes_ctx_handle_t *ctx, uint32_t *state);
+void aes_tot_HW_batch_clear(uint32_t *frame);
+int aes_tot_HW_batch_add(uint32_t *frame, int lane, const uint32_t *block, int final, uint8_t final_size);
+void aes_tot_HW_batch(uint32_t *frame, uint32_t *output);
+void aes_tot_HW_queue_init(hw_queue_t *q, uint32_t *mem);
+void aes_tot_HW_read_stats(hw_stats_t *stats);
+void print_HW_stats(hw_stats_t *stats);
 
 #endif
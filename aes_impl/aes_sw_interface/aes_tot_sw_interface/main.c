@@ -14,6 +14,16 @@ extern uint32_t ctr0[32],
                 mac_expected[4];
 
 uint32_t output[32];
+uint32_t mac_blocks[64], mac_outputs[64];
+uint32_t oneshot_blocks[4*AES_TOT_ONESHOT_MAX_BLOCKS];
+hw_stats_t stats;
+aes_key_handle_t ctr_key, mac_key;
+aes_ctx_handle_t ctx_a, ctx_b, ctx_c;
+uint32_t ctx_ctr[64], ctx_mac[96], ctx_state[32];
+uint32_t queue_mem[10*32];
+hw_queue_t queue;
+hw_desc_t desc[6];
+hw_compl_t compl[6];
 
 int main()
 {
@@ -48,6 +58,133 @@ int main()
 	if (check_correctness(output, mac_expected, 4) != 1) xil_printf("    MAC test: tag for AES TOT correct!\n\r\n\r");
 	else xil_printf("    MAC test: tag for AES TOT incorrect :(\n\r\n\r");
 
+	// -- Test CMAC with the pipelined call sequence
+	xil_printf("Test pipelined MAC...\n\r");
+	for (int i = 0; i < 32; i++) {
+		mac_blocks[i]    = mac_block0[i];
+		mac_blocks[32+i] = mac_block1[i];
+	}
+	aes_tot_HW_init(mac_block0);
+	aes_tot_HW_next_pipelined(mac_blocks, mac_outputs, 2);
+	aes_tot_HW_finalize(mac_block2, output);
+	customprint(output, "    Output", 32);
+	if (check_correctness(output, mac_expected, 4) != 1) xil_printf("    pipelined MAC test: tag for AES TOT correct!\n\r\n\r");
+	else xil_printf("    pipelined MAC test: tag for AES TOT incorrect :(\n\r\n\r");
+
+	// -- Test a message under a preloaded key
+	xil_printf("Test key slot...\n\r");
+	aes_tot_HW_load_key(&ctr_key, 2, ctr0);
+	aes_tot_HW_init_key(&ctr_key, ctr0);
+	aes_tot_HW_next(ctr0, output);
+	customprint(output, "    Output", 32);
+	if (check_correctness(output, ctr0_expected, 4) != 1) xil_printf("    key slot test: AES encryption block 0 correct!\n\r\n\r");
+	else xil_printf("    key slot test: AES encryption block 0 incorrect :(\n\r\n\r");
+
+	// -- Test encryption of both blocks with a single command
+	xil_printf("Test one-shot encryption...\n\r");
+	for (int i = 0; i < 4; i++) {
+		oneshot_blocks[i]   = ctr0[i];
+		oneshot_blocks[4+i] = ctr1[i];
+	}
+	aes_tot_HW_oneshot(&ctr_key, ctr1, oneshot_blocks, 2, output);
+	customprint(output, "    Output", 32);
+	if ((check_correctness(output, ctr0_expected, 4) != 1) && (check_correctness(output + 4, ctr1_expected, 4) != 1)) xil_printf("    one-shot encryption test: AES encryption blocks correct!\n\r\n\r");
+	else xil_printf("    one-shot encryption test: AES encryption blocks incorrect :(\n\r\n\r");
+
+	// -- Test CMAC of the whole message with a single command
+	xil_printf("Test one-shot MAC...\n\r");
+	for (int i = 0; i < 4; i++) {
+		oneshot_blocks[i]   = mac_block0[i];
+		oneshot_blocks[4+i] = mac_block1[i];
+		oneshot_blocks[8+i] = mac_block2[i];
+	}
+	aes_tot_HW_oneshot(NULL, mac_block2, oneshot_blocks, 3, output);
+	customprint(output, "    Output", 32);
+	if (check_correctness(output, mac_expected, 4) != 1) xil_printf("    one-shot MAC test: tag for AES TOT correct!\n\r\n\r");
+	else xil_printf("    one-shot MAC test: tag for AES TOT incorrect :(\n\r\n\r");
+
+	// -- A one-shot message must have 1 to AES_TOT_ONESHOT_MAX_BLOCKS blocks
+	if ((aes_tot_HW_oneshot(NULL, mac_block2, oneshot_blocks, 0, output) == -1) &&
+	    (aes_tot_HW_oneshot(NULL, mac_block2, oneshot_blocks, AES_TOT_ONESHOT_MAX_BLOCKS + 1, output) == -1))
+		xil_printf("    one-shot length test: invalid block counts rejected!\n\r\n\r");
+	else xil_printf("    one-shot length test: invalid block counts accepted :(\n\r\n\r");
+
+	// -- Test an encryption and a MAC interleaved in two contexts, with the
+	//    MAC moved to a third context halfway
+	xil_printf("Test contexts...\n\r");
+	for (int i = 0; i < 32; i++) {
+		ctx_ctr[i]    = ctr0[i];
+		ctx_ctr[32+i] = ctr1[i];
+		ctx_mac[i]    = mac_block0[i];
+		ctx_mac[32+i] = mac_block1[i];
+		ctx_mac[64+i] = mac_block2[i];
+	}
+	aes_tot_HW_load_key(&mac_key, 3, ctx_mac);
+	if ((aes_tot_HW_ctx_alloc(&ctx_a) != 0) || (aes_tot_HW_ctx_alloc(&ctx_b) != 0) || (aes_tot_HW_ctx_alloc(&ctx_c) != 0))
+		xil_printf("    context test: out of contexts :(\n\r\n\r");
+	aes_tot_HW_set_ctx(&ctx_a, ctx_ctr);
+	aes_tot_HW_set_ctx(&ctx_a, ctx_ctr + 32);
+	aes_tot_HW_set_ctx(&ctx_b, ctx_mac);
+	aes_tot_HW_init_key(&ctr_key, ctx_ctr);
+	aes_tot_HW_init_key(&mac_key, ctx_mac);
+	aes_tot_HW_next(ctx_ctr, output);
+	if (check_correctness(output, ctr0_expected, 4) != 1) xil_printf("    context test: AES encryption block 0 correct!\n\r");
+	else xil_printf("    context test: AES encryption block 0 incorrect :(\n\r");
+	aes_tot_HW_next(ctx_mac, output);
+	aes_tot_HW_ctx_save(&ctx_b, ctx_state);
+	aes_tot_HW_finalize(ctx_ctr + 32, output);
+	if (check_correctness(output, ctr1_expected, 4) != 1) xil_printf("    context test: AES encryption block 1 correct!\n\r");
+	else xil_printf("    context test: AES encryption block 1 incorrect :(\n\r");
+	aes_tot_HW_ctx_restore(&ctx_c, ctx_state);
+	aes_tot_HW_set_ctx(&ctx_c, ctx_mac + 32);
+	aes_tot_HW_set_ctx(&ctx_c, ctx_mac + 64);
+	aes_tot_HW_next(ctx_mac + 32, output);
+	aes_tot_HW_finalize(ctx_mac + 64, output);
+	customprint(output, "    Output", 32);
+	if (check_correctness(output, mac_expected, 4) != 1) xil_printf("    context test: tag for AES TOT correct!\n\r\n\r");
+	else xil_printf("    context test: tag for AES TOT incorrect :(\n\r\n\r");
+	aes_tot_HW_ctx_free(&ctx_a);
+	aes_tot_HW_ctx_free(&ctx_b);
+	aes_tot_HW_ctx_free(&ctx_c);
+
+	// -- Test the encryption and the MAC as descriptors of the ring. Frames
+	//    0-4 of queue_mem are the inputs, frames 5-9 the outputs.
+	xil_printf("Test descriptor ring...\n\r");
+	uint32_t *in_frames[5] = { ctr0, ctr1, mac_block0, mac_block1, mac_block2 };
+	hw_desc_t ring_desc[6] = {
+		{ AES_TOT_HW_OP_INIT,  0, 0*32, HW_QUEUE_NONE, 1 },
+		{ AES_TOT_HW_OP_NEXT,  0, 0*32, 5*32,          1 },
+		{ AES_TOT_HW_OP_FINAL, 0, 1*32, 6*32,          1 },
+		{ AES_TOT_HW_OP_INIT,  1, 2*32, HW_QUEUE_NONE, 1 },
+		{ AES_TOT_HW_OP_NEXT,  1, 2*32, 7*32,          2 },
+		{ AES_TOT_HW_OP_FINAL, 1, 4*32, 9*32,          1 }
+	};
+	uint32_t done = 0, polls = 0, errors = 0;
+	for (int f = 0; f < 5; f++)
+		for (int i = 0; i < 32; i++)
+			queue_mem[32*f + i] = in_frames[f][i];
+	for (int d = 0; d < 6; d++) desc[d] = ring_desc[d];
+	aes_tot_HW_queue_init(&queue, queue_mem);
+	hw_submit(&queue, desc, 6);
+	while (done < 6) {
+		done += hw_poll_completions(&queue, compl + done, 6 - done);
+		polls++;  // The CPU is free for other work between the polls
+	}
+	for (int d = 0; d < 6; d++)
+		if ((compl[d].seq != (uint32_t)d) || (compl[d].ctx != desc[d].ctx)) errors++;
+	if (check_correctness(queue_mem + 5*32, ctr0_expected, 4) == 1) errors++;
+	if (check_correctness(queue_mem + 6*32, ctr1_expected, 4) == 1) errors++;
+	if (check_correctness(queue_mem + 9*32, mac_expected, 4) == 1) errors++;
+	xil_printf("    %d polls\n\r", polls);
+	if (errors == 0) xil_printf("    descriptor ring test: encryption and tag for AES TOT correct!\n\r\n\r");
+	else xil_printf("    descriptor ring test: encryption and tag for AES TOT incorrect :(\n\r\n\r");
+
+	// -- Read the cycle counters of the wrapper
+	xil_printf("Cycle counters...\n\r");
+	aes_tot_HW_read_stats(&stats);
+	print_HW_stats(&stats);
+	xil_printf("\n\r");
+
 	xil_printf("----------- End AES TOT test -----------\n\r");
 
 	cleanup_platform();
@@ -10,6 +10,9 @@
 #define CMD_COMPUTE_INIT 2
 #define CMD_COMPUTE_NEXT 3
 #define CMD_WRITE        4
+#define CMD_WRITE_PREV   (CMD_WRITE | 8)
+#define CMD_READ_STATS   7
+#define CMD_READ_STATS_HI (CMD_READ_STATS | 8)
 
 void init_HW_access(void)
 {
@@ -59,6 +62,26 @@ void cmac_HW_next(uint32_t *input)
 	while(!is_done());
 }
 
+// Runs cmac_HW_next() on nblocks input frames of 32 words. The wrapper
+// computes in the background and COMPUTE_NEXT returns as soon as the block
+// is started, so the upload of block i overlaps the computation of block
+// i-1. There is no output to fetch before the final block.
+void cmac_HW_next_pipelined(uint32_t *input, int nblocks)
+{
+	int i;
+
+	for (i = 0; i < nblocks; i++) {
+		//// --- Send the read command and transfer input data to FPGA
+		send_cmd_to_hw(CMD_READ_BLOCK);
+		send_data_to_hw(input + 32*i);
+		while(!is_done());
+
+		//// --- Start the compute operation, once the previous block is done
+		send_cmd_to_hw(CMD_COMPUTE_NEXT);
+		while(!is_done());
+	}
+}
+
 void cmac_HW_finalize(uint32_t *input, uint32_t *output)
 {
 	//// --- Send the read command and transfer input data to FPGA
@@ -75,3 +98,59 @@ void cmac_HW_finalize(uint32_t *input, uint32_t *output)
 	read_data_from_hw(output);
 	while(!is_done());
 }
+
+// Descriptor ring in front of the wrapper, see hw_queue.h. The frames of
+// the descriptors are read from and written to mem.
+void cmac_HW_queue_init(hw_queue_t *q, uint32_t *mem)
+{
+	hw_queue_init(q, mem, CMD_READ_BLOCK, CMD_WRITE);
+}
+
+void cmac_HW_read_stats(hw_stats_t *stats)
+{
+	uint32_t frame[32];
+	int i;
+
+	//// --- Send read stats command and transfer the counters from FPGA
+	send_cmd_to_hw(CMD_READ_STATS);
+	read_data_from_hw(frame);
+	while(!is_done());
+
+	for (i = 0; i < 16; i++) stats->state_cycles[i] = frame[i];
+	for (i = 0; i < 8; i++) {
+		stats->cmd_cycles[i] = frame[16+i];
+		stats->cmd_count[i]  = frame[24+i];
+	}
+
+	//// --- Same for the counters of the commands 8 to 15
+	send_cmd_to_hw(CMD_READ_STATS_HI);
+	read_data_from_hw(frame);
+	while(!is_done());
+
+	for (i = 0; i < 8; i++) {
+		stats->cmd_cycles[8+i] = frame[16+i];
+		stats->cmd_count[8+i]  = frame[24+i];
+	}
+}
+
+// Names of the wrapper commands, indexed by the command code
+static const char *cmd_names[16] = {
+	"READ_KEY", "READ_BLOCK", "COMPUTE_INIT", "COMPUTE_NEXT",
+	"WRITE", NULL, NULL, "READ_STATS",
+	NULL, NULL, NULL, NULL,
+	"WRITE_PREV", NULL, NULL, "READ_STATS_HI"
+};
+
+void print_HW_stats(hw_stats_t *stats)
+{
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		if (stats->state_cycles[i]) xil_printf("    state %d: %u cycles\n\r", i, stats->state_cycles[i]);
+	}
+	for (i = 0; i < 16; i++) {
+		if (!stats->cmd_count[i]) continue;
+		if (cmd_names[i]) xil_printf("    %s: %u times, %u cycles\n\r", cmd_names[i], stats->cmd_count[i], stats->cmd_cycles[i]);
+		else xil_printf("    cmd %d: %u times, %u cycles\n\r", i, stats->cmd_count[i], stats->cmd_cycles[i]);
+	}
+}
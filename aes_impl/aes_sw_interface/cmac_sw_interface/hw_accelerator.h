@@ -1,11 +1,31 @@
 #ifndef _HW_ACCEL_H_
 #define _HW_ACCEL_H_
 
+#include "hw_queue.h"
+
+// Descriptor opcode for hw_submit(), the compute command of the wrapper.
+// The key is loaded with cmac_HW_init(), the queue only uploads blocks.
+#define CMAC_HW_OP_NEXT 3  // CMD_COMPUTE_NEXT
+
+// Cycle counters of the wrapper, as returned by CMD_READ_STATS and, for
+// the commands 8 to 15, CMD_READ_STATS_HI. cmd_cycles and cmd_count are
+// indexed by the command code. The counters wrap around and are only
+// cleared by a reset of the FPGA.
+typedef struct {
+	uint32_t state_cycles[16];  // Cycles spent in every state of the wrapper FSM
+	uint32_t cmd_cycles[16];    // Cycles between accepting a command and returning to idle
+	uint32_t cmd_count[16];     // Number of times every command was accepted
+} hw_stats_t;
+
 void init_HW_access(void);
 void customprint(uint32_t *large_number, char *str, int size);
 int check_correctness(uint32_t *expected, uint32_t *calculated, int size);
-void ctr_HW_init(uint32_t *input);
-void ctr_HW_next(uint32_t *input);
-void ctr_HW_finalize(uint32_t *input, uint32_t *output);
+void cmac_HW_init(uint32_t *input);
+void cmac_HW_next(uint32_t *input);
+void cmac_HW_next_pipelined(uint32_t *input, int nblocks);
+void cmac_HW_finalize(uint32_t *input, uint32_t *output);
+void cmac_HW_queue_init(hw_queue_t *q, uint32_t *mem);
+void cmac_HW_read_stats(hw_stats_t *stats);
+void print_HW_stats(hw_stats_t *stats);
 
 #endif
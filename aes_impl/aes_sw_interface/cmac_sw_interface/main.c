@@ -11,7 +11,7 @@ extern uint32_t tc3_key[32],
                 tc5_block0[32],
                 tc5_block1[32],
                 tc5_block2[32],
-                tc5_expected[4],
+                tc5_expected[4];
 //                tc7_key[32],
 //                tc7_block0[32],
 //                tc7_block1[32],
@@ -20,6 +20,7 @@ extern uint32_t tc3_key[32],
 //                tc7_expected[4];
 
 uint32_t output[32];
+hw_stats_t stats;
 
 int main()
 {
@@ -69,6 +70,12 @@ STOP_TIMING
 //	if (check_correctness(output, tc7_expected, 4) != 1) xil_printf("    tc7 test for CMAC correct!\n\r\n\r");
 //	else xil_printf("    tc7 test for CMAC incorrect :(\n\r\n\r");
 
+	// -- Read the cycle counters of the wrapper
+	xil_printf("Cycle counters...\n\r");
+	cmac_HW_read_stats(&stats);
+	print_HW_stats(&stats);
+	xil_printf("\n\r");
+
 	xil_printf("----------- End CMAC test -----------\n\r");
 
 	cleanup_platform();
@@ -8,6 +8,9 @@
 #define CMD_READ    0
 #define CMD_COMPUTE 1
 #define CMD_WRITE   2
+#define CMD_WRITE_PREV (CMD_WRITE | 8)
+#define CMD_READ_STATS 7
+#define CMD_READ_STATS_HI (CMD_READ_STATS | 8)
 
 void init_HW_access(void)
 {
@@ -49,3 +52,92 @@ void ctr_HW(uint32_t *input, uint32_t *output)
 	read_data_from_hw(output);
 	while(!is_done());
 }
+
+// Runs ctr_HW() on nblocks input frames of 32 words. The wrapper computes
+// in the background, so the upload of block i and the download of block
+// i-1 overlap the computation of block i-1 and block i respectively.
+void ctr_HW_pipelined(uint32_t *input, uint32_t *output, int nblocks)
+{
+	int i;
+
+	for (i = 0; i < nblocks; i++) {
+		//// --- Send the read command and transfer input data to FPGA
+		send_cmd_to_hw(CMD_READ);
+		send_data_to_hw(input + 32*i);
+		while(!is_done());
+
+		//// --- Start the compute operation, once the previous block is done
+		send_cmd_to_hw(CMD_COMPUTE);
+		while(!is_done());
+
+		//// --- Transfer the output data of the previous block from FPGA
+		if (i > 0) {
+			send_cmd_to_hw(CMD_WRITE_PREV);
+			read_data_from_hw(output + 32*(i-1));
+			while(!is_done());
+		}
+	}
+
+	//// --- Wait for the last block and transfer its output data from FPGA
+	if (nblocks > 0) {
+		send_cmd_to_hw(CMD_WRITE);
+		read_data_from_hw(output + 32*(nblocks-1));
+		while(!is_done());
+	}
+}
+
+// Descriptor ring in front of the wrapper, see hw_queue.h. The frames of
+// the descriptors are read from and written to mem.
+void ctr_HW_queue_init(hw_queue_t *q, uint32_t *mem)
+{
+	hw_queue_init(q, mem, CMD_READ, CMD_WRITE);
+}
+
+void ctr_HW_read_stats(hw_stats_t *stats)
+{
+	uint32_t frame[32];
+	int i;
+
+	//// --- Send read stats command and transfer the counters from FPGA
+	send_cmd_to_hw(CMD_READ_STATS);
+	read_data_from_hw(frame);
+	while(!is_done());
+
+	for (i = 0; i < 16; i++) stats->state_cycles[i] = frame[i];
+	for (i = 0; i < 8; i++) {
+		stats->cmd_cycles[i] = frame[16+i];
+		stats->cmd_count[i]  = frame[24+i];
+	}
+
+	//// --- Same for the counters of the commands 8 to 15
+	send_cmd_to_hw(CMD_READ_STATS_HI);
+	read_data_from_hw(frame);
+	while(!is_done());
+
+	for (i = 0; i < 8; i++) {
+		stats->cmd_cycles[8+i] = frame[16+i];
+		stats->cmd_count[8+i]  = frame[24+i];
+	}
+}
+
+// Names of the wrapper commands, indexed by the command code
+static const char *cmd_names[16] = {
+	"READ", "COMPUTE", "WRITE", NULL,
+	NULL, NULL, NULL, "READ_STATS",
+	NULL, NULL, "WRITE_PREV", NULL,
+	NULL, NULL, NULL, "READ_STATS_HI"
+};
+
+void print_HW_stats(hw_stats_t *stats)
+{
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		if (stats->state_cycles[i]) xil_printf("    state %d: %u cycles\n\r", i, stats->state_cycles[i]);
+	}
+	for (i = 0; i < 16; i++) {
+		if (!stats->cmd_count[i]) continue;
+		if (cmd_names[i]) xil_printf("    %s: %u times, %u cycles\n\r", cmd_names[i], stats->cmd_count[i], stats->cmd_cycles[i]);
+		else xil_printf("    cmd %d: %u times, %u cycles\n\r", i, stats->cmd_count[i], stats->cmd_cycles[i]);
+	}
+}
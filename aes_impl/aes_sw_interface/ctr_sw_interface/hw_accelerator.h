@@ -1,9 +1,28 @@
 #ifndef _HW_ACCEL_H_
 #define _HW_ACCEL_H_
 
+#include "hw_queue.h"
+
+// Descriptor opcodes for hw_submit(), the compute commands of the wrapper
+#define CTR_HW_OP_COMPUTE 1  // CMD_COMPUTE
+
+// Cycle counters of the wrapper, as returned by CMD_READ_STATS and, for
+// the commands 8 to 15, CMD_READ_STATS_HI. cmd_cycles and cmd_count are
+// indexed by the command code. The counters wrap around and are only
+// cleared by a reset of the FPGA.
+typedef struct {
+	uint32_t state_cycles[16];  // Cycles spent in every state of the wrapper FSM
+	uint32_t cmd_cycles[16];    // Cycles between accepting a command and returning to idle
+	uint32_t cmd_count[16];     // Number of times every command was accepted
+} hw_stats_t;
+
 void init_HW_access(void);
 void customprint(uint32_t *large_number, char *str, int size);
 int check_correctness(uint32_t *expected, uint32_t *calculated, int size);
 void ctr_HW(uint32_t *input, uint32_t *output);
+void ctr_HW_pipelined(uint32_t *input, uint32_t *output, int nblocks);
+void ctr_HW_queue_init(hw_queue_t *q, uint32_t *mem);
+void ctr_HW_read_stats(hw_stats_t *stats);
+void print_HW_stats(hw_stats_t *stats);
 
 #endif
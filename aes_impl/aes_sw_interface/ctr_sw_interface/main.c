@@ -14,6 +14,8 @@ extern uint32_t nist_ctr_128_enc_in0[32],
                 nist_ctr_256_enc_expected1[4];
 
 uint32_t output[32];
+uint32_t inputs[64], outputs[64];
+hw_stats_t stats;
 
 int main()
 {
@@ -61,6 +63,27 @@ STOP_TIMING
 	if (check_correctness(output, nist_ctr_256_enc_expected1, 4) != 1) xil_printf("    Second 256 bit test for CTR-mode correct!\n\r\n\r");
 	else xil_printf("    Second 256 bit test for CTR-mode incorrect :(\n\r\n\r");
 
+	// Both 256 bit blocks with the pipelined call sequence
+	xil_printf("Pipelined 256 bit test...\n\r");
+	for (int i = 0; i < 32; i++) {
+		inputs[i]    = nist_ctr_256_enc_in0[i];
+		inputs[32+i] = nist_ctr_256_enc_in1[i];
+	}
+START_TIMING
+	ctr_HW_pipelined(inputs, outputs, 2);
+STOP_TIMING
+	customprint(outputs, "    Output 0", 32);
+	customprint(outputs + 32, "    Output 1", 32);
+	if ((check_correctness(outputs, nist_ctr_256_enc_expected0, 4) != 1) &&
+	    (check_correctness(outputs + 32, nist_ctr_256_enc_expected1, 4) != 1)) xil_printf("    Pipelined 256 bit test for CTR-mode correct!\n\r\n\r");
+	else xil_printf("    Pipelined 256 bit test for CTR-mode incorrect :(\n\r\n\r");
+
+	// -- Read the cycle counters of the wrapper
+	xil_printf("Cycle counters...\n\r");
+	ctr_HW_read_stats(&stats);
+	print_HW_stats(&stats);
+	xil_printf("\n\r");
+
 	xil_printf("----------- End CTR-mode test -----------\n\r");
 
 	cleanup_platform();
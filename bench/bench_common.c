@@ -0,0 +1,104 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_common.h"
+
+const char *bench_mode_names[BENCH_MODES] = { "enc", "auth", "aead" };
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+	        "usage: %s [-f MHz] [-n reps] [-l min_len] [-L max_len] [-o file.csv] [-H]\n"
+	        "  -f  clock of the measured cycles, used to convert to Gb/s\n"
+	        "  -n  messages per length (at most %d)\n"
+	        "  -l  -L  smallest and largest message length in bytes (%d to %d)\n"
+	        "  -H  do not print the CSV header\n",
+	        prog, BENCH_MAX_REPS, BENCH_MIN_LEN, BENCH_MAX_LEN);
+}
+
+// Parses the options on top of the defaults already in opts
+int bench_parse_args(bench_opts_t *opts, int argc, char **argv)
+{
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-H") == 0) {
+			opts->header = 0;
+			continue;
+		}
+		if ((argv[i][0] != '-') || (argv[i][1] == '\0') || (argv[i][2] != '\0') || (i + 1 >= argc)) {
+			usage(argv[0]);
+			return -1;
+		}
+		switch (argv[i][1]) {
+		case 'f': opts->clock_mhz = atof(argv[++i]); break;
+		case 'n': opts->reps = (uint32_t) atoi(argv[++i]); break;
+		case 'l': opts->min_len = (uint32_t) atoi(argv[++i]); break;
+		case 'L': opts->max_len = (uint32_t) atoi(argv[++i]); break;
+		case 'o':
+			opts->out = fopen(argv[++i], "w");
+			if (opts->out == NULL) {
+				perror(argv[i]);
+				return -1;
+			}
+			break;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
+	}
+
+	if ((opts->clock_mhz <= 0.0) || (opts->reps == 0) || (opts->reps > BENCH_MAX_REPS) ||
+	    (opts->min_len < BENCH_MIN_LEN) || (opts->max_len > BENCH_MAX_LEN) ||
+	    (opts->min_len > opts->max_len)) {
+		usage(argv[0]);
+		return -1;
+	}
+	return 0;
+}
+
+void bench_print_header(const bench_opts_t *opts)
+{
+	if (opts->header)
+		fprintf(opts->out, "impl,cipher,mode,bytes,msgs,clock_mhz,cycles_per_byte,gbps,"
+		                   "lat_p50,lat_p90,lat_p99,lat_max\n");
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+
+	return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of the sorted latencies
+static uint64_t percentile(const uint64_t *sorted, uint32_t n, uint32_t pct)
+{
+	uint32_t rank = (pct * n + 99) / 100;
+
+	return sorted[(rank > 0) ? rank - 1 : 0];
+}
+
+// Writes one CSV row for n messages of len bytes. Latencies are in cycles per
+// message and are sorted in place. Throughput is based on the mean latency.
+void bench_report(const bench_opts_t *opts, const char *impl, const char *cipher, bench_mode_t mode,
+                  uint32_t len, uint64_t *latency, uint32_t n)
+{
+	uint64_t total = 0;
+	double mean;
+	uint32_t i;
+
+	qsort(latency, n, sizeof(latency[0]), cmp_u64);
+	for (i = 0; i < n; i++)
+		total += latency[i];
+	mean = (double) total / n;
+
+	fprintf(opts->out, "%s,%s,%s,%u,%u,%.1f,%.3f,%.4f,%llu,%llu,%llu,%llu\n",
+	        impl, cipher, bench_mode_names[mode], len, n, opts->clock_mhz,
+	        mean / len, 8.0 * len * opts->clock_mhz / (mean * 1000.0),
+	        (unsigned long long) percentile(latency, n, 50),
+	        (unsigned long long) percentile(latency, n, 90),
+	        (unsigned long long) percentile(latency, n, 99),
+	        (unsigned long long) latency[n - 1]);
+	fflush(opts->out);
+}
@@ -0,0 +1,38 @@
+#ifndef _BENCH_COMMON_H_
+#define _BENCH_COMMON_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Message lengths of the sweep: 16 B up to 64 KB in powers of two
+#define BENCH_MIN_LEN  16
+#define BENCH_MAX_LEN  65536
+
+// Upper bound on the number of messages per length
+#define BENCH_MAX_REPS 1000
+
+typedef enum {
+	BENCH_ENC = 0,  // Encryption only
+	BENCH_AUTH,     // Authentication only
+	BENCH_AEAD,     // Encryption and authentication
+	BENCH_MODES
+} bench_mode_t;
+
+// Options shared by the software and the hardware benchmark
+typedef struct {
+	double   clock_mhz;  // Clock of the measured cycles, used for Gb/s
+	uint32_t reps;       // Messages per length
+	uint32_t min_len;
+	uint32_t max_len;
+	int      header;     // Print the CSV header
+	FILE    *out;
+} bench_opts_t;
+
+extern const char *bench_mode_names[BENCH_MODES];
+
+int bench_parse_args(bench_opts_t *opts, int argc, char **argv);
+void bench_print_header(const bench_opts_t *opts);
+void bench_report(const bench_opts_t *opts, const char *impl, const char *cipher, bench_mode_t mode,
+                  uint32_t len, uint64_t *latency, uint32_t n);
+
+#endif
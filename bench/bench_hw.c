@@ -0,0 +1,201 @@
+#include <string.h>
+
+#include "common.h"
+
+#include "bench_common.h"
+#include "hw_accelerator.h"
+
+// Message-length sweep of one accelerator through its hw_accelerator.c
+// driver. The wrapper is selected at compile time with BENCH_AES_TOT,
+// BENCH_SNOWV_GCM or BENCH_ZUC256_TOT; the cosim Makefile sets it from
+// CIPHER. Latencies are in clock cycles of the FPGA design.
+
+// Cycle counter of the platform. The co-simulation counts the clock cycles
+// of the simulated design; on the board, define BENCH_CYCLES() to read a
+// counter that runs at the clock of the accelerator.
+#ifndef BENCH_CYCLES
+#define BENCH_CYCLES() cosim_cycles()
+#endif
+
+#if defined(BENCH_AES_TOT)
+#define BENCH_CIPHER "aes256"
+#elif defined(BENCH_SNOWV_GCM)
+#define BENCH_CIPHER "snowv"
+#elif defined(BENCH_ZUC256_TOT) && defined(BENCH_ZUC_MAC_S)
+// MAC window of the wrapper, set by the cosim Makefile from ZUC_MAC_S
+#define BENCH_STR(x) #x
+#define BENCH_XSTR(x) BENCH_STR(x)
+#define BENCH_CIPHER "zuc256_s" BENCH_XSTR(BENCH_ZUC_MAC_S)
+#elif defined(BENCH_ZUC256_TOT)
+#define BENCH_CIPHER "zuc256"
+#else
+#error "Define BENCH_AES_TOT, BENCH_SNOWV_GCM or BENCH_ZUC256_TOT"
+#endif
+
+static uint8_t msg_in[BENCH_MAX_LEN], msg_out[BENCH_MAX_LEN];
+static uint64_t latency[BENCH_MAX_REPS];
+static uint32_t frame[32], output[32];
+
+// Sets width <= 32 bits of the frame, starting at bit lsb
+static void set_bits(uint32_t *f, uint32_t lsb, uint32_t width, uint32_t value)
+{
+	uint32_t i, bit;
+
+	for (i = 0; i < width; i++) {
+		bit = lsb + i;
+		f[bit >> 5] = (f[bit >> 5] & ~(1u << (bit & 31))) | (((value >> i) & 1u) << (bit & 31));
+	}
+}
+
+#if defined(BENCH_AES_TOT) || defined(BENCH_ZUC256_TOT)
+
+// Copies up to 16 message bytes into the 128-bit block field at bit lsb.
+// The byte order does not change the timing, so the words are taken as is.
+static void set_block(uint32_t *f, uint32_t lsb, const uint8_t *in, uint32_t nbytes)
+{
+	uint32_t w[4] = { 0, 0, 0, 0 };
+	int i;
+
+	memcpy(w, in, nbytes);
+	for (i = 0; i < 4; i++)
+		set_bits(f, lsb + 32*i, 32, w[i]);
+}
+
+#endif
+
+#if defined(BENCH_AES_TOT)
+
+static aes_key_handle_t key_handle;
+
+// The key is expanded once into a round-key slot before the sweep
+static void setup(void)
+{
+	memset(frame, 0, sizeof(frame));
+	set_bits(frame, 136, 1, 1);                  // 256-bit key
+	aes_tot_HW_load_key(&key_handle, 0, frame);
+}
+
+// CTR-mode (enc_auth = 0) or CMAC (enc_auth = 1) over one message,
+// the CTR-mode output is kept in out
+static void aes_pass(int enc_auth, const uint8_t *in, uint8_t *out, uint32_t len)
+{
+	uint32_t nblocks = (len + 15) >> 4, b, last;
+
+	memset(frame, 0, sizeof(frame));
+	set_bits(frame, 521, 1, enc_auth);
+	aes_tot_HW_init_key(&key_handle, frame);
+
+	for (b = 0; b < nblocks; b++) {
+		last = (b == nblocks - 1) ? len - 16*b : 16;
+		set_block(frame, 0, in + 16*b, last);
+		if (b < nblocks - 1) {
+			aes_tot_HW_next(frame, output);
+		} else {
+			set_bits(frame, 128, 8, 8*last);     // final_size in bits
+			aes_tot_HW_finalize(frame, output);
+		}
+		if (!enc_auth) memcpy(out + 16*b, output, last);
+	}
+}
+
+static void one_message(bench_mode_t mode, uint32_t len)
+{
+	if (mode != BENCH_AUTH) aes_pass(0, msg_in, msg_out, len);
+	if (mode != BENCH_ENC)  aes_pass(1, (mode == BENCH_AEAD) ? msg_out : msg_in, NULL, len);
+}
+
+#elif defined(BENCH_SNOWV_GCM)
+
+static snowv_gcm_ctx_t ctx;
+
+static void setup(void) { }
+
+static void one_message(bench_mode_t mode, uint32_t len)
+{
+	memset(frame, 0, sizeof(frame));
+	set_bits(frame, 771, 1, mode == BENCH_ENC);  // encdec_only
+	set_bits(frame, 770, 1, mode == BENCH_AUTH); // auth_only
+	set_bits(frame, 769, 1, 1);                  // encrypt
+	set_bits(frame, 192, 32, 128);               // len_ad: one AD block
+	set_bits(frame, 0, 32, 8*len);               // len_i in bits
+
+	snowv_gcm_HW_start(&ctx, frame);
+	snowv_gcm_HW_process(&ctx, msg_in, msg_out, len);
+	if (mode != BENCH_ENC) snowv_gcm_HW_finalize(output);
+}
+
+#elif defined(BENCH_ZUC256_TOT)
+
+static zuc256_ctx_t ctx;
+
+static void setup(void) { }
+
+// The MAC takes the bit length of a message as the 8-bit i_len of its last
+// block: the total number of message bits less those of the full blocks.
+// It is set per message before init and is in every frame, since the
+// wrapper loads it again with each block.
+static uint32_t zuc_i_len(uint32_t len)
+{
+	uint32_t bits = 8*len;
+
+	return (bits == 0) ? 0 : bits - 128*((bits - 1) >> 7);
+}
+
+static void one_message(bench_mode_t mode, uint32_t len)
+{
+	uint32_t nblocks = (len + 15) >> 4, b;
+	const uint8_t *mac_in = (mode == BENCH_AEAD) ? msg_out : msg_in;
+
+	if (mode != BENCH_AUTH) {
+		memset(frame, 0, sizeof(frame));
+		zuc256_tot_HW_start(&ctx, frame);
+		zuc256_tot_HW_encrypt(&ctx, msg_in, msg_out, len);
+	}
+	if (mode != BENCH_ENC) {
+		memset(frame, 0, sizeof(frame));
+		set_bits(frame, 528, 1, 1);                            // enc_auth
+		set_bits(frame, 8, 8, zuc_i_len(len));                 // i_len
+		set_bits(frame, 0, 8, 128);                            // tag_len
+		zuc256_tot_HW_init(frame);
+		for (b = 0; b < nblocks; b++) {
+			set_block(frame, 16, mac_in + 16*b, (b < nblocks - 1) ? 16 : len - 16*b);
+			zuc256_tot_HW_next(frame, output);
+		}
+		zuc256_tot_HW_finalize(output);
+	}
+}
+
+#endif
+
+int main(int argc, char **argv)
+{
+	bench_opts_t opts = { 100.0, 10, BENCH_MIN_LEN, BENCH_MAX_LEN, 1, NULL };
+	uint32_t m, len, i;
+	uint64_t t0;
+
+	opts.out = stdout;
+	if (bench_parse_args(&opts, argc, argv) != 0) return 1;
+
+	init_platform();
+	init_HW_access();
+
+	for (i = 0; i < BENCH_MAX_LEN; i++)
+		msg_in[i] = (uint8_t) (i * 131 + 7);
+
+	setup();
+	bench_print_header(&opts);
+	for (m = 0; m < BENCH_MODES; m++) {
+		for (len = opts.min_len; len <= opts.max_len; len <<= 1) {
+			for (i = 0; i < opts.reps; i++) {
+				t0 = BENCH_CYCLES();
+				one_message((bench_mode_t) m, len);
+				latency[i] = BENCH_CYCLES() - t0;
+			}
+			bench_report(&opts, "hw", BENCH_CIPHER, (bench_mode_t) m, len, latency, opts.reps);
+		}
+	}
+
+	if (opts.out != stdout) fclose(opts.out);
+	cleanup_platform();
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "bench_common.h"
+#include "sw_engine.h"
+
+// Message-length sweep of the host software engine. Latencies are measured
+// with the time stamp counter, so the default clock is the TSC frequency.
+
+typedef struct {
+	const char  *name;
+	sw_cipher_t  enc;
+	sw_cipher_t  auth;
+} bench_cipher_t;
+
+// SNOW-V-GCM selects the mode with encdec_only/auth_only, the other ciphers
+// run CTR followed by the MAC over the ciphertext for AEAD.
+static const bench_cipher_t ciphers[] = {
+	{ "aes256", SW_AES_CTR,    SW_AES_CMAC   },
+	{ "snowv",  SW_SNOWV_GCM,  SW_SNOWV_GCM  },
+	{ "zuc256", SW_ZUC256_CTR, SW_ZUC256_MAC }
+};
+
+static uint8_t msg_in[BENCH_MAX_LEN], msg_out[BENCH_MAX_LEN], msg_tmp[BENCH_MAX_LEN];
+static uint64_t latency[BENCH_MAX_REPS];
+
+static uint64_t cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+// Frequency of cycles() in MHz, measured against the monotonic clock
+static double cycles_mhz(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	struct timespec t0, t1;
+	uint64_t c0, c1;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	c0 = cycles();
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+	} while ((t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec) < 100000000LL);
+	c1 = cycles();
+	return (double) (c1 - c0) * 1000.0 /
+	       ((t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec));
+#else
+	return 1000.0;
+#endif
+}
+
+static void one_pass(const sw_params_t *params, const uint8_t *in, uint8_t *out, uint32_t len)
+{
+	sw_ctx_t ctx;
+	uint8_t tag[16];
+	size_t n;
+
+	sw_ctx_init(&ctx, params);
+	n = sw_ctx_update(&ctx, in, out, len);
+	sw_ctx_final(&ctx, out + n, tag);
+}
+
+static void one_message(const bench_cipher_t *c, bench_mode_t mode, sw_params_t *params, uint32_t len)
+{
+	if (c->enc == c->auth) {
+		params->cipher = c->enc;
+		params->encdec_only = (mode == BENCH_ENC);
+		params->auth_only = (mode == BENCH_AUTH);
+		one_pass(params, msg_in, msg_out, len);
+		return;
+	}
+	if (mode != BENCH_AUTH) {
+		params->cipher = c->enc;
+		one_pass(params, msg_in, msg_out, len);
+	}
+	if (mode != BENCH_ENC) {
+		params->cipher = c->auth;
+		one_pass(params, (mode == BENCH_AEAD) ? msg_out : msg_in, msg_tmp, len);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	static const uint8_t key[32] = { 0 }, iv[16] = { 0 }, ad[16] = { 0 };
+	bench_opts_t opts = { 0.0, 100, BENCH_MIN_LEN, BENCH_MAX_LEN, 1, stdout };
+	sw_params_t params = { 0 };
+	uint32_t c, m, len, i;
+	uint64_t t0;
+
+	opts.clock_mhz = cycles_mhz();
+	if (bench_parse_args(&opts, argc, argv) != 0) return 1;
+
+	for (i = 0; i < BENCH_MAX_LEN; i++)
+		msg_in[i] = (uint8_t) (i * 131 + 7);
+	params.key = key;
+	params.keylen = 1;
+	params.iv = iv;
+	params.ad = ad;
+	params.ad_len = 16;
+	params.encdec = 1;
+	params.tag_len = 128;
+
+	bench_print_header(&opts);
+	for (c = 0; c < sizeof(ciphers) / sizeof(ciphers[0]); c++) {
+		for (m = 0; m < BENCH_MODES; m++) {
+			for (len = opts.min_len; len <= opts.max_len; len <<= 1) {
+				// One untimed message to warm up the caches and tables
+				one_message(&ciphers[c], (bench_mode_t) m, &params, len);
+				for (i = 0; i < opts.reps; i++) {
+					t0 = cycles();
+					one_message(&ciphers[c], (bench_mode_t) m, &params, len);
+					latency[i] = cycles() - t0;
+				}
+				bench_report(&opts, "sw", ciphers[c].name, (bench_mode_t) m, len, latency, opts.reps);
+			}
+		}
+	}
+
+	if (opts.out != stdout) fclose(opts.out);
+	return 0;
+}
@@ -0,0 +1,193 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer:
+//
+// Create Date:
+// Design Name:
+// Module Name: aes_core
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description: Maps the aes_core instances of ctr_core and cmac_core onto
+//              aes_core_fly for co-simulation. Not needed when the original
+//              aes_core is given with AES_CORE_SRC.
+//
+// Dependencies: aes_core_fly
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments: aes_core keeps its round keys after init, while
+//                      aes_core_fly computes them during the block and
+//                      needs an init before every next. The key is kept
+//                      here and every next is turned into an init of
+//                      aes_core_fly followed by its next. Only encryption
+//                      is supported.
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module aes_core(
+                input wire            clk,
+                input wire            reset_n,
+
+                input wire            encdec,
+                input wire            init,
+                input wire            next,
+                output wire           ready,
+
+                input wire [255 : 0]  key,
+                input wire            keylen,
+
+                input wire [127 : 0]  block,
+                output wire [127 : 0] result,
+                output wire           result_valid
+               );
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  localparam CTRL_IDLE = 2'h0;
+  localparam CTRL_NEXT = 2'h1;
+  localparam CTRL_BUSY = 2'h2;
+
+  //----------------------------------------------------------------
+  // Registers + update variables and write enable.
+  //----------------------------------------------------------------
+  reg [255 : 0] key_reg;
+  reg           keylen_reg;
+  reg           key_we;
+
+  reg [127 : 0] block_reg;
+  reg           block_we;
+
+  reg           valid_reg;
+  reg           valid_new;
+  reg           valid_we;
+
+  reg [1 : 0]   shim_ctrl_reg;
+  reg [1 : 0]   shim_ctrl_new;
+  reg           shim_ctrl_we;
+
+  //----------------------------------------------------------------
+  // Wires.
+  //----------------------------------------------------------------
+  reg            core_init;
+  reg            core_next;
+  wire           core_ready;
+
+  //----------------------------------------------------------------
+  // Concurrent connectivity for ports etc.
+  //----------------------------------------------------------------
+  assign ready        = (shim_ctrl_reg == CTRL_IDLE) && core_ready;
+  assign result_valid = ready && valid_reg;
+
+  //----------------------------------------------------------------
+  // Instantiations.
+  //----------------------------------------------------------------
+  aes_core_fly core(
+                    .clk(clk),
+                    .reset_n(reset_n),
+
+                    .encdec(encdec),
+                    .init(core_init),
+                    .next(core_next),
+                    .ready(core_ready),
+
+                    .key(key_reg),
+                    .keylen(keylen_reg),
+
+                    .block(block_reg),
+                    .result(result),
+                    .result_valid()
+                   );
+
+  //----------------------------------------------------------------
+  // reg_update
+  //
+  // Update functionality for all registers in the core.
+  // All registers are positive edge triggered with asynchronous
+  // active low reset. All registers have write enable.
+  //----------------------------------------------------------------
+  always @ (posedge clk or negedge reset_n)
+    begin: reg_update
+      if (!reset_n)
+        begin
+          key_reg       <= 256'h0;
+          keylen_reg    <= 1'b0;
+          block_reg     <= 128'h0;
+          valid_reg     <= 1'b0;
+          shim_ctrl_reg <= CTRL_IDLE;
+        end
+      else
+        begin
+          if (key_we)
+            begin
+              key_reg    <= key;
+              keylen_reg <= keylen;
+            end
+          if (block_we)
+            block_reg <= block;
+          if (valid_we)
+            valid_reg <= valid_new;
+          if (shim_ctrl_we)
+            shim_ctrl_reg <= shim_ctrl_new;
+        end
+    end // reg_update
+
+  //----------------------------------------------------------------
+  // shim_ctrl
+  //
+  // init only keeps the key, every next restarts the key schedule
+  // of aes_core_fly from it before the block is encrypted.
+  //----------------------------------------------------------------
+  always @*
+    begin: shim_ctrl
+      key_we        = 1'b0;
+      block_we      = 1'b0;
+      valid_new     = 1'b0;
+      valid_we      = 1'b0;
+      core_init     = 1'b0;
+      core_next     = 1'b0;
+      shim_ctrl_new = CTRL_IDLE;
+      shim_ctrl_we  = 1'b0;
+
+      case (shim_ctrl_reg)
+        CTRL_IDLE:
+          if (core_ready)
+            begin
+              if (init)
+                begin
+                  key_we    = 1'b1;
+                  valid_we  = 1'b1;
+                end
+              else if (next)
+                begin
+                  block_we      = 1'b1;
+                  core_init     = 1'b1;
+                  valid_we      = 1'b1;
+                  shim_ctrl_new = CTRL_NEXT;
+                  shim_ctrl_we  = 1'b1;
+                end
+            end
+        CTRL_NEXT:
+          begin
+            core_next     = 1'b1;
+            shim_ctrl_new = CTRL_BUSY;
+            shim_ctrl_we  = 1'b1;
+          end
+        CTRL_BUSY:
+          if (core_ready)
+            begin
+              valid_new     = 1'b1;
+              valid_we      = 1'b1;
+              shim_ctrl_new = CTRL_IDLE;
+              shim_ctrl_we  = 1'b1;
+            end
+        default:
+          begin
+          end
+      endcase
+    end // shim_ctrl
+
+endmodule // aes_core
@@ -0,0 +1,186 @@
+// Verilator implementation of the platform interface. The wrapper selected
+// with CIPHER in the Makefile is clocked from the calls of the driver, so
+// hw_accelerator.c and main.c run unmodified against the RTL. Every call
+// is counted in simulated clock cycles, which are reported per call type
+// by cleanup_platform(). Set COSIM_TRACE=1 to print every call.
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "verilated.h"
+
+#include "cosim_top.h"              // generated by the Makefile for the selected wrapper
+
+#include "common.h"
+#include "platform/interface.h"
+
+// Give up when the wrapper does not answer a handshake within this many cycles
+#define COSIM_TIMEOUT 10000000ULL
+
+enum { CALL_CMD = 0, CALL_SEND, CALL_READ, CALL_DONE, CALLS };
+
+static const char *call_names[CALLS] = { "send_cmd_to_hw", "send_data_to_hw", "read_data_from_hw", "is_done" };
+
+static cosim_top_t *top;
+static uint64_t cycles;
+static uint64_t call_count[CALLS];
+static uint64_t call_cycles[CALLS];
+static uint64_t timing_start;
+static int trace;
+
+static void tick(void)
+{
+	top->clk = 0;
+	top->eval();
+	top->clk = 1;
+	top->eval();
+	cycles++;
+}
+
+static void wait_for(const unsigned char *signal, const char *name)
+{
+	uint64_t start = cycles;
+
+	while (!*signal) {
+		if (cycles - start > COSIM_TIMEOUT) {
+			fprintf(stderr, "cosim: timeout waiting for %s\n", name);
+			exit(1);
+		}
+		tick();
+	}
+}
+
+static void account(int call, uint64_t start)
+{
+	call_count[call]++;
+	call_cycles[call] += cycles - start;
+	if (trace && (call != CALL_DONE)) printf("[cosim] %-18s %8llu cycles\n", call_names[call],
+	                                        (unsigned long long) (cycles - start));
+}
+
+extern "C" {
+
+void init_platform(void)
+{
+	trace = (getenv("COSIM_TRACE") != NULL) && (atoi(getenv("COSIM_TRACE")) != 0);
+}
+
+void init_performance_counters(int reset)
+{
+	if (reset) timing_start = cycles;
+}
+
+void cleanup_platform(void)
+{
+	int i;
+
+	printf("[cosim] %llu cycles in total\n", (unsigned long long) cycles);
+	for (i = 0; i < CALLS; i++)
+		if (call_count[i] > 0)
+			printf("[cosim] %-18s %8llu calls %10llu cycles (%.1f per call)\n", call_names[i],
+			       (unsigned long long) call_count[i], (unsigned long long) call_cycles[i],
+			       (double) call_cycles[i] / call_count[i]);
+	if (top) {
+		top->final();
+		delete top;
+		top = NULL;
+	}
+}
+
+void cosim_timing_start(void)
+{
+	timing_start = cycles;
+}
+
+void cosim_timing_stop(void)
+{
+	printf("[cosim] %llu cycles\n", (unsigned long long) (cycles - timing_start));
+}
+
+uint64_t cosim_cycles(void)
+{
+	return cycles;
+}
+
+void interface_init(void)
+{
+	int i;
+
+	if (top == NULL) top = new cosim_top_t;
+	top->arm_to_fpga_cmd = 0;
+	top->arm_to_fpga_cmd_valid = 0;
+	top->fpga_to_arm_done_read = 0;
+	top->arm_to_fpga_data_valid = 0;
+	top->fpga_to_arm_data_ready = 0;
+	for (i = 0; i < 32; i++)
+		top->arm_to_fpga_data[i] = 0;
+
+	top->resetn = 0;
+	for (i = 0; i < 4; i++)
+		tick();
+	top->resetn = 1;
+	tick();
+}
+
+void send_cmd_to_hw(uint32_t cmd)
+{
+	uint64_t start = cycles;
+
+	top->arm_to_fpga_cmd = cmd;
+	top->arm_to_fpga_cmd_valid = 1;
+	tick();
+	top->arm_to_fpga_cmd_valid = 0;
+	tick();
+	account(CALL_CMD, start);
+}
+
+// Word i of data is bits [32*i + 31 : 32*i] of the 1024-bit bus
+void send_data_to_hw(uint32_t *data)
+{
+	uint64_t start = cycles;
+	int i;
+
+	for (i = 0; i < 32; i++)
+		top->arm_to_fpga_data[i] = data[i];
+	top->arm_to_fpga_data_valid = 1;
+	tick();
+	wait_for(&top->arm_to_fpga_data_ready, "arm_to_fpga_data_ready");
+	top->arm_to_fpga_data_valid = 0;
+	tick();
+	account(CALL_SEND, start);
+}
+
+void read_data_from_hw(uint32_t *data)
+{
+	uint64_t start = cycles;
+	int i;
+
+	top->fpga_to_arm_data_ready = 1;
+	tick();
+	wait_for(&top->fpga_to_arm_data_valid, "fpga_to_arm_data_valid");
+	for (i = 0; i < 32; i++)
+		data[i] = top->fpga_to_arm_data[i];
+	top->fpga_to_arm_data_ready = 0;
+	tick();
+	account(CALL_READ, start);
+}
+
+// One polling step of the driver's while(!is_done()) loop
+int is_done(void)
+{
+	uint64_t start = cycles;
+
+	tick();
+	if (!top->fpga_to_arm_done) {
+		account(CALL_DONE, start);
+		return 0;
+	}
+	top->fpga_to_arm_done_read = 1;
+	tick();
+	top->fpga_to_arm_done_read = 0;
+	tick();
+	account(CALL_DONE, start);
+	return 1;
+}
+
+}
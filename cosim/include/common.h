@@ -0,0 +1,32 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+// Host replacement for the common.h of the PYNQ platform, used when the
+// drivers run against the Verilator model of a wrapper. Times are given
+// in clock cycles of the simulated design.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define xil_printf printf
+
+void init_platform(void);
+void cleanup_platform(void);
+void init_performance_counters(int reset);
+
+void cosim_timing_start(void);
+void cosim_timing_stop(void);
+uint64_t cosim_cycles(void);
+
+#define START_TIMING cosim_timing_start();
+#define STOP_TIMING  cosim_timing_stop();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef _INTERFACE_H_
+#define _INTERFACE_H_
+
+// ARM <-> FPGA interface of the wrappers, implemented on top of the
+// Verilator model in cosim_interface.cpp. Each call drives the wrapper
+// ports the same way as the tasks of the tb_*_wrapper.v testbenches.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void interface_init(void);
+void send_cmd_to_hw(uint32_t cmd);
+void send_data_to_hw(uint32_t *data);
+void read_data_from_hw(uint32_t *data);
+int is_done(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
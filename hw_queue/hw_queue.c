@@ -0,0 +1,179 @@
+#include "common.h"
+#include "platform/interface.h"
+
+#include "hw_queue.h"
+
+// Descriptor ring in front of one wrapper. hw_submit() only queues the
+// descriptors; every hw_poll_completions() runs them through the wrapper
+// until a command is still busy, so the CPU checks the done flag once per
+// call instead of spinning on it after every command.
+//
+// Per frame the queue sends READ, the compute command and then WRITE_PREV
+// for the frame before, so that the upload and download of a frame overlap
+// the computation of its neighbour, as in *_HW_next_pipelined(). The
+// result of the last computed frame is fetched with WRITE once the ring
+// runs empty.
+
+enum { Q_IDLE = 0, Q_READ, Q_COMPUTE, Q_WRITE_PREV, Q_WRITE };
+
+// WRITE_PREV is WRITE with bit 3 set in all wrappers
+#define CMD_WRITE_PREV_BIT 8
+
+void hw_queue_init(hw_queue_t *q, uint32_t *mem, uint32_t cmd_read, uint32_t cmd_write)
+{
+	q->mem = mem;
+	q->cmd_read = cmd_read;
+	q->cmd_write = cmd_write;
+	q->desc_head = q->desc_tail = 0;
+	q->compl_head = q->compl_tail = 0;
+	q->step = Q_IDLE;
+	q->busy = 0;
+	q->frame = 0;
+	q->prev_valid = 0;
+}
+
+// Queues up to n descriptors and returns how many were taken. A slot is
+// only reused once its completion has been polled, so the completion
+// ring never overflows.
+uint32_t hw_submit(hw_queue_t *q, const hw_desc_t *desc, uint32_t n)
+{
+	uint32_t i;
+
+	for (i = 0; i < n; i++) {
+		if (q->desc_head - q->compl_tail == HW_QUEUE_SIZE) break;
+		q->desc[q->desc_head % HW_QUEUE_SIZE] = desc[i];
+		q->desc_head++;
+	}
+	return i;
+}
+
+static void post(hw_queue_t *q, const hw_compl_t *c)
+{
+	q->compl[q->compl_head % HW_QUEUE_SIZE] = *c;
+	q->compl_head++;
+}
+
+// The compute command of the current frame has been accepted: its result
+// becomes the pending one, or the descriptor completes if it has no output
+static void frame_done(hw_queue_t *q)
+{
+	hw_desc_t *d = &q->desc[q->desc_tail % HW_QUEUE_SIZE];
+	hw_compl_t c = { d->ctx, q->desc_tail };
+	uint32_t last = (q->frame + 1 >= d->len);
+
+	if (d->out_off != HW_QUEUE_NONE) {
+		q->prev_valid = 1;
+		q->prev_out = d->out_off + 32*q->frame;
+		q->prev_last = last;
+		q->prev_compl = c;
+	} else if (last) {
+		post(q, &c);
+	}
+
+	q->frame++;
+	if (last) {
+		q->frame = 0;
+		q->desc_tail++;
+	}
+}
+
+// Next command once the previous one is done
+static void next_step(hw_queue_t *q)
+{
+	hw_desc_t *d;
+	hw_compl_t c;
+
+	switch (q->step) {
+	case Q_READ:
+		q->step = Q_COMPUTE;
+		return;
+	case Q_COMPUTE:
+		if (q->prev_valid) {
+			q->step = Q_WRITE_PREV;
+			return;
+		}
+		frame_done(q);
+		break;
+	case Q_WRITE_PREV:
+	case Q_WRITE:
+		q->prev_valid = 0;
+		if (q->prev_last) post(q, &q->prev_compl);
+		if (q->step == Q_WRITE_PREV) frame_done(q);
+		break;
+	default:
+		break;
+	}
+
+	// Empty descriptors complete without touching the wrapper
+	while ((q->desc_tail != q->desc_head) && (q->desc[q->desc_tail % HW_QUEUE_SIZE].len == 0)) {
+		c.ctx = q->desc[q->desc_tail % HW_QUEUE_SIZE].ctx;
+		c.seq = q->desc_tail;
+		post(q, &c);
+		q->desc_tail++;
+	}
+
+	if (q->desc_tail != q->desc_head) {
+		d = &q->desc[q->desc_tail % HW_QUEUE_SIZE];
+		q->step = (d->in_off != HW_QUEUE_NONE) ? Q_READ : Q_COMPUTE;
+	} else if (q->prev_valid)
+		q->step = Q_WRITE;
+	else
+		q->step = Q_IDLE;
+}
+
+static void issue(hw_queue_t *q)
+{
+	hw_desc_t *d = &q->desc[q->desc_tail % HW_QUEUE_SIZE];
+
+	switch (q->step) {
+	case Q_READ:
+		send_cmd_to_hw(q->cmd_read);
+		send_data_to_hw(q->mem + d->in_off + 32*q->frame);
+		break;
+	case Q_COMPUTE:
+		send_cmd_to_hw(d->opcode);
+		break;
+	case Q_WRITE_PREV:
+		send_cmd_to_hw(q->cmd_write | CMD_WRITE_PREV_BIT);
+		read_data_from_hw(q->mem + q->prev_out);
+		break;
+	case Q_WRITE:
+		send_cmd_to_hw(q->cmd_write);
+		read_data_from_hw(q->mem + q->prev_out);
+		break;
+	default:
+		return;
+	}
+	q->busy = 1;
+}
+
+// Advances the queue as far as the wrapper allows without waiting and
+// returns up to max completions, in submission order.
+uint32_t hw_poll_completions(hw_queue_t *q, hw_compl_t *compl, uint32_t max)
+{
+	uint32_t n = 0;
+
+	for (;;) {
+		if (q->busy) {
+			if (!is_done()) break;
+			q->busy = 0;
+			next_step(q);
+		} else if (q->step == Q_IDLE) {
+			next_step(q);
+		}
+		if (q->step == Q_IDLE) break;
+		issue(q);
+	}
+
+	while ((n < max) && (q->compl_tail != q->compl_head)) {
+		compl[n++] = q->compl[q->compl_tail % HW_QUEUE_SIZE];
+		q->compl_tail++;
+	}
+	return n;
+}
+
+// No descriptor is queued or running and all completions have been polled
+int hw_queue_idle(const hw_queue_t *q)
+{
+	return (q->step == Q_IDLE) && (q->desc_tail == q->desc_head) && (q->compl_tail == q->compl_head);
+}
@@ -0,0 +1,62 @@
+#ifndef _HW_QUEUE_H_
+#define _HW_QUEUE_H_
+
+#include <stdint.h>
+
+// Descriptor ring walked by the driver, see hw_queue.c. The wrapper
+// cannot fetch descriptors itself, so the CPU still issues every command:
+// the ring only makes progress inside hw_poll_completions(), which must be
+// called until all completions have been returned.
+
+// Entries of the descriptor and of the completion ring, a power of two
+#define HW_QUEUE_SIZE 64
+
+// Offset of a descriptor without input or output frames
+#define HW_QUEUE_NONE 0xffffffffu
+
+// One command of the wrapper on len frames of 32 words. Frame i is
+// uploaded from mem + in_off + 32*i, computed with opcode and its result
+// is stored at mem + out_off + 32*i.
+typedef struct {
+	uint32_t opcode;   // Compute command of the wrapper, e.g. CTR_HW_OP_COMPUTE
+	uint32_t ctx;      // Returned in the completion, identifies the message
+	uint32_t in_off;   // Word offset of the input frames, or HW_QUEUE_NONE
+	uint32_t out_off;  // Word offset of the output frames, or HW_QUEUE_NONE
+	uint32_t len;      // Number of frames
+} hw_desc_t;
+
+// Posted when the last frame of a descriptor has been computed and, if it
+// has an output, read back into mem
+typedef struct {
+	uint32_t ctx;
+	uint32_t seq;      // Position of the descriptor in the submission order
+} hw_compl_t;
+
+typedef struct {
+	uint32_t   *mem;        // Frames referenced by the descriptors
+	uint32_t    cmd_read;   // Command that uploads an input frame
+	uint32_t    cmd_write;  // Command that waits for and returns the result
+
+	hw_desc_t   desc[HW_QUEUE_SIZE];
+	hw_compl_t  compl[HW_QUEUE_SIZE];
+	uint32_t    desc_head, desc_tail;    // Free-running ring indices
+	uint32_t    compl_head, compl_tail;
+
+	// Execution state of the descriptor at desc_tail
+	uint32_t    step;
+	uint32_t    busy;       // A command is waiting for its done
+	uint32_t    frame;
+
+	// Frame whose result is still in the wrapper, see hw_queue.c
+	uint32_t    prev_valid;
+	uint32_t    prev_out;
+	uint32_t    prev_last;
+	hw_compl_t  prev_compl;
+} hw_queue_t;
+
+void hw_queue_init(hw_queue_t *q, uint32_t *mem, uint32_t cmd_read, uint32_t cmd_write);
+uint32_t hw_submit(hw_queue_t *q, const hw_desc_t *desc, uint32_t n);
+uint32_t hw_poll_completions(hw_queue_t *q, hw_compl_t *compl, uint32_t max);
+int hw_queue_idle(const hw_queue_t *q);
+
+#endif
@@ -20,7 +20,7 @@
 
 `default_nettype none
 
-module ghash(
+module ghash #(parameter MULH_IMPL = 0)(
            input wire            clk,
            input wire            reset_n,
            
@@ -85,21 +85,62 @@ module ghash(
   //----------------------------------------------------------------
   // Instantiations.
   //----------------------------------------------------------------
-  mulH mulH(
-            .clk(clk),
-            .reset_n(reset_n),
-    
-            .start(mulH_start),
-            .H(mulH_H),    
-            .block_i(mulH_in),
-            
-            .block_o(mulH_out),
-            .ready(mulH_ready)
-            );
+  // MULH_IMPL: 0 = bit-serial mulH, 1 = single-cycle Karatsuba,
+  // 2 = 2-stage pipelined Karatsuba
+  generate
+    if (MULH_IMPL == 0)
+      begin : mulH_gen
+        mulH mulH(
+                  .clk(clk),
+                  .reset_n(reset_n),
+          
+                  .start(mulH_start),
+                  .H(mulH_H),    
+                  .block_i(mulH_in),
+                  
+                  .block_o(mulH_out),
+                  .ready(mulH_ready)
+                  );
+      end
+    else
+      begin : mulH_kara_gen
+        // mulH_kara uses the GCM bit order, which is the reverse of mulH
+        wire [127 : 0] kara_out;
+        
+        mulH_kara #(.PIPELINED(MULH_IMPL == 2)) mulH_kara(
+                  .clk(clk),
+                  .reset_n(reset_n),
+          
+                  .start(mulH_start),
+                  .derive(1'b0),
+                  .H(reverse_bits(mulH_H)),    
+                  .block_i(reverse_bits(mulH_in)),
+                  .power(2'h0),
+                  .accumulate(1'b0),
+                  
+                  .ctx_load(1'b0),
+                  .ctx_i(639'h0),
+                  .ctx_o(),
+                  
+                  .block_o(kara_out),
+                  .ready(mulH_ready)
+                  );
+        
+        assign mulH_out = reverse_bits(kara_out);
+      end
+  endgenerate
     
   //----------------------------------------------------------------
   // Concurrent connectivity for ports etc.
   //----------------------------------------------------------------
+  function [127 : 0] reverse_bits(input [127 : 0] in);
+    integer i;
+    begin
+      for (i = 0; i < 128; i = i + 1)
+        reverse_bits[i] = in[127 - i];
+    end
+  endfunction
+  
   assign mulH_H = H;
   assign X      = X_reg;
   assign ready  = ready_reg; 
@@ -20,10 +20,11 @@
 
 `default_nettype none
 
-module ghash_alt(
+module ghash_alt #(parameter MULH_IMPL = 0, parameter AGGREGATE = 0)(
            input wire            clk,
            input wire            reset_n,
            
+           input wire            derive_h,  // precompute H^2..H^4 when H changes (AGGREGATE only)
            input wire            first_init,
            input wire            init,
            input wire            next_no_ad,
@@ -36,6 +37,10 @@ module ghash_alt(
            input wire [127 : 0]  block_i,
            input wire [63 : 0]   len_i,
            
+           input wire            ctx_load,  // Load X, the phase and the state of mulH from ctx_i, only when idle
+           input wire [768 : 0]  ctx_i,
+           output wire [768 : 0] ctx_o,
+           
            output wire [127 : 0] X,
            output wire           ready
           );
@@ -50,6 +55,7 @@ module ghash_alt(
   localparam CTRL_NEXT   = 3'h4;
   localparam CTRL_FFINAL = 3'h5;
   localparam CTRL_FINAL  = 3'h6;
+  localparam CTRL_DERIVE = 3'h7;
   
   //----------------------------------------------------------------
   // Registers + update variables and write enable.
@@ -66,36 +72,83 @@ module ghash_alt(
   reg [127 : 0] X_new;
   reg           X_we;
   
+  // Remaining blocks of the message minus one, modulo 4
+  reg [1 : 0]   phase_reg;
+  reg [1 : 0]   phase_new;
+  reg           phase_we;
+  
+  reg           ctx_we;
+  
   //----------------------------------------------------------------
   // Wires.
   //----------------------------------------------------------------
   
   // Connections with instantiations.
   reg            mulH_start;
+  reg            mulH_derive;
+  wire [1 : 0]   mulH_power;
+  wire           mulH_accumulate;
   wire [127 : 0] mulH_H;
   reg [127 : 0]  mulH_in;
   wire [127 : 0] mulH_out;
   wire           mulH_ready;
+  wire [638 : 0] mulH_ctx_o;
   
   // Other control signals
   wire           loading;
   wire           initializing;
   wire           continuing;
+  
+  // Number of AD and payload blocks, modulo 4
+  wire [63 : 0]  len_ad_up;
+  wire [63 : 0]  len_i_up;
+  wire [1 : 0]   phase_first;
     
   //----------------------------------------------------------------
   // Instantiations.
   //----------------------------------------------------------------
-  mulH_fast mulH_fast(
-            .clk(clk),
-            .reset_n(reset_n),
-    
-            .start(mulH_start),
-            .H(mulH_H),    
-            .block_i(mulH_in),
-            
-            .block_o(mulH_out),
-            .ready(mulH_ready)
-            );
+  // MULH_IMPL: 0 = mulH_fast (32 bits per cycle), 1 = single-cycle
+  // Karatsuba, 2 = 2-stage pipelined Karatsuba. AGGREGATE needs 1 or 2.
+  generate
+    if (MULH_IMPL == 0)
+      begin : mulH_fast_gen
+        mulH_fast mulH_fast(
+                  .clk(clk),
+                  .reset_n(reset_n),
+          
+                  .start(mulH_start),
+                  .H(mulH_H),    
+                  .block_i(mulH_in),
+                  
+                  .block_o(mulH_out),
+                  .ready(mulH_ready)
+                  );
+        
+        // mulH_fast keeps nothing between blocks
+        assign mulH_ctx_o = 639'h0;
+      end
+    else
+      begin : mulH_kara_gen
+        mulH_kara #(.PIPELINED(MULH_IMPL == 2), .AGGREGATE(AGGREGATE)) mulH_kara(
+                  .clk(clk),
+                  .reset_n(reset_n),
+          
+                  .start(mulH_start),
+                  .derive(mulH_derive),
+                  .H(mulH_H),    
+                  .block_i(mulH_in),
+                  .power(mulH_power),
+                  .accumulate(mulH_accumulate),
+                  
+                  .ctx_load(ctx_load),
+                  .ctx_i(ctx_i[638 : 0]),
+                  .ctx_o(mulH_ctx_o),
+                  
+                  .block_o(mulH_out),
+                  .ready(mulH_ready)
+                  );
+      end
+  endgenerate
     
   //----------------------------------------------------------------
   // Concurrent connectivity for ports etc.
@@ -122,8 +175,19 @@ module ghash_alt(
   endfunction
   
   assign mulH_H = reverse_byte_order(H);
+  
+  // With AGGREGATE, block i of a message of n blocks (including the length
+  // block) is multiplied by H^(((n - 1 - i) mod 4) + 1), and the sum is only
+  // reduced at the last block of every group of four. The lengths therefore
+  // have to be valid from the first block on.
+  assign len_ad_up       = len_ad + 64'd127;
+  assign len_i_up        = len_i + 64'd127;
+  assign phase_first     = len_ad_up[8 : 7] + len_i_up[8 : 7];
+  assign mulH_power      = phase_reg;
+  assign mulH_accumulate = AGGREGATE && (phase_reg != 2'h0);
   assign X      = X_reg;
   assign ready  = ready_reg; 
+  assign ctx_o  = {phase_reg, X_reg, mulH_ctx_o};
     
   //----------------------------------------------------------------
   // reg_update
@@ -139,6 +203,7 @@ module ghash_alt(
           ghash_ctrl_reg   <= CTRL_IDLE;
           ready_reg        <= 1'b0;
           X_reg            <= 128'b0;
+          phase_reg        <= 2'h0;
         end
       else
         begin
@@ -148,6 +213,13 @@ module ghash_alt(
             ready_reg <= ready_new;
           if (X_we)
               X_reg <= X_new;
+          if (phase_we)
+            phase_reg <= phase_new;
+          if (ctx_we)
+            begin
+              X_reg     <= ctx_i[766 : 639];
+              phase_reg <= ctx_i[768 : 767];
+            end
         end
     end // reg_update
     
@@ -176,6 +248,11 @@ module ghash_alt(
           mulH_in = reverse_byte_order(X_reg) ^ {len_ad, len_i};
           X_new   = reverse_byte_order(mulH_out);
         end
+      
+      // Within a group, X is cleared so that the next block enters
+      // without it. X is added to the first block of every group.
+      if (mulH_accumulate)
+        X_new = 128'h0;
     end
         
   //----------------------------------------------------------------
@@ -190,14 +267,26 @@ module ghash_alt(
       ready_new        = 1'b0;
       ready_we         = 1'b0;
       X_we             = 1'b0;
+      phase_new        = phase_reg - 2'h1;
+      phase_we         = 1'b0;
       mulH_start       = 1'b0;
+      mulH_derive      = 1'b0;
+      ctx_we           = 1'b0;
       
       case (ghash_ctrl_reg)
         CTRL_IDLE:
           begin
             ready_new        = 1'b0;
             ready_we         = 1'b1;
-            if (first_init)
+            if (ctx_load)
+              ctx_we         = 1'b1;
+            if (derive_h && AGGREGATE)
+              begin
+                ghash_ctrl_new = CTRL_DERIVE;
+                ghash_ctrl_we  = 1'b1;
+                mulH_derive    = 1'b1;
+              end
+            else if (first_init)
               begin
                 ghash_ctrl_new = CTRL_FINIT;
                 ghash_ctrl_we  = 1'b1;
@@ -237,6 +326,8 @@ module ghash_alt(
               ghash_ctrl_we    = 1'b1;
               X_we             = 1'b1;
               mulH_start       = 1'b1;
+              phase_new        = phase_first;
+              phase_we         = 1'b1;
             end
         CTRL_INIT:
           begin
@@ -247,6 +338,7 @@ module ghash_alt(
                 ready_new      = 1'b1;
                 ready_we       = 1'b1;
                 X_we           = 1'b1;
+                phase_we       = 1'b1;
               end
           end
         CTRL_FNEXT:
@@ -255,6 +347,8 @@ module ghash_alt(
             ghash_ctrl_we  = 1'b1;
             X_we           = 1'b1;
             mulH_start     = 1'b1;
+            phase_new      = phase_first;
+            phase_we       = 1'b1;
           end
         CTRL_NEXT:
           begin
@@ -265,6 +359,7 @@ module ghash_alt(
                 ready_new      = 1'b1;
                 ready_we       = 1'b1;
                 X_we           = 1'b1;
+                phase_we       = 1'b1;
               end
           end
         CTRL_FFINAL:
@@ -273,6 +368,8 @@ module ghash_alt(
             ghash_ctrl_we  = 1'b1;
             X_we           = 1'b1;
             mulH_start     = 1'b1;
+            phase_new      = phase_first;
+            phase_we       = 1'b1;
           end
         CTRL_FINAL:
           begin
@@ -283,6 +380,17 @@ module ghash_alt(
                 ready_new      = 1'b1;
                 ready_we       = 1'b1;
                 X_we           = 1'b1;
+                phase_we       = 1'b1;
+              end
+          end
+        CTRL_DERIVE:
+          begin
+            if (mulH_ready)
+              begin
+                ghash_ctrl_new = CTRL_IDLE;
+                ghash_ctrl_we  = 1'b1;
+                ready_new      = 1'b1;
+                ready_we       = 1'b1;
               end
           end
         default: 
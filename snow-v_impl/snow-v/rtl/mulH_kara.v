@@ -0,0 +1,417 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer:
+//
+// Create Date:
+// Design Name:
+// Module Name: mulH_kara
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description: Full-width GF(2^128) multiplier for GHASH, with the same bit
+//              order and start/ready interface as mulH_fast. The 128x128
+//              carry-less product is split into three 64x64 products
+//              (Karatsuba) and reduced modulo x^128 + x^7 + x^2 + x + 1.
+//              PIPELINED = 0 computes a block in a single cycle,
+//              PIPELINED = 1 registers the three partial products and
+//              combines and reduces them in a second cycle.
+//
+//              With AGGREGATE = 1, derive precomputes H^2, H^3 and H^4, and
+//              every block is multiplied by H^(power + 1). While accumulate
+//              is set, the unreduced product is added to an accumulator and
+//              block_o is left as is. The first block with accumulate low
+//              reduces the accumulated sum into block_o. This absorbs up to
+//              four blocks per reduction:
+//                (X ^ B1).H^4 ^ B2.H^3 ^ B3.H^2 ^ B4.H
+//
+// Dependencies:
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments: block_i, power and accumulate are sampled in the
+//                      cycle after start, and have to be kept stable until
+//                      ready.
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module mulH_kara #(parameter PIPELINED = 0, parameter AGGREGATE = 0)(
+           input wire            clk,
+           input wire            reset_n,
+
+           input wire            start,
+           input wire            derive,     // Precompute H^2..H^4 (AGGREGATE only)
+           input wire [127 : 0]  H,
+           input wire [127 : 0]  block_i,
+           input wire [1 : 0]    power,      // Multiply by H^(power + 1) (AGGREGATE only)
+           input wire            accumulate, // Do not reduce yet (AGGREGATE only)
+
+           input wire            ctx_load,   // Load the accumulator and H^2..H^4 from ctx_i, only when idle
+           input wire [638 : 0]  ctx_i,
+           output wire [638 : 0] ctx_o,
+
+           output wire [127 : 0] block_o,
+           output wire           ready
+          );
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  localparam CTRL_IDLE        = 3'h0;
+  localparam CTRL_LOAD        = 3'h1;
+  localparam CTRL_COMP        = 3'h2;
+  localparam CTRL_DERIVE      = 3'h3;
+  localparam CTRL_DERIVE_COMP = 3'h4;
+
+  //----------------------------------------------------------------
+  // Registers + update variables and write enable.
+  //----------------------------------------------------------------
+  reg [2 : 0]    mulH_ctrl_reg;
+  reg [2 : 0]    mulH_ctrl_new;
+  reg            mulH_ctrl_we;
+
+  reg            ready_reg;
+  reg            ready_new;
+  reg            ready_we;
+
+  reg [127 : 0]  Z_reg;
+  reg [127 : 0]  Z_new;
+  reg            Z_we;
+
+  reg [254 : 0]  acc_reg;
+  reg [254 : 0]  acc_new;
+  reg            acc_we;
+
+  reg [126 : 0]  lo_reg;
+  reg [126 : 0]  mid_reg;
+  reg [126 : 0]  hi_reg;
+  reg            partial_we;
+
+  reg [127 : 0]  H2_reg;
+  reg [127 : 0]  H3_reg;
+  reg [127 : 0]  H4_reg;
+  reg            Hpow_we;
+
+  reg            ctx_we;
+
+  reg [1 : 0]    step_reg;
+  reg [1 : 0]    step_new;
+  reg            step_we;
+  reg            step_inc;
+  reg            step_rst;
+
+  //----------------------------------------------------------------
+  // Wires.
+  //----------------------------------------------------------------
+  reg [127 : 0]  op_a;
+  reg [127 : 0]  op_b;
+  reg [126 : 0]  lo;
+  reg [126 : 0]  mid;
+  reg [126 : 0]  hi;
+  reg [254 : 0]  prod;
+
+  //----------------------------------------------------------------
+  // Functions.
+  //
+  // The operands use the GCM bit order (bit 127 is the coefficient
+  // of x^0), so they are bit reversed around the polynomial logic.
+  //----------------------------------------------------------------
+  function [127 : 0] reverse_bits(input [127 : 0] in);
+    integer i;
+    begin
+      for (i = 0; i < 128; i = i + 1)
+        reverse_bits[i] = in[127 - i];
+    end
+  endfunction
+
+  function [126 : 0] clmul64(input [63 : 0] a, input [63 : 0] b);
+    integer i;
+    begin
+      clmul64 = 127'h0;
+      for (i = 0; i < 64; i = i + 1)
+        if (b[i])
+          clmul64 = clmul64 ^ ({63'h0, a} << i);
+    end
+  endfunction
+
+  function [254 : 0] karatsuba(input [126 : 0] p_lo, input [126 : 0] p_mid, input [126 : 0] p_hi);
+    reg [126 : 0] m;
+    begin
+      m = p_mid ^ p_lo ^ p_hi;
+      karatsuba = {128'h0, p_lo} ^ {64'h0, m, 64'h0} ^ {p_hi, 128'h0};
+    end
+  endfunction
+
+  function [127 : 0] reduce(input [254 : 0] p);
+    reg [254 : 0] t;
+    integer i;
+    begin
+      t = p;
+      for (i = 254; i >= 128; i = i - 1)
+        if (t[i])
+          begin
+            t[i - 121] = !t[i - 121];
+            t[i - 126] = !t[i - 126];
+            t[i - 127] = !t[i - 127];
+            t[i - 128] = !t[i - 128];
+          end
+      reduce = t[127 : 0];
+    end
+  endfunction
+
+  //----------------------------------------------------------------
+  // Concurrent connectivity for ports etc.
+  //----------------------------------------------------------------
+  assign block_o = Z_reg;
+  assign ready   = ready_reg;
+  assign ctx_o   = {H4_reg, H3_reg, H2_reg, acc_reg};
+
+  //----------------------------------------------------------------
+  // reg_update
+  //
+  // Update functionality for all registers in the core.
+  // All registers are positive edge triggered with asynchronous
+  // active low reset. All registers have write enable.
+  //----------------------------------------------------------------
+  always @ (posedge clk or negedge reset_n)
+    begin: reg_update
+      if (!reset_n)
+        begin
+          mulH_ctrl_reg <= CTRL_IDLE;
+          ready_reg     <= 1'b0;
+          Z_reg         <= 128'h0;
+          acc_reg       <= 255'h0;
+          lo_reg        <= 127'h0;
+          mid_reg       <= 127'h0;
+          hi_reg        <= 127'h0;
+          H2_reg        <= 128'h0;
+          H3_reg        <= 128'h0;
+          H4_reg        <= 128'h0;
+          step_reg      <= 2'h0;
+        end
+      else
+        begin
+          if (mulH_ctrl_we)
+            mulH_ctrl_reg <= mulH_ctrl_new;
+          if (ready_we)
+            ready_reg <= ready_new;
+          if (Z_we)
+            Z_reg <= Z_new;
+          if (acc_we)
+            acc_reg <= acc_new;
+          if (partial_we)
+            begin
+              lo_reg  <= lo;
+              mid_reg <= mid;
+              hi_reg  <= hi;
+            end
+          if (Hpow_we)
+            case (step_reg)
+              2'h0: H2_reg <= reverse_bits(reduce(prod));
+              2'h1: H3_reg <= reverse_bits(reduce(prod));
+              default: H4_reg <= reverse_bits(reduce(prod));
+            endcase
+          if (step_we)
+            step_reg <= step_new;
+
+          if (ctx_we)
+            begin
+              acc_reg <= ctx_i[254 : 0];
+              H2_reg  <= ctx_i[382 : 255];
+              H3_reg  <= ctx_i[510 : 383];
+              H4_reg  <= ctx_i[638 : 511];
+            end
+        end
+    end // reg_update
+
+  //----------------------------------------------------------------
+  // mulH Logic
+  //
+  // Operand selection, the three 64x64 products and their
+  // combination into the 255-bit carry-less product.
+  //----------------------------------------------------------------
+  always @*
+    begin : mulH_logic
+      reg [127 : 0] a, b;
+
+      if ((mulH_ctrl_reg == CTRL_DERIVE) || (mulH_ctrl_reg == CTRL_DERIVE_COMP))
+        begin
+          // H^2 = H.H, H^3 = H^2.H, H^4 = H^2.H^2
+          op_a = (step_reg == 2'h0) ? H : H2_reg;
+          op_b = (step_reg == 2'h2) ? H2_reg : H;
+        end
+      else
+        begin
+          op_a = block_i;
+          if (AGGREGATE)
+            case (power)
+              2'h0: op_b = H;
+              2'h1: op_b = H2_reg;
+              2'h2: op_b = H3_reg;
+              default: op_b = H4_reg;
+            endcase
+          else
+            op_b = H;
+        end
+
+      a   = reverse_bits(op_a);
+      b   = reverse_bits(op_b);
+      lo  = clmul64(a[63 : 0], b[63 : 0]);
+      hi  = clmul64(a[127 : 64], b[127 : 64]);
+      mid = clmul64(a[63 : 0] ^ a[127 : 64], b[63 : 0] ^ b[127 : 64]);
+
+      if (PIPELINED)
+        prod = karatsuba(lo_reg, mid_reg, hi_reg);
+      else
+        prod = karatsuba(lo, mid, hi);
+
+      // The accumulator is cleared when the powers of a new H are derived
+      if (AGGREGATE && accumulate && (mulH_ctrl_reg != CTRL_IDLE))
+        begin
+          acc_new = acc_reg ^ prod;
+          Z_new   = Z_reg;
+        end
+      else
+        begin
+          acc_new = 255'h0;
+          Z_new   = reverse_bits(reduce(acc_reg ^ prod));
+        end
+    end // mulH_logic
+
+  //----------------------------------------------------------------
+  // step
+  //----------------------------------------------------------------
+  always @*
+    begin : step
+      step_new = 2'h0;
+      step_we  = 1'b0;
+      if (step_rst)
+        begin
+          step_new = 2'h0;
+          step_we  = 1'b1;
+        end
+      else if (step_inc)
+        begin
+          step_new = step_reg + 2'h1;
+          step_we  = 1'b1;
+        end
+    end // step
+
+  //----------------------------------------------------------------
+  // mulH_ctrl
+  //
+  // Control FSM for mulH_kara.
+  //----------------------------------------------------------------
+  always @*
+    begin: mulH_ctrl
+      ready_new     = 1'b0;
+      ready_we      = 1'b0;
+      mulH_ctrl_new = CTRL_IDLE;
+      mulH_ctrl_we  = 1'b0;
+      Z_we          = 1'b0;
+      acc_we        = 1'b0;
+      partial_we    = 1'b0;
+      Hpow_we       = 1'b0;
+      step_rst      = 1'b0;
+      step_inc      = 1'b0;
+      ctx_we        = 1'b0;
+
+      case (mulH_ctrl_reg)
+        CTRL_IDLE:
+          begin
+            ready_new = 1'b0;
+            ready_we  = 1'b1;
+            if (ctx_load)
+              ctx_we = 1'b1;
+
+            if (start)
+              begin
+                mulH_ctrl_new = CTRL_LOAD;
+                mulH_ctrl_we  = 1'b1;
+              end
+            else if (derive && AGGREGATE)
+              begin
+                mulH_ctrl_new = CTRL_DERIVE;
+                mulH_ctrl_we  = 1'b1;
+                acc_we        = 1'b1;
+                step_rst      = 1'b1;
+              end
+          end
+        CTRL_LOAD:
+          begin
+            if (PIPELINED)
+              begin
+                partial_we    = 1'b1;
+                mulH_ctrl_new = CTRL_COMP;
+                mulH_ctrl_we  = 1'b1;
+              end
+            else
+              begin
+                Z_we          = 1'b1;
+                acc_we        = 1'b1;
+                mulH_ctrl_new = CTRL_IDLE;
+                mulH_ctrl_we  = 1'b1;
+                ready_new     = 1'b1;
+                ready_we      = 1'b1;
+              end
+          end
+        CTRL_COMP:
+          begin
+            Z_we          = 1'b1;
+            acc_we        = 1'b1;
+            mulH_ctrl_new = CTRL_IDLE;
+            mulH_ctrl_we  = 1'b1;
+            ready_new     = 1'b1;
+            ready_we      = 1'b1;
+          end
+        CTRL_DERIVE:
+          begin
+            if (PIPELINED)
+              begin
+                partial_we    = 1'b1;
+                mulH_ctrl_new = CTRL_DERIVE_COMP;
+                mulH_ctrl_we  = 1'b1;
+              end
+            else
+              begin
+                Hpow_we = 1'b1;
+                if (step_reg == 2'h2)
+                  begin
+                    mulH_ctrl_new = CTRL_IDLE;
+                    mulH_ctrl_we  = 1'b1;
+                    step_rst      = 1'b1;
+                    ready_new     = 1'b1;
+                    ready_we      = 1'b1;
+                  end
+                else
+                  step_inc = 1'b1;
+              end
+          end
+        CTRL_DERIVE_COMP:
+          begin
+            Hpow_we = 1'b1;
+            if (step_reg == 2'h2)
+              begin
+                mulH_ctrl_new = CTRL_IDLE;
+                mulH_ctrl_we  = 1'b1;
+                step_rst      = 1'b1;
+                ready_new     = 1'b1;
+                ready_we      = 1'b1;
+              end
+            else
+              begin
+                step_inc      = 1'b1;
+                mulH_ctrl_new = CTRL_DERIVE;
+                mulH_ctrl_we  = 1'b1;
+              end
+          end
+        default:
+          begin
+
+          end
+        endcase // case (mulH_ctrl_reg)
+
+      end // mulH_ctrl
+
+endmodule // mulH_kara
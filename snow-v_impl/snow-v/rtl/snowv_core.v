@@ -30,6 +30,10 @@ module snowv_core(
            input wire [255 : 0]  key,
            input wire [127 : 0]  iv,
            
+           input wire            ctx_load,  // Load the LFSRs and the FSM from ctx_i, only when idle
+           input wire [895 : 0]  ctx_i,
+           output wire [895 : 0] ctx_o,
+           
            output wire [127 : 0] keystream_z,
            output wire           ready
           );
@@ -88,6 +92,8 @@ module snowv_core(
   
   reg           fsm_we;
   
+  reg           ctx_we;
+  
   // Counter to count the number of cycles
   reg [7 : 0]   counter_reg;
   reg [7 : 0]   counter_new;
@@ -156,6 +162,9 @@ module snowv_core(
   assign ready         = ready_reg; 
   assign aes_round_key = 128'h0; // Key is always set to zero
   assign keystream_z   = z_reg;
+  assign ctx_o         = {R3b_reg, R3a_reg, R2b_reg, R2a_reg, R1b_reg, R1a_reg,
+                          lfsr_b_reg[3], lfsr_b_reg[2], lfsr_b_reg[1], lfsr_b_reg[0],
+                          lfsr_a_reg[3], lfsr_a_reg[2], lfsr_a_reg[1], lfsr_a_reg[0]};
     
   //----------------------------------------------------------------
   // reg_update
@@ -214,6 +223,20 @@ module snowv_core(
             counter_reg <= counter_new;
           if (came_from_init_we)
             came_from_init_reg <= came_from_init_new;
+          if (ctx_we)
+            begin
+              for (i = 0 ; i < 4 ; i = i + 1)
+                begin
+                  lfsr_a_reg [i] <= ctx_i[64 * i +: 64];
+                  lfsr_b_reg [i] <= ctx_i[256 + 64 * i +: 64];
+                end
+              R1a_reg <= ctx_i[575 : 512];
+              R1b_reg <= ctx_i[639 : 576];
+              R2a_reg <= ctx_i[703 : 640];
+              R2b_reg <= ctx_i[767 : 704];
+              R3a_reg <= ctx_i[831 : 768];
+              R3b_reg <= ctx_i[895 : 832];
+            end
         end
     end // reg_update
     
@@ -465,6 +488,7 @@ module snowv_core(
       R1_load_key        = 2'b00;
       came_from_init_new = 1'b0;
       came_from_init_we  = 1'b0;
+      ctx_we             = 1'b0;
       
       case (snowv_ctrl_reg)
         CTRL_IDLE:
@@ -486,6 +510,8 @@ module snowv_core(
                 snowv_ctrl_we  = 1'b1;
                 aes_round_start = 1'b1;
               end
+            else if (ctx_load)
+              ctx_we = 1'b1;
           end
         CTRL_LOAD:
           begin
@@ -8,9 +8,13 @@
 // Project Name: 
 // Target Devices: 
 // Tool Versions: 
-// Description: 
+// Description: SNOW-V-GCM. Encryption/decryption and authentication run
+//              decoupled: every processed block is pushed into a small
+//              FIFO that GHASH drains on its own, so that ready for the next
+//              block only depends on the keystream and on FIFO space.
+//              finalize waits until the FIFO is empty.
 // 
-// Dependencies: 
+// Dependencies: snowv_core, snowv_ks_fifo, ghash_alt
 // 
 // Revision:
 // Revision 0.01 - File Created
@@ -20,7 +24,7 @@
 
 `default_nettype none
 
-module snowv_gcm(
+module snowv_gcm #(parameter GHASH_MULH = 2, parameter GHASH_AGGREGATE = 1, parameter CT_FIFO_BITS = 2, parameter KS_PREFETCH = 1, parameter KS_FIFO_BITS = 1)(
            input wire            clk,
            input wire            reset_n,
            
@@ -39,6 +43,11 @@ module snowv_gcm(
            input wire [127 : 0]  block_i,
            input wire [63 : 0]   len_i,
            
+           input wire            ctx_load,    // load the state of a message from ctx_i, only when ctx_ready
+           input wire [1921 : 0] ctx_i,
+           output wire [1921 : 0] ctx_o,
+           output wire           ctx_ready,   // idle, with GHASH drained and the powers of H derived
+           
            output wire [127 : 0] block_o,
            output wire [127 : 0] tag,
            output wire           ready,
@@ -60,9 +69,16 @@ module snowv_gcm(
   localparam CTRL_NEXT        = 4'h9;
   localparam CTRL_XOR_ENCDEC  = 4'ha;
   localparam CTRL_XOR         = 4'hb;
-  localparam CTRL_AUTH        = 4'hc;
+  localparam CTRL_DRAIN       = 4'hc;
   localparam CTRL_FINAL       = 4'hd;
   localparam CTRL_FINAL_XOR   = 4'he;
+  localparam CTRL_DERIVE_HPOW = 4'hf;
+  
+    // GHASH drain FSM
+  localparam DRAIN_IDLE       = 1'b0;
+  localparam DRAIN_BUSY       = 1'b1;
+  
+  localparam CT_FIFO_DEPTH    = 1 << CT_FIFO_BITS;
   
   //----------------------------------------------------------------
   // Registers + update variables and write enable.
@@ -96,6 +112,22 @@ module snowv_gcm(
   reg            first_block_new;
   reg            first_block_we;
   
+  reg            hpow_pending_reg; // GHASH is still deriving H^2..H^4
+  reg            hpow_pending_new;
+  reg            hpow_pending_we;
+  
+  reg            ctx_we;
+  
+  // GHASH input FIFO (ciphertext when encrypting, block_i otherwise)
+  reg [127 : 0]  ct_fifo_mem [0 : CT_FIFO_DEPTH - 1];
+  
+  reg [CT_FIFO_BITS : 0] ct_wr_ptr_reg;
+  reg [CT_FIFO_BITS : 0] ct_rd_ptr_reg;
+  
+  reg            drain_ctrl_reg;
+  reg            drain_ctrl_new;
+  reg            drain_ctrl_we;
+  
   //----------------------------------------------------------------
   // Wires.
   //----------------------------------------------------------------
@@ -108,12 +140,22 @@ module snowv_gcm(
   wire [127 : 0] core_iv;
   wire [127 : 0] core_keystream_z;
   wire           core_ready;
+  wire [895 : 0] core_ctx_o;
+  
+  // For snowv_core itself, behind the keystream FIFO when KS_PREFETCH
+  wire           snowv_init;
+  wire           snowv_next;
+  wire           snowv_ctx_load;
+  wire [895 : 0] snowv_ctx_o;
+  wire [127 : 0] snowv_keystream_z;
+  wire           snowv_ready;
   
   // For GHASH core
+  reg            ghash_derive_h;       // Use to precompute the powers of H for aggregated reduction
   reg            ghash_first_init;     // Use for first block of AD
   reg            ghash_init;           // Use for subsequent blocks of AD
-  reg            ghash_next_no_ad;     // Use for the first block of ciphertext if no AD
-  reg            ghash_next;           // Use for the first block of ciphertext if there is AD or for subsequent blocks
+  reg            ghash_next_no_ad;     // Use for the first block of ciphertext if no AD (drain FSM)
+  reg            ghash_next;           // Use for the first block of ciphertext if there is AD or for subsequent blocks (drain FSM)
   reg            ghash_finalize_no_in; // Use to finalize if no AD and no ciphertext
   reg            ghash_finalize;       // Use to finalize (final XOR and mulH)
   wire [127 : 0] ghash_H;
@@ -123,6 +165,16 @@ module snowv_gcm(
   wire [63 : 0]  ghash_len_i;
   wire [127 : 0] ghash_out;
   wire           ghash_ready;
+  wire [768 : 0] ghash_ctx_o;
+  
+  // For the GHASH input FIFO
+  reg [127 : 0]  ct_fifo_in;
+  reg            ct_fifo_push;
+  reg            ct_fifo_pop;
+  reg            ct_fifo_clear;
+  wire           ct_fifo_empty;
+  wire           ct_fifo_full;
+  wire           drain_idle;
   
   //----------------------------------------------------------------
   // Instantiations.
@@ -132,19 +184,63 @@ module snowv_gcm(
                    .reset_n(reset_n),
       
                    .aead_mode(core_aead_mode),
-                   .init(core_init),
-                   .next(core_next),     
+                   .init(snowv_init),
+                   .next(snowv_next),     
                    .key(core_key),
                    .iv(core_iv),
+                   
+                   .ctx_load(snowv_ctx_load),
+                   .ctx_i(ctx_i[895 : 0]),
+                   .ctx_o(snowv_ctx_o),
                      
-                   .keystream_z(core_keystream_z),
-                   .ready(core_ready)
+                   .keystream_z(snowv_keystream_z),
+                   .ready(snowv_ready)
                   );
   
-  ghash_alt ghash_alt(
+  // KS_PREFETCH: 0 = keystream on demand, 1 = SNOW-V runs up to 2**KS_FIFO_BITS
+  // blocks ahead, so that a block only waits for the core if the FIFO is empty.
+  generate
+    if (KS_PREFETCH)
+      begin : ks_gen
+        snowv_ks_fifo #(.KS_FIFO_BITS(KS_FIFO_BITS)) ks_fifo(
+                                                             .clk(clk),
+                                                             .reset_n(reset_n),
+                                                             
+                                                             .init(core_init),
+                                                             .next(core_next),
+                                                             .ctx_load(ctx_load),
+                                                             .ctx_i(ctx_i[895 : 0]),
+                                                             .ctx_o(core_ctx_o),
+                                                             
+                                                             .keystream_z(core_keystream_z),
+                                                             .ready(core_ready),
+                                                             
+                                                             .core_init(snowv_init),
+                                                             .core_next(snowv_next),
+                                                             .core_ctx_load(snowv_ctx_load),
+                                                             .core_ctx_o(snowv_ctx_o),
+                                                             .core_z(snowv_keystream_z),
+                                                             .core_ready(snowv_ready)
+                                                             );
+      end
+    else
+      begin : ks_gen
+        assign snowv_init       = core_init;
+        assign snowv_next       = core_next;
+        assign snowv_ctx_load   = ctx_load;
+        assign core_ctx_o       = snowv_ctx_o;
+        assign core_keystream_z = snowv_keystream_z;
+        assign core_ready       = snowv_ready;
+      end
+  endgenerate
+  
+  // GHASH_MULH selects the multiplier of ghash_alt: 0 = mulH_fast, 1 = single-cycle
+  // Karatsuba, 2 = 2-stage pipelined Karatsuba. GHASH_AGGREGATE reduces once per 4 blocks.
+  ghash_alt #(.MULH_IMPL(GHASH_MULH), .AGGREGATE(GHASH_AGGREGATE)) ghash_alt(
               .clk(clk),
               .reset_n(reset_n),
                
+              .derive_h(ghash_derive_h),
               .first_init(ghash_first_init),
               .init(ghash_init),
               .next_no_ad(ghash_next_no_ad),
@@ -158,6 +254,10 @@ module snowv_gcm(
               .block_i(ghash_in),
               .len_i(ghash_len_i),
               
+              .ctx_load(ctx_load),
+              .ctx_i(ctx_i[1664 : 896]),
+              .ctx_o(ghash_ctx_o),
+              
               .X(ghash_out),
               .ready(ghash_ready)
               );
@@ -172,9 +272,7 @@ module snowv_gcm(
   assign ghash_H        = H_reg;
   assign ghash_ad       = ad;
   assign ghash_len_ad   = len_ad;
-  // encdec == 1 -> Encryption, thus GHASH needs ciphertext_reg as input
-  // encdec == 0 -> Decryption, thus GHASH needs block_i as input
-  assign ghash_in       = encdec ? block_o_reg : block_i;
+  assign ghash_in       = ct_fifo_mem[ct_rd_ptr_reg[CT_FIFO_BITS - 1 : 0]];
   assign ghash_len_i    = len_i;
   
   assign H_new          = core_keystream_z;
@@ -185,6 +283,15 @@ module snowv_gcm(
   assign ready          = ready_reg;
   assign tag_ready      = tag_ready_reg;
   
+  assign ct_fifo_empty  = (ct_wr_ptr_reg == ct_rd_ptr_reg);
+  assign ct_fifo_full   = (ct_wr_ptr_reg == {~ct_rd_ptr_reg[CT_FIFO_BITS], ct_rd_ptr_reg[CT_FIFO_BITS - 1 : 0]});
+  assign drain_idle     = ct_fifo_empty && (drain_ctrl_reg == DRAIN_IDLE);
+  
+  // The state of a message between two commands. The GHASH input FIFO is
+  // empty whenever ctx_ready is set, so it is not part of it.
+  assign ctx_o          = {first_block_reg, Mtag_reg, H_reg, ghash_ctx_o, core_ctx_o};
+  assign ctx_ready      = (snowv_gcm_ctrl_reg == CTRL_IDLE) && drain_idle && !hpow_pending_reg;
+  
   //----------------------------------------------------------------
   // reg_update
   //
@@ -203,6 +310,10 @@ module snowv_gcm(
           Mtag_reg            <= 128'h0;
           block_o_reg         <= 128'h0;
           first_block_reg     <= 1'b0;
+          hpow_pending_reg    <= 1'b0;
+          ct_wr_ptr_reg       <= {(CT_FIFO_BITS + 1){1'b0}};
+          ct_rd_ptr_reg       <= {(CT_FIFO_BITS + 1){1'b0}};
+          drain_ctrl_reg      <= DRAIN_IDLE;
         end
       else
         begin
@@ -220,8 +331,41 @@ module snowv_gcm(
             block_o_reg <= block_o_new;
           if (first_block_we)
             first_block_reg <= first_block_new;
+          if (hpow_pending_we)
+            hpow_pending_reg <= hpow_pending_new;
+          if (ct_fifo_clear)
+            begin
+              ct_wr_ptr_reg <= {(CT_FIFO_BITS + 1){1'b0}};
+              ct_rd_ptr_reg <= {(CT_FIFO_BITS + 1){1'b0}};
+            end
+          else
+            begin
+              if (ct_fifo_push)
+                ct_wr_ptr_reg <= ct_wr_ptr_reg + 1'b1;
+              if (ct_fifo_pop)
+                ct_rd_ptr_reg <= ct_rd_ptr_reg + 1'b1;
+            end
+          if (drain_ctrl_we)
+            drain_ctrl_reg <= drain_ctrl_new;
+          if (ctx_we)
+            begin
+              H_reg           <= ctx_i[1792 : 1665];
+              Mtag_reg        <= ctx_i[1920 : 1793];
+              first_block_reg <= ctx_i[1921];
+            end
         end
     end // reg_update
+  
+  //----------------------------------------------------------------
+  // ct_fifo_update
+  //
+  // Write port of the GHASH input FIFO, without reset.
+  //----------------------------------------------------------------
+  always @ (posedge clk)
+    begin: ct_fifo_update
+      if (ct_fifo_push)
+        ct_fifo_mem[ct_wr_ptr_reg[CT_FIFO_BITS - 1 : 0]] <= ct_fifo_in;
+    end // ct_fifo_update
     
   //----------------------------------------------------------------
   // Encryption/Decryption Logic
@@ -232,6 +376,10 @@ module snowv_gcm(
         block_o_new = block_i ^ (core_keystream_z << (128 - len_i[6 : 0])) >> (128 - len_i[6 : 0]);
       else
         block_o_new = block_i ^ core_keystream_z;
+      
+      // encdec == 1 -> Encryption, thus GHASH needs the ciphertext as input
+      // encdec == 0 -> Decryption, thus GHASH needs block_i as input
+      ct_fifo_in = encdec ? block_o_new : block_i;
     end
   
   //----------------------------------------------------------------
@@ -258,15 +406,19 @@ module snowv_gcm(
       
       core_init            = 1'b0;
       core_next            = 1'b0;
+      ghash_derive_h       = 1'b0;
       ghash_first_init     = 1'b0;
       ghash_init           = 1'b0;
-      ghash_next_no_ad     = 1'b0;
-      ghash_next           = 1'b0;
       ghash_finalize_no_in = 1'b0;
       ghash_finalize       = 1'b0;
       
-      first_block_new      = 1'b0;
-      first_block_we       = 1'b0;
+      ct_fifo_push         = 1'b0;
+      ct_fifo_clear        = 1'b0;
+      ctx_we               = 1'b0;
+      
+      // GHASH is only busy with the powers of H while hpow_pending_reg is set
+      hpow_pending_new     = 1'b0;
+      hpow_pending_we      = ghash_ready;
         
       case (snowv_gcm_ctrl_reg)
         CTRL_IDLE:
@@ -275,13 +427,14 @@ module snowv_gcm(
             ready_we      = 1'b1;
             tag_ready_new = 1'b0;
             tag_ready_we  = 1'b1;
+            if (ctx_load)
+              ctx_we      = 1'b1;
             if (init)
               begin
                 snowv_gcm_ctrl_new = CTRL_INIT;
                 snowv_gcm_ctrl_we  = 1'b1;
                 core_init          = 1'b1;
-                first_block_new    = 1'b1;
-                first_block_we     = 1'b1;
+                ct_fifo_clear      = 1'b1;
               end
             if (next_ad)
               begin
@@ -301,10 +454,6 @@ module snowv_gcm(
                   begin
                     snowv_gcm_ctrl_new = CTRL_NEXT_AUTH;
                     snowv_gcm_ctrl_we  = 1'b1;
-                    if (first_block_reg && (len_ad == 64'h0))
-                      ghash_next_no_ad = 1'b1;
-                    else
-                      ghash_next = 1'b1;
                   end
                 else
                   begin
@@ -315,12 +464,17 @@ module snowv_gcm(
               end
             if (finalize)
               begin
-                snowv_gcm_ctrl_new = CTRL_FINAL;
                 snowv_gcm_ctrl_we  = 1'b1;
-                if ((len_ad == 64'h0) && (len_i == 64'h0))
-                  ghash_finalize_no_in = 1'b1;
+                if (!drain_idle)
+                  snowv_gcm_ctrl_new = CTRL_DRAIN;
                 else
-                  ghash_finalize = 1'b1;
+                  begin
+                    snowv_gcm_ctrl_new = CTRL_FINAL;
+                    if ((len_ad == 64'h0) && (len_i == 64'h0))
+                      ghash_finalize_no_in = 1'b1;
+                    else
+                      ghash_finalize = 1'b1;
+                  end
               end
           end
         CTRL_INIT:
@@ -338,6 +492,9 @@ module snowv_gcm(
               begin
                 core_next          = 1'b1;
                 H_we               = 1'b1;
+                ghash_derive_h     = GHASH_AGGREGATE;
+                hpow_pending_new   = GHASH_AGGREGATE;
+                hpow_pending_we    = 1'b1;
                 if (len_ad == 64'h0)
                   begin
                     snowv_gcm_ctrl_new = CTRL_MTAG_NO_AD;
@@ -354,21 +511,56 @@ module snowv_gcm(
           begin
             if (core_ready)
               begin
-                snowv_gcm_ctrl_new = CTRL_IDLE;
-                snowv_gcm_ctrl_we  = 1'b1;
                 Mtag_we            = 1'b1;
-                ready_new          = 1'b1;
-                ready_we           = 1'b1;
+                if (hpow_pending_reg && !ghash_ready)
+                  begin
+                    snowv_gcm_ctrl_new = CTRL_DERIVE_HPOW;
+                    snowv_gcm_ctrl_we  = 1'b1;
+                  end
+                else
+                  begin
+                    snowv_gcm_ctrl_new = CTRL_IDLE;
+                    snowv_gcm_ctrl_we  = 1'b1;
+                    ready_new          = 1'b1;
+                    ready_we           = 1'b1;
+                  end
               end
           end
         CTRL_MTAG_W_AD:
           begin
             if (core_ready)
               begin
-                snowv_gcm_ctrl_new = CTRL_MTAG_W_AD_2;
-                snowv_gcm_ctrl_we  = 1'b1;
                 Mtag_we            = 1'b1;
-                ghash_first_init   = 1'b1;
+                if (hpow_pending_reg && !ghash_ready)
+                  begin
+                    snowv_gcm_ctrl_new = CTRL_DERIVE_HPOW;
+                    snowv_gcm_ctrl_we  = 1'b1;
+                  end
+                else
+                  begin
+                    snowv_gcm_ctrl_new = CTRL_MTAG_W_AD_2;
+                    snowv_gcm_ctrl_we  = 1'b1;
+                    ghash_first_init   = 1'b1;
+                  end
+              end
+          end
+        CTRL_DERIVE_HPOW:
+          begin
+            if (ghash_ready)
+              begin
+                if (len_ad == 64'h0)
+                  begin
+                    snowv_gcm_ctrl_new = CTRL_IDLE;
+                    snowv_gcm_ctrl_we  = 1'b1;
+                    ready_new          = 1'b1;
+                    ready_we           = 1'b1;
+                  end
+                else
+                  begin
+                    snowv_gcm_ctrl_new = CTRL_MTAG_W_AD_2;
+                    snowv_gcm_ctrl_we  = 1'b1;
+                    ghash_first_init   = 1'b1;
+                  end
               end
           end
         CTRL_MTAG_W_AD_2:
@@ -393,20 +585,19 @@ module snowv_gcm(
           begin
             if (core_ready)
               begin
-                snowv_gcm_ctrl_new = CTRL_XOR;
+                snowv_gcm_ctrl_new = CTRL_XOR_ENCDEC;
                 snowv_gcm_ctrl_we  = 1'b1;
               end
           end
         CTRL_NEXT_AUTH:
           begin
-            first_block_new = 1'b0;
-            first_block_we  = 1'b1;
-            if (ghash_ready)
+            if (!ct_fifo_full)
               begin
                 snowv_gcm_ctrl_new = CTRL_IDLE;
                 snowv_gcm_ctrl_we  = 1'b1;
                 ready_new          = 1'b1;
                 ready_we           = 1'b1;
+                ct_fifo_push       = 1'b1;
               end
           end
         CTRL_NEXT:
@@ -427,24 +618,28 @@ module snowv_gcm(
           end  
         CTRL_XOR:
           begin
-            snowv_gcm_ctrl_new = CTRL_AUTH;
-            snowv_gcm_ctrl_we  = 1'b1;
-            block_o_we         = 1'b1;
-            if (first_block_reg && (len_ad == 64'h0))
-              ghash_next_no_ad = 1'b1;
-            else
-              ghash_next = 1'b1;
-          end
-        CTRL_AUTH:
-          begin
-            first_block_new = 1'b0;
-            first_block_we  = 1'b1;
-            if (ghash_ready)
+            // The keystream stays at core_keystream_z until the next core_next,
+            // so the block waits here while the FIFO is full.
+            if (!ct_fifo_full)
               begin
                 snowv_gcm_ctrl_new = CTRL_IDLE;
                 snowv_gcm_ctrl_we  = 1'b1;
                 ready_new          = 1'b1;
                 ready_we           = 1'b1;
+                block_o_we         = 1'b1;
+                ct_fifo_push       = 1'b1;
+              end
+          end
+        CTRL_DRAIN:
+          begin
+            if (drain_idle)
+              begin
+                snowv_gcm_ctrl_new = CTRL_FINAL;
+                snowv_gcm_ctrl_we  = 1'b1;
+                if ((len_ad == 64'h0) && (len_i == 64'h0))
+                  ghash_finalize_no_in = 1'b1;
+                else
+                  ghash_finalize = 1'b1;
               end
           end
         CTRL_FINAL:
@@ -470,4 +665,57 @@ module snowv_gcm(
         
       end // snowvgcm_ctrl
   
+  //----------------------------------------------------------------
+  // drain_ctrl
+  //
+  // Feeds the blocks in the FIFO to GHASH, one at a time. The head
+  // of the FIFO is the input of GHASH and is only popped once GHASH
+  // is ready with it. A FIFO clear at init comes at least a full
+  // SNOW-V initialization before the first GHASH command of the
+  // new message, so a block that is still being drained cannot
+  // collide with it.
+  //----------------------------------------------------------------
+  always @*
+    begin: drain_ctrl
+      drain_ctrl_new   = DRAIN_IDLE;
+      drain_ctrl_we    = 1'b0;
+      ghash_next_no_ad = 1'b0;
+      ghash_next       = 1'b0;
+      ct_fifo_pop      = 1'b0;
+      first_block_new  = 1'b0;
+      first_block_we   = 1'b0;
+      
+      if (ct_fifo_clear)
+        begin
+          first_block_new = 1'b1;
+          first_block_we  = 1'b1;
+        end
+      
+      case (drain_ctrl_reg)
+        DRAIN_IDLE:
+          begin
+            if (!ct_fifo_empty && !ct_fifo_clear)
+              begin
+                drain_ctrl_new = DRAIN_BUSY;
+                drain_ctrl_we  = 1'b1;
+                if (first_block_reg && (len_ad == 64'h0))
+                  ghash_next_no_ad = 1'b1;
+                else
+                  ghash_next = 1'b1;
+                first_block_new = 1'b0;
+                first_block_we  = 1'b1;
+              end
+          end
+        DRAIN_BUSY:
+          begin
+            if (ghash_ready)
+              begin
+                drain_ctrl_new = DRAIN_IDLE;
+                drain_ctrl_we  = 1'b1;
+                ct_fifo_pop    = !ct_fifo_empty;
+              end
+          end
+      endcase // case (drain_ctrl_reg)
+    end // drain_ctrl
+  
 endmodule // snowv_gcm
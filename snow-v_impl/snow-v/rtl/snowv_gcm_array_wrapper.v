@@ -0,0 +1,550 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer: Ryan De Koninck
+//
+// Create Date:
+// Design Name:
+// Module Name: snowv_gcm_array_wrapper
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description: snowv_gcm_wrapper with NUM_CORES snowv_gcm cores, one per
+//              lane. A lane keeps one message. The normal commands work as
+//              in snowv_gcm_wrapper, on the lane in the ctx_id field of the
+//              frame read last. CMD_COMPUTE_BATCH carries a block for every
+//              lane in one frame, runs them on all cores in parallel and
+//              returns all results in the same command.
+//
+// Dependencies: snowv_gcm, wrapper_stats
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments:
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module snowv_gcm_array_wrapper #(parameter NUM_CORES = 4)(  // 1 to 7
+                   input wire             clk,
+                   input wire             resetn,
+
+                   input wire [31 : 0]    arm_to_fpga_cmd,
+                   input wire             arm_to_fpga_cmd_valid,
+                   output wire            fpga_to_arm_done,
+                   input wire             fpga_to_arm_done_read,
+
+                   input wire             arm_to_fpga_data_valid,
+                   output wire            arm_to_fpga_data_ready,
+                   input wire [1023 : 0]  arm_to_fpga_data,
+
+                   output wire            fpga_to_arm_data_valid,
+                   input wire             fpga_to_arm_data_ready,
+                   output wire [1023 : 0] fpga_to_arm_data,
+
+                   output wire [3 : 0]    leds
+                   );
+
+    //----------------------------------------------------------------
+    // Internal constant and parameter definitions.
+    //----------------------------------------------------------------
+    localparam LANE_BITS           = 3;
+
+      // States
+    localparam CTRL_WAIT_FOR_CMD   = 4'h0;
+    localparam CTRL_READ           = 4'h1;
+    localparam CTRL_LOAD           = 4'h2;
+    localparam CTRL_START          = 4'h3;
+    localparam CTRL_BUSY           = 4'h4;
+    localparam CTRL_WRITE          = 4'h5;
+    localparam CTRL_ASSERT_DONE    = 4'h6;
+    localparam CTRL_STATS_WRITE    = 4'h7;
+    localparam CTRL_BATCH_WAIT     = 4'h8;
+    localparam CTRL_BATCH_READ     = 4'h9;
+    localparam CTRL_BATCH_START    = 4'ha;
+    localparam CTRL_BATCH_BUSY     = 4'hb;
+    localparam CTRL_BATCH_WRITE    = 4'hc;
+
+      // Operation started in CTRL_START
+    localparam OP_INIT             = 2'h0;
+    localparam OP_NEXT_AD          = 2'h1;
+    localparam OP_NEXT             = 2'h2;
+    localparam OP_FINAL            = 2'h3;
+
+      // Wrapper commands, the same codes as snowv_gcm_wrapper
+    localparam CMD_READ            = 32'h0;
+    localparam CMD_COMPUTE_INIT    = 32'h1;
+    localparam CMD_COMPUTE_NEXT_AD = 32'h2;
+    localparam CMD_COMPUTE_NEXT    = 32'h3;
+    localparam CMD_COMPUTE_FINAL   = 32'h4;
+    localparam CMD_WRITE           = 32'h5;
+    localparam CMD_READ_STATS      = 32'h7;
+    localparam CMD_READ_STATS_HI   = 32'hf;  // CMD_READ_STATS with bit 3 set
+    localparam CMD_COMPUTE_BATCH   = 32'hb;
+
+    //----------------------------------------------------------------
+    // Registers + update variables and write enable.
+    //----------------------------------------------------------------
+    reg [3 : 0]    snowv_gcm_array_wrapper_ctrl_reg;
+    reg [3 : 0]    snowv_gcm_array_wrapper_ctrl_new;
+    reg            snowv_gcm_array_wrapper_ctrl_we;
+
+      // Inputs of every lane, loaded from in_buf_reg by a compute command
+      // for the lane, or from the batch frame
+    reg [NUM_CORES - 1 : 0] encdec_only_reg;
+    reg [NUM_CORES - 1 : 0] auth_only_reg;
+    reg [NUM_CORES - 1 : 0] encdec_reg;
+    reg [NUM_CORES - 1 : 0] adj_len_reg;
+    reg [255 : 0]  key_reg [0 : NUM_CORES - 1];
+    reg [127 : 0]  iv_reg [0 : NUM_CORES - 1];
+    reg [127 : 0]  ad_reg [0 : NUM_CORES - 1];
+    reg [63 : 0]   len_ad_reg [0 : NUM_CORES - 1];
+    reg [127 : 0]  block_i_reg [0 : NUM_CORES - 1];
+    reg [63 : 0]   len_i_reg [0 : NUM_CORES - 1];
+    reg            inputs_we;
+
+    reg [779 : 0]  in_buf_reg;
+    reg            in_buf_we;
+
+    reg [1 : 0]    start_op_reg;
+    reg [1 : 0]    start_op_new;
+    reg            start_op_we;
+
+      // Lanes that run in the background, until the ready (lane_busy) or
+      // the tag_ready (tag_busy) of their core
+    reg [NUM_CORES - 1 : 0] lane_busy_reg;
+    reg [NUM_CORES - 1 : 0] lane_busy_new;
+    reg [NUM_CORES - 1 : 0] tag_busy_reg;
+    reg [NUM_CORES - 1 : 0] tag_busy_new;
+
+    reg [127 : 0]  block_o_reg [0 : NUM_CORES - 1];
+    reg [NUM_CORES - 1 : 0] block_o_we;
+    reg [127 : 0]  tag_reg [0 : NUM_CORES - 1];
+    reg [NUM_CORES - 1 : 0] tag_we;
+
+    reg [NUM_CORES - 1 : 0] batch_mask_reg;
+    reg [NUM_CORES - 1 : 0] batch_final_reg;
+    reg            batch_we;
+
+    reg            batch_mode_reg;
+    reg            batch_mode_new;
+    reg            batch_mode_we;
+
+    reg            stats_mode_reg;
+    reg            stats_mode_new;
+    reg            stats_mode_we;
+
+    reg            fpga_to_arm_data_valid_reg;
+    wire           fpga_to_arm_data_valid_new;
+
+    reg            arm_to_fpga_data_ready_reg;
+    wire           arm_to_fpga_data_ready_new;
+
+    reg            fpga_to_arm_done_reg;
+    wire           fpga_to_arm_done_new;
+
+    //----------------------------------------------------------------
+    // Wires.
+    //----------------------------------------------------------------
+      // Core I/O
+    reg [NUM_CORES - 1 : 0] core_init;
+    reg [NUM_CORES - 1 : 0] core_next_ad;
+    reg [NUM_CORES - 1 : 0] core_next;
+    reg [NUM_CORES - 1 : 0] core_finalize;
+    wire [128 * NUM_CORES - 1 : 0] core_block_o;
+    wire [128 * NUM_CORES - 1 : 0] core_tag;
+    wire [NUM_CORES - 1 : 0] core_ready;
+    wire [NUM_CORES - 1 : 0] core_tag_ready;
+
+      // Lane of the frame read last
+    wire [LANE_BITS - 1 : 0] lane;
+    wire           lane_ok;
+    wire [NUM_CORES - 1 : 0] lane_sel;
+    wire [NUM_CORES - 1 : 0] lane_idle;
+
+      // Batch frame
+    wire [NUM_CORES - 1 : 0] batch_mask_new;
+    wire [NUM_CORES - 1 : 0] batch_final_new;
+    reg [1023 : 0] batch_out;
+
+      // Statistics
+    wire           stats_cmd_accept;
+    wire [1023 : 0] stats;
+
+    //----------------------------------------------------------------
+    // Instantiations.
+    //----------------------------------------------------------------
+    wrapper_stats wrapper_stats(
+                                .clk(clk),
+                                .reset_n(resetn),
+                                .state(snowv_gcm_array_wrapper_ctrl_reg),
+                                .cmd_accept(stats_cmd_accept),
+                                .cmd(arm_to_fpga_cmd[3 : 0]),
+                                .stats(stats)
+                                );
+
+    genvar k;
+    generate
+      for (k = 0; k < NUM_CORES; k = k + 1)
+        begin : lane_gen
+          snowv_gcm core(
+                         .clk(clk),
+                         .reset_n(resetn),
+
+                         .init(core_init[k]),
+                         .next_ad(core_next_ad[k]),
+                         .next(core_next[k]),
+                         .finalize(core_finalize[k]),
+                         .encdec_only(encdec_only_reg[k]),
+                         .auth_only(auth_only_reg[k]),
+                         .encdec(encdec_reg[k]),
+                         .adj_len(adj_len_reg[k]),
+                         .key(key_reg[k]),
+                         .iv(iv_reg[k]),
+                         .ad(ad_reg[k]),
+                         .len_ad(len_ad_reg[k]),
+                         .block_i(block_i_reg[k]),
+                         .len_i(len_i_reg[k]),
+
+                         .ctx_load(1'b0),
+                         .ctx_i(1922'h0),
+                         .ctx_o(),
+                         .ctx_ready(),
+
+                         .block_o(core_block_o[128 * k +: 128]),
+                         .tag(core_tag[128 * k +: 128]),
+                         .ready(core_ready[k]),
+                         .tag_ready(core_tag_ready[k])
+                         );
+        end
+    endgenerate
+
+    //----------------------------------------------------------------
+    // Concurrent connectivity for ports etc.
+    //----------------------------------------------------------------
+      // ARM to FPGA data decomposition: the frame of snowv_gcm_wrapper,
+      // with the lane in the ctx_id field
+    assign lane      = in_buf_reg[772 + LANE_BITS - 1 : 772];
+    assign lane_ok   = (lane < NUM_CORES) && (in_buf_reg[779 : 772 + LANE_BITS] == 0);
+    assign lane_sel  = lane_ok ? ({{NUM_CORES{1'b0}}, 1'b1} << lane) : {NUM_CORES{1'b0}};
+    assign lane_idle = ~(lane_busy_reg | tag_busy_reg);
+
+      // Batch frame: the block of lane i in bits 128 * i + 127 to 128 * i,
+      // the lanes that get a block in bits 903 to 896, the lanes that are
+      // finalized instead in bits 911 to 904, and the adj_len of lane i in
+      // bit 912 + i. len_i stays the one of the last frame for the lane.
+      // The result frame has the output block of lane i, or its tag if the
+      // lane was finalized, in the same place as its block.
+    assign batch_mask_new  = arm_to_fpga_data[896 +: NUM_CORES];
+    assign batch_final_new = arm_to_fpga_data[904 +: NUM_CORES] & batch_mask_new;
+
+    always @*
+      begin: batch_frame
+        integer j;
+
+        batch_out = 1024'h0;
+        for (j = 0; j < NUM_CORES; j = j + 1)
+          if (batch_mask_reg[j])
+            batch_out[128 * j +: 128] = batch_final_reg[j] ? tag_reg[j] : block_o_reg[j];
+        batch_out[896 +: NUM_CORES] = batch_mask_reg;
+      end
+
+      // Wrapper I/O
+    assign fpga_to_arm_data       = stats_mode_reg ? stats :
+                                    batch_mode_reg ? batch_out :
+                                    {768'h0, lane_ok ? {block_o_reg[lane], tag_reg[lane]} : 256'h0};
+    assign fpga_to_arm_data_valid = fpga_to_arm_data_valid_reg;
+    assign arm_to_fpga_data_ready = arm_to_fpga_data_ready_reg;
+    assign fpga_to_arm_done       = fpga_to_arm_done_reg;
+
+      // Statistics: every command that leaves CTRL_WAIT_FOR_CMD is counted
+    assign stats_cmd_accept = (snowv_gcm_array_wrapper_ctrl_reg == CTRL_WAIT_FOR_CMD) && snowv_gcm_array_wrapper_ctrl_we;
+
+      // The four LEDs on the board are used as debug signals.
+    assign leds = snowv_gcm_array_wrapper_ctrl_reg;
+
+    //----------------------------------------------------------------
+    // reg_update
+    //
+    // Update functionality for all registers in the core.
+    // All registers are positive edge triggered with asynchronous
+    // active low reset. All registers have write enable.
+    //----------------------------------------------------------------
+    always @ (posedge clk or negedge resetn)
+      begin: reg_update
+        integer i;
+
+        if (!resetn)
+          begin
+            for (i = 0; i < NUM_CORES; i = i + 1)
+              begin
+                key_reg[i]     <= 256'h0;
+                iv_reg[i]      <= 128'h0;
+                ad_reg[i]      <= 128'h0;
+                len_ad_reg[i]  <= 64'h0;
+                block_i_reg[i] <= 128'h0;
+                len_i_reg[i]   <= 64'h0;
+                block_o_reg[i] <= 128'h0;
+                tag_reg[i]     <= 128'h0;
+              end
+            snowv_gcm_array_wrapper_ctrl_reg <= CTRL_WAIT_FOR_CMD;
+            encdec_only_reg                  <= {NUM_CORES{1'b0}};
+            auth_only_reg                    <= {NUM_CORES{1'b0}};
+            encdec_reg                       <= {NUM_CORES{1'b0}};
+            adj_len_reg                      <= {NUM_CORES{1'b0}};
+            in_buf_reg                       <= 780'h0;
+            start_op_reg                     <= OP_INIT;
+            lane_busy_reg                    <= {NUM_CORES{1'b0}};
+            tag_busy_reg                     <= {NUM_CORES{1'b0}};
+            batch_mask_reg                   <= {NUM_CORES{1'b0}};
+            batch_final_reg                  <= {NUM_CORES{1'b0}};
+            batch_mode_reg                   <= 1'b0;
+            stats_mode_reg                   <= 1'b0;
+            fpga_to_arm_data_valid_reg       <= 1'b0;
+            arm_to_fpga_data_ready_reg       <= 1'b0;
+            fpga_to_arm_done_reg             <= 1'b0;
+          end
+        else
+          begin
+            if (snowv_gcm_array_wrapper_ctrl_we)
+              snowv_gcm_array_wrapper_ctrl_reg <= snowv_gcm_array_wrapper_ctrl_new;
+            for (i = 0; i < NUM_CORES; i = i + 1)
+              begin
+                if (inputs_we && lane_sel[i])
+                  begin
+                    encdec_only_reg[i] <= in_buf_reg[771];
+                    auth_only_reg[i]   <= in_buf_reg[770];
+                    encdec_reg[i]      <= in_buf_reg[769];
+                    adj_len_reg[i]     <= in_buf_reg[768];
+                    key_reg[i]         <= in_buf_reg[767 : 512];
+                    iv_reg[i]          <= in_buf_reg[511 : 384];
+                    ad_reg[i]          <= in_buf_reg[383 : 256];
+                    len_ad_reg[i]      <= in_buf_reg[255 : 192];
+                    block_i_reg[i]     <= in_buf_reg[191 : 64];
+                    len_i_reg[i]       <= in_buf_reg[63 : 0];
+                  end
+                if (batch_we && batch_mask_new[i])
+                  begin
+                    block_i_reg[i] <= arm_to_fpga_data[128 * i +: 128];
+                    adj_len_reg[i] <= arm_to_fpga_data[912 + i];
+                  end
+                if (block_o_we[i])
+                  block_o_reg[i] <= core_block_o[128 * i +: 128];
+                if (tag_we[i])
+                  tag_reg[i] <= core_tag[128 * i +: 128];
+              end
+            if (in_buf_we)
+              in_buf_reg <= arm_to_fpga_data[779 : 0];
+            if (start_op_we)
+              start_op_reg <= start_op_new;
+            lane_busy_reg <= lane_busy_new;
+            tag_busy_reg  <= tag_busy_new;
+            if (batch_we)
+              begin
+                batch_mask_reg  <= batch_mask_new;
+                batch_final_reg <= batch_final_new;
+              end
+            if (batch_mode_we)
+              batch_mode_reg <= batch_mode_new;
+            if (stats_mode_we)
+              stats_mode_reg <= stats_mode_new;
+
+            // Wrapper control signals don't have a write enable
+            fpga_to_arm_data_valid_reg <= fpga_to_arm_data_valid_new;
+            arm_to_fpga_data_ready_reg <= arm_to_fpga_data_ready_new;
+            fpga_to_arm_done_reg <= fpga_to_arm_done_new;
+          end
+      end // reg_update
+
+    //----------------------------------------------------------------
+    // snowv_gcm_array_wrapper_ctrl
+    //
+    // Control FSM for snowv_gcm_array_wrapper.
+    //----------------------------------------------------------------
+    always @*
+      begin: snowv_gcm_array_wrapper_ctrl
+        snowv_gcm_array_wrapper_ctrl_new = CTRL_WAIT_FOR_CMD;
+        snowv_gcm_array_wrapper_ctrl_we  = 1'b0;
+        core_init                        = {NUM_CORES{1'b0}};
+        core_next_ad                     = {NUM_CORES{1'b0}};
+        core_next                        = {NUM_CORES{1'b0}};
+        core_finalize                    = {NUM_CORES{1'b0}};
+        inputs_we                        = 1'b0;
+        in_buf_we                        = 1'b0;
+        start_op_new                     = OP_INIT;
+        start_op_we                      = 1'b0;
+        batch_we                         = 1'b0;
+        batch_mode_new                   = 1'b0;
+        batch_mode_we                    = 1'b0;
+        stats_mode_new                   = 1'b0;
+        stats_mode_we                    = 1'b0;
+
+        // The results of the cores are captured whatever command the FSM
+        // is handling in the meantime
+        block_o_we    = lane_busy_reg & core_ready;
+        lane_busy_new = lane_busy_reg & ~core_ready;
+        tag_we        = tag_busy_reg & core_tag_ready;
+        tag_busy_new  = tag_busy_reg & ~core_tag_ready;
+
+        case (snowv_gcm_array_wrapper_ctrl_reg)
+          CTRL_WAIT_FOR_CMD:
+            begin
+              if (arm_to_fpga_cmd_valid)
+                begin
+                  snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+                  batch_mode_we                    = 1'b1;
+                  stats_mode_we                    = 1'b1;
+                  start_op_we                      = 1'b1;
+                  snowv_gcm_array_wrapper_ctrl_new = CTRL_LOAD;
+                  case (arm_to_fpga_cmd)
+                    CMD_READ:
+                      snowv_gcm_array_wrapper_ctrl_new = CTRL_READ;
+                    CMD_COMPUTE_INIT:
+                      start_op_new                     = OP_INIT;
+                    CMD_COMPUTE_NEXT_AD:
+                      start_op_new                     = OP_NEXT_AD;
+                    CMD_COMPUTE_NEXT:
+                      start_op_new                     = OP_NEXT;
+                    CMD_COMPUTE_FINAL:
+                      start_op_new                     = OP_FINAL;
+                    CMD_WRITE:
+                      snowv_gcm_array_wrapper_ctrl_new = CTRL_BUSY;
+                    CMD_COMPUTE_BATCH:
+                      begin
+                        snowv_gcm_array_wrapper_ctrl_new = CTRL_BATCH_WAIT;
+                        batch_mode_new                   = 1'b1;
+                      end
+                    CMD_READ_STATS, CMD_READ_STATS_HI:
+                      begin
+                        snowv_gcm_array_wrapper_ctrl_new = CTRL_STATS_WRITE;
+                        stats_mode_new                   = 1'b1;
+                      end
+                    default:
+                      begin
+                        snowv_gcm_array_wrapper_ctrl_we  = 1'b0;
+                        batch_mode_we                    = 1'b0;
+                        stats_mode_we                    = 1'b0;
+                        start_op_we                      = 1'b0;
+                      end
+                  endcase
+                end
+            end
+          CTRL_READ:
+            if (arm_to_fpga_data_valid)
+              begin
+                snowv_gcm_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+                in_buf_we                        = 1'b1;
+              end
+          CTRL_LOAD:
+              // A frame for a lane that does not exist is dropped
+            if (!lane_ok)
+              begin
+                snowv_gcm_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+              end
+            else if ((lane_idle & lane_sel) == lane_sel)
+              begin
+                snowv_gcm_array_wrapper_ctrl_new = CTRL_START;
+                snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+                inputs_we                        = 1'b1;
+              end
+          CTRL_START:
+            begin
+              case (start_op_reg)
+                OP_INIT:
+                  core_init     = lane_sel;
+                OP_NEXT_AD:
+                  core_next_ad  = lane_sel;
+                OP_NEXT:
+                  core_next     = lane_sel;
+                default:
+                  core_finalize = lane_sel;
+              endcase
+              if (start_op_reg == OP_FINAL)
+                tag_busy_new  = tag_busy_new | lane_sel;
+              else
+                lane_busy_new = lane_busy_new | lane_sel;
+              snowv_gcm_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+              snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+            end
+          CTRL_BUSY:
+            if ((lane_idle & lane_sel) == lane_sel)
+              begin
+                snowv_gcm_array_wrapper_ctrl_new = CTRL_WRITE;
+                snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_WRITE:
+            if (fpga_to_arm_data_ready)
+              begin
+                snowv_gcm_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+              end
+            // The blocks of a batch go straight into the inputs of the
+            // lanes, so all lanes have to be done first
+          CTRL_BATCH_WAIT:
+            if (lane_idle == {NUM_CORES{1'b1}})
+              begin
+                snowv_gcm_array_wrapper_ctrl_new = CTRL_BATCH_READ;
+                snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_BATCH_READ:
+            if (arm_to_fpga_data_valid)
+              begin
+                snowv_gcm_array_wrapper_ctrl_new = CTRL_BATCH_START;
+                snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+                batch_we                         = 1'b1;
+              end
+          CTRL_BATCH_START:
+            begin
+              core_next                        = batch_mask_reg & ~batch_final_reg;
+              core_finalize                    = batch_final_reg;
+              lane_busy_new                    = lane_busy_new | (batch_mask_reg & ~batch_final_reg);
+              tag_busy_new                     = tag_busy_new | batch_final_reg;
+              snowv_gcm_array_wrapper_ctrl_new = CTRL_BATCH_BUSY;
+              snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+            end
+          CTRL_BATCH_BUSY:
+            if (lane_idle == {NUM_CORES{1'b1}})
+              begin
+                snowv_gcm_array_wrapper_ctrl_new = CTRL_BATCH_WRITE;
+                snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_BATCH_WRITE:
+            if (fpga_to_arm_data_ready)
+              begin
+                snowv_gcm_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_STATS_WRITE:
+            if (fpga_to_arm_data_ready)
+              begin
+                snowv_gcm_array_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_ASSERT_DONE:
+            if (fpga_to_arm_done_read)
+              begin
+                snowv_gcm_array_wrapper_ctrl_new = CTRL_WAIT_FOR_CMD;
+                snowv_gcm_array_wrapper_ctrl_we  = 1'b1;
+              end
+          default:
+            begin
+
+            end
+          endcase // case (snowv_gcm_array_wrapper_ctrl_reg)
+        end // snowv_gcm_array_wrapper_ctrl
+
+    //----------------------------------------------------------------
+    // Wrapper control signals
+    //
+    // Set the control signals based on the current state of the FSM.
+    //----------------------------------------------------------------
+    assign fpga_to_arm_data_valid_new = (snowv_gcm_array_wrapper_ctrl_reg == CTRL_WRITE) ||
+                                        (snowv_gcm_array_wrapper_ctrl_reg == CTRL_BATCH_WRITE) ||
+                                        (snowv_gcm_array_wrapper_ctrl_reg == CTRL_STATS_WRITE);
+    assign arm_to_fpga_data_ready_new = (snowv_gcm_array_wrapper_ctrl_reg == CTRL_READ) ||
+                                        (snowv_gcm_array_wrapper_ctrl_reg == CTRL_BATCH_READ);
+    assign fpga_to_arm_done_new       = (snowv_gcm_array_wrapper_ctrl_reg == CTRL_ASSERT_DONE);
+
+endmodule
@@ -43,6 +43,10 @@ module snowv_gcm_wrapper(
     //----------------------------------------------------------------
     // Internal constant and parameter definitions.
     //----------------------------------------------------------------
+    localparam CTX_BITS            = 2;  // Number of message contexts: 4
+    localparam CTX_WIDTH           = 1922;
+    localparam CTX_HALF            = 961; // A context takes two frames
+    
       // States
     localparam CTRL_WAIT_FOR_CMD   = 4'h0;  
     localparam CTRL_READ           = 4'h1;
@@ -51,9 +55,14 @@ module snowv_gcm_wrapper(
     localparam CTRL_NEXT           = 4'h4;
     localparam CTRL_FINAL          = 4'h5;
     localparam CTRL_BUSY           = 4'h6;
-    localparam CTRL_BUSY_TAG       = 4'h7;
+    localparam CTRL_LOAD           = 4'h7;
     localparam CTRL_WRITE          = 4'h8;
     localparam CTRL_ASSERT_DONE    = 4'h9;
+    localparam CTRL_STREAM_READ    = 4'ha;
+    localparam CTRL_STREAM_NEXT    = 4'hb;
+    localparam CTRL_STREAM_BUSY    = 4'hc;
+    localparam CTRL_STREAM_WRITE   = 4'hd;
+    localparam CTRL_STATS_WRITE    = 4'he;
     
       // Wrapper commands
     localparam CMD_READ            = 32'h0;
@@ -62,6 +71,16 @@ module snowv_gcm_wrapper(
     localparam CMD_COMPUTE_NEXT    = 32'h3;
     localparam CMD_COMPUTE_FINAL   = 32'h4;
     localparam CMD_WRITE           = 32'h5;
+    localparam CMD_COMPUTE_STREAM  = 32'h6;
+    localparam CMD_READ_STATS      = 32'h7;
+    localparam CMD_READ_STATS_HI   = 32'hf;  // CMD_READ_STATS with bit 3 set
+    localparam CMD_WRITE_PREV      = 32'hd;  // CMD_WRITE with bit 3 set
+    localparam CMD_RESTORE_CTX     = 32'h8;  // CMD_READ with bit 3 set
+    localparam CMD_SAVE_CTX        = 32'h9;  // Lower half of the context
+    localparam CMD_SAVE_CTX_HI     = 32'ha;  // Upper half of the context
+    
+      // Maximum number of payload blocks in one stream frame
+    localparam STREAM_BLOCKS       = 7;
 
     //----------------------------------------------------------------
     // Registers + update variables and write enable.
@@ -100,8 +119,32 @@ module snowv_gcm_wrapper(
     reg [63 : 0]   len_i_reg;
     wire [63 : 0]  len_i_new;
     
+    reg [7 : 0]    ctx_id_reg;
+    wire [7 : 0]   ctx_id_new;
+    
     reg            inputs_we;
     
+      // Double buffering: READ fills in_buf_reg, which is copied into the
+      // registers above when the next command starts on the core. The core
+      // runs in the background (core_busy_reg until ready, tag_busy_reg
+      // until tag_ready), so the host can upload the next frame and fetch
+      // the previous result (out_buf_reg, saved when a new compute starts)
+      // while it computes.
+    reg [779 : 0]  in_buf_reg;
+    reg            in_buf_we;
+    
+    reg [3 : 0]    start_state_reg;
+    reg [3 : 0]    start_state_new;
+    reg            start_state_we;
+    
+    reg            core_busy_reg;
+    reg            core_busy_new;
+    reg            core_busy_we;
+    
+    reg            tag_busy_reg;
+    reg            tag_busy_new;
+    reg            tag_busy_we;
+    
     reg [127 : 0]  block_o_reg;
     wire [127 : 0] block_o_new;
     reg            block_o_we;
@@ -110,6 +153,66 @@ module snowv_gcm_wrapper(
     wire [127 : 0] tag_new;
     reg            tag_we;
     
+    reg [255 : 0]  out_buf_reg;
+    reg            out_buf_we;
+    
+    reg            write_prev_reg;
+    reg            write_prev_new;
+    reg            write_prev_we;
+    
+    reg [127 : 0]  stream_i_reg [0 : STREAM_BLOCKS - 1];
+    reg [127 : 0]  stream_i_new [0 : STREAM_BLOCKS - 1];
+    
+    reg [2 : 0]    stream_len_reg;
+    wire [2 : 0]   stream_len_new;
+    
+    reg            stream_adj_len_reg;
+    wire           stream_adj_len_new;
+    
+    reg            stream_we;
+    
+    reg [127 : 0]  stream_o_reg [0 : STREAM_BLOCKS - 1];
+    reg            stream_o_we;
+    
+    reg [2 : 0]    stream_ctr_reg;
+    reg [2 : 0]    stream_ctr_new;
+    reg            stream_ctr_we;
+    
+    reg            stream_mode_reg;
+    reg            stream_mode_new;
+    reg            stream_mode_we;
+    
+    reg            stats_mode_reg;
+    reg            stats_mode_new;
+    reg            stats_mode_we;
+    
+      // Contexts: the state of up to 2**CTX_BITS messages, selected by the
+      // ctx_id of the frame. The core holds the state of context
+      // ctx_cur_reg (while ctx_live_reg), ctx_mem that of the others. A
+      // compute command for another context first swaps the two, once the
+      // core is quiescent (core_ctx_ready). CMD_SAVE_CTX/CMD_SAVE_CTX_HI
+      // and CMD_RESTORE_CTX move a context to and from the host, half a
+      // context per frame. CMD_COMPUTE_STREAM has no ctx_id and continues
+      // the context of the last compute command.
+    reg [CTX_WIDTH - 1 : 0] ctx_mem [0 : (1 << CTX_BITS) - 1];
+    reg [CTX_WIDTH - 1 : 0] ctx_mem_new;
+    reg [CTX_BITS - 1 : 0]  ctx_mem_addr;
+    reg            ctx_mem_we;
+    
+    reg [CTX_BITS - 1 : 0]  ctx_cur_reg;
+    reg            ctx_cur_we;
+    
+    reg            ctx_live_reg;
+    reg            ctx_live_new;
+    reg            ctx_live_we;
+    
+    reg            ctx_mode_reg;
+    reg            ctx_mode_new;
+    reg            ctx_mode_we;
+    
+    reg            ctx_half_reg;
+    reg            ctx_half_new;
+    
     reg            fpga_to_arm_data_valid_reg;
     wire           fpga_to_arm_data_valid_new;
     
@@ -143,9 +246,39 @@ module snowv_gcm_wrapper(
     wire           core_ready;
     wire           core_tag_ready;
     
+    reg            core_ctx_load;
+    wire [1921 : 0] core_ctx_i;
+    wire [1921 : 0] core_ctx_o;
+    wire           core_ctx_ready;
+    
+      // Contexts
+    wire           ctx_swap;
+    wire [CTX_BITS - 1 : 0] ctx_save_slot;
+    wire [CTX_WIDTH - 1 : 0] ctx_save;
+    wire [CTX_HALF - 1 : 0] ctx_save_half;
+    wire [CTX_BITS - 1 : 0] ctx_restore_slot;
+    wire           ctx_restore_half;
+    
+    wire           stream_last;
+    wire           stream_core;
+    wire [895 : 0] stream_o;
+    
+      // Statistics
+    wire           stats_cmd_accept;
+    wire [1023 : 0] stats;
+    
     //----------------------------------------------------------------
     // Instantiations.
     //----------------------------------------------------------------
+    wrapper_stats wrapper_stats(
+                                .clk(clk),
+                                .reset_n(resetn),
+                                .state(snowv_gcm_wrapper_ctrl_reg),
+                                .cmd_accept(stats_cmd_accept),
+                                .cmd(arm_to_fpga_cmd[3 : 0]),
+                                .stats(stats)
+                                );
+    
     snowv_gcm core(
                    .clk(clk),
                    .reset_n(resetn),
@@ -165,6 +298,11 @@ module snowv_gcm_wrapper(
                    .block_i(core_block_i),
                    .len_i(core_len_i),
                    
+                   .ctx_load(core_ctx_load),
+                   .ctx_i(core_ctx_i),
+                   .ctx_o(core_ctx_o),
+                   .ctx_ready(core_ctx_ready),
+                   
                    .block_o(core_block_o),
                    .tag(core_tag),
                    .ready(core_ready),
@@ -178,35 +316,80 @@ module snowv_gcm_wrapper(
     assign core_encdec_only = encdec_only_reg;
     assign core_auth_only   = auth_only_reg;
     assign core_encdec      = encdec_reg;
-    assign core_adj_len     = adj_len_reg;
+    assign core_adj_len     = stream_core ? (stream_adj_len_reg & stream_last) : adj_len_reg;
     assign core_key         = key_reg;
     assign core_iv          = iv_reg;
     assign core_ad          = ad_reg;
     assign core_len_ad      = len_ad_reg;
-    assign core_block_i     = block_i_reg;
+    assign core_block_i     = stream_core ? stream_i_reg[stream_ctr_reg] : block_i_reg;
     assign core_len_i       = len_i_reg;
+    assign core_ctx_i       = ctx_mem[ctx_id_reg[CTX_BITS - 1 : 0]];
     
     assign block_o_new      = core_block_o;
     assign tag_new          = core_tag;
     
       // ARM to FPGA data decomposition
-    assign encdec_only_new = arm_to_fpga_data[771];
-    assign auth_only_new   = arm_to_fpga_data[770];
-    assign encdec_new      = arm_to_fpga_data[769];
-    assign adj_len_new     = arm_to_fpga_data[768];
-    assign key_new         = arm_to_fpga_data[767 : 512];
-    assign iv_new          = arm_to_fpga_data[511 : 384];
-    assign ad_new          = arm_to_fpga_data[383 : 256];
-    assign len_ad_new      = arm_to_fpga_data[255 : 192];
-    assign block_i_new     = arm_to_fpga_data[191 : 64];
-    assign len_i_new       = arm_to_fpga_data[63 : 0];
+    assign ctx_id_new      = in_buf_reg[779 : 772];
+    assign encdec_only_new = in_buf_reg[771];
+    assign auth_only_new   = in_buf_reg[770];
+    assign encdec_new      = in_buf_reg[769];
+    assign adj_len_new     = in_buf_reg[768];
+    assign key_new         = in_buf_reg[767 : 512];
+    assign iv_new          = in_buf_reg[511 : 384];
+    assign ad_new          = in_buf_reg[383 : 256];
+    assign len_ad_new      = in_buf_reg[255 : 192];
+    assign block_i_new     = in_buf_reg[191 : 64];
+    assign len_i_new       = in_buf_reg[63 : 0];
+    
+      // ARM to FPGA stream frame decomposition: up to STREAM_BLOCKS payload
+      // blocks, the number of valid blocks and whether the last one is partial.
+    assign stream_adj_len_new = arm_to_fpga_data[899];
+    assign stream_len_new     = arm_to_fpga_data[898 : 896];
+    
+    always @*
+      begin: stream_frame
+        stream_i_new[0] = arm_to_fpga_data[127 : 0];
+        stream_i_new[1] = arm_to_fpga_data[255 : 128];
+        stream_i_new[2] = arm_to_fpga_data[383 : 256];
+        stream_i_new[3] = arm_to_fpga_data[511 : 384];
+        stream_i_new[4] = arm_to_fpga_data[639 : 512];
+        stream_i_new[5] = arm_to_fpga_data[767 : 640];
+        stream_i_new[6] = arm_to_fpga_data[895 : 768];
+      end
+    
+    assign stream_o    = {stream_o_reg[6], stream_o_reg[5], stream_o_reg[4], stream_o_reg[3],
+                          stream_o_reg[2], stream_o_reg[1], stream_o_reg[0]};
+    assign stream_last = (stream_ctr_reg == stream_len_reg - 3'h1);
+    
+      // A stream command may be accepted while a block still runs in the
+      // background, which keeps its own inputs until the core is ready.
+    assign stream_core = stream_mode_reg && !core_busy_reg;
+    
+      // Contexts: a compute command swaps first if its frame is for
+      // another context than the live one. CMD_SAVE_CTX returns the context
+      // named in the last frame read, from the core if it is the live one.
+      // A context frame holds half of the state in its lower CTX_HALF bits,
+      // the half in bit 1015 and the ctx_id in bits 1023 to 1016. Both
+      // halves have to be restored.
+    assign ctx_swap         = (ctx_id_reg[CTX_BITS - 1 : 0] != ctx_cur_reg) || !ctx_live_reg;
+    assign ctx_save_slot    = ctx_id_new[CTX_BITS - 1 : 0];
+    assign ctx_save         = (ctx_live_reg && (ctx_save_slot == ctx_cur_reg)) ? core_ctx_o : ctx_mem[ctx_save_slot];
+    assign ctx_save_half    = ctx_half_reg ? ctx_save[CTX_WIDTH - 1 : CTX_HALF] : ctx_save[CTX_HALF - 1 : 0];
+    assign ctx_restore_slot = arm_to_fpga_data[1016 + CTX_BITS - 1 : 1016];
+    assign ctx_restore_half = arm_to_fpga_data[1015];
     
       // Wrapper I/O
-    assign fpga_to_arm_data       = {768'h0, block_o_reg, tag_reg};
+    assign fpga_to_arm_data       = stats_mode_reg ? stats :
+                                    ctx_mode_reg ? {ctx_id_new, ctx_half_reg, {(1015 - CTX_HALF){1'b0}}, ctx_save_half} :
+                                    stream_mode_reg ? {128'h0, stream_o} :
+                                    {768'h0, write_prev_reg ? out_buf_reg : {block_o_reg, tag_reg}};
     assign fpga_to_arm_data_valid = fpga_to_arm_data_valid_reg;
     assign arm_to_fpga_data_ready = arm_to_fpga_data_ready_reg;
     assign fpga_to_arm_done       = fpga_to_arm_done_reg;
     
+      // Statistics: every command that leaves CTRL_WAIT_FOR_CMD is counted
+    assign stats_cmd_accept = (snowv_gcm_wrapper_ctrl_reg == CTRL_WAIT_FOR_CMD) && snowv_gcm_wrapper_ctrl_we;
+    
       // The four LEDs on the board are used as debug signals.
     assign leds = snowv_gcm_wrapper_ctrl_reg;
 
@@ -219,8 +402,17 @@ module snowv_gcm_wrapper(
     //----------------------------------------------------------------
     always @ (posedge clk or negedge resetn)
       begin: reg_update
+        integer j;
+        
         if (!resetn)
           begin
+            for (j = 0; j < (1 << CTX_BITS); j = j + 1)
+              ctx_mem[j] <= {CTX_WIDTH{1'b0}};
+            for (j = 0; j < STREAM_BLOCKS; j = j + 1)
+              begin
+                stream_i_reg[j] <= 128'h0;
+                stream_o_reg[j] <= 128'h0;
+              end
             snowv_gcm_wrapper_ctrl_reg <= CTRL_WAIT_FOR_CMD;
             encdec_only_reg            <= 1'b0;
             auth_only_reg              <= 1'b0;
@@ -232,8 +424,24 @@ module snowv_gcm_wrapper(
             len_ad_reg                 <= 64'h0;
             block_i_reg                <= 128'h0;
             len_i_reg                  <= 64'h0;
+            ctx_id_reg                 <= 8'h0;
             block_o_reg                <= 128'h0;
             tag_reg                    <= 128'h0;
+            in_buf_reg                 <= 780'h0;
+            start_state_reg            <= CTRL_WAIT_FOR_CMD;
+            core_busy_reg              <= 1'b0;
+            tag_busy_reg               <= 1'b0;
+            out_buf_reg                <= 256'h0;
+            write_prev_reg             <= 1'b0;
+            stream_len_reg             <= 3'h0;
+            stream_adj_len_reg         <= 1'b0;
+            stream_ctr_reg             <= 3'h0;
+            stream_mode_reg            <= 1'b0;
+            stats_mode_reg             <= 1'b0;
+            ctx_cur_reg                <= {CTX_BITS{1'b0}};
+            ctx_live_reg               <= 1'b0;
+            ctx_mode_reg               <= 1'b0;
+            ctx_half_reg               <= 1'b0;
           end
         else
           begin
@@ -251,11 +459,50 @@ module snowv_gcm_wrapper(
                 len_ad_reg                 <= len_ad_new;
                 block_i_reg                <= block_i_new;
                 len_i_reg                  <= len_i_new;
+                ctx_id_reg                 <= ctx_id_new;
               end
             if (block_o_we)
               block_o_reg <= block_o_new;
             if (tag_we)
               tag_reg <= tag_new;
+            if (in_buf_we)
+              in_buf_reg <= arm_to_fpga_data[779 : 0];
+            if (start_state_we)
+              start_state_reg <= start_state_new;
+            if (core_busy_we)
+              core_busy_reg <= core_busy_new;
+            if (tag_busy_we)
+              tag_busy_reg <= tag_busy_new;
+            if (out_buf_we)
+              out_buf_reg <= {block_o_reg, tag_reg};
+            if (write_prev_we)
+              write_prev_reg <= write_prev_new;
+            if (stream_we)
+              begin
+                for (j = 0; j < STREAM_BLOCKS; j = j + 1)
+                  stream_i_reg[j] <= stream_i_new[j];
+                stream_len_reg     <= stream_len_new;
+                stream_adj_len_reg <= stream_adj_len_new;
+              end
+            if (stream_o_we)
+              stream_o_reg[stream_ctr_reg] <= core_block_o;
+            if (stream_ctr_we)
+              stream_ctr_reg <= stream_ctr_new;
+            if (stream_mode_we)
+              stream_mode_reg <= stream_mode_new;
+            if (stats_mode_we)
+              stats_mode_reg <= stats_mode_new;
+            if (ctx_mem_we)
+              ctx_mem[ctx_mem_addr] <= ctx_mem_new;
+            if (ctx_cur_we)
+              ctx_cur_reg <= ctx_id_reg[CTX_BITS - 1 : 0];
+            if (ctx_live_we)
+              ctx_live_reg <= ctx_live_new;
+            if (ctx_mode_we)
+              begin
+                ctx_mode_reg <= ctx_mode_new;
+                ctx_half_reg <= ctx_half_new;
+              end
             
             // Wrapper control signals don't have a write enable
             fpga_to_arm_data_valid_reg <= fpga_to_arm_data_valid_new;
@@ -280,6 +527,49 @@ module snowv_gcm_wrapper(
         inputs_we                  = 1'b0;
         block_o_we                 = 1'b0;
         tag_we                     = 1'b0;
+        in_buf_we                  = 1'b0;
+        start_state_new            = CTRL_WAIT_FOR_CMD;
+        start_state_we             = 1'b0;
+        core_busy_new              = 1'b0;
+        core_busy_we               = 1'b0;
+        tag_busy_new               = 1'b0;
+        tag_busy_we                = 1'b0;
+        out_buf_we                 = 1'b0;
+        write_prev_new             = 1'b0;
+        write_prev_we              = 1'b0;
+        stream_we                  = 1'b0;
+        stream_o_we                = 1'b0;
+        stream_ctr_new             = 3'h0;
+        stream_ctr_we              = 1'b0;
+        stream_mode_new            = 1'b0;
+        stream_mode_we             = 1'b0;
+        stats_mode_new             = 1'b0;
+        stats_mode_we              = 1'b0;
+        core_ctx_load              = 1'b0;
+        ctx_mem_new                = core_ctx_o;
+        ctx_mem_addr               = ctx_cur_reg;
+        ctx_mem_we                 = 1'b0;
+        ctx_cur_we                 = 1'b0;
+        ctx_live_new               = 1'b0;
+        ctx_live_we                = 1'b0;
+        ctx_mode_new               = 1'b0;
+        ctx_mode_we                = 1'b0;
+        ctx_half_new               = 1'b0;
+        
+        // The results of the core are captured whatever command the FSM
+        // is handling in the meantime
+        if (core_busy_reg && core_ready)
+          begin
+            block_o_we    = 1'b1;
+            core_busy_new = 1'b0;
+            core_busy_we  = 1'b1;
+          end
+        if (tag_busy_reg && core_tag_ready)
+          begin
+            tag_we       = 1'b1;
+            tag_busy_new = 1'b0;
+            tag_busy_we  = 1'b1;
+          end
         
         case (snowv_gcm_wrapper_ctrl_reg)
           CTRL_WAIT_FOR_CMD:
@@ -287,21 +577,65 @@ module snowv_gcm_wrapper(
               if (arm_to_fpga_cmd_valid)
                 begin
                   snowv_gcm_wrapper_ctrl_we  = 1'b1;
+                  stream_mode_we             = 1'b1;
+                  stats_mode_we              = 1'b1;
+                  write_prev_we              = 1'b1;
+                  ctx_mode_we                = 1'b1;
+                  start_state_we             = 1'b1;
+                  snowv_gcm_wrapper_ctrl_new = CTRL_LOAD;
                   case (arm_to_fpga_cmd)
                     CMD_READ:
                       snowv_gcm_wrapper_ctrl_new = CTRL_READ;
                     CMD_COMPUTE_INIT:
-                      snowv_gcm_wrapper_ctrl_new = CTRL_INIT;
+                      start_state_new            = CTRL_INIT;
                     CMD_COMPUTE_NEXT_AD:
-                      snowv_gcm_wrapper_ctrl_new = CTRL_NEXT_AD;
+                      start_state_new            = CTRL_NEXT_AD;
                     CMD_COMPUTE_NEXT:
-                      snowv_gcm_wrapper_ctrl_new = CTRL_NEXT;
+                      start_state_new            = CTRL_NEXT;
                     CMD_COMPUTE_FINAL:
-                      snowv_gcm_wrapper_ctrl_new = CTRL_FINAL;
+                      start_state_new            = CTRL_FINAL;
                     CMD_WRITE:
-                      snowv_gcm_wrapper_ctrl_new = CTRL_WRITE;
+                      snowv_gcm_wrapper_ctrl_new = CTRL_BUSY;
+                    CMD_WRITE_PREV:
+                      begin
+                        snowv_gcm_wrapper_ctrl_new = CTRL_WRITE;
+                        write_prev_new             = 1'b1;
+                      end
+                    CMD_COMPUTE_STREAM:
+                      begin
+                        snowv_gcm_wrapper_ctrl_new = CTRL_STREAM_READ;
+                        stream_mode_new            = 1'b1;
+                      end
+                    CMD_READ_STATS, CMD_READ_STATS_HI:
+                      begin
+                        snowv_gcm_wrapper_ctrl_new = CTRL_STATS_WRITE;
+                        stats_mode_new             = 1'b1;
+                      end
+                    CMD_RESTORE_CTX:
+                      begin
+                        snowv_gcm_wrapper_ctrl_new = CTRL_READ;
+                        ctx_mode_new               = 1'b1;
+                      end
+                    CMD_SAVE_CTX:
+                      begin
+                        snowv_gcm_wrapper_ctrl_new = CTRL_BUSY;
+                        ctx_mode_new               = 1'b1;
+                      end
+                    CMD_SAVE_CTX_HI:
+                      begin
+                        snowv_gcm_wrapper_ctrl_new = CTRL_BUSY;
+                        ctx_mode_new               = 1'b1;
+                        ctx_half_new               = 1'b1;
+                      end
                     default:
-                      snowv_gcm_wrapper_ctrl_we  = 1'b0;
+                      begin
+                        snowv_gcm_wrapper_ctrl_we  = 1'b0;
+                        stream_mode_we             = 1'b0;
+                        stats_mode_we              = 1'b0;
+                        write_prev_we              = 1'b0;
+                        ctx_mode_we                = 1'b0;
+                        start_state_we             = 1'b0;
+                      end
                   endcase
                 end
             end
@@ -310,47 +644,139 @@ module snowv_gcm_wrapper(
               begin
                 snowv_gcm_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 snowv_gcm_wrapper_ctrl_we  = 1'b1;
-                inputs_we                  = 1'b1;
+                  // A context frame goes straight into the context table.
+                  // Restoring the live context drops the state in the core.
+                if (ctx_mode_reg)
+                  begin
+                    if (ctx_restore_half)
+                      ctx_mem_new = {arm_to_fpga_data[CTX_HALF - 1 : 0], ctx_mem[ctx_restore_slot][CTX_HALF - 1 : 0]};
+                    else
+                      ctx_mem_new = {ctx_mem[ctx_restore_slot][CTX_WIDTH - 1 : CTX_HALF], arm_to_fpga_data[CTX_HALF - 1 : 0]};
+                    ctx_mem_addr = ctx_restore_slot;
+                    ctx_mem_we   = 1'b1;
+                    if (ctx_restore_slot == ctx_cur_reg)
+                      ctx_live_we = 1'b1;
+                  end
+                else
+                  in_buf_we                  = 1'b1;
+              end
+          CTRL_LOAD:
+            if (!core_busy_reg && !tag_busy_reg)
+              begin
+                  // The inputs are loaded first. A frame for another
+                  // context than the live one then swaps the contexts and
+                  // loads the inputs again, two cycles more. GHASH still
+                  // drains with the lengths of the live context, so both
+                  // wait for core_ctx_ready.
+                if (ctx_swap)
+                  begin
+                    if (core_ctx_ready)
+                      begin
+                        core_ctx_load = 1'b1;
+                        ctx_mem_we    = ctx_live_reg;
+                        ctx_cur_we    = 1'b1;
+                        ctx_live_new  = 1'b1;
+                        ctx_live_we   = 1'b1;
+                      end
+                  end
+                else if ((ctx_id_new[CTX_BITS - 1 : 0] == ctx_cur_reg) || core_ctx_ready)
+                  begin
+                    inputs_we = 1'b1;
+                    if (ctx_id_new[CTX_BITS - 1 : 0] == ctx_cur_reg)
+                      begin
+                        snowv_gcm_wrapper_ctrl_new = start_state_reg;
+                        snowv_gcm_wrapper_ctrl_we  = 1'b1;
+                      end
+                  end
               end
           CTRL_INIT:
             begin
               core_init                  = 1'b1;
-              snowv_gcm_wrapper_ctrl_new = CTRL_BUSY;
+              core_busy_new              = 1'b1;
+              core_busy_we               = 1'b1;
+              out_buf_we                 = 1'b1;
+              snowv_gcm_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               snowv_gcm_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_NEXT_AD:
             begin
               core_next_ad               = 1'b1;
-              snowv_gcm_wrapper_ctrl_new = CTRL_BUSY;
+              core_busy_new              = 1'b1;
+              core_busy_we               = 1'b1;
+              out_buf_we                 = 1'b1;
+              snowv_gcm_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               snowv_gcm_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_NEXT:
             begin
               core_next                  = 1'b1;
-              snowv_gcm_wrapper_ctrl_new = CTRL_BUSY;
+              core_busy_new              = 1'b1;
+              core_busy_we               = 1'b1;
+              out_buf_we                 = 1'b1;
+              snowv_gcm_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               snowv_gcm_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_FINAL:
             begin
               core_finalize              = 1'b1;
-              snowv_gcm_wrapper_ctrl_new = CTRL_BUSY_TAG;
+              tag_busy_new               = 1'b1;
+              tag_busy_we                = 1'b1;
+              out_buf_we                 = 1'b1;
+              snowv_gcm_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               snowv_gcm_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_BUSY:
-            if (core_ready)
+            if (!core_busy_reg && !tag_busy_reg && (!ctx_mode_reg || core_ctx_ready))
+              begin
+                snowv_gcm_wrapper_ctrl_new = CTRL_WRITE;
+                snowv_gcm_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_WRITE:
+            if (fpga_to_arm_data_ready)
               begin
                 snowv_gcm_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 snowv_gcm_wrapper_ctrl_we  = 1'b1;
-                block_o_we = 1'b1;
               end
-          CTRL_BUSY_TAG:
-            if (core_tag_ready)
+          CTRL_STREAM_READ:
+            if (arm_to_fpga_data_valid)
+              begin
+                stream_we                  = 1'b1;
+                stream_ctr_new             = 3'h0;
+                stream_ctr_we              = 1'b1;
+                snowv_gcm_wrapper_ctrl_we  = 1'b1;
+                if (stream_len_new == 3'h0)
+                  snowv_gcm_wrapper_ctrl_new = CTRL_STREAM_WRITE;
+                else
+                  snowv_gcm_wrapper_ctrl_new = CTRL_STREAM_NEXT;
+              end
+          CTRL_STREAM_NEXT:
+            if (!core_busy_reg && !tag_busy_reg)
+              begin
+                core_next                  = 1'b1;
+                snowv_gcm_wrapper_ctrl_new = CTRL_STREAM_BUSY;
+                snowv_gcm_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_STREAM_BUSY:
+            if (core_ready)
+              begin
+                stream_o_we                = 1'b1;
+                snowv_gcm_wrapper_ctrl_we  = 1'b1;
+                if (stream_last)
+                  snowv_gcm_wrapper_ctrl_new = CTRL_STREAM_WRITE;
+                else
+                  begin
+                    stream_ctr_new             = stream_ctr_reg + 3'h1;
+                    stream_ctr_we              = 1'b1;
+                    snowv_gcm_wrapper_ctrl_new = CTRL_STREAM_NEXT;
+                  end
+              end
+          CTRL_STREAM_WRITE:
+            if (fpga_to_arm_data_ready)
               begin
                 snowv_gcm_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 snowv_gcm_wrapper_ctrl_we  = 1'b1;
-                tag_we = 1'b1;
               end
-          CTRL_WRITE:
+          CTRL_STATS_WRITE:
             if (fpga_to_arm_data_ready)
               begin
                 snowv_gcm_wrapper_ctrl_new = CTRL_ASSERT_DONE;
@@ -374,8 +800,11 @@ module snowv_gcm_wrapper(
     //
     // Set the control signals based on the current state of the FSM.
     //----------------------------------------------------------------
-    assign fpga_to_arm_data_valid_new = (snowv_gcm_wrapper_ctrl_reg == CTRL_WRITE);
-    assign arm_to_fpga_data_ready_new = (snowv_gcm_wrapper_ctrl_reg == CTRL_READ);
+    assign fpga_to_arm_data_valid_new = (snowv_gcm_wrapper_ctrl_reg == CTRL_WRITE) ||
+                                        (snowv_gcm_wrapper_ctrl_reg == CTRL_STREAM_WRITE) ||
+                                        (snowv_gcm_wrapper_ctrl_reg == CTRL_STATS_WRITE);
+    assign arm_to_fpga_data_ready_new = (snowv_gcm_wrapper_ctrl_reg == CTRL_READ) ||
+                                        (snowv_gcm_wrapper_ctrl_reg == CTRL_STREAM_READ);
     assign fpga_to_arm_done_new       = (snowv_gcm_wrapper_ctrl_reg == CTRL_ASSERT_DONE);
 
 endmodule
\ No newline at end of file
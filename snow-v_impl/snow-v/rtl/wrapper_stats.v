@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company: 
+// Engineer: 
+// 
+// Create Date: 
+// Design Name: 
+// Module Name: wrapper_stats
+// Project Name: 
+// Target Devices: 
+// Tool Versions: 
+// Description: Free-running cycle counters for the control FSM of a wrapper.
+//              Counts the cycles spent in every control state, the cycles
+//              spent on every command type (from the cycle after the command
+//              is accepted until the FSM is back in CTRL_WAIT_FOR_CMD) and
+//              the number of accepted commands of every type. The counters
+//              wrap around and are only cleared by the reset.
+//
+//              Layout of stats, one 32-bit counter per word, when the
+//              last command was CMD_READ_STATS (4'h7):
+//                word  0-15 : cycles in control state 0-15
+//                word 16-23 : cycles spent on command 0-7
+//                word 24-31 : number of commands 0-7
+//              and when it was CMD_READ_STATS_HI (4'hf):
+//                word  0-15 : zero
+//                word 16-23 : cycles spent on command 8-15
+//                word 24-31 : number of commands 8-15
+// 
+// Dependencies: 
+// 
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments: The wrapper FSM must use state 4'h0 for
+//                      CTRL_WAIT_FOR_CMD, and 4'h7 and 4'hf for
+//                      CMD_READ_STATS and CMD_READ_STATS_HI.
+// 
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module wrapper_stats(
+                     input wire             clk,
+                     input wire             reset_n,
+                     
+                     input wire [3 : 0]     state,
+                     input wire             cmd_accept,
+                     input wire [3 : 0]     cmd,
+                     
+                     output wire [1023 : 0] stats
+                     );
+
+    //----------------------------------------------------------------
+    // Internal constant and parameter definitions.
+    //----------------------------------------------------------------
+    localparam CTRL_WAIT_FOR_CMD = 4'h0;
+    localparam CMD_READ_STATS    = 4'h7;
+    localparam CMD_READ_STATS_HI = 4'hf;
+
+    //----------------------------------------------------------------
+    // Registers.
+    //----------------------------------------------------------------
+    reg [31 : 0] state_cycles_reg [0 : 15];
+    reg [31 : 0] cmd_cycles_reg [0 : 15];
+    reg [31 : 0] cmd_count_reg [0 : 15];
+    reg [3 : 0]  cur_cmd_reg;
+    reg          hi_reg;
+
+    //----------------------------------------------------------------
+    // Concurrent connectivity for ports etc.
+    //----------------------------------------------------------------
+    assign stats = hi_reg ?
+                   {cmd_count_reg[15], cmd_count_reg[14], cmd_count_reg[13], cmd_count_reg[12],
+                    cmd_count_reg[11], cmd_count_reg[10], cmd_count_reg[9], cmd_count_reg[8],
+                    cmd_cycles_reg[15], cmd_cycles_reg[14], cmd_cycles_reg[13], cmd_cycles_reg[12],
+                    cmd_cycles_reg[11], cmd_cycles_reg[10], cmd_cycles_reg[9], cmd_cycles_reg[8],
+                    512'h0} :
+                   {cmd_count_reg[7], cmd_count_reg[6], cmd_count_reg[5], cmd_count_reg[4],
+                    cmd_count_reg[3], cmd_count_reg[2], cmd_count_reg[1], cmd_count_reg[0],
+                    cmd_cycles_reg[7], cmd_cycles_reg[6], cmd_cycles_reg[5], cmd_cycles_reg[4],
+                    cmd_cycles_reg[3], cmd_cycles_reg[2], cmd_cycles_reg[1], cmd_cycles_reg[0],
+                    state_cycles_reg[15], state_cycles_reg[14], state_cycles_reg[13], state_cycles_reg[12],
+                    state_cycles_reg[11], state_cycles_reg[10], state_cycles_reg[9], state_cycles_reg[8],
+                    state_cycles_reg[7], state_cycles_reg[6], state_cycles_reg[5], state_cycles_reg[4],
+                    state_cycles_reg[3], state_cycles_reg[2], state_cycles_reg[1], state_cycles_reg[0]};
+
+    //----------------------------------------------------------------
+    // reg_update
+    //
+    // Update functionality for all registers in the core.
+    // All registers are positive edge triggered with asynchronous
+    // active low reset.
+    //----------------------------------------------------------------
+    always @ (posedge clk or negedge reset_n)
+      begin: reg_update
+        integer i;
+        
+        if (!reset_n)
+          begin
+            for (i = 0 ; i < 16 ; i = i + 1)
+              state_cycles_reg[i] <= 32'h0;
+            for (i = 0 ; i < 16 ; i = i + 1)
+              begin
+                cmd_cycles_reg[i] <= 32'h0;
+                cmd_count_reg[i]  <= 32'h0;
+              end
+            cur_cmd_reg <= 4'h0;
+            hi_reg      <= 1'b0;
+          end
+        else
+          begin
+            state_cycles_reg[state] <= state_cycles_reg[state] + 1'b1;
+            
+            if (cmd_accept)
+              begin
+                cur_cmd_reg        <= cmd;
+                cmd_count_reg[cmd] <= cmd_count_reg[cmd] + 1'b1;
+                if (cmd == CMD_READ_STATS || cmd == CMD_READ_STATS_HI)
+                  hi_reg <= (cmd == CMD_READ_STATS_HI);
+              end
+            
+            if (state != CTRL_WAIT_FOR_CMD)
+              cmd_cycles_reg[cur_cmd_reg] <= cmd_cycles_reg[cur_cmd_reg] + 1'b1;
+          end
+      end // reg_update
+
+endmodule
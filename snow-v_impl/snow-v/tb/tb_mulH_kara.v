@@ -0,0 +1,280 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company: 
+// Engineer: 
+// 
+// Create Date: 
+// Design Name: 
+// Module Name: tb_mulH_kara
+// Project Name: 
+// Target Devices: 
+// Tool Versions: 
+// Description: 
+// 
+// Dependencies: 
+// 
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments:
+// 
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module tb_mulH_kara();
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  parameter CLK_HALF_PERIOD = 1;
+  parameter CLK_PERIOD = 2 * CLK_HALF_PERIOD;
+  
+  //----------------------------------------------------------------
+  // Register and Wire declarations.
+  //----------------------------------------------------------------
+  reg [31 : 0] cycle_ctr;
+  reg [31 : 0] error_ctr;
+  reg [31 : 0] tc_ctr;
+  
+  reg            tb_clk;
+  reg            tb_reset_n;
+  reg [1 : 0]    tb_start;
+  reg [1 : 0]    tb_derive;
+  reg [127 : 0]  tb_H;
+  reg [127 : 0]  tb_in;
+  reg [1 : 0]    tb_power;
+  reg            tb_accumulate;
+  wire [127 : 0] tb_out [0 : 1];
+  wire [1 : 0]   tb_ready;
+  
+  reg            tb_sel;  // 0: single-cycle DUT, 1: pipelined DUT
+  
+  //----------------------------------------------------------------
+  // Devices Under Test.
+  //----------------------------------------------------------------
+  mulH_kara #(.PIPELINED(0), .AGGREGATE(1)) dut(
+           .clk(tb_clk),
+           .reset_n(tb_reset_n),
+            
+           .start(tb_start[0]),
+           .derive(tb_derive[0]),
+           .H(tb_H),
+           .block_i(tb_in),
+           .power(tb_power),
+           .accumulate(tb_accumulate),
+            
+           .ctx_load(1'b0),
+           .ctx_i(639'h0),
+           .ctx_o(),
+            
+           .block_o(tb_out[0]),
+           .ready(tb_ready[0])
+           );
+  
+  mulH_kara #(.PIPELINED(1), .AGGREGATE(1)) dut_pipe(
+           .clk(tb_clk),
+           .reset_n(tb_reset_n),
+            
+           .start(tb_start[1]),
+           .derive(tb_derive[1]),
+           .H(tb_H),
+           .block_i(tb_in),
+           .power(tb_power),
+           .accumulate(tb_accumulate),
+            
+           .ctx_load(1'b0),
+           .ctx_i(639'h0),
+           .ctx_o(),
+            
+           .block_o(tb_out[1]),
+           .ready(tb_ready[1])
+           );
+    
+  //----------------------------------------------------------------
+  // clk_gen
+  //
+  // Always running clock generator process.
+  //----------------------------------------------------------------
+  always
+    begin : clk_gen
+      #CLK_HALF_PERIOD;
+      tb_clk = !tb_clk;
+    end // clk_gen
+  
+  //----------------------------------------------------------------
+  // sys_monitor()
+  //
+  // An always running process that creates a cycle counter and
+  // conditionally displays information about the DUT.
+  //----------------------------------------------------------------
+  always
+    begin : sys_monitor
+      cycle_ctr = cycle_ctr + 1;
+      #(CLK_PERIOD);
+    end
+  
+  //----------------------------------------------------------------
+  // reset_dut()
+  //
+  // Toggle reset to put the DUT into a well known state.
+  //----------------------------------------------------------------
+  task reset_dut;
+    begin
+      $display("*** Toggle reset.");
+      tb_reset_n = 0;
+      #(2 * CLK_PERIOD);
+      tb_reset_n = 1;
+    end
+  endtask // reset_dut
+
+  //----------------------------------------------------------------
+  // init_sim()
+  //
+  // Initialize all counters and testbed functionality as well
+  // as setting the DUT inputs to defined values.
+  //----------------------------------------------------------------
+  task init_sim;
+    begin
+      cycle_ctr = 0;
+      error_ctr = 0;
+      tc_ctr    = 0;
+
+      tb_clk        = 0;
+      tb_reset_n    = 1;
+      tb_start      = 2'b00;
+      tb_derive     = 2'b00;
+      tb_in         = {4{32'h00000000}};
+      tb_H          = {4{32'h00000000}};
+      tb_power      = 2'h0;
+      tb_accumulate = 1'b0;
+      tb_sel        = 1'b0;
+    end
+  endtask // init_sim
+  
+  //----------------------------------------------------------------
+  // display_test_result()
+  //
+  // Display the accumulated test results.
+  //----------------------------------------------------------------
+  task display_test_result;
+    begin
+      if (error_ctr == 0)
+        begin
+          $display("*** All %02d test cases completed successfully", tc_ctr);
+        end
+      else
+        begin
+          $display("*** %02d tests completed - %02d test cases did not complete successfully.",
+                   tc_ctr, error_ctr);
+        end
+    end
+  endtask // display_test_result
+  
+  //----------------------------------------------------------------
+  // wait_ready()
+  //
+  // Wait for the ready flag in the selected dut to be set.
+  //
+  // Note: It is the callers responsibility to call the function
+  // when the dut is actively processing and will in fact at some
+  // point set the flag.
+  //----------------------------------------------------------------
+  task wait_ready;
+    begin
+      while (!tb_ready[tb_sel])
+        begin
+          #(CLK_PERIOD);
+        end
+    end
+  endtask // wait_ready
+  
+  //----------------------------------------------------------------
+  // multiply()
+  //
+  // Multiply one block with H^(power + 1) in the selected dut.
+  //----------------------------------------------------------------
+  task multiply(input [127 : 0] in, input [1 : 0] power, input accumulate);
+    begin
+      tb_in         = in;
+      tb_power      = power;
+      tb_accumulate = accumulate;
+      tb_start[tb_sel] = 1'b1;
+      #(CLK_PERIOD*2);
+      tb_start[tb_sel] = 1'b0;
+      wait_ready();
+    end
+  endtask // multiply
+  
+  //----------------------------------------------------------------
+  // check_out()
+  //----------------------------------------------------------------
+  task check_out(input [127 : 0] expected);
+    begin
+      if (tb_out[tb_sel] == expected)
+         begin
+           $display("--- Testcase successful.");
+           $display("--- Got: 0x%032x", tb_out[tb_sel]);
+         end
+       else
+         begin
+           $display("--- ERROR: Testcase NOT successful.");
+           $display("--- Expected: 0x%032x", expected);
+           $display("--- Got:      0x%032x", tb_out[tb_sel]);
+           error_ctr = error_ctr + 1;
+         end
+    end
+  endtask // check_out
+  
+  //----------------------------------------------------------------
+  // kara_test()
+  //
+  // Single multiplication with H, followed by four blocks absorbed
+  // with H^4..H^1 and a single reduction. The result of the latter
+  // equals four Horner steps (((B1.H ^ B2).H ^ B3).H ^ B4).H.
+  //----------------------------------------------------------------
+  task kara_test;
+    begin
+      $display("*** Begin test of the %s multiplier.", tb_sel ? "pipelined" : "single-cycle");
+      
+      tc_ctr = tc_ctr + 1;
+      tb_H = 128'ha578c7e6c9dde77fafb7ae37fa56954a;
+      multiply(128'hdd7e01b2b424a2ef8250000000000000, 2'h0, 1'b0);
+      check_out(128'h6eebfcd4b92e5fb516ed6f1a6f48de7f);
+      
+      tc_ctr = tc_ctr + 1;
+      tb_derive[tb_sel] = 1'b1;
+      #(CLK_PERIOD*2);
+      tb_derive[tb_sel] = 1'b0;
+      wait_ready();
+      
+      multiply(128'hdd7e01b2b424a2ef8250000000000000, 2'h3, 1'b1);
+      multiply(128'h00000000000000000000000000000001, 2'h2, 1'b1);
+      multiply(128'h80000000000000000000000000000000, 2'h1, 1'b1);
+      multiply(128'h0123456789abcdef0123456789abcdef, 2'h0, 1'b0);
+      check_out(128'h6232b2ed47426bc8b9e9c556f01315aa);
+      $display("");
+    end
+  endtask // kara_test
+
+  //----------------------------------------------------------------
+  // mulH_test
+  // The main test functionality.
+  //----------------------------------------------------------------
+  initial
+    begin : mulH_test
+      init_sim();
+      reset_dut();
+
+      tb_sel = 1'b0;
+      kara_test();
+      
+      tb_sel = 1'b1;
+      kara_test();
+         
+      display_test_result();
+      $display("");
+      $display("*** mulH_kara simulation done. ***");
+      $finish;
+         
+    end // mulH_test
+      
+endmodule // tb_mulH_kara
@@ -62,6 +62,10 @@ module tb_snowv_core();
                  .key(tb_key),
                  .iv(tb_iv),
 
+                 .ctx_load(1'b0),
+                 .ctx_i(896'h0),
+                 .ctx_o(),
+
                  .keystream_z(tb_keystream_z),
                  .ready(tb_ready)
                  );
@@ -83,6 +83,11 @@ module tb_snowv_gcm();
                .block_i(tb_block_i),
                .len_i(tb_len_i),
                
+               .ctx_load(1'b0),
+               .ctx_i(1922'h0),
+               .ctx_o(),
+               .ctx_ready(),
+               
                .block_o(tb_block_o),
                .tag(tb_tag),
                .ready(tb_ready),
@@ -779,6 +784,87 @@ module tb_snowv_gcm();
     end
   endtask // test6_dec
 
+  //----------------------------------------------------------------
+  // test6_burst
+  //
+  // Test vectors #6 with the blocks given back to back: every next
+  // follows the previous ready after one cycle, so that GHASH is still
+  // draining the FIFO while the next block is encrypted.
+  //----------------------------------------------------------------
+  task test6_burst;
+    begin : test6_burst
+      integer i;
+      reg [127 : 0] blocks [0 : 2];
+      reg [127 : 0] expected [0 : 2];
+      reg [127 : 0] expected_tag;
+      reg           block_ok;
+
+      $display("*** Testvectors #6 (back to back) BEGIN");
+      inc_tc_ctr();
+
+      tb_key     = 256'hfaeadacabaaa9a8a7a6a5a4a3a2a1a0a5f5e5d5c5b5a59585756555453525150;
+      tb_iv      = 128'h1032547698badcfeefcdab8967452301;
+      tb_ad      = 128'h2165756c6176207473657420444141;
+      tb_len_ad  = 64'd120;
+      tb_len_i   = 64'd264;
+      tb_encdec  = 1'b1;
+      tb_adj_len = 1'b0;
+      
+      blocks[0]   = 128'h66656463626139383736353433323130;
+      blocks[1]   = 128'h65646f6d20444145412d56776f6e5320;
+      blocks[2]   = 128'h21;
+      expected[0] = 128'hc1327ae807275082efa224b4b2017edd;
+      expected[1] = 128'h1be95956a1b53e24127ffd1818d0b052;
+      expected[2] = 128'h4c;
+      
+      tb_init    = 1'h1;
+      #(2 * CLK_PERIOD);
+      tb_init   = 1'h0;
+      wait_ready();
+      
+      block_ok = 1'b1;
+      for (i = 0; i < 3; i = i + 1)
+        begin
+          #(CLK_PERIOD);
+          tb_block_i = blocks[i];
+          tb_adj_len = (i == 2);
+          tb_next    = 1'h1;
+          #(CLK_PERIOD);
+          tb_next    = 1'h0;
+          wait_ready();
+          
+          if (tb_block_o != expected[i])
+            begin
+              $display("Ciphertext %0d incorrect - Expected 0x%032x, got 0x%032x", i, expected[i], tb_block_o);
+              block_ok = 1'b0;
+            end
+        end
+      
+      if (!block_ok)
+        inc_error_ctr();
+      else
+        $display("Ciphertext correct!");
+        
+      expected_tag = 128'h9b02eed99a3e7c74de513ab7a5a67e90;
+      
+      tb_finalize = 1'h1;
+      #(CLK_PERIOD);
+      tb_finalize = 1'h0;
+      wait_tag_ready();
+         
+      if (tb_tag != expected_tag)
+        begin
+          $display("Tag incorrect - Expected 0x%032x, got 0x%032x", expected_tag, tb_tag);
+          inc_error_ctr();
+        end
+      else
+        $display("Tag correct!"); 
+      
+      $display("*** Testvectors #6 (back to back) END");
+      $display("");
+    end
+  endtask // test6_burst
+
   //----------------------------------------------------------------
   // main
   //
@@ -799,6 +885,7 @@ module tb_snowv_gcm();
       test5();
       test6();
       test6_dec();
+      test6_burst();
 
       display_test_results();
       $display("*** SNOWV-GCM simulation done. ***");
@@ -39,6 +39,13 @@ module tb_snowv_gcm_wrapper();
   parameter CMD_COMPUTE_NEXT    = 32'h3;
   parameter CMD_COMPUTE_FINAL   = 32'h4;
   parameter CMD_WRITE           = 32'h5;
+  parameter CMD_COMPUTE_STREAM  = 32'h6;
+  parameter CMD_READ_STATS      = 32'h7;
+  parameter CMD_READ_STATS_HI   = 32'hf;
+  parameter CMD_WRITE_PREV      = 32'hd;
+  parameter CMD_RESTORE_CTX     = 32'h8;
+  parameter CMD_SAVE_CTX        = 32'h9;
+  parameter CMD_SAVE_CTX_HI     = 32'ha;
   
   //----------------------------------------------------------------
   // Register and Wire declarations.
@@ -310,6 +317,18 @@ module tb_snowv_gcm_wrapper();
     end
   endtask
 
+  //----------------------------------------------------------------
+  // wait_core_idle()
+  //
+  // Wait until the block the core runs in the background is done.
+  //----------------------------------------------------------------
+  task wait_core_idle;
+    begin
+      while (dut.core_busy_reg || dut.tag_busy_reg)
+        #(CLK_PERIOD);
+    end
+  endtask
+
   //----------------------------------------------------------------
   // load_and_init()
   //
@@ -325,6 +344,9 @@ module tb_snowv_gcm_wrapper();
       $display("Sending COMPUTE_INIT command");
       send_cmd_to_hw(CMD_COMPUTE_INIT);
       wait_done();
+      
+      // The tests check the core state right after the init
+      wait_core_idle();
     end
   endtask
   
@@ -370,6 +392,48 @@ module tb_snowv_gcm_wrapper();
     end
   endtask
   
+  //----------------------------------------------------------------
+  // load_and_next_pipelined()
+  //
+  // Load inputs and start the next block while the previous block may
+  // still be running, then read back the result of the previous block.
+  //----------------------------------------------------------------
+  task load_and_next_pipelined(input  [1023 : 0] in,
+                               output [1023 : 0] prev_out);
+    begin
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(in);
+      wait_done();
+        
+      $display("Sending COMPUTE_NEXT command");
+      send_cmd_to_hw(CMD_COMPUTE_NEXT);
+      wait_done();
+        
+      $display("Sending WRITE_PREV command");
+      send_cmd_to_hw(CMD_WRITE_PREV);
+      read_data_from_hw(prev_out);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // load_and_stream()
+  //
+  // Send a stream frame, process all of its blocks, and read back
+  // the resulting blocks in a single command.
+  //----------------------------------------------------------------
+  task load_and_stream(input  [1023 : 0] in,
+                       output [1023 : 0] out);
+    begin
+      $display("Sending COMPUTE_STREAM command");
+      send_cmd_to_hw(CMD_COMPUTE_STREAM);
+      send_data_to_hw(in);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+  
   //----------------------------------------------------------------
   // finalize()
   //
@@ -611,9 +675,434 @@ module tb_snowv_gcm_wrapper();
       $display("");
     end
   endtask // test6
+
+  //----------------------------------------------------------------
+  // test7
+  //
+  // Test vectors #6 for SNOWV-GCM from https://eprint.iacr.org/2018/1143.pdf,
+  // with all payload blocks sent in a single stream frame.
+  //----------------------------------------------------------------
+  task test7;
+    begin : test7
+      reg [1023 : 0] stream_frame;
+      reg [127 : 0]  expected_block0, expected_block1, expected_block2, expected_tag;
+
+      $display("*** Testvectors #6 (stream) BEGIN");
+      inc_tc_ctr();
+      
+      tb_encdec_only = 1'b0;
+      tb_auth_only   = 1'b0;
+      tb_encdec      = 1'b1;
+      tb_adj_len     = 1'b0;
+      tb_key         = 256'hfaeadacabaaa9a8a7a6a5a4a3a2a1a0a5f5e5d5c5b5a59585756555453525150;
+      tb_iv          = 128'h1032547698badcfeefcdab8967452301;
+      tb_ad          = 128'h2165756c6176207473657420444141;
+      tb_len_ad      = 64'd120;
+      tb_block_i     = 128'h0;
+      tb_len_i       = 64'd264;
+      
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+      
+      // Three blocks, the last one partial
+      stream_frame = {124'h0, 1'b1, 3'h3, 512'h0,
+                      128'h21,
+                      128'h65646f6d20444145412d56776f6e5320,
+                      128'h66656463626139383736353433323130};
+      expected_block0 = 128'hc1327ae807275082efa224b4b2017edd;
+      expected_block1 = 128'h1be95956a1b53e24127ffd1818d0b052;
+      expected_block2 = 128'h4c;
+      
+      #(CLK_PERIOD);
+      load_and_stream(stream_frame, tb_output_data);
+      
+      if ((tb_output_data[127 : 0]   != expected_block0) ||
+          (tb_output_data[255 : 128] != expected_block1) ||
+          (tb_output_data[383 : 256] != expected_block2))
+        begin
+          $display("Ciphertext incorrect - Expected 0x%032x 0x%032x 0x%032x, got 0x%032x 0x%032x 0x%032x",
+                   expected_block0, expected_block1, expected_block2,
+                   tb_output_data[127 : 0], tb_output_data[255 : 128], tb_output_data[383 : 256]);
+          inc_error_ctr();
+        end
+      else
+        $display("Ciphertext correct!");
+        
+      expected_tag = 128'h9b02eed99a3e7c74de513ab7a5a67e90;
+      
+      #(CLK_PERIOD);
+      finalize(tb_output_data);
+         
+      if (tb_output_data[127 : 0] != expected_tag)
+        begin
+          $display("Tag incorrect - Expected 0x%032x, got 0x%032x", expected_tag, tb_output_data[127 : 0]);
+          inc_error_ctr();
+        end
+      else
+        $display("Tag correct!");
+      
+      $display("*** Testvectors #6 (stream) END");
+      $display("");
+    end
+  endtask // test7
   
   
   
+  //----------------------------------------------------------------
+  // test8
+  //
+  // Test vectors #6 for SNOWV-GCM from https://eprint.iacr.org/2018/1143.pdf,
+  // with every block uploaded while the previous one is running.
+  //----------------------------------------------------------------
+  task test8;
+    begin : test8
+      reg [127 : 0] expected_block0, expected_block1, expected_block2, expected_tag;
+      reg [1023 : 0] out0, out1, out2;
+
+      $display("*** Testvectors #6 (pipelined) BEGIN");
+      inc_tc_ctr();
+      
+      tb_encdec_only = 1'b0;
+      tb_auth_only   = 1'b0;
+      tb_encdec      = 1'b1;
+      tb_adj_len     = 1'b0;
+      tb_key         = 256'hfaeadacabaaa9a8a7a6a5a4a3a2a1a0a5f5e5d5c5b5a59585756555453525150;
+      tb_iv          = 128'h1032547698badcfeefcdab8967452301;
+      tb_ad          = 128'h2165756c6176207473657420444141;
+      tb_len_ad      = 64'd120;
+      tb_block_i     = 128'h0;
+      tb_len_i       = 64'd264;
+      
+      expected_block0 = 128'hc1327ae807275082efa224b4b2017edd;
+      expected_block1 = 128'h1be95956a1b53e24127ffd1818d0b052;
+      expected_block2 = 128'h4c;
+      
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+      
+      // The result of the init is not a block, the first WRITE_PREV is skipped
+      tb_block_i = 128'h66656463626139383736353433323130;
+      #(CLK_PERIOD);
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(tb_input_data);
+      wait_done();
+      $display("Sending COMPUTE_NEXT command");
+      send_cmd_to_hw(CMD_COMPUTE_NEXT);
+      wait_done();
+      
+      tb_block_i = 128'h65646f6d20444145412d56776f6e5320;
+      #(CLK_PERIOD);
+      load_and_next_pipelined(tb_input_data, out0);
+      
+      tb_block_i = 128'h21;
+      tb_adj_len = 1'b1;
+      #(CLK_PERIOD);
+      load_and_next_pipelined(tb_input_data, out1);
+      
+      $display("Sending WRITE command");
+      send_cmd_to_hw(CMD_WRITE);
+      read_data_from_hw(out2);
+      wait_done();
+      
+      if ((out0[255 : 128] != expected_block0) ||
+          (out1[255 : 128] != expected_block1) ||
+          (out2[255 : 128] != expected_block2))
+        begin
+          $display("Ciphertext incorrect - Expected 0x%032x 0x%032x 0x%032x, got 0x%032x 0x%032x 0x%032x",
+                   expected_block0, expected_block1, expected_block2,
+                   out0[255 : 128], out1[255 : 128], out2[255 : 128]);
+          inc_error_ctr();
+        end
+      else
+        $display("Ciphertext correct!");
+        
+      expected_tag = 128'h9b02eed99a3e7c74de513ab7a5a67e90;
+      
+      #(CLK_PERIOD);
+      finalize(tb_output_data);
+         
+      if (tb_output_data[127 : 0] != expected_tag)
+        begin
+          $display("Tag incorrect - Expected 0x%032x, got 0x%032x", expected_tag, tb_output_data[127 : 0]);
+          inc_error_ctr();
+        end
+      else
+        $display("Tag correct!");
+      
+      $display("*** Testvectors #6 (pipelined) END");
+      $display("");
+    end
+  endtask // test8
+
+  //----------------------------------------------------------------
+  // ctx_frame()
+  //
+  // The normal input frame for the given context.
+  //----------------------------------------------------------------
+  function [1023 : 0] ctx_frame(input [1023 : 0] in,
+                                input [7 : 0]    ctx_id);
+    begin
+      ctx_frame = {244'h0, ctx_id, in[771 : 0]};
+    end
+  endfunction
+  
+  //----------------------------------------------------------------
+  // save_ctx()
+  //
+  // Fetch both halves of context ctx_id from the accelerator.
+  //----------------------------------------------------------------
+  task save_ctx(input [7 : 0] ctx_id, output [1023 : 0] out_lo, output [1023 : 0] out_hi);
+    begin
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(ctx_frame(1024'h0, ctx_id));
+      wait_done();
+      
+      $display("Sending SAVE_CTX command");
+      send_cmd_to_hw(CMD_SAVE_CTX);
+      read_data_from_hw(out_lo);
+      wait_done();
+      
+      $display("Sending SAVE_CTX_HI command");
+      send_cmd_to_hw(CMD_SAVE_CTX_HI);
+      read_data_from_hw(out_hi);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // restore_ctx()
+  //
+  // Load both halves of a saved context into context ctx_id.
+  //----------------------------------------------------------------
+  task restore_ctx(input [7 : 0] ctx_id, input [1023 : 0] in_lo, input [1023 : 0] in_hi);
+    begin
+      $display("Sending RESTORE_CTX command");
+      send_cmd_to_hw(CMD_RESTORE_CTX);
+      send_data_to_hw({ctx_id, 1'b0, in_lo[1014 : 0]});
+      wait_done();
+      
+      $display("Sending RESTORE_CTX command");
+      send_cmd_to_hw(CMD_RESTORE_CTX);
+      send_data_to_hw({ctx_id, 1'b1, in_hi[1014 : 0]});
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // test_ctx
+  //
+  // Test vectors #6 in context 1 and #5 in context 2, a block of
+  // each in turn. After its only block, #5 is saved to the host
+  // and finalized in context 3, after #6.
+  //----------------------------------------------------------------
+  task test_ctx;
+    begin : test_ctx
+      reg [1023 : 0] frame6, frame5, saved_lo, saved_hi;
+      reg [127 : 0]  expected_block0, expected_block1, expected_block2;
+      reg [127 : 0]  expected_block5, expected_tag6, expected_tag5;
+
+      $display("*** Interleaved contexts BEGIN");
+      inc_tc_ctr();
+      
+      expected_block0 = 128'hc1327ae807275082efa224b4b2017edd;
+      expected_block1 = 128'h1be95956a1b53e24127ffd1818d0b052;
+      expected_block2 = 128'h4c;
+      expected_block5 = 128'h5082efa224b4b2017edd;
+      expected_tag6   = 128'h9b02eed99a3e7c74de513ab7a5a67e90;
+      expected_tag5   = 128'h0dd919e35cec312390e6bfe7314efedd;
+      
+      tb_encdec_only = 1'b0;
+      tb_auth_only   = 1'b0;
+      tb_encdec      = 1'b1;
+      tb_adj_len     = 1'b0;
+      tb_key         = 256'hfaeadacabaaa9a8a7a6a5a4a3a2a1a0a5f5e5d5c5b5a59585756555453525150;
+      tb_iv          = 128'h1032547698badcfeefcdab8967452301;
+      tb_ad          = 128'h2165756c6176207473657420444141;
+      tb_len_ad      = 64'd120;
+      tb_block_i     = 128'h0;
+      tb_len_i       = 64'd264;
+      #(CLK_PERIOD);
+      frame6 = ctx_frame(tb_input_data, 8'h1);
+      load_and_init(frame6);
+      
+      tb_ad          = 128'h0;
+      tb_len_ad      = 64'h0;
+      tb_len_i       = 64'h50;
+      #(CLK_PERIOD);
+      frame5 = ctx_frame(tb_input_data, 8'h2);
+      load_and_init(frame5);
+      
+      // #6, first block
+      frame6[191 : 64] = 128'h66656463626139383736353433323130;
+      load_and_next(frame6, tb_output_data);
+      if (tb_output_data[255 : 128] != expected_block0)
+        begin
+          $display("Ciphertext incorrect - Expected 0x%032x, got 0x%032x", expected_block0, tb_output_data[255 : 128]);
+          inc_error_ctr();
+        end
+      
+      // #5, only block
+      frame5[768]      = 1'b1;
+      frame5[191 : 64] = 128'h39383736353433323130;
+      load_and_next(frame5, tb_output_data);
+      if (tb_output_data[255 : 128] != expected_block5)
+        begin
+          $display("Ciphertext incorrect - Expected 0x%032x, got 0x%032x", expected_block5, tb_output_data[255 : 128]);
+          inc_error_ctr();
+        end
+      
+      // Move #5 to the host and on to context 3
+      save_ctx(8'h2, saved_lo, saved_hi);
+      if ((saved_lo[1015] != 1'b0) || (saved_hi[1015] != 1'b1))
+        begin
+          $display("Context halves incorrect");
+          inc_error_ctr();
+        end
+      restore_ctx(8'h3, saved_lo, saved_hi);
+      frame5 = ctx_frame(frame5, 8'h3);
+      
+      // #6, remaining blocks and tag
+      frame6[191 : 64] = 128'h65646f6d20444145412d56776f6e5320;
+      load_and_next(frame6, tb_output_data);
+      if (tb_output_data[255 : 128] != expected_block1)
+        begin
+          $display("Ciphertext incorrect - Expected 0x%032x, got 0x%032x", expected_block1, tb_output_data[255 : 128]);
+          inc_error_ctr();
+        end
+      
+      frame6[768]      = 1'b1;
+      frame6[191 : 64] = 128'h21;
+      load_and_next(frame6, tb_output_data);
+      if (tb_output_data[255 : 128] != expected_block2)
+        begin
+          $display("Ciphertext incorrect - Expected 0x%032x, got 0x%032x", expected_block2, tb_output_data[255 : 128]);
+          inc_error_ctr();
+        end
+      
+      finalize(tb_output_data);
+      if (tb_output_data[127 : 0] != expected_tag6)
+        begin
+          $display("Tag incorrect - Expected 0x%032x, got 0x%032x", expected_tag6, tb_output_data[127 : 0]);
+          inc_error_ctr();
+        end
+      else
+        $display("Tag correct!");
+      
+      // #5 from context 3: the frame read last selects the context
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(frame5);
+      wait_done();
+      finalize(tb_output_data);
+      if (tb_output_data[127 : 0] != expected_tag5)
+        begin
+          $display("Tag incorrect - Expected 0x%032x, got 0x%032x", expected_tag5, tb_output_data[127 : 0]);
+          inc_error_ctr();
+        end
+      else
+        $display("Tag correct!");
+      
+      $display("*** Interleaved contexts END");
+      $display("");
+    end
+  endtask // test_ctx
+
+  //----------------------------------------------------------------
+  // read_stats()
+  //
+  // Read the cycle counters of the wrapper.
+  //----------------------------------------------------------------
+  task read_stats(output [1023 : 0] out);
+    begin
+      $display("Sending READ_STATS command");
+      send_cmd_to_hw(CMD_READ_STATS);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+
+  //----------------------------------------------------------------
+  // read_stats_hi()
+  //
+  // Read the counters of the commands 8 to 15.
+  //----------------------------------------------------------------
+  task read_stats_hi(output [1023 : 0] out);
+    begin
+      $display("Sending READ_STATS_HI command");
+      send_cmd_to_hw(CMD_READ_STATS_HI);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+
+  //----------------------------------------------------------------
+  // test_stats
+  //
+  // Check that the cycle counters account for one init sequence, and
+  // that saving a context is counted on its own command code.
+  // Word i of the stats frame holds counter i, see wrapper_stats.v.
+  //----------------------------------------------------------------
+  task test_stats;
+    begin : test_stats
+      reg [1023 : 0] stats_before, stats_after;
+      reg [1023 : 0] stats_hi_before, stats_hi_after;
+      reg [1023 : 0] ctx_frame_out, ctx_frame_out_hi;
+
+      $display("*** Statistics BEGIN");
+      inc_tc_ctr();
+
+      read_stats(stats_before);
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+      #(CLK_PERIOD);
+      read_stats(stats_after);
+
+      // Command counters: READ, COMPUTE_INIT and READ_STATS once each
+      if ((stats_after[(24 + CMD_READ) * 32 +: 32] - stats_before[(24 + CMD_READ) * 32 +: 32] != 32'd1) ||
+          (stats_after[(24 + CMD_COMPUTE_INIT) * 32 +: 32] - stats_before[(24 + CMD_COMPUTE_INIT) * 32 +: 32] != 32'd1) ||
+          (stats_after[(24 + CMD_READ_STATS) * 32 +: 32] - stats_before[(24 + CMD_READ_STATS) * 32 +: 32] != 32'd1))
+        begin
+          $display("Command counters incorrect - got 0x%064x", stats_after[1023 : 768]);
+          inc_error_ctr();
+        end
+      else
+        $display("Command counters correct!");
+
+      // The init command and the idle state both took cycles
+      if ((stats_after[(16 + CMD_COMPUTE_INIT) * 32 +: 32] == stats_before[(16 + CMD_COMPUTE_INIT) * 32 +: 32]) ||
+          (stats_after[31 : 0] == stats_before[31 : 0]))
+        begin
+          $display("Cycle counters incorrect - got 0x%0128x", stats_after[511 : 0]);
+          inc_error_ctr();
+        end
+      else
+        $display("Cycle counters correct!");
+
+      // SAVE_CTX and SAVE_CTX_HI only move their own counters on the upper page
+      read_stats(stats_before);
+      read_stats_hi(stats_hi_before);
+      save_ctx(8'h1, ctx_frame_out, ctx_frame_out_hi);
+      read_stats(stats_after);
+      read_stats_hi(stats_hi_after);
+
+      if ((stats_hi_after[(24 + CMD_SAVE_CTX - 8) * 32 +: 32] - stats_hi_before[(24 + CMD_SAVE_CTX - 8) * 32 +: 32] != 32'd1) ||
+          (stats_hi_after[(24 + CMD_SAVE_CTX_HI - 8) * 32 +: 32] - stats_hi_before[(24 + CMD_SAVE_CTX_HI - 8) * 32 +: 32] != 32'd1) ||
+          (stats_after[(24 + CMD_COMPUTE_INIT) * 32 +: 32] != stats_before[(24 + CMD_COMPUTE_INIT) * 32 +: 32]) ||
+          (stats_hi_after[511 : 0] != 512'h0))
+        begin
+          $display("Context command counters incorrect - got 0x%064x", stats_hi_after[1023 : 768]);
+          inc_error_ctr();
+        end
+      else
+        $display("Context command counters correct!");
+
+      $display("*** Statistics END");
+      $display("");
+    end
+  endtask // test_stats
+
   //----------------------------------------------------------------
   // snowv_gcm_test
   // The main test functionality.
@@ -630,6 +1119,11 @@ module tb_snowv_gcm_wrapper();
       test4();
       test5();
       test6();
+      test7();
+      test8();
+      test_ctx();
+
+      test_stats();
 
       display_test_result();
 
@@ -0,0 +1,431 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company: 
+// Engineer: 
+// 
+// Create Date: 
+// Design Name: 
+// Module Name: tb_snowv_ks_fifo
+// Project Name: 
+// Target Devices: 
+// Tool Versions: 
+// Description: snowv_ks_fifo in front of snowv_core.
+// 
+// Dependencies: 
+// 
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments:
+// 
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module tb_snowv_ks_fifo();
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  parameter DEBUG     = 0;
+  parameter DUMP_WAIT = 0;
+
+  parameter CLK_HALF_PERIOD = 1;
+  parameter CLK_PERIOD = 2 * CLK_HALF_PERIOD;
+
+  parameter NUM_BLOCKS = 8;
+
+  // Enough for snowv_core to fill the FIFO between two blocks
+  parameter GAP_CYCLES = 32;
+
+  //----------------------------------------------------------------
+  // Register and Wire declarations.
+  //----------------------------------------------------------------
+  reg [31 : 0]   cycle_ctr;
+  reg [31 : 0]   error_ctr;
+  reg [31 : 0]   tc_ctr;
+
+  reg            tb_clk;
+  reg            tb_reset_n;
+  reg            tb_aead_mode;
+  reg            tb_init;
+  reg            tb_next;
+  reg [255 : 0]  tb_key;
+  reg [127 : 0]  tb_iv;
+  reg            tb_ctx_load;
+  reg [895 : 0]  tb_ctx_i;
+  wire [895 : 0] tb_ctx_o;
+  wire [127 : 0] tb_keystream_z;
+  wire           tb_ready;
+
+  wire           core_init;
+  wire           core_next;
+  wire           core_ctx_load;
+  wire [895 : 0] core_ctx_o;
+  wire [127 : 0] core_keystream_z;
+  wire           core_ready;
+
+
+  //----------------------------------------------------------------
+  // Device Under Test.
+  //----------------------------------------------------------------
+  snowv_ks_fifo dut(
+                    .clk(tb_clk),
+                    .reset_n(tb_reset_n),
+
+                    .init(tb_init),
+                    .next(tb_next),
+                    .ctx_load(tb_ctx_load),
+                    .ctx_i(tb_ctx_i),
+                    .ctx_o(tb_ctx_o),
+
+                    .keystream_z(tb_keystream_z),
+                    .ready(tb_ready),
+
+                    .core_init(core_init),
+                    .core_next(core_next),
+                    .core_ctx_load(core_ctx_load),
+                    .core_ctx_o(core_ctx_o),
+                    .core_z(core_keystream_z),
+                    .core_ready(core_ready)
+                    );
+
+  snowv_core core(
+                  .clk(tb_clk),
+                  .reset_n(tb_reset_n),
+
+                  .aead_mode(tb_aead_mode),
+                  .init(core_init),
+                  .next(core_next),
+                  .key(tb_key),
+                  .iv(tb_iv),
+
+                  .ctx_load(core_ctx_load),
+                  .ctx_i(tb_ctx_i),
+                  .ctx_o(core_ctx_o),
+
+                  .keystream_z(core_keystream_z),
+                  .ready(core_ready)
+                  );
+
+  //----------------------------------------------------------------
+  // clk_gen
+  //
+  // Always running clock generator process.
+  //----------------------------------------------------------------
+  always
+    begin : clk_gen
+      #CLK_HALF_PERIOD;
+      tb_clk = !tb_clk;
+    end // clk_gen
+
+
+  //----------------------------------------------------------------
+  // sys_monitor()
+  //
+  // An always running process that creates a cycle counter and
+  // conditionally displays information about the DUT.
+  //----------------------------------------------------------------
+  always
+    begin : sys_monitor
+      cycle_ctr = cycle_ctr + 1;
+      #(CLK_PERIOD);
+      if (DEBUG)
+        begin
+          dump_dut_state();
+        end
+    end
+
+
+  //----------------------------------------------------------------
+  // dump_dut_state()
+  //
+  // Dump the state of the dump when needed.
+  //----------------------------------------------------------------
+  task dump_dut_state;
+    begin
+      $display("State of DUT");
+      $display("------------");
+      $display("Inputs and outputs:");
+      $display("aead_mode = 0x%01x, init = 0x%01x, next = 0x%01x, ctx_load = 0x%01x",
+               tb_aead_mode, dut.init, dut.next, dut.ctx_load);
+      $display("key  = 0x%064x ", tb_key);
+      $display("iv   = 0x%032x", tb_iv);
+      $display("");
+      $display("ready  = 0x%01x", dut.ready);
+      $display("keystream_z = 0x%032x", dut.keystream_z);
+      $display("FIFO: wr_ptr = 0x%01x, rd_ptr = 0x%01x",
+               dut.ks_wr_ptr_reg, dut.ks_rd_ptr_reg);
+      $display("------------");
+      $display("");
+    end
+  endtask // dump_dut_state
+
+
+  //----------------------------------------------------------------
+  // reset_dut()
+  //
+  // Toggle reset to put the DUT into a well known state.
+  //----------------------------------------------------------------
+  task reset_dut;
+    begin
+      $display("*** Toggle reset.");
+      tb_reset_n = 0;
+      #(2 * CLK_PERIOD);
+      tb_reset_n = 1;
+    end
+  endtask // reset_dut
+
+
+  //----------------------------------------------------------------
+  // init_sim()
+  //
+  // Initialize all counters and testbed functionality as well
+  // as setting the DUT inputs to defined values.
+  //----------------------------------------------------------------
+  task init_sim;
+    begin
+      cycle_ctr    = 0;
+      error_ctr    = 0;
+      tc_ctr       = 0;
+
+      tb_clk       = 0;
+      tb_reset_n   = 1;
+      tb_aead_mode = 0;
+      tb_init      = 0;
+      tb_next      = 0;
+      tb_key       = {8{32'h00000000}};
+      tb_iv        = {4{32'h00000000}};
+      tb_ctx_load  = 0;
+      tb_ctx_i     = 896'h0;
+    end
+  endtask // init_sim
+
+
+  //----------------------------------------------------------------
+  // display_test_result()
+  //
+  // Display the accumulated test results.
+  //----------------------------------------------------------------
+  task display_test_result;
+    begin
+      if (error_ctr == 0)
+        begin
+          $display("*** All %02d test cases completed successfully", tc_ctr);
+        end
+      else
+        begin
+          $display("*** %02d tests completed - %02d test cases did not complete successfully.",
+                   tc_ctr, error_ctr);
+        end
+    end
+  endtask // display_test_result
+
+
+  //----------------------------------------------------------------
+  // wait_ready()
+  //
+  // Wait for the ready flag in the dut to be set.
+  //
+  // Note: It is the callers responsibility to call the function
+  // when the dut is actively processing and will in fact at some
+  // point set the flag.
+  //----------------------------------------------------------------
+  task wait_ready;
+    begin
+      while (!tb_ready)
+        begin
+          #(CLK_PERIOD);
+          if (DUMP_WAIT)
+            begin
+              dump_dut_state();
+            end
+        end
+    end
+  endtask // wait_ready
+
+
+  //----------------------------------------------------------------
+  // init_dut()
+  //
+  // Initialises the core with key and iv, with a single-cycle init.
+  //----------------------------------------------------------------
+  task init_dut(input [255 : 0] key, input [127 : 0] iv);
+    begin
+      tb_key  = key;
+      tb_iv   = iv;
+      tb_init = 1;
+      #(CLK_PERIOD);
+      tb_init = 0;
+      wait_ready();
+    end
+  endtask // init_dut
+
+
+  //----------------------------------------------------------------
+  // read_block()
+  //
+  // Single-cycle next for one keystream block. hit is set when the
+  // block came from the FIFO, i.e. ready did not drop after next.
+  //----------------------------------------------------------------
+  task read_block(output [127 : 0] block, output hit);
+    begin
+      tb_next = 1;
+      #(CLK_PERIOD);
+      tb_next = 0;
+      hit     = tb_ready;
+      wait_ready();
+      block   = tb_keystream_z;
+    end
+  endtask // read_block
+
+
+  //----------------------------------------------------------------
+  // keystream_test()
+  //
+  // Initialises the core with key and iv and compares keystream
+  // block NUM_BLOCKS - 1 with expected. With gap set, the core gets
+  // GAP_CYCLES to refill the FIFO between two blocks and every block
+  // must come from the FIFO, otherwise the blocks are read back to
+  // back.
+  //----------------------------------------------------------------
+  task keystream_test(input [7 : 0] tc_number, input [255 : 0] key,
+                      input [127 : 0] iv, input gap,
+                      input [127 : 0] expected);
+    begin : keystream_test
+      integer i;
+      reg [127 : 0] block;
+      reg hit;
+      reg ok;
+
+      tc_ctr = tc_ctr + 1;
+      init_dut(key, iv);
+
+      $display("Init done");
+
+      ok = 1;
+      for (i = 0 ; i < NUM_BLOCKS ; i = i + 1)
+        begin
+          if (gap)
+            #(GAP_CYCLES * CLK_PERIOD);
+          read_block(block, hit);
+          $display("result[%1x] = 0x%032x", i, block);
+          if (gap && !hit)
+            begin
+              $display("result[%1x] not prefetched", i);
+              ok = 0;
+            end
+        end
+
+      if (ok && (block == expected))
+        begin
+          $display("*** TC %0d successful.", tc_number);
+          $display("");
+        end
+      else
+        begin
+          $display("*** ERROR: TC %0d NOT successful.", tc_number);
+          $display("Expected: 0x%032x", expected);
+          $display("Got:      0x%032x", block);
+          $display("");
+          error_ctr = error_ctr + 1;
+        end
+    end
+  endtask // keystream_test
+
+
+  //----------------------------------------------------------------
+  // ctx_test()
+  //
+  // Saves the context after NUM_BLOCKS / 2 blocks of testvectors #1
+  // while the core runs ahead, runs testvectors #2 in between and
+  // restores the context. The rest of the blocks of testvectors #1
+  // must follow, so the FIFO is flushed and ctx_o is the state after
+  // the last popped block and not that of the core.
+  //----------------------------------------------------------------
+  task ctx_test(input [7 : 0] tc_number, input [127 : 0] expected);
+    begin : ctx_test
+      integer i;
+      reg [895 : 0] saved;
+      reg [127 : 0] block;
+      reg hit;
+      reg ok;
+
+      tc_ctr = tc_ctr + 1;
+      ok = 1;
+
+      init_dut(256'h0, 128'h0);
+      for (i = 0 ; i < NUM_BLOCKS / 2 ; i = i + 1)
+        read_block(block, hit);
+      #(GAP_CYCLES * CLK_PERIOD);
+      saved = tb_ctx_o;
+
+      init_dut({8{32'hffffffff}}, {4{32'hffffffff}});
+      read_block(block, hit);
+      read_block(block, hit);
+
+      tb_ctx_i    = saved;
+      tb_ctx_load = 1;
+      #(CLK_PERIOD);
+      tb_ctx_load = 0;
+      if (tb_ctx_o != saved)
+        begin
+          $display("ctx_o does not follow the restored context");
+          ok = 0;
+        end
+
+      for (i = NUM_BLOCKS / 2 ; i < NUM_BLOCKS ; i = i + 1)
+        begin
+          read_block(block, hit);
+          $display("result[%1x] = 0x%032x", i, block);
+        end
+
+      if (ok && (block == expected))
+        begin
+          $display("*** TC %0d successful.", tc_number);
+          $display("");
+        end
+      else
+        begin
+          $display("*** ERROR: TC %0d NOT successful.", tc_number);
+          $display("Expected: 0x%032x", expected);
+          $display("Got:      0x%032x", block);
+          $display("");
+          error_ctr = error_ctr + 1;
+        end
+    end
+  endtask // ctx_test
+
+
+  //----------------------------------------------------------------
+  // snowv_ks_fifo_test
+  // The main test functionality.
+  //----------------------------------------------------------------
+  initial
+    begin : snowv_ks_fifo_test
+      init_sim();
+      dump_dut_state();
+      reset_dut();
+      dump_dut_state();
+
+      // testvectors #1 from https://eprint.iacr.org/2018/1143.pdf
+      $display("--- Testvectors #1");
+      keystream_test(8'h01, 256'h0, 128'h0, 1'b1, 128'h7982bfe61d48e2a8f602af8430df4f95);
+      keystream_test(8'h02, 256'h0, 128'h0, 1'b0, 128'h7982bfe61d48e2a8f602af8430df4f95);
+
+      $display("--- Context save and restore");
+      ctx_test(8'h03, 128'h7982bfe61d48e2a8f602af8430df4f95);
+
+      // testvectors #2 from https://eprint.iacr.org/2018/1143.pdf
+      $display("--- Testvectors #2");
+      keystream_test(8'h04, {8{32'hffffffff}}, {4{32'hffffffff}}, 1'b1, 128'h09eaa6cb49b83a3b706e6762fcff0486);
+      keystream_test(8'h05, {8{32'hffffffff}}, {4{32'hffffffff}}, 1'b0, 128'h09eaa6cb49b83a3b706e6762fcff0486);
+
+      display_test_result();
+      $display("");
+      $display("*** SNOW-V keystream FIFO simulation done. ***");
+      $finish;
+    end // snowv_ks_fifo_test
+endmodule // tb_snowv_ks_fifo
+
+//======================================================================
+// EOF tb_snowv_ks_fifo.v
+//======================================================================
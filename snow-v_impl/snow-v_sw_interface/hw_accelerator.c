@@ -1,6 +1,8 @@
 #include "common.h"
 #include "platform/interface.h"
 
+#include <string.h>
+
 #include "hw_accelerator.h"
 
 // Note that these tree CMDs are same as
@@ -11,6 +13,14 @@
 #define CMD_COMPUTE_NEXT    3
 #define CMD_COMPUTE_FINAL   4
 #define CMD_WRITE           5
+#define CMD_COMPUTE_STREAM  6
+#define CMD_READ_STATS      7
+#define CMD_READ_STATS_HI   (CMD_READ_STATS | 8)
+#define CMD_WRITE_PREV      (CMD_WRITE | 8)
+#define CMD_RESTORE_CTX     (CMD_READ | 8)
+#define CMD_SAVE_CTX        9
+#define CMD_SAVE_CTX_HI     10
+#define CMD_COMPUTE_BATCH   11  // snowv_gcm_array_wrapper.v only
 
 void init_HW_access(void)
 {
@@ -77,6 +87,49 @@ void snowv_gcm_HW_next(uint32_t *input, uint32_t *output)
 	while(!is_done());
 }
 
+// Only transfers the input frame. The frame read last selects the context
+// and the lengths of the message for snowv_gcm_HW_finalize().
+void snowv_gcm_HW_load(uint32_t *input)
+{
+	//// --- Send the read command and transfer input data to FPGA
+	send_cmd_to_hw(CMD_READ);
+	send_data_to_hw(input);
+	while(!is_done());
+}
+
+// Runs snowv_gcm_HW_next() on nblocks input frames of 32 words. The wrapper
+// computes in the background, so the upload of block i and the download of
+// block i-1 overlap the computation of block i-1 and block i respectively.
+void snowv_gcm_HW_next_pipelined(uint32_t *input, uint32_t *output, int nblocks)
+{
+	int i;
+
+	for (i = 0; i < nblocks; i++) {
+		//// --- Send the read command and transfer input data to FPGA
+		send_cmd_to_hw(CMD_READ);
+		send_data_to_hw(input + 32*i);
+		while(!is_done());
+
+		//// --- Start the compute operation, once the previous block is done
+		send_cmd_to_hw(CMD_COMPUTE_NEXT);
+		while(!is_done());
+
+		//// --- Transfer the output data of the previous block from FPGA
+		if (i > 0) {
+			send_cmd_to_hw(CMD_WRITE_PREV);
+			read_data_from_hw(output + 32*(i-1));
+			while(!is_done());
+		}
+	}
+
+	//// --- Wait for the last block and transfer its output data from FPGA
+	if (nblocks > 0) {
+		send_cmd_to_hw(CMD_WRITE);
+		read_data_from_hw(output + 32*(nblocks-1));
+		while(!is_done());
+	}
+}
+
 void snowv_gcm_HW_finalize(uint32_t *output)
 {
 	//// --- Perform the compute operation
@@ -88,3 +141,218 @@ void snowv_gcm_HW_finalize(uint32_t *output)
 	read_data_from_hw(output);
 	while(!is_done());
 }
+
+// Load key, IV, AD and total payload length from the input frame and
+// initialize the core. The payload is then passed to snowv_gcm_HW_process().
+void snowv_gcm_HW_start(snowv_gcm_ctx_t *ctx, uint32_t *input)
+{
+	uint64_t len_i = ((uint64_t) input[1] << 32) | input[0];
+
+	ctx->remaining = (len_i + 7) >> 3;
+	snowv_gcm_HW_init(input);
+}
+
+// Encrypt/decrypt nbytes of payload, STREAM_BLOCKS blocks per command.
+// The wrapper takes a partial block as the last one of the message, so
+// nbytes has to be a multiple of 16 unless the call ends the message.
+// Returns -1 without touching the wrapper otherwise.
+int snowv_gcm_HW_process(snowv_gcm_ctx_t *ctx, const uint8_t *in, uint8_t *out, uint32_t nbytes)
+{
+	uint32_t chunk, nblocks;
+
+	if (nbytes > ctx->remaining) nbytes = ctx->remaining;
+	if ((nbytes < ctx->remaining) && (nbytes & 0xf)) return -1;
+
+	while (nbytes > 0) {
+		chunk = (nbytes > 16*STREAM_BLOCKS) ? 16*STREAM_BLOCKS : nbytes;
+		nblocks = (chunk + 15) >> 4;
+
+		// Blocks are little-endian, so the payload maps directly onto the frame
+		memset(ctx->frame_in, 0, sizeof(ctx->frame_in));
+		memcpy(ctx->frame_in, in, chunk);
+		ctx->frame_in[28] = ((chunk & 0xf) ? 0x8 : 0x0) | nblocks;
+
+		//// --- Send the stream command, transfer the blocks and read back the result
+		send_cmd_to_hw(CMD_COMPUTE_STREAM);
+		send_data_to_hw(ctx->frame_in);
+		read_data_from_hw(ctx->frame_out);
+		while(!is_done());
+
+		memcpy(out, ctx->frame_out, chunk);
+
+		in += chunk;
+		out += chunk;
+		nbytes -= chunk;
+		ctx->remaining -= chunk;
+	}
+	return 0;
+}
+
+// Contexts in use, context 0 is never handed out
+static uint32_t ctx_used = 1;
+
+// Reserves an on-chip message context. Returns -1 if all are in use.
+int snowv_gcm_HW_ctx_alloc(snowv_gcm_ctx_handle_t *ctx)
+{
+	uint32_t id;
+
+	for (id = 1; id < SNOWV_GCM_CTX_SLOTS; id++) {
+		if (!(ctx_used & (1u << id))) {
+			ctx_used |= 1u << id;
+			ctx->id = id;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+void snowv_gcm_HW_ctx_free(snowv_gcm_ctx_handle_t *ctx)
+{
+	ctx_used &= ~(1u << ctx->id);
+	ctx->id = 0;
+}
+
+// Makes input a frame of the message in ctx. The ctx_id is in bits 779..772
+// of the input frame. The wrapper switches contexts by itself, so messages
+// in different contexts can be interleaved frame by frame. Stream frames
+// have no ctx_id: snowv_gcm_HW_process() continues the context of the last
+// init, next or finalize.
+void snowv_gcm_HW_set_ctx(const snowv_gcm_ctx_handle_t *ctx, uint32_t *input)
+{
+	input[24] = (input[24] & ~(0xffu << 4)) | ((ctx->id & 0xffu) << 4);
+}
+
+// Copies the state of the message in ctx to state, 64 words: a context
+// takes two frames. The message can then be continued in any context with
+// snowv_gcm_HW_ctx_restore().
+void snowv_gcm_HW_ctx_save(const snowv_gcm_ctx_handle_t *ctx, uint32_t *state)
+{
+	uint32_t frame[32] = {0};
+
+	snowv_gcm_HW_set_ctx(ctx, frame);
+
+	//// --- Select the context
+	send_cmd_to_hw(CMD_READ);
+	send_data_to_hw(frame);
+	while(!is_done());
+
+	//// --- Transfer both halves of the context from FPGA
+	send_cmd_to_hw(CMD_SAVE_CTX);
+	read_data_from_hw(state);
+	while(!is_done());
+
+	send_cmd_to_hw(CMD_SAVE_CTX_HI);
+	read_data_from_hw(state + 32);
+	while(!is_done());
+}
+
+// Loads a state saved by snowv_gcm_HW_ctx_save() into ctx. Every half has
+// the ctx_id in its top byte, and bit 23 of its last word tells which half
+// it is.
+void snowv_gcm_HW_ctx_restore(const snowv_gcm_ctx_handle_t *ctx, uint32_t *state)
+{
+	state[31] = (state[31] & 0x007fffffu) | ((ctx->id & 0xffu) << 24);
+	state[63] = (state[63] & 0x007fffffu) | ((ctx->id & 0xffu) << 24) | (1u << 23);
+
+	//// --- Send the restore commands and transfer the context to FPGA
+	send_cmd_to_hw(CMD_RESTORE_CTX);
+	send_data_to_hw(state);
+	while(!is_done());
+
+	send_cmd_to_hw(CMD_RESTORE_CTX);
+	send_data_to_hw(state + 32);
+	while(!is_done());
+}
+
+// Batch frames of snowv_gcm_array_wrapper.v, where the ctx_id of a frame is
+// the core (lane) it runs on. A batch frame holds one block per lane in
+// words 4*lane to 4*lane+3, the lanes with a block in bits 903..896, the
+// lanes that are finalized instead in bits 911..904 and the adj_len of
+// every lane in bit 912+lane. len_i stays the one of the last frame of the
+// lane.
+void snowv_gcm_HW_batch_clear(uint32_t *frame)
+{
+	memset(frame, 0, 32*sizeof(uint32_t));
+}
+
+// Adds block to frame for lane. Returns -1 if the array has no such lane.
+int snowv_gcm_HW_batch_add(uint32_t *frame, int lane, const uint32_t *block, int final, int adj_len)
+{
+	if (lane < 0 || lane >= SNOWV_GCM_BATCH_LANES) return -1;
+
+	if (block) memcpy(&frame[4*lane], block, 4*sizeof(uint32_t));
+	frame[28] |= 1u << lane;
+	if (final) frame[28] |= 1u << (8+lane);
+	if (adj_len) frame[28] |= 1u << (16+lane);
+	return 0;
+}
+
+// Runs the blocks of all lanes in frame in parallel. The output block of a
+// lane, or its tag if it was finalized, is in the words of its block in
+// output, the lanes in bits 903..896.
+void snowv_gcm_HW_batch(uint32_t *frame, uint32_t *output)
+{
+	//// --- Send the batch command and transfer input data to FPGA
+	send_cmd_to_hw(CMD_COMPUTE_BATCH);
+	send_data_to_hw(frame);
+
+	//// --- Transfer output data from FPGA once all lanes are done
+	read_data_from_hw(output);
+	while(!is_done());
+}
+
+// Descriptor ring in front of the wrapper, see hw_queue.h. The frames of
+// the descriptors are read from and written to mem.
+void snowv_gcm_HW_queue_init(hw_queue_t *q, uint32_t *mem)
+{
+	hw_queue_init(q, mem, CMD_READ, CMD_WRITE);
+}
+
+void snowv_gcm_HW_read_stats(hw_stats_t *stats)
+{
+	uint32_t frame[32];
+	int i;
+
+	//// --- Send read stats command and transfer the counters from FPGA
+	send_cmd_to_hw(CMD_READ_STATS);
+	read_data_from_hw(frame);
+	while(!is_done());
+
+	for (i = 0; i < 16; i++) stats->state_cycles[i] = frame[i];
+	for (i = 0; i < 8; i++) {
+		stats->cmd_cycles[i] = frame[16+i];
+		stats->cmd_count[i]  = frame[24+i];
+	}
+
+	//// --- Same for the counters of the commands 8 to 15
+	send_cmd_to_hw(CMD_READ_STATS_HI);
+	read_data_from_hw(frame);
+	while(!is_done());
+
+	for (i = 0; i < 8; i++) {
+		stats->cmd_cycles[8+i] = frame[16+i];
+		stats->cmd_count[8+i]  = frame[24+i];
+	}
+}
+
+// Names of the wrapper commands, indexed by the command code
+static const char *cmd_names[16] = {
+	"READ", "COMPUTE_INIT", "COMPUTE_NEXT_AD", "COMPUTE_NEXT",
+	"COMPUTE_FINAL", "WRITE", "COMPUTE_STREAM", "READ_STATS",
+	"RESTORE_CTX", "SAVE_CTX", "SAVE_CTX_HI", "COMPUTE_BATCH",
+	NULL, "WRITE_PREV", NULL, "READ_STATS_HI"
+};
+
+void print_HW_stats(hw_stats_t *stats)
+{
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		if (stats->state_cycles[i]) xil_printf("    state %d: %u cycles\n\r", i, stats->state_cycles[i]);
+	}
+	for (i = 0; i < 16; i++) {
+		if (!stats->cmd_count[i]) continue;
+		if (cmd_names[i]) xil_printf("    %s: %u times, %u cycles\n\r", cmd_names[i], stats->cmd_count[i], stats->cmd_cycles[i]);
+		else xil_printf("    cmd %d: %u times, %u cycles\n\r", i, stats->cmd_count[i], stats->cmd_cycles[i]);
+	}
+}
@@ -1,12 +1,71 @@
 #ifndef _HW_ACCEL_H_
 #define _HW_ACCEL_H_
 
+#include "hw_queue.h"
+
+// Maximum number of 128-bit payload blocks in one stream frame,
+// same as STREAM_BLOCKS in snowv_gcm_wrapper.v
+#define STREAM_BLOCKS 7
+
+// State of one message that is streamed through the accelerator
+typedef struct {
+	uint64_t remaining;     // Payload bytes left in the message
+	uint32_t frame_in[32];
+	uint32_t frame_out[32];
+} snowv_gcm_ctx_t;
+
+// Number of on-chip message contexts, 2**CTX_BITS in snowv_gcm_wrapper.v.
+// Context 0 is used by the frames that don't name a context.
+#define SNOWV_GCM_CTX_SLOTS 4
+
+// On-chip message context, see snowv_gcm_HW_ctx_alloc()
+typedef struct {
+	uint32_t id;
+} snowv_gcm_ctx_handle_t;
+
+// Lanes of snowv_gcm_array_wrapper.v, its NUM_CORES. A lane is named by
+// the ctx_id of a frame, lane 0 also by the frames that don't name a
+// context. snowv_gcm_HW_batch_add() takes the lane itself,
+// 0..SNOWV_GCM_BATCH_LANES-1.
+#define SNOWV_GCM_BATCH_LANES 4
+
+// Descriptor opcodes for hw_submit(), the compute commands of the wrapper
+#define SNOWV_GCM_HW_OP_INIT    1  // CMD_COMPUTE_INIT
+#define SNOWV_GCM_HW_OP_NEXT_AD 2  // CMD_COMPUTE_NEXT_AD
+#define SNOWV_GCM_HW_OP_NEXT    3  // CMD_COMPUTE_NEXT
+#define SNOWV_GCM_HW_OP_FINAL   4  // CMD_COMPUTE_FINAL
+
+// Cycle counters of the wrapper, as returned by CMD_READ_STATS and, for
+// the commands 8 to 15, CMD_READ_STATS_HI. cmd_cycles and cmd_count are
+// indexed by the command code. The counters wrap around and are only
+// cleared by a reset of the FPGA.
+typedef struct {
+	uint32_t state_cycles[16];  // Cycles spent in every state of the wrapper FSM
+	uint32_t cmd_cycles[16];    // Cycles between accepting a command and returning to idle
+	uint32_t cmd_count[16];     // Number of times every command was accepted
+} hw_stats_t;
+
 void init_HW_access(void);
 void customprint(uint32_t *large_number, char *str, int size);
 int check_correctness(uint32_t *expected, uint32_t *calculated, int size);
 void snowv_gcm_HW_init(uint32_t *input);
 void snowv_gcm_HW_next_ad(uint32_t *input);
 void snowv_gcm_HW_next(uint32_t *input, uint32_t *output);
+void snowv_gcm_HW_next_pipelined(uint32_t *input, uint32_t *output, int nblocks);
+void snowv_gcm_HW_load(uint32_t *input);
 void snowv_gcm_HW_finalize(uint32_t *output);
+void snowv_gcm_HW_start(snowv_gcm_ctx_t *ctx, uint32_t *input);
+int snowv_gcm_HW_process(snowv_gcm_ctx_t *ctx, const uint8_t *in, uint8_t *out, uint32_t nbytes);
+int snowv_gcm_HW_ctx_alloc(snowv_gcm_ctx_handle_t *ctx);
+void snowv_gcm_HW_ctx_free(snowv_gcm_ctx_handle_t *ctx);
+void snowv_gcm_HW_set_ctx(const snowv_gcm_ctx_handle_t *ctx, uint32_t *input);
+void snowv_gcm_HW_ctx_save(const snowv_gcm_ctx_handle_t *ctx, uint32_t *state);
+void snowv_gcm_HW_ctx_restore(const snowv_gcm_ctx_handle_t *ctx, uint32_t *state);
+void snowv_gcm_HW_batch_clear(uint32_t *frame);
+int snowv_gcm_HW_batch_add(uint32_t *frame, int lane, const uint32_t *block, int final, int adj_len);
+void snowv_gcm_HW_batch(uint32_t *frame, uint32_t *output);
+void snowv_gcm_HW_queue_init(hw_queue_t *q, uint32_t *mem);
+void snowv_gcm_HW_read_stats(hw_stats_t *stats);
+void print_HW_stats(hw_stats_t *stats);
 
 #endif
@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "common.h"
 
 #include "hw_accelerator.h"
@@ -14,8 +16,16 @@ extern uint32_t tc4_init[32],
                 tc6_block2[32],
                 tc6_expected_block2[4],
                 tc6_expected_tag[4];
+extern uint8_t  tc6_payload[33],
+                tc6_expected_payload[33];
 
 uint32_t output[32];
+uint32_t blocks[3*32], outputs[3*32];
+uint8_t payload_out[33];
+snowv_gcm_ctx_t ctx;
+snowv_gcm_ctx_handle_t ctx_a, ctx_b, ctx_c;
+uint32_t ctx_tc6[4*32], ctx_tc4[32], ctx_state[2*32];
+hw_stats_t stats;
 
 int main()
 {
@@ -60,6 +70,94 @@ STOP_TIMING
 	if (check_correctness(output, tc6_expected_tag, 4) != 1) xil_printf("    tc6 test: tag for SNOWV-GCM correct!\n\r\n\r");
 	else xil_printf("    tc6 test: tag for SNOWV-GCM incorrect :(\n\r\n\r");
 
+	// tc6 test, streaming the whole payload in one frame
+	xil_printf("Test tc6 (stream)...\n\r");
+START_TIMING
+	snowv_gcm_HW_start(&ctx, tc6_init);
+	snowv_gcm_HW_process(&ctx, tc6_payload, payload_out, 33);
+	snowv_gcm_HW_finalize(output);
+STOP_TIMING
+	if (memcmp(payload_out, tc6_expected_payload, 33) == 0) xil_printf("    tc6 stream test: payload for SNOWV-GCM correct!\n\r\n\r");
+	else xil_printf("    tc6 stream test: payload for SNOWV-GCM incorrect :(\n\r\n\r");
+	customprint(output, "    Output", 32);
+	if (check_correctness(output, tc6_expected_tag, 4) != 1) xil_printf("    tc6 stream test: tag for SNOWV-GCM correct!\n\r\n\r");
+	else xil_printf("    tc6 stream test: tag for SNOWV-GCM incorrect :(\n\r\n\r");
+
+	// tc6 test, streaming the payload in two calls. A partial block may
+	// only end the message, so a first call of 17 bytes is rejected.
+	xil_printf("Test tc6 (stream, split)...\n\r");
+	memset(payload_out, 0, 33);
+	snowv_gcm_HW_start(&ctx, tc6_init);
+	if (snowv_gcm_HW_process(&ctx, tc6_payload, payload_out, 17) == -1) xil_printf("    tc6 split test: partial middle block rejected!\n\r");
+	else xil_printf("    tc6 split test: partial middle block accepted :(\n\r");
+	snowv_gcm_HW_process(&ctx, tc6_payload, payload_out, 16);
+	snowv_gcm_HW_process(&ctx, tc6_payload + 16, payload_out + 16, 17);
+	snowv_gcm_HW_finalize(output);
+	if (memcmp(payload_out, tc6_expected_payload, 33) == 0) xil_printf("    tc6 split test: payload for SNOWV-GCM correct!\n\r");
+	else xil_printf("    tc6 split test: payload for SNOWV-GCM incorrect :(\n\r");
+	if (check_correctness(output, tc6_expected_tag, 4) != 1) xil_printf("    tc6 split test: tag for SNOWV-GCM correct!\n\r\n\r");
+	else xil_printf("    tc6 split test: tag for SNOWV-GCM incorrect :(\n\r\n\r");
+
+	// tc6 test, uploading every block while the previous one is running
+	xil_printf("Test tc6 (pipelined)...\n\r");
+	memcpy(blocks,      tc6_block0, sizeof(tc6_block0));
+	memcpy(blocks + 32, tc6_block1, sizeof(tc6_block1));
+	memcpy(blocks + 64, tc6_block2, sizeof(tc6_block2));
+START_TIMING
+	snowv_gcm_HW_init(tc6_init);
+	snowv_gcm_HW_next_pipelined(blocks, outputs, 3);
+	snowv_gcm_HW_finalize(output);
+STOP_TIMING
+	if ((check_correctness(outputs + 4, tc6_expected_block0, 4) != 1) &&
+	    (check_correctness(outputs + 36, tc6_expected_block1, 4) != 1) &&
+	    (check_correctness(outputs + 68, tc6_expected_block2, 4) != 1)) xil_printf("    tc6 pipelined test: blocks for SNOWV-GCM correct!\n\r\n\r");
+	else xil_printf("    tc6 pipelined test: blocks for SNOWV-GCM incorrect :(\n\r\n\r");
+	customprint(output, "    Output", 32);
+	if (check_correctness(output, tc6_expected_tag, 4) != 1) xil_printf("    tc6 pipelined test: tag for SNOWV-GCM correct!\n\r\n\r");
+	else xil_printf("    tc6 pipelined test: tag for SNOWV-GCM incorrect :(\n\r\n\r");
+
+	// -- Test tc6 and tc4 interleaved in two contexts, with tc4 moved to a
+	//    third context halfway
+	xil_printf("Test contexts...\n\r");
+	memcpy(ctx_tc6,      tc6_init,   sizeof(tc6_init));
+	memcpy(ctx_tc6 + 32, tc6_block0, sizeof(tc6_block0));
+	memcpy(ctx_tc6 + 64, tc6_block1, sizeof(tc6_block1));
+	memcpy(ctx_tc6 + 96, tc6_block2, sizeof(tc6_block2));
+	memcpy(ctx_tc4, tc4_init, sizeof(tc4_init));
+	if ((snowv_gcm_HW_ctx_alloc(&ctx_a) != 0) || (snowv_gcm_HW_ctx_alloc(&ctx_b) != 0) || (snowv_gcm_HW_ctx_alloc(&ctx_c) != 0))
+		xil_printf("    context test: out of contexts :(\n\r\n\r");
+	for (int i = 0; i < 4; i++)
+		snowv_gcm_HW_set_ctx(&ctx_a, ctx_tc6 + 32*i);
+	snowv_gcm_HW_set_ctx(&ctx_b, ctx_tc4);
+	snowv_gcm_HW_init(ctx_tc6);
+	snowv_gcm_HW_init(ctx_tc4);
+	snowv_gcm_HW_next(ctx_tc6 + 32, output);
+	if (check_correctness(output + 4, tc6_expected_block0, 4) != 0) xil_printf("    context test: first block for SNOWV-GCM incorrect :(\n\r");
+	snowv_gcm_HW_ctx_save(&ctx_b, ctx_state);
+	snowv_gcm_HW_ctx_restore(&ctx_c, ctx_state);
+	snowv_gcm_HW_set_ctx(&ctx_c, ctx_tc4);
+	snowv_gcm_HW_next(ctx_tc6 + 64, output);
+	if (check_correctness(output + 4, tc6_expected_block1, 4) != 0) xil_printf("    context test: second block for SNOWV-GCM incorrect :(\n\r");
+	snowv_gcm_HW_next(ctx_tc6 + 96, output);
+	if (check_correctness(output + 4, tc6_expected_block2, 4) != 0) xil_printf("    context test: third block for SNOWV-GCM incorrect :(\n\r");
+	snowv_gcm_HW_finalize(output);
+	if (check_correctness(output, tc6_expected_tag, 4) != 1) xil_printf("    context test: tc6 tag for SNOWV-GCM correct!\n\r");
+	else xil_printf("    context test: tc6 tag for SNOWV-GCM incorrect :(\n\r");
+	snowv_gcm_HW_load(ctx_tc4);
+	snowv_gcm_HW_finalize(output);
+	customprint(output, "    Output", 32);
+	if (check_correctness(output, tc4_expected_tag, 4) != 1) xil_printf("    context test: tc4 tag for SNOWV-GCM correct!\n\r\n\r");
+	else xil_printf("    context test: tc4 tag for SNOWV-GCM incorrect :(\n\r\n\r");
+	snowv_gcm_HW_ctx_free(&ctx_a);
+	snowv_gcm_HW_ctx_free(&ctx_b);
+	snowv_gcm_HW_ctx_free(&ctx_c);
+
+	// -- Read the cycle counters of the wrapper
+	xil_printf("Cycle counters...\n\r");
+	snowv_gcm_HW_read_stats(&stats);
+	print_HW_stats(&stats);
+	xil_printf("\n\r");
+
 	xil_printf("----------- End SNOWV-GCM test -----------\n\r");
 
 	cleanup_platform();
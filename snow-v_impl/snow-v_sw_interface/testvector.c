@@ -16,3 +16,6 @@ uint32_t tc6_expected_block1[4] = { 0x18d0b052, 0x127ffd18, 0xa1b53e24, 0x1be959
 uint32_t tc6_block2[32] = { 0x00000108, 0x00000000, 0x00000021, 0x00000000, 0x00000000, 0x00000000, 0x00000078, 0x00000000, 0x20444141, 0x74736574, 0x6c617620, 0x00216575, 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0x53525150, 0x57565554, 0x5b5a5958, 0x5f5e5d5c, 0x3a2a1a0a, 0x7a6a5a4a, 0xbaaa9a8a, 0xfaeadaca, 0x00000003, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000 };
 uint32_t tc6_expected_block2[4] = { 0x0000004c, 0x00000000, 0x00000000, 0x00000000 };
 uint32_t tc6_expected_tag[4] = { 0xa5a67e90, 0xde513ab7, 0x9a3e7c74, 0x9b02eed9 };
+
+uint8_t tc6_payload[33] = { 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x20, 0x53, 0x6e, 0x6f, 0x77, 0x56, 0x2d, 0x41, 0x45, 0x41, 0x44, 0x20, 0x6d, 0x6f, 0x64, 0x65, 0x21 };
+uint8_t tc6_expected_payload[33] = { 0xdd, 0x7e, 0x01, 0xb2, 0xb4, 0x24, 0xa2, 0xef, 0x82, 0x50, 0x27, 0x07, 0xe8, 0x7a, 0x32, 0xc1, 0x52, 0xb0, 0xd0, 0x18, 0x18, 0xfd, 0x7f, 0x12, 0x24, 0x3e, 0xb5, 0xa1, 0x56, 0x59, 0xe9, 0x1b, 0x4c };
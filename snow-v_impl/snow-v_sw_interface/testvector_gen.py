@@ -53,9 +53,24 @@ def print_test(name_test, encdec_only, auth_only, encdec, adj_len, key, iv, ad,
         print(f"uint32_t {name_test}_expected_block{i}[4] = {{ {convert_string(expected_blocks[i])} }};")
     print(f"uint32_t {name_test}_expected_tag[4] = {{ {convert_string(expected_tag)} }};")
 
+def convert_bytes(blocks, blocks_size):
+    num_bytes = (int(blocks_size, 16) + 7) // 8
+    result = []
+    for block in blocks:
+        value = int(block, 16)
+        result += ["0x" + format((value >> (8*i)) & 0xff, "02x") for i in range(16)]
+    return ", ".join(result[:num_bytes])
+
+def print_stream_test(name_test, blocks, blocks_size, expected_blocks):
+    num_bytes = (int(blocks_size, 16) + 7) // 8
+    print(f"uint8_t {name_test}_payload[{num_bytes}] = {{ {convert_bytes(blocks, blocks_size)} }};")
+    print(f"uint8_t {name_test}_expected_payload[{num_bytes}] = {{ {convert_bytes(expected_blocks, blocks_size)} }};")
+
 print("// Test tc4")
 print_test("tc4", tc4_encdec_only, tc4_auth_only, tc4_encdec, tc4_adj_len, tc4_key, tc4_iv, tc4_ad, tc4_ad_len, tc4_blocks, tc4_blocks_size, tc4_expected_blocks, tc4_expected_tag)
 print("")
 print("// Test tc6")
 print_test("tc6", tc6_encdec_only, tc6_auth_only, tc6_encdec, tc6_adj_len, tc6_key, tc6_iv, tc6_ad, tc6_ad_len, tc6_blocks, tc6_blocks_size, tc6_expected_blocks, tc6_expected_tag)
 print("")
+print_stream_test("tc6", tc6_blocks, tc6_blocks_size, tc6_expected_blocks)
+print("")
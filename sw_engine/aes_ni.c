@@ -0,0 +1,234 @@
+#include <string.h>
+
+#include "aes_ni.h"
+
+// AES-NI and PCLMULQDQ versions of the bulk loops of aes_sw.c and of the
+// GHASH of snowv_sw.c. They are compiled for their target only and used
+// when aes_ni_supported() says the CPU has both extensions; the callers
+// keep the table-based code as the fallback.
+//
+// The round keys of aes_sw_key_t are little-endian column words, which is
+// the byte order of the AES state, so they are loaded as they are.
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define AES_NI_X86
+#include <immintrin.h>
+#endif
+
+// Blocks in flight in the CTR loop, enough to cover the latency of AESENC
+#define CTR_WAYS 8
+
+#ifdef AES_NI_X86
+
+int aes_ni_supported(void)
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("aes") && __builtin_cpu_supports("pclmul") &&
+	       __builtin_cpu_supports("ssse3");
+}
+
+static uint64_t load64_be(const uint8_t *p)
+{
+	uint64_t x;
+
+	memcpy(&x, p, 8);
+	return __builtin_bswap64(x);
+}
+
+// Only the lower 64 bits of the counter are incremented, as in aes_sw.c
+__attribute__((target("aes,sse2")))
+void aes_ni_ctr(const aes_sw_key_t *key, uint8_t *ctr, const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+	__m128i rk[15], b[CTR_WAYS];
+	uint64_t hi, lo;
+	int r, i;
+
+	for (r = 0; r <= key->nr; r++)
+		rk[r] = _mm_loadu_si128((const __m128i *) (key->rk + 4*r));
+	memcpy(&hi, ctr, 8);
+	lo = load64_be(ctr + 8);
+
+	while (nblocks >= CTR_WAYS) {
+		for (i = 0; i < CTR_WAYS; i++)
+			b[i] = _mm_xor_si128(_mm_set_epi64x(__builtin_bswap64(lo + i), hi), rk[0]);
+		for (r = 1; r < key->nr; r++)
+			for (i = 0; i < CTR_WAYS; i++)
+				b[i] = _mm_aesenc_si128(b[i], rk[r]);
+		for (i = 0; i < CTR_WAYS; i++) {
+			b[i] = _mm_aesenclast_si128(b[i], rk[key->nr]);
+			_mm_storeu_si128((__m128i *) (out + 16*i),
+			                 _mm_xor_si128(b[i], _mm_loadu_si128((const __m128i *) (in + 16*i))));
+		}
+		lo += CTR_WAYS;
+		in += 16*CTR_WAYS;
+		out += 16*CTR_WAYS;
+		nblocks -= CTR_WAYS;
+	}
+
+	for (; nblocks > 0; nblocks--) {
+		b[0] = _mm_xor_si128(_mm_set_epi64x(__builtin_bswap64(lo), hi), rk[0]);
+		for (r = 1; r < key->nr; r++)
+			b[0] = _mm_aesenc_si128(b[0], rk[r]);
+		b[0] = _mm_aesenclast_si128(b[0], rk[key->nr]);
+		_mm_storeu_si128((__m128i *) out, _mm_xor_si128(b[0], _mm_loadu_si128((const __m128i *) in)));
+		lo++;
+		in += 16;
+		out += 16;
+	}
+
+	lo = __builtin_bswap64(lo);
+	memcpy(ctr + 8, &lo, 8);
+}
+
+// CBC-MAC chaining x = E(x ^ block) over full blocks. The chain is serial,
+// so there is nothing to interleave within one message.
+__attribute__((target("aes,sse2")))
+void aes_ni_cmac(const aes_sw_key_t *key, uint8_t *x, const uint8_t *in, size_t nblocks)
+{
+	__m128i rk[15], s;
+	int r;
+
+	for (r = 0; r <= key->nr; r++)
+		rk[r] = _mm_loadu_si128((const __m128i *) (key->rk + 4*r));
+	s = _mm_loadu_si128((const __m128i *) x);
+
+	for (; nblocks > 0; nblocks--) {
+		s = _mm_xor_si128(s, _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), rk[0]));
+		for (r = 1; r < key->nr; r++)
+			s = _mm_aesenc_si128(s, rk[r]);
+		s = _mm_aesenclast_si128(s, rk[key->nr]);
+		in += 16;
+	}
+	_mm_storeu_si128((__m128i *) x, s);
+}
+
+// GHASH works on byte-reflected values, as in Intel's carry-less
+// multiplication white paper. The 256-bit product of two of them is one
+// bit short, so it is shifted left by one before the reduction modulo
+// x^128 + x^7 + x^2 + x + 1. Both steps are linear, which lets four
+// products be added up and reduced once.
+
+__attribute__((target("pclmul,sse2")))
+static inline void clmul(__m128i a, __m128i b, __m128i *lo, __m128i *hi)
+{
+	__m128i l, h, m;
+
+	l = _mm_clmulepi64_si128(a, b, 0x00);
+	h = _mm_clmulepi64_si128(a, b, 0x11);
+	m = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+	*lo = _mm_xor_si128(*lo, _mm_xor_si128(l, _mm_slli_si128(m, 8)));
+	*hi = _mm_xor_si128(*hi, _mm_xor_si128(h, _mm_srli_si128(m, 8)));
+}
+
+__attribute__((target("sse2")))
+static inline __m128i reduce(__m128i lo, __m128i hi)
+{
+	__m128i c0, c1, t, u;
+
+	// (hi:lo) << 1
+	c0 = _mm_srli_epi32(lo, 31);
+	c1 = _mm_srli_epi32(hi, 31);
+	lo = _mm_slli_epi32(lo, 1);
+	hi = _mm_slli_epi32(hi, 1);
+	hi = _mm_or_si128(hi, _mm_or_si128(_mm_slli_si128(c1, 4), _mm_srli_si128(c0, 12)));
+	lo = _mm_or_si128(lo, _mm_slli_si128(c0, 4));
+
+	// Fold lo into hi
+	t = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+	u = _mm_srli_si128(t, 4);
+	lo = _mm_xor_si128(lo, _mm_slli_si128(t, 12));
+	t = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+	t = _mm_xor_si128(t, u);
+	return _mm_xor_si128(hi, _mm_xor_si128(lo, t));
+}
+
+__attribute__((target("pclmul,sse2")))
+static inline __m128i gfmul(__m128i a, __m128i b)
+{
+	__m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+
+	clmul(a, b, &lo, &hi);
+	return reduce(lo, hi);
+}
+
+__attribute__((target("ssse3")))
+static inline __m128i load_reflected(const uint8_t *p)
+{
+	const __m128i rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+	return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) p), rev);
+}
+
+__attribute__((target("pclmul,ssse3")))
+void aes_ni_ghash_init(aes_ni_ghash_key_t *hk, const uint8_t *h)
+{
+	__m128i h1 = load_reflected(h), hn = h1;
+	int i;
+
+	_mm_store_si128((__m128i *) hk->pow[0], h1);
+	for (i = 1; i < 4; i++) {
+		hn = gfmul(hn, h1);
+		_mm_store_si128((__m128i *) hk->pow[i], hn);
+	}
+}
+
+// X = (...((X ^ in_0) * H ^ in_1) * H ...) * H, with X as the big-endian
+// halves of snowv_sw_ctx_t. Four blocks are done per reduction:
+// X' = (X ^ in_0) * H^4 ^ in_1 * H^3 ^ in_2 * H^2 ^ in_3 * H
+__attribute__((target("pclmul,ssse3")))
+void aes_ni_ghash(const aes_ni_ghash_key_t *hk, uint64_t *X, const uint8_t *in, size_t nblocks)
+{
+	const __m128i h1 = _mm_load_si128((const __m128i *) hk->pow[0]);
+	const __m128i h2 = _mm_load_si128((const __m128i *) hk->pow[1]);
+	const __m128i h3 = _mm_load_si128((const __m128i *) hk->pow[2]);
+	const __m128i h4 = _mm_load_si128((const __m128i *) hk->pow[3]);
+	__m128i x = _mm_set_epi64x(X[0], X[1]), lo, hi;
+	uint64_t t[2];
+
+	while (nblocks >= 4) {
+		lo = hi = _mm_setzero_si128();
+		clmul(_mm_xor_si128(x, load_reflected(in)), h4, &lo, &hi);
+		clmul(load_reflected(in + 16), h3, &lo, &hi);
+		clmul(load_reflected(in + 32), h2, &lo, &hi);
+		clmul(load_reflected(in + 48), h1, &lo, &hi);
+		x = reduce(lo, hi);
+		in += 64;
+		nblocks -= 4;
+	}
+
+	for (; nblocks > 0; nblocks--) {
+		x = gfmul(_mm_xor_si128(x, load_reflected(in)), h1);
+		in += 16;
+	}
+
+	_mm_storeu_si128((__m128i *) t, x);
+	X[0] = t[1];
+	X[1] = t[0];
+}
+
+#else
+
+// Never called: the callers only use these when aes_ni_supported() is set
+
+int aes_ni_supported(void)
+{
+	return 0;
+}
+
+void aes_ni_ctr(const aes_sw_key_t *key, uint8_t *ctr, const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+}
+
+void aes_ni_cmac(const aes_sw_key_t *key, uint8_t *x, const uint8_t *in, size_t nblocks)
+{
+}
+
+void aes_ni_ghash_init(aes_ni_ghash_key_t *hk, const uint8_t *h)
+{
+}
+
+void aes_ni_ghash(const aes_ni_ghash_key_t *hk, uint64_t *X, const uint8_t *in, size_t nblocks)
+{
+}
+
+#endif
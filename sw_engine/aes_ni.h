@@ -0,0 +1,21 @@
+#ifndef _AES_NI_H_
+#define _AES_NI_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aes_sw.h"
+
+// GHASH key for aes_ni_ghash(): H, H^2, H^3 and H^4 in byte-reflected order
+typedef struct {
+	uint8_t pow[4][16] __attribute__((aligned(16)));
+} aes_ni_ghash_key_t;
+
+int aes_ni_supported(void);
+
+void aes_ni_ctr(const aes_sw_key_t *key, uint8_t *ctr, const uint8_t *in, uint8_t *out, size_t nblocks);
+void aes_ni_cmac(const aes_sw_key_t *key, uint8_t *x, const uint8_t *in, size_t nblocks);
+void aes_ni_ghash_init(aes_ni_ghash_key_t *hk, const uint8_t *h);
+void aes_ni_ghash(const aes_ni_ghash_key_t *hk, uint64_t *X, const uint8_t *in, size_t nblocks);
+
+#endif
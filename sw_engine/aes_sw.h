@@ -0,0 +1,42 @@
+#ifndef _AES_SW_H_
+#define _AES_SW_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Implementation of the bulk loops, chosen when a context is initialized
+typedef enum {
+	AES_SW_AUTO = 0,        // AES-NI if the CPU supports it
+	AES_SW_PORTABLE,        // table-based C
+	AES_SW_NI               // AES-NI and PCLMULQDQ, see aes_ni.c
+} aes_sw_impl_t;
+
+// Expanded AES-128/AES-256 encryption key
+typedef struct {
+	uint32_t rk[60];
+	int      nr;
+} aes_sw_key_t;
+
+// State of one AES-CTR or AES-CMAC message
+typedef struct {
+	aes_sw_key_t key;
+	int          mac;       // 0 : CTR, 1 : CMAC (same as enc_auth in aes_tot.v)
+	uint8_t      ctr[16];   // CTR: next counter block, CMAC: chaining value
+	uint8_t      buf[16];   // Input that is not processed yet, at most one block
+	uint32_t     buf_len;
+	aes_sw_impl_t impl;
+} aes_sw_ctx_t;
+
+aes_sw_impl_t aes_sw_detect(void);
+int aes_sw_select(aes_sw_impl_t impl);
+aes_sw_impl_t aes_sw_impl(void);
+
+void aes_sw_expand_key(aes_sw_key_t *key, const uint8_t *k, int keylen);
+void aes_sw_encrypt_block(const aes_sw_key_t *key, const uint8_t *in, uint8_t *out);
+void aes_sw_round(uint32_t *out, const uint32_t *in);
+
+int aes_sw_init(aes_sw_ctx_t *ctx, int mac, const uint8_t *key, int keylen, const uint8_t *counter);
+size_t aes_sw_update(aes_sw_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len);
+size_t aes_sw_final(aes_sw_ctx_t *ctx, uint8_t *out, uint8_t *tag);
+
+#endif
@@ -0,0 +1,221 @@
+#include <string.h>
+
+#include "job_mgr.h"
+
+// Job manager for many short messages. Jobs are queued per cipher and a
+// queue is handed to its backend as one batch when it holds JOB_MGR_LANES
+// jobs, or on job_mgr_flush(). Callbacks run when the batch of a job is
+// done, so jobs of different ciphers complete out of submission order.
+
+// Default backend: one message after the other through the software engine
+static void batch_sw(sw_job_t *jobs, uint32_t njobs, void *arg)
+{
+	sw_ctx_t ctx;
+	size_t n;
+	uint32_t j;
+
+	(void) arg;
+	for (j = 0; j < njobs; j++) {
+		if (sw_ctx_init(&ctx, &jobs[j].params) != 0) {
+			jobs[j].status = -1;
+			continue;
+		}
+		n = sw_ctx_update(&ctx, jobs[j].in, jobs[j].out, jobs[j].len);
+		sw_ctx_final(&ctx, jobs[j].out + n, jobs[j].tag);
+		jobs[j].status = 0;
+	}
+}
+
+// ZUC-256 CTR: all jobs of the batch are lanes of the multi-lane engine.
+// The lanes run until the longest message is done.
+#define ZUC_CHUNK_WORDS 64
+
+static void batch_zuc_ctr(sw_job_t *jobs, uint32_t njobs, void *arg)
+{
+	uint32_t z[ZUC256_MB_LANES][ZUC_CHUNK_WORDS];
+	zuc256_mb_state_t st;
+	const uint8_t *key[ZUC256_MB_LANES], *iv[ZUC256_MB_LANES];
+	uint32_t *zp[ZUC256_MB_LANES];
+	const uint8_t *src;
+	uint8_t *dst;
+	sw_job_t *lane[ZUC256_MB_LANES];
+	uint32_t nlanes = 0, l;
+	size_t max_len = 0, off, i, end;
+
+	for (l = 0; l < njobs; l++) {
+		if ((jobs[l].params.key == NULL) || (jobs[l].params.iv == NULL)) {
+			jobs[l].status = -1;
+			continue;
+		}
+		jobs[l].status = 0;
+		lane[nlanes] = &jobs[l];
+		key[nlanes] = jobs[l].params.key;
+		iv[nlanes] = jobs[l].params.iv;
+		zp[nlanes] = z[nlanes];
+		if (jobs[l].len > max_len) max_len = jobs[l].len;
+		nlanes++;
+	}
+	if (nlanes == 0) return;
+
+	zuc256_mb_setup(&st, *(zuc256_mb_impl_t *) arg, nlanes, key, iv, 0);
+
+	// The keystream is used most significant byte first, as in zuc256_sw.c
+	for (off = 0; off < max_len; off += 4*ZUC_CHUNK_WORDS) {
+		zuc256_mb_keystream(&st, zp, ZUC_CHUNK_WORDS);
+		for (l = 0; l < nlanes; l++) {
+			if (off >= lane[l]->len) continue;
+			end = lane[l]->len - off;
+			if (end > 4*ZUC_CHUNK_WORDS) end = 4*ZUC_CHUNK_WORDS;
+			src = lane[l]->in + off;
+			dst = lane[l]->out + off;
+			for (i = 0; i + 4 <= end; i += 4) {
+				dst[i]     = src[i]     ^ (z[l][i >> 2] >> 24);
+				dst[i + 1] = src[i + 1] ^ (z[l][i >> 2] >> 16);
+				dst[i + 2] = src[i + 2] ^ (z[l][i >> 2] >> 8);
+				dst[i + 3] = src[i + 3] ^ z[l][i >> 2];
+			}
+			for (; i < end; i++)
+				dst[i] = src[i] ^ (z[l][i >> 2] >> (24 - 8*(i & 3)));
+		}
+	}
+}
+
+// SNOW-V-GCM: the jobs go through the engine in groups of SNOWV_MB_LANES
+// messages, whose key/IV setup and bulk keystream are done together by
+// snowv_mb.c. GHASH stays per message. Once a message has less than
+// a chunk of full blocks left, it is finished on its own.
+#define SNOWV_CHUNK_BLOCKS 16
+
+static void batch_snowv(sw_job_t *jobs, uint32_t njobs, void *arg)
+{
+	snowv_mb_impl_t impl = *(snowv_mb_impl_t *) arg;
+	snowv_sw_ctx_t ctx[SNOWV_MB_LANES];
+	snowv_sw_state_t *s[SNOWV_MB_LANES], *sa[SNOWV_MB_LANES];
+	uint8_t z[SNOWV_MB_LANES][16*SNOWV_CHUNK_BLOCKS];
+	uint8_t *zp[SNOWV_MB_LANES];
+	const uint8_t *key[SNOWV_MB_LANES], *iv[SNOWV_MB_LANES];
+	sw_job_t *lane[SNOWV_MB_LANES];
+	uint32_t nlanes, nact, act[SNOWV_MB_LANES], l, j = 0;
+	size_t off[SNOWV_MB_LANES], n;
+
+	while (j < njobs) {
+		for (nlanes = 0; (nlanes < SNOWV_MB_LANES) && (j < njobs); j++) {
+			if ((jobs[j].params.key == NULL) || (jobs[j].params.iv == NULL)) {
+				jobs[j].status = -1;
+				continue;
+			}
+			lane[nlanes] = &jobs[j];
+			key[nlanes] = jobs[j].params.key;
+			iv[nlanes] = jobs[j].params.iv;
+			s[nlanes] = &ctx[nlanes].s;
+			nlanes++;
+		}
+		if (nlanes == 0) break;
+
+		snowv_mb_keyiv_setup(s, nlanes, impl, key, iv, 1);
+		nact = 0;
+		for (l = 0; l < nlanes; l++) {
+			const sw_params_t *p = &lane[l]->params;
+
+			lane[l]->status = snowv_sw_init_state(&ctx[l], p->ad, p->ad_len, p->encdec_only,
+			                                      p->auth_only, p->encdec);
+			off[l] = 0;
+			if ((lane[l]->status == 0) && !p->auth_only && (lane[l]->len >= 16*SNOWV_CHUNK_BLOCKS))
+				act[nact++] = l;
+		}
+
+		// Chunks of keystream for all messages that still have that many blocks
+		while (nact > 0) {
+			for (l = 0; l < nact; l++) {
+				sa[l] = s[act[l]];
+				zp[l] = z[act[l]];
+			}
+			snowv_mb_keystream(sa, nact, impl, zp, SNOWV_CHUNK_BLOCKS);
+			for (l = 0; l < nact; l++) {
+				sw_job_t *job = lane[act[l]];
+
+				snowv_sw_update_ks(&ctx[act[l]], job->in + off[act[l]], job->out + off[act[l]],
+				                   SNOWV_CHUNK_BLOCKS, z[act[l]]);
+				off[act[l]] += 16*SNOWV_CHUNK_BLOCKS;
+			}
+			for (l = 0; l < nact; )
+				if (lane[act[l]]->len - off[act[l]] < 16*SNOWV_CHUNK_BLOCKS) act[l] = act[--nact];
+				else l++;
+		}
+
+		for (l = 0; l < nlanes; l++) {
+			if (lane[l]->status != 0) continue;
+			n = snowv_sw_update(&ctx[l], lane[l]->in + off[l], lane[l]->out + off[l], lane[l]->len - off[l]);
+			snowv_sw_final(&ctx[l], lane[l]->out + off[l] + n, lane[l]->tag);
+		}
+	}
+}
+
+void job_mgr_init(job_mgr_t *mgr)
+{
+	int c;
+
+	memset(mgr->count, 0, sizeof(mgr->count));
+	for (c = 0; c < JOB_MGR_CIPHERS; c++) {
+		mgr->backend[c] = batch_sw;
+		mgr->backend_arg[c] = NULL;
+	}
+	mgr->zuc_impl = zuc256_mb_detect();
+	mgr->backend[SW_ZUC256_CTR] = batch_zuc_ctr;
+	mgr->backend_arg[SW_ZUC256_CTR] = &mgr->zuc_impl;
+	mgr->snowv_impl = snowv_mb_detect();
+	mgr->backend[SW_SNOWV_GCM] = batch_snowv;
+	mgr->backend_arg[SW_SNOWV_GCM] = &mgr->snowv_impl;
+}
+
+void job_mgr_set_backend(job_mgr_t *mgr, sw_cipher_t cipher, job_batch_fn_t fn, void *arg)
+{
+	mgr->backend[cipher] = fn;
+	mgr->backend_arg[cipher] = arg;
+}
+
+static void dispatch(job_mgr_t *mgr, int cipher)
+{
+	sw_job_t jobs[JOB_MGR_LANES];
+	uint32_t n = mgr->count[cipher], j;
+
+	// The batch is taken out of the queue first, so that callbacks can
+	// submit new jobs
+	memcpy(jobs, mgr->queue[cipher], n*sizeof(sw_job_t));
+	mgr->count[cipher] = 0;
+	mgr->backend[cipher](jobs, n, mgr->backend_arg[cipher]);
+	for (j = 0; j < n; j++)
+		if (jobs[j].cb) jobs[j].cb(&jobs[j], jobs[j].cb_arg);
+}
+
+// Queues one message. Returns -1 if the cipher is unknown.
+int job_mgr_submit(job_mgr_t *mgr, const sw_params_t *params, const uint8_t *in, uint8_t *out,
+                   size_t len, job_cb_t cb, void *cb_arg)
+{
+	sw_job_t *job;
+	int c = params->cipher;
+
+	if ((c < 0) || (c >= JOB_MGR_CIPHERS)) return -1;
+
+	job = &mgr->queue[c][mgr->count[c]++];
+	job->params = *params;
+	job->in = in;
+	job->out = out;
+	job->len = len;
+	job->status = 0;
+	job->cb = cb;
+	job->cb_arg = cb_arg;
+	memset(job->tag, 0, sizeof(job->tag));
+
+	if (mgr->count[c] == JOB_MGR_LANES) dispatch(mgr, c);
+	return 0;
+}
+
+// Runs all queued jobs, also the ones in incomplete batches
+void job_mgr_flush(job_mgr_t *mgr)
+{
+	int c;
+
+	for (c = 0; c < JOB_MGR_CIPHERS; c++)
+		if (mgr->count[c] > 0) dispatch(mgr, c);
+}
@@ -0,0 +1,50 @@
+#ifndef _JOB_MGR_H_
+#define _JOB_MGR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "snowv_mb.h"
+#include "sw_engine.h"
+#include "zuc256_mb.h"
+
+#define JOB_MGR_CIPHERS 5                   // number of sw_cipher_t values
+#define JOB_MGR_LANES   ZUC256_MB_LANES     // jobs per batch
+
+struct sw_job;
+typedef void (*job_cb_t)(const struct sw_job *job, void *cb_arg);
+
+// One message. The key, IV, AD, input and output buffers belong to the
+// caller and must stay valid until the callback has run.
+typedef struct sw_job {
+	sw_params_t    params;
+	const uint8_t *in;
+	uint8_t       *out;
+	size_t         len;
+	uint8_t        tag[16];    // sw_tag_bytes(&params) bytes are valid
+	int            status;     // 0 : done, -1 : invalid parameters
+	job_cb_t       cb;
+	void          *cb_arg;
+} sw_job_t;
+
+// Processes a batch of jobs of one cipher and fills in out, tag and status.
+// The default backends use the software engine; a driver can take over a
+// cipher by registering its own, e.g. to hand the batch to the accelerator.
+typedef void (*job_batch_fn_t)(sw_job_t *jobs, uint32_t njobs, void *arg);
+
+typedef struct {
+	sw_job_t       queue[JOB_MGR_CIPHERS][JOB_MGR_LANES];
+	uint32_t       count[JOB_MGR_CIPHERS];
+	job_batch_fn_t backend[JOB_MGR_CIPHERS];
+	void          *backend_arg[JOB_MGR_CIPHERS];
+	zuc256_mb_impl_t zuc_impl;
+	snowv_mb_impl_t  snowv_impl;
+} job_mgr_t;
+
+void job_mgr_init(job_mgr_t *mgr);
+void job_mgr_set_backend(job_mgr_t *mgr, sw_cipher_t cipher, job_batch_fn_t fn, void *arg);
+int job_mgr_submit(job_mgr_t *mgr, const sw_params_t *params, const uint8_t *in, uint8_t *out,
+                   size_t len, job_cb_t cb, void *cb_arg);
+void job_mgr_flush(job_mgr_t *mgr);
+
+#endif
@@ -0,0 +1,398 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "sw_engine.h"
+#include "job_mgr.h"
+#include "snowv_mb.h"
+#include "zuc256_mb.h"
+
+// Host test for the software engine. The vectors are the ones used by the
+// hardware testbenches and the *_sw_interface test programs. Byte strings
+// are given in the order in which they appear in the message.
+
+static int failures = 0;
+
+static void check_ok(const char *name, int ok)
+{
+	if (ok) {
+		printf("    %s correct!\n", name);
+	} else {
+		printf("    %s incorrect :(\n", name);
+		failures++;
+	}
+}
+
+static void check(const char *name, const uint8_t *out, const uint8_t *expected, size_t len)
+{
+	check_ok(name, memcmp(out, expected, len) == 0);
+}
+
+// Runs one message through the engine in chunks of at most chunk bytes
+static void run(const sw_params_t *params, const uint8_t *in, uint8_t *out, size_t len,
+                size_t chunk, uint8_t *tag)
+{
+	sw_ctx_t ctx;
+	size_t n = 0;
+
+	sw_ctx_init(&ctx, params);
+	for (size_t i = 0; i < len; i += chunk)
+		n += sw_ctx_update(&ctx, in + i, out + n, (len - i < chunk) ? len - i : chunk);
+	sw_ctx_final(&ctx, out + n, tag);
+}
+
+static void test_aes(void)
+{
+	// NIST SP 800-38A F.5.5, second block truncated to its last 8 bytes
+	static const uint8_t key[32] = {
+		0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+		0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4 };
+	static const uint8_t counter[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff };
+	static const uint8_t pt[24] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51 };
+	// The final partial block is XORed with the last bytes of the keystream block, as in aes_tot.v
+	static const uint8_t ct[24] = {
+		0x60, 0x1e, 0xc3, 0x13, 0x77, 0x57, 0x89, 0xa5, 0xb7, 0xa7, 0xf5, 0x04, 0xbb, 0xf3, 0xd2, 0x28,
+		0xca, 0x84, 0xe9, 0x90, 0xca, 0xca, 0xf5, 0xc5 };
+	// RFC 4493 uses AES-128: example 3, 40-byte message
+	static const uint8_t mac_key[16] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+	static const uint8_t msg[40] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+		0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+		0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11 };
+	static const uint8_t mac[16] = {
+		0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27 };
+	sw_params_t params = { 0 };
+	uint8_t out[40], tag[16];
+
+	printf("Test AES-256...\n");
+	params.cipher = SW_AES_CTR;
+	params.key = key;
+	params.keylen = 1;
+	params.iv = counter;
+	run(&params, pt, out, 24, 24, tag);
+	check("CTR encryption", out, ct, 24);
+	run(&params, pt, out, 24, 5, tag);
+	check("CTR encryption (5-byte chunks)", out, ct, 24);
+
+	params.cipher = SW_AES_CMAC;
+	params.key = mac_key;
+	params.keylen = 0;
+	run(&params, msg, out, 40, 40, tag);
+	check("CMAC tag", tag, mac, 16);
+	run(&params, msg, out, 40, 16, tag);
+	check("CMAC tag (16-byte chunks)", tag, mac, 16);
+}
+
+static void test_snowv(void)
+{
+	static const uint8_t key[32] = {
+		0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f,
+		0x0a, 0x1a, 0x2a, 0x3a, 0x4a, 0x5a, 0x6a, 0x7a, 0x8a, 0x9a, 0xaa, 0xba, 0xca, 0xda, 0xea, 0xfa };
+	static const uint8_t iv[16] = {
+		0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10 };
+	static const uint8_t tc4_tag[16] = {
+		0x25, 0x0e, 0xc8, 0xd7, 0x7a, 0x02, 0x2c, 0x08, 0x7a, 0xdf, 0x08, 0xb6, 0x5a, 0xdc, 0xbb, 0x1a };
+	static const uint8_t tc6_pt[33] = "0123456789abcdef SnowV-AEAD mode!";
+	static const uint8_t tc6_ct[33] = {
+		0xdd, 0x7e, 0x01, 0xb2, 0xb4, 0x24, 0xa2, 0xef, 0x82, 0x50, 0x27, 0x07, 0xe8, 0x7a, 0x32, 0xc1,
+		0x52, 0xb0, 0xd0, 0x18, 0x18, 0xfd, 0x7f, 0x12, 0x24, 0x3e, 0xb5, 0xa1, 0x56, 0x59, 0xe9, 0x1b,
+		0x4c };
+	static const uint8_t tc6_tag[16] = {
+		0x90, 0x7e, 0xa6, 0xa5, 0xb7, 0x3a, 0x51, 0xde, 0x74, 0x7c, 0x3e, 0x9a, 0xd9, 0xee, 0x02, 0x9b };
+	sw_params_t params = { 0 };
+	uint8_t out[33], tag[16];
+
+	printf("Test SNOW-V-GCM...\n");
+	params.cipher = SW_SNOWV_GCM;
+	params.key = key;
+	params.iv = iv;
+	params.ad = (const uint8_t *)"0123456789abcdef";
+	params.ad_len = 16;
+	run(&params, NULL, out, 0, 16, tag);
+	check("tc4 tag", tag, tc4_tag, 16);
+
+	params.ad = (const uint8_t *)"AAD test value!";
+	params.ad_len = 15;
+	params.encdec = 1;
+	run(&params, tc6_pt, out, 33, 33, tag);
+	check("tc6 encryption", out, tc6_ct, 33);
+	check("tc6 tag", tag, tc6_tag, 16);
+	run(&params, tc6_pt, out, 33, 7, tag);
+	check("tc6 encryption (7-byte chunks)", out, tc6_ct, 33);
+	check("tc6 tag (7-byte chunks)", tag, tc6_tag, 16);
+
+	params.encdec = 0;
+	run(&params, tc6_ct, out, 33, 33, tag);
+	check("tc6 decryption", out, tc6_pt, 33);
+	check("tc6 tag (decryption)", tag, tc6_tag, 16);
+}
+
+static void test_zuc256(void)
+{
+	static const uint8_t ctr_pt[16] = {
+		0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x00 };
+	static const uint8_t ctr_ct[16] = {
+		0x38, 0x87, 0xe1, 0xab, 0x30, 0x35, 0xd3, 0x21, 0x3a, 0x8f, 0x8b, 0xfc, 0xed, 0xd6, 0x03, 0xe9 };
+	static const uint8_t mac[16] = {
+		0xdd, 0x3a, 0x40, 0x17, 0x35, 0x78, 0x03, 0xa5, 0x1c, 0x3f, 0xb9, 0xa5, 0x7a, 0x96, 0xfe, 0xda };
+	static const size_t lens[] = { 3, 4, 37, 500 };
+	uint8_t key[32], iv[16], msg[500], out[500], tag[16], ref_tag[16];
+	sw_params_t params = { 0 };
+	char name[64];
+	uint32_t t;
+	size_t l;
+	int ok;
+
+	memset(key, 0xff, sizeof(key));
+	memset(iv, 0xff, sizeof(iv));
+	memset(msg, 0x11, sizeof(msg));
+
+	printf("Test ZUC-256...\n");
+	params.cipher = SW_ZUC256_CTR;
+	params.key = key;
+	params.iv = iv;
+	run(&params, ctr_pt, out, 16, 16, tag);
+	check("CTR encryption", out, ctr_ct, 16);
+	run(&params, ctr_pt, out, 16, 3, tag);
+	check("CTR encryption (3-byte chunks)", out, ctr_ct, 16);
+
+	params.cipher = SW_ZUC256_MAC;
+	params.tag_len = 128;
+	run(&params, msg, out, 500, 500, tag);
+	check("MAC tag", tag, mac, 16);
+	run(&params, msg, out, 500, 13, tag);
+	check("MAC tag (13-byte chunks)", tag, mac, 16);
+
+	// Whole words against the bit-by-bit path, which 1-byte chunks take
+	for (l = 0; l < sizeof(msg); l++) msg[l] = 7*l ^ (l >> 3);
+	for (t = 32; t <= 128; t *= 2) {
+		params.tag_len = t;
+		for (ok = 1, l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+			run(&params, msg, out, lens[l], lens[l], tag);
+			run(&params, msg, out, lens[l], 1, ref_tag);
+			ok &= (memcmp(tag, ref_tag, t / 8) == 0);
+			run(&params, msg, out, lens[l], 6, tag);
+			ok &= (memcmp(tag, ref_tag, t / 8) == 0);
+		}
+		snprintf(name, sizeof(name), "%u-bit MAC tag (word-wise)", t);
+		check_ok(name, ok);
+	}
+}
+
+// Every lane of the multi-lane engine against the single-stream engine,
+// for each implementation the CPU supports
+static void test_zuc256_mb(void)
+{
+	static const char *names[] = { "", "scalar", "AVX2", "AVX-512" };
+	static uint8_t key[ZUC256_MB_LANES][32], iv[ZUC256_MB_LANES][16];
+	static uint32_t z[ZUC256_MB_LANES][100], ref[100];
+	const uint8_t *keys[ZUC256_MB_LANES], *ivs[ZUC256_MB_LANES];
+	uint32_t *zs[ZUC256_MB_LANES], *zs_next[ZUC256_MB_LANES];
+	zuc256_mb_state_t st;
+	zuc256_sw_state_t s;
+	char name[64];
+	int impl, nlanes, l, i, ok;
+
+	for (l = 0; l < ZUC256_MB_LANES; l++) {
+		for (i = 0; i < 32; i++) key[l][i] = 17*l + 5*i + 3;
+		for (i = 0; i < 16; i++) iv[l][i] = 29*l ^ 7*i;
+		keys[l] = key[l];
+		ivs[l] = iv[l];
+		zs[l] = z[l];
+		zs_next[l] = z[l] + 7;
+	}
+
+	printf("Test ZUC-256 multi-lane...\n");
+	for (impl = ZUC256_MB_SCALAR; impl <= (int) zuc256_mb_detect(); impl++) {
+		for (nlanes = 5; nlanes <= ZUC256_MB_LANES; nlanes += 11) {
+			zuc256_mb_setup(&st, impl, nlanes, keys, ivs, 64);
+			zuc256_mb_keystream(&st, zs, 7);
+			zuc256_mb_keystream(&st, zs_next, 93);
+			for (ok = 1, l = 0; l < nlanes; l++) {
+				zuc256_sw_setup(&s, key[l], iv[l], 64);
+				zuc256_sw_keystream(&s, ref, 100);
+				ok &= (memcmp(z[l], ref, sizeof(ref)) == 0);
+			}
+			snprintf(name, sizeof(name), "%s keystream (%d lanes)", names[impl], nlanes);
+			check_ok(name, ok);
+		}
+	}
+}
+
+// Same for the SNOW-V lanes, also in initialization mode
+static void test_snowv_mb(void)
+{
+	static const char *names[] = { "", "scalar", "AES-NI", "VAES" };
+	static uint8_t key[SNOWV_MB_LANES][32], iv[SNOWV_MB_LANES][16];
+	static uint8_t z[SNOWV_MB_LANES][16*40], ref[16*40];
+	const uint8_t *keys[SNOWV_MB_LANES], *ivs[SNOWV_MB_LANES];
+	uint8_t *zs[SNOWV_MB_LANES], *zs_next[SNOWV_MB_LANES];
+	snowv_sw_state_t st[SNOWV_MB_LANES], *sp[SNOWV_MB_LANES], s;
+	char name[64];
+	int impl, nlanes, aead, l, i, ok;
+
+	for (l = 0; l < SNOWV_MB_LANES; l++) {
+		for (i = 0; i < 32; i++) key[l][i] = 23*l + 3*i + 1;
+		for (i = 0; i < 16; i++) iv[l][i] = 31*l ^ 5*i;
+		keys[l] = key[l];
+		ivs[l] = iv[l];
+		zs[l] = z[l];
+		zs_next[l] = z[l] + 16*3;
+		sp[l] = &st[l];
+	}
+
+	printf("Test SNOW-V multi-lane...\n");
+	for (impl = SNOWV_MB_SCALAR; impl <= (int) snowv_mb_detect(); impl++) {
+		for (nlanes = 1; nlanes <= SNOWV_MB_LANES; nlanes++) {
+			for (ok = 1, aead = 0; aead < 2; aead++) {
+				snowv_mb_keyiv_setup(sp, nlanes, impl, keys, ivs, aead);
+				snowv_mb_keystream(sp, nlanes, impl, zs, 3);
+				snowv_mb_keystream(sp, nlanes, impl, zs_next, 37);
+				for (l = 0; l < nlanes; l++) {
+					snowv_sw_keyiv_setup(&s, key[l], iv[l], aead);
+					for (i = 0; i < 40; i++)
+						snowv_sw_keystream(&s, ref + 16*i);
+					ok &= (memcmp(z[l], ref, sizeof(ref)) == 0);
+				}
+			}
+			snprintf(name, sizeof(name), "%s keystream (%d lanes)", names[impl], nlanes);
+			check_ok(name, ok);
+		}
+	}
+}
+
+// Long messages through the AES-NI/PCLMULQDQ paths in 1000-byte chunks,
+// against the portable code in 37-byte chunks: AES-CTR and AES-CMAC with
+// both key lengths and SNOW-V-GCM in all modes, so that the 8-way CTR
+// loop, the 4-block GHASH aggregation and their tails are all covered
+static void test_aes_ni(void)
+{
+	static const size_t lens[] = { 17, 127, 128, 129, 1000, 4099 };
+	static uint8_t key[32], iv[16], ad[100], in[4099], out[2][4099];
+	uint8_t tag[2][16];
+	sw_params_t params = { 0 };
+	char name[64];
+	int c, k, m, ok;
+	size_t i, l;
+
+	if (aes_sw_detect() != AES_SW_NI) return;
+
+	for (i = 0; i < 32; i++) key[i] = 11*i + 1;
+	for (i = 0; i < 16; i++) iv[i] = 0xf0 + i;   // lower 64 bits of the counter wrap around
+	for (i = 0; i < 100; i++) ad[i] = 3*i;
+	for (i = 0; i < sizeof(in); i++) in[i] = i ^ (i >> 8);
+
+	printf("Test AES-NI against the portable code...\n");
+	params.key = key;
+	params.iv = iv;
+	params.ad = ad;
+	params.ad_len = 100;
+	for (c = 0; c < 3; c++) {
+		for (m = 0; m < ((c == 2) ? 4 : 2); m++) {
+			params.cipher = (c == 0) ? SW_AES_CTR : (c == 1) ? SW_AES_CMAC : SW_SNOWV_GCM;
+			params.keylen = m & 1;
+			params.encdec = (m != 1);
+			params.encdec_only = (c == 2) && (m == 2);
+			params.auth_only = (c == 2) && (m == 3);
+			for (ok = 1, l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+				for (k = 0; k < 2; k++) {
+					memset(out[k], 0, lens[l]);
+					memset(tag[k], 0, 16);
+					aes_sw_select(k ? AES_SW_NI : AES_SW_PORTABLE);
+					run(&params, in, out[k], lens[l], k ? 1000 : 37, tag[k]);
+				}
+				ok &= (memcmp(out[0], out[1], lens[l]) == 0) && (memcmp(tag[0], tag[1], 16) == 0);
+			}
+			snprintf(name, sizeof(name), "%s mode %d", (c == 0) ? "AES-CTR" : (c == 1) ? "AES-CMAC" : "SNOW-V-GCM", m);
+			check_ok(name, ok);
+		}
+	}
+	aes_sw_select(AES_SW_AUTO);
+}
+
+// Jobs of mixed ciphers and lengths through the job manager, checked
+// against single runs of the software engine
+#define JOBS 40
+
+static int jobs_done;
+
+static void job_done(const sw_job_t *job, void *cb_arg)
+{
+	uint8_t *tag = cb_arg;
+
+	if (job->status == 0) memcpy(tag, job->tag, 16);
+	jobs_done++;
+}
+
+static void test_job_mgr(void)
+{
+	static const sw_cipher_t ciphers[4] = { SW_ZUC256_CTR, SW_ZUC256_CTR, SW_AES_CTR, SW_SNOWV_GCM };
+	static uint8_t key[JOBS][32], iv[JOBS][16], in[JOBS][1500], out[JOBS][1500], ref[1500];
+	static uint8_t tag[JOBS][16], ref_tag[16];
+	static job_mgr_t mgr;
+	sw_params_t params[JOBS];
+	size_t len[JOBS];
+	int j, i, ok = 1;
+
+	printf("Test job manager...\n");
+	job_mgr_init(&mgr);
+	jobs_done = 0;
+	for (j = 0; j < JOBS; j++) {
+		for (i = 0; i < 32; i++) key[j][i] = 3*j + i;
+		for (i = 0; i < 16; i++) iv[j][i] = 7*j ^ i;
+		len[j] = 40 + (j*367) % 1461;
+		for (i = 0; i < (int) len[j]; i++) in[j][i] = i + j;
+		memset(&params[j], 0, sizeof(sw_params_t));
+		params[j].cipher = ciphers[j & 3];
+		params[j].key = key[j];
+		params[j].keylen = 1;
+		params[j].iv = iv[j];
+		params[j].encdec = 1;
+		if (params[j].cipher == SW_SNOWV_GCM) {
+			// All SNOW-V-GCM modes, with AD
+			params[j].ad = in[j];
+			params[j].ad_len = j;
+			params[j].encdec = ((j >> 2) & 3) != 1;
+			params[j].encdec_only = ((j >> 2) & 3) == 2;
+			params[j].auth_only = ((j >> 2) & 3) == 3;
+		}
+		job_mgr_submit(&mgr, &params[j], in[j], out[j], len[j], job_done, tag[j]);
+	}
+	job_mgr_flush(&mgr);
+
+	for (j = 0; j < JOBS; j++) {
+		run(&params[j], in[j], ref, len[j], len[j], ref_tag);
+		if (!params[j].auth_only) ok &= (memcmp(out[j], ref, len[j]) == 0);
+		if ((params[j].cipher == SW_SNOWV_GCM) && !params[j].encdec_only)
+			ok &= (memcmp(tag[j], ref_tag, 16) == 0);
+	}
+	check_ok("all jobs completed", jobs_done == JOBS);
+	check_ok("job outputs and tags", ok);
+}
+
+int main()
+{
+	static const char *aes_impls[] = { "", "portable", "AES-NI" };
+	int impl;
+
+	printf("----------- Begin software engine test: -----------\n");
+
+	for (impl = AES_SW_PORTABLE; impl <= (int) aes_sw_detect(); impl++) {
+		printf("AES implementation: %s\n", aes_impls[impl]);
+		aes_sw_select(impl);
+		test_aes();
+		test_snowv();
+		test_zuc256();
+	}
+	aes_sw_select(AES_SW_AUTO);
+	test_aes_ni();
+	test_zuc256_mb();
+	test_snowv_mb();
+	test_job_mgr();
+
+	printf("---------------- %d test(s) failed ----------------\n", failures);
+	return failures != 0;
+}
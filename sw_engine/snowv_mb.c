@@ -0,0 +1,254 @@
+#include <string.h>
+
+#include "snowv_mb.h"
+
+// Vectorised SNOW-V. As in snowv_core.v, the FSM updates R2 and R3 with a
+// full AES round, here AESENC with an all-zero round key. The two LFSRs of
+// 16 x 16 bits are kept as a low and a high register each, (a0..a7) and
+// (a8..a15). The 8 steps of one keystream block only read cells that
+// already exist, so they are done at once:
+//
+//   a16..a23 = mul_x(a0..a7) ^ a1..a8 ^ mul_x_inv(a8..a15) ^ b0..b7
+//   b16..b23 = mul_x(b0..b7) ^ b3..b10 ^ mul_x_inv(b8..b15) ^ a0..a7
+//
+// The lanes are independent snowv_sw_state_t, e.g. the contexts of
+// separate messages, loaded into the registers for a call and written back
+// at the end. The SIMD versions are compiled for their target only and
+// picked at runtime, as in zuc256_mb.c.
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SNOWV_MB_X86
+#include <immintrin.h>
+#endif
+
+#define LOAD32(p)  ((uint32_t) (p)[0] | ((uint32_t) (p)[1] << 8) | ((uint32_t) (p)[2] << 16) | ((uint32_t) (p)[3] << 24))
+
+static void xor_r1(snowv_sw_state_t *s, const uint8_t *k)
+{
+	int j;
+
+	for (j = 0; j < 4; j++)
+		s->R1[j] ^= LOAD32(k + 4*j);
+}
+
+#ifdef SNOWV_MB_X86
+
+// One keystream block, written against the V_* operations below so that
+// the 128-bit and the AVX-512 version share it. zz is the keystream.
+#define V_MULX(x, c)   V_XOR(V_SLL16(x, 1), V_AND(V_SRA16(x, 15), c))
+#define V_INVX(x, d)   V_XOR(V_SRL16(x, 1), V_AND(V_SRA16(V_SLL16(x, 15), 15), d))
+
+#define MB_STEP()                                                                          \
+	do {                                                                                   \
+		zz = V_XOR(V_ADD32(b_hi, r1), r2);                                                 \
+		t = V_SHUF8(V_ADD32(V_XOR(a_lo, r3), r2), SIGMA);                                  \
+		r3 = V_AESR(r2);                                                                   \
+		r2 = V_AESR(r1);                                                                   \
+		r1 = t;                                                                            \
+		na = V_XOR(V_XOR(V_MULX(a_lo, PA), V_ALIGNR(a_hi, a_lo, 2)),                       \
+		           V_XOR(V_INVX(a_hi, QA), b_lo));                                         \
+		nb = V_XOR(V_XOR(V_MULX(b_lo, PB), V_ALIGNR(b_hi, b_lo, 6)),                       \
+		           V_XOR(V_INVX(b_hi, QB), a_lo));                                         \
+		a_lo = a_hi;                                                                       \
+		b_lo = b_hi;                                                                       \
+		a_hi = na;                                                                         \
+		b_hi = nb;                                                                         \
+	} while (0)
+
+// 128 bits: one lane
+
+#define V_AND(a, b)        _mm_and_si128(a, b)
+#define V_XOR(a, b)        _mm_xor_si128(a, b)
+#define V_ADD32(a, b)      _mm_add_epi32(a, b)
+#define V_SLL16(a, n)      _mm_slli_epi16(a, n)
+#define V_SRL16(a, n)      _mm_srli_epi16(a, n)
+#define V_SRA16(a, n)      _mm_srai_epi16(a, n)
+#define V_ALIGNR(a, b, n)  _mm_alignr_epi8(a, b, n)
+#define V_SHUF8(a, m)      _mm_shuffle_epi8(a, m)
+#define V_AESR(a)          _mm_aesenc_si128(a, _mm_setzero_si128())
+
+// In initialization mode (z == NULL) the keystream is fed back into the
+// high half of LFSR A instead of being output
+__attribute__((target("aes,ssse3")))
+static void lane_aesni(snowv_sw_state_t *s, uint8_t *z, size_t nblocks)
+{
+	const __m128i SIGMA = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+	const __m128i PA = _mm_set1_epi16((short) 0x990f), QA = _mm_set1_epi16((short) 0xcc87);
+	const __m128i PB = _mm_set1_epi16((short) 0xc963), QB = _mm_set1_epi16((short) 0xe4b1);
+	__m128i a_lo, a_hi, b_lo, b_hi, r1, r2, r3, zz, t, na, nb;
+	size_t k;
+
+	a_lo = _mm_loadu_si128((const __m128i *) s->A);
+	a_hi = _mm_loadu_si128((const __m128i *) (s->A + 8));
+	b_lo = _mm_loadu_si128((const __m128i *) s->B);
+	b_hi = _mm_loadu_si128((const __m128i *) (s->B + 8));
+	r1 = _mm_loadu_si128((const __m128i *) s->R1);
+	r2 = _mm_loadu_si128((const __m128i *) s->R2);
+	r3 = _mm_loadu_si128((const __m128i *) s->R3);
+
+	for (k = 0; k < nblocks; k++) {
+		MB_STEP();
+		if (z) _mm_storeu_si128((__m128i *) (z + 16*k), zz);
+		else a_hi = _mm_xor_si128(a_hi, zz);
+	}
+
+	_mm_storeu_si128((__m128i *) s->A, a_lo);
+	_mm_storeu_si128((__m128i *) (s->A + 8), a_hi);
+	_mm_storeu_si128((__m128i *) s->B, b_lo);
+	_mm_storeu_si128((__m128i *) (s->B + 8), b_hi);
+	_mm_storeu_si128((__m128i *) s->R1, r1);
+	_mm_storeu_si128((__m128i *) s->R2, r2);
+	_mm_storeu_si128((__m128i *) s->R3, r3);
+}
+
+#undef V_AND
+#undef V_XOR
+#undef V_ADD32
+#undef V_SLL16
+#undef V_SRL16
+#undef V_SRA16
+#undef V_ALIGNR
+#undef V_SHUF8
+#undef V_AESR
+
+// AVX-512 with VAES: lane l in the 128-bit lane l of every register
+
+#define V_AND(a, b)        _mm512_and_si512(a, b)
+#define V_XOR(a, b)        _mm512_xor_si512(a, b)
+#define V_ADD32(a, b)      _mm512_add_epi32(a, b)
+#define V_SLL16(a, n)      _mm512_slli_epi16(a, n)
+#define V_SRL16(a, n)      _mm512_srli_epi16(a, n)
+#define V_SRA16(a, n)      _mm512_srai_epi16(a, n)
+#define V_ALIGNR(a, b, n)  _mm512_alignr_epi8(a, b, n)
+#define V_SHUF8(a, m)      _mm512_shuffle_epi8(a, m)
+#define V_AESR(a)          _mm512_aesenc_epi128(a, _mm512_setzero_si512())
+
+// Unused lanes compute on a copy of lane 0 and are not written back
+#define LANE(l)            s[((l) < nlanes) ? (l) : 0]
+#define LOAD4(f)                                                                           \
+	_mm512_inserti32x4(_mm512_inserti32x4(_mm512_inserti32x4(                              \
+		_mm512_castsi128_si512(_mm_loadu_si128((const __m128i *) (LANE(0)->f))),           \
+		_mm_loadu_si128((const __m128i *) (LANE(1)->f)), 1),                               \
+		_mm_loadu_si128((const __m128i *) (LANE(2)->f)), 2),                               \
+		_mm_loadu_si128((const __m128i *) (LANE(3)->f)), 3)
+#define STORE4(f, v)                                                                       \
+	do {                                                                                   \
+		_mm512_store_si512((void *) tmp, v);                                               \
+		for (l = 0; l < nlanes; l++)                                                       \
+			memcpy(s[l]->f, tmp + 16*l, 16);                                               \
+	} while (0)
+
+__attribute__((target("avx512f,avx512bw,vaes")))
+static void lanes_vaes(snowv_sw_state_t *const *s, uint32_t nlanes, uint8_t *const *z, size_t nblocks)
+{
+	const __m512i SIGMA = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15));
+	const __m512i PA = _mm512_set1_epi16((short) 0x990f), QA = _mm512_set1_epi16((short) 0xcc87);
+	const __m512i PB = _mm512_set1_epi16((short) 0xc963), QB = _mm512_set1_epi16((short) 0xe4b1);
+	__m512i a_lo, a_hi, b_lo, b_hi, r1, r2, r3, zz, t, na, nb;
+	uint8_t tmp[64] __attribute__((aligned(64)));
+	uint32_t l;
+	size_t k;
+
+	a_lo = LOAD4(A);
+	a_hi = LOAD4(A + 8);
+	b_lo = LOAD4(B);
+	b_hi = LOAD4(B + 8);
+	r1 = LOAD4(R1);
+	r2 = LOAD4(R2);
+	r3 = LOAD4(R3);
+
+	for (k = 0; k < nblocks; k++) {
+		MB_STEP();
+		if (z) {
+			_mm512_store_si512((void *) tmp, zz);
+			for (l = 0; l < nlanes; l++)
+				memcpy(z[l] + 16*k, tmp + 16*l, 16);
+		} else {
+			a_hi = _mm512_xor_si512(a_hi, zz);
+		}
+	}
+
+	STORE4(A, a_lo);
+	STORE4(A + 8, a_hi);
+	STORE4(B, b_lo);
+	STORE4(B + 8, b_hi);
+	STORE4(R1, r1);
+	STORE4(R2, r2);
+	STORE4(R3, r3);
+}
+
+#endif
+
+snowv_mb_impl_t snowv_mb_detect(void)
+{
+#ifdef SNOWV_MB_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("vaes") && __builtin_cpu_supports("avx512bw")) return SNOWV_MB_VAES;
+	if (__builtin_cpu_supports("aes") && __builtin_cpu_supports("ssse3")) return SNOWV_MB_AESNI;
+#endif
+	return SNOWV_MB_SCALAR;
+}
+
+// nblocks keystream blocks of every lane, or initialization rounds if z
+// is NULL. A single lane does not need the wide registers.
+static void mb_blocks(snowv_sw_state_t *const *s, uint32_t nlanes, snowv_mb_impl_t impl,
+                      uint8_t *const *z, size_t nblocks)
+{
+	uint8_t ks[16];
+	uint32_t l, j;
+	size_t k;
+
+	switch (impl) {
+#ifdef SNOWV_MB_X86
+	case SNOWV_MB_VAES:
+		if (nlanes > 1) {
+			lanes_vaes(s, nlanes, z, nblocks);
+			break;
+		}
+		/* fall through */
+	case SNOWV_MB_AESNI:
+		for (l = 0; l < nlanes; l++)
+			lane_aesni(s[l], z ? z[l] : NULL, nblocks);
+		break;
+#endif
+	default:
+		for (l = 0; l < nlanes; l++)
+			for (k = 0; k < nblocks; k++) {
+				if (z) {
+					snowv_sw_keystream(s[l], z[l] + 16*k);
+				} else {
+					snowv_sw_keystream(s[l], ks);
+					for (j = 0; j < 8; j++)
+						s[l]->A[j + 8] ^= (uint16_t) (ks[2*j] | (ks[2*j + 1] << 8));
+				}
+			}
+		break;
+	}
+}
+
+// snowv_sw_keyiv_setup() of key[l] and iv[l] into lane l, with the 16
+// initialization rounds of all lanes run together
+void snowv_mb_keyiv_setup(snowv_sw_state_t *const *s, uint32_t nlanes, snowv_mb_impl_t impl,
+                          const uint8_t *const *key, const uint8_t *const *iv, int aead)
+{
+	uint32_t l;
+
+	if (impl == SNOWV_MB_AUTO) impl = snowv_mb_detect();
+
+	for (l = 0; l < nlanes; l++)
+		snowv_sw_keyiv_load(s[l], key[l], iv[l], aead);
+	mb_blocks(s, nlanes, impl, NULL, 15);
+	for (l = 0; l < nlanes; l++)
+		xor_r1(s[l], key[l]);
+	mb_blocks(s, nlanes, impl, NULL, 1);
+	for (l = 0; l < nlanes; l++)
+		xor_r1(s[l], key[l] + 16);
+}
+
+// Writes the next nblocks keystream blocks of lane l to z[l]
+void snowv_mb_keystream(snowv_sw_state_t *const *s, uint32_t nlanes, snowv_mb_impl_t impl,
+                        uint8_t *const *z, size_t nblocks)
+{
+	if (impl == SNOWV_MB_AUTO) impl = snowv_mb_detect();
+	mb_blocks(s, nlanes, impl, z, nblocks);
+}
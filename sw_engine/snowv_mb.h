@@ -0,0 +1,25 @@
+#ifndef _SNOWV_MB_H_
+#define _SNOWV_MB_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "snowv_sw.h"
+
+#define SNOWV_MB_LANES 4
+
+typedef enum {
+	SNOWV_MB_AUTO = 0,      // best implementation supported by the CPU
+	SNOWV_MB_SCALAR,
+	SNOWV_MB_AESNI,         // one lane after the other in 128-bit registers
+	SNOWV_MB_VAES           // four lanes in AVX-512 registers
+} snowv_mb_impl_t;
+
+snowv_mb_impl_t snowv_mb_detect(void);
+
+void snowv_mb_keyiv_setup(snowv_sw_state_t *const *s, uint32_t nlanes, snowv_mb_impl_t impl,
+                          const uint8_t *const *key, const uint8_t *const *iv, int aead);
+void snowv_mb_keystream(snowv_sw_state_t *const *s, uint32_t nlanes, snowv_mb_impl_t impl,
+                        uint8_t *const *z, size_t nblocks);
+
+#endif
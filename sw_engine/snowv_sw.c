@@ -0,0 +1,385 @@
+#include <string.h>
+
+#include "aes_sw.h"
+#include "snowv_mb.h"
+#include "snowv_sw.h"
+
+// SNOW-V-GCM for the host, following snowv_gcm.v: the first keystream
+// block after initialization is the hash key H, the second one masks the
+// tag (Mtag), and the payload keystream starts at the third block.
+
+// Keystream blocks generated per call of snowv_mb_keystream() in the bulk
+#define KS_CHUNK 16
+
+static const uint8_t sigma[16] = { 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15 };
+
+// Constants of the GHASH reduction for 4-bit multiplication
+static const uint64_t last4[16] = {
+	0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+	0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+#define MAKEU16(hi, lo)        (((uint16_t) (hi) << 8) | (uint16_t) (lo))
+#define MAKEU32(a, b, c, d)    (((uint32_t) (a) << 24) | ((uint32_t) (b) << 16) | ((uint32_t) (c) << 8) | (uint32_t) (d))
+
+static uint16_t mul_x(uint16_t v, uint16_t c)
+{
+	return (v & 0x8000) ? ((v << 1) ^ c) : (v << 1);
+}
+
+static uint16_t mul_x_inv(uint16_t v, uint16_t d)
+{
+	return (v & 0x0001) ? ((v >> 1) ^ d) : (v >> 1);
+}
+
+static void permute_sigma(uint32_t *state)
+{
+	uint8_t tmp[16];
+	int i;
+
+	for (i = 0; i < 16; i++)
+		tmp[i] = state[sigma[i] >> 2] >> ((sigma[i] & 3) << 3);
+	for (i = 0; i < 4; i++)
+		state[i] = MAKEU32(tmp[4*i + 3], tmp[4*i + 2], tmp[4*i + 1], tmp[4*i]);
+}
+
+static void lfsr_update(snowv_sw_state_t *s)
+{
+	uint16_t u, v;
+	int i, j;
+
+	for (i = 0; i < 8; i++) {
+		u = mul_x(s->A[0], 0x990f) ^ s->A[1] ^ mul_x_inv(s->A[8], 0xcc87) ^ s->B[0];
+		v = mul_x(s->B[0], 0xc963) ^ s->B[3] ^ mul_x_inv(s->B[8], 0xe4b1) ^ s->A[0];
+		for (j = 0; j < 15; j++) {
+			s->A[j] = s->A[j + 1];
+			s->B[j] = s->B[j + 1];
+		}
+		s->A[15] = u;
+		s->B[15] = v;
+	}
+}
+
+static void fsm_update(snowv_sw_state_t *s)
+{
+	uint32_t R1temp[4], T2;
+	int i;
+
+	memcpy(R1temp, s->R1, sizeof(R1temp));
+	for (i = 0; i < 4; i++) {
+		T2 = ((uint32_t) s->A[2*i + 1] << 16) | s->A[2*i];
+		s->R1[i] = (T2 ^ s->R3[i]) + s->R2[i];
+	}
+	permute_sigma(s->R1);
+	aes_sw_round(s->R3, s->R2);
+	aes_sw_round(s->R2, R1temp);
+}
+
+// Produce one 16-byte keystream block and clock the cipher
+void snowv_sw_keystream(snowv_sw_state_t *s, uint8_t *z)
+{
+	uint32_t T1, v;
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		T1 = ((uint32_t) s->B[2*i + 9] << 16) | s->B[2*i + 8];
+		v = (T1 + s->R1[i]) ^ s->R2[i];
+		z[4*i + 0] = v;
+		z[4*i + 1] = v >> 8;
+		z[4*i + 2] = v >> 16;
+		z[4*i + 3] = v >> 24;
+	}
+	fsm_update(s);
+	lfsr_update(s);
+}
+
+// Loads key and IV into the state, before the initialization rounds
+void snowv_sw_keyiv_load(snowv_sw_state_t *s, const uint8_t *key, const uint8_t *iv, int aead)
+{
+	static const uint16_t aead_b[8] = { 0x6C41, 0x7865, 0x6B45, 0x2064, 0x694A, 0x676E, 0x6854, 0x6D6F };
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		s->A[i] = MAKEU16(iv[2*i + 1], iv[2*i]);
+		s->A[i + 8] = MAKEU16(key[2*i + 1], key[2*i]);
+		s->B[i] = aead ? aead_b[i] : 0x0000;
+		s->B[i + 8] = MAKEU16(key[2*i + 17], key[2*i + 16]);
+	}
+	for (i = 0; i < 4; i++)
+		s->R1[i] = s->R2[i] = s->R3[i] = 0;
+}
+
+void snowv_sw_keyiv_setup(snowv_sw_state_t *s, const uint8_t *key, const uint8_t *iv, int aead)
+{
+	uint8_t z[16];
+	int i, j;
+
+	snowv_sw_keyiv_load(s, key, iv, aead);
+	for (i = 0; i < 16; i++) {
+		snowv_sw_keystream(s, z);
+		for (j = 0; j < 8; j++)
+			s->A[j + 8] ^= MAKEU16(z[2*j + 1], z[2*j]);
+		if (i == 14)
+			for (j = 0; j < 4; j++)
+				s->R1[j] ^= MAKEU32(key[4*j + 3], key[4*j + 2], key[4*j + 1], key[4*j]);
+		if (i == 15)
+			for (j = 0; j < 4; j++)
+				s->R1[j] ^= MAKEU32(key[4*j + 19], key[4*j + 18], key[4*j + 17], key[4*j + 16]);
+	}
+}
+
+static uint64_t load64_be(const uint8_t *p)
+{
+	uint64_t x = 0;
+	int i;
+
+	for (i = 0; i < 8; i++)
+		x = (x << 8) | p[i];
+	return x;
+}
+
+static void ghash_table(snowv_sw_ctx_t *ctx, const uint8_t *h)
+{
+	uint64_t vh = load64_be(h), vl = load64_be(h + 8);
+	uint32_t T;
+	int i, j;
+
+	ctx->HL[8] = vl;
+	ctx->HH[8] = vh;
+	ctx->HL[0] = 0;
+	ctx->HH[0] = 0;
+	for (i = 4; i > 0; i >>= 1) {
+		T = (vl & 1) * 0xe1000000U;
+		vl = (vh << 63) | (vl >> 1);
+		vh = (vh >> 1) ^ ((uint64_t) T << 32);
+		ctx->HL[i] = vl;
+		ctx->HH[i] = vh;
+	}
+	for (i = 2; i <= 8; i *= 2)
+		for (j = 1; j < i; j++) {
+			ctx->HH[i + j] = ctx->HH[i] ^ ctx->HH[j];
+			ctx->HL[i + j] = ctx->HL[i] ^ ctx->HL[j];
+		}
+}
+
+// X = (X ^ block) * H
+static void ghash_block(snowv_sw_ctx_t *ctx, const uint8_t *block)
+{
+	uint8_t x[16];
+	uint64_t zh, zl;
+	uint8_t lo, hi, rem;
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		x[i] = block[i] ^ (ctx->X[0] >> (56 - 8*i));
+		x[i + 8] = block[i + 8] ^ (ctx->X[1] >> (56 - 8*i));
+	}
+
+	lo = x[15] & 0xf;
+	zh = ctx->HH[lo];
+	zl = ctx->HL[lo];
+	for (i = 15; i >= 0; i--) {
+		lo = x[i] & 0xf;
+		hi = x[i] >> 4;
+		if (i != 15) {
+			rem = zl & 0xf;
+			zl = (zh << 60) | (zl >> 4);
+			zh = (zh >> 4) ^ (last4[rem] << 48);
+			zh ^= ctx->HH[lo];
+			zl ^= ctx->HL[lo];
+		}
+		rem = zl & 0xf;
+		zl = (zh << 60) | (zl >> 4);
+		zh = (zh >> 4) ^ (last4[rem] << 48);
+		zh ^= ctx->HH[hi];
+		zl ^= ctx->HL[hi];
+	}
+	ctx->X[0] = zh;
+	ctx->X[1] = zl;
+}
+
+// GHASH over nblocks full blocks
+static void ghash_blocks(snowv_sw_ctx_t *ctx, const uint8_t *in, size_t nblocks)
+{
+	if (ctx->ni) {
+		aes_ni_ghash(&ctx->hk, ctx->X, in, nblocks);
+		return;
+	}
+	for (; nblocks > 0; nblocks--) {
+		ghash_block(ctx, in);
+		in += 16;
+	}
+}
+
+// GHASH over a zero-padded partial block
+static void ghash_partial(snowv_sw_ctx_t *ctx, const uint8_t *in, size_t len)
+{
+	uint8_t block[16];
+
+	memset(block, 0, 16);
+	memcpy(block, in, len);
+	ghash_block(ctx, block);
+}
+
+int snowv_sw_init(snowv_sw_ctx_t *ctx, const uint8_t *key, const uint8_t *iv,
+                  const uint8_t *ad, size_t ad_len, int encdec_only, int auth_only, int encdec)
+{
+	snowv_sw_state_t *s = &ctx->s;
+
+	if ((key == NULL) || (iv == NULL)) return -1;
+
+	snowv_mb_keyiv_setup(&s, 1, (aes_sw_impl() == AES_SW_NI) ? SNOWV_MB_AESNI : SNOWV_MB_SCALAR,
+	                     &key, &iv, 1);
+	return snowv_sw_init_state(ctx, ad, ad_len, encdec_only, auth_only, encdec);
+}
+
+// snowv_sw_init() for a ctx->s that was already set up with the key and
+// IV in AEAD mode, e.g. by snowv_mb_keyiv_setup() for several messages
+int snowv_sw_init_state(snowv_sw_ctx_t *ctx, const uint8_t *ad, size_t ad_len,
+                        int encdec_only, int auth_only, int encdec)
+{
+	uint8_t h[16];
+
+	if ((ad == NULL) && (ad_len > 0)) return -1;
+	if (encdec_only && auth_only) return -1;
+
+	ctx->encdec_only = encdec_only;
+	ctx->auth_only = auth_only;
+	ctx->encdec = encdec;
+	ctx->len_ad = ad_len;
+	ctx->len_i = 0;
+	ctx->buf_len = 0;
+	ctx->X[0] = 0;
+	ctx->X[1] = 0;
+
+	ctx->ni = (aes_sw_impl() == AES_SW_NI);
+	snowv_sw_keystream(&ctx->s, h);
+	snowv_sw_keystream(&ctx->s, ctx->Mtag);
+	ghash_table(ctx, h);
+	if (ctx->ni) aes_ni_ghash_init(&ctx->hk, h);
+
+	if (!encdec_only) {
+		ghash_blocks(ctx, ad, ad_len / 16);
+		ad += ad_len & ~(size_t) 15;
+		ad_len &= 15;
+		if (ad_len > 0) ghash_partial(ctx, ad, ad_len);
+	}
+	return 0;
+}
+
+// Encrypt/decrypt and/or authenticate len bytes of a block, len <= 16
+static void process_block(snowv_sw_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len)
+{
+	uint8_t z[16], c[16];
+	size_t i;
+
+	if (ctx->auth_only) {
+		ghash_partial(ctx, in, len);
+		return;
+	}
+
+	snowv_sw_keystream(&ctx->s, z);
+	for (i = 0; i < len; i++)
+		c[i] = in[i] ^ z[i];
+	if (!ctx->encdec_only) {
+		if (len == 16) ghash_block(ctx, ctx->encdec ? c : in);
+		else ghash_partial(ctx, ctx->encdec ? c : in, len);
+	}
+	memcpy(out, c, len);
+}
+
+// Same for nblocks full blocks. The keystream is applied to all of them
+// at once, so that it comes from snowv_mb_keystream() in chunks and GHASH
+// can aggregate blocks. The input is hashed before it is overwritten, in
+// case in == out. ks is the keystream of the blocks if the caller already
+// has it, or NULL.
+static void process_blocks(snowv_sw_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t nblocks,
+                           const uint8_t *ks)
+{
+	uint8_t z[16*KS_CHUNK], *zp = z;
+	const uint8_t *zk = z;
+	snowv_sw_state_t *s = &ctx->s;
+	size_t i, j, n;
+
+	if (!ctx->encdec_only && (ctx->auth_only || !ctx->encdec)) ghash_blocks(ctx, in, nblocks);
+	if (ctx->auth_only) return;
+	for (i = 0; i < nblocks; i += n) {
+		n = (nblocks - i < KS_CHUNK) ? nblocks - i : KS_CHUNK;
+		if (ks) zk = ks + 16*i;
+		else snowv_mb_keystream(&s, 1, ctx->ni ? SNOWV_MB_AESNI : SNOWV_MB_SCALAR, &zp, n);
+		for (j = 0; j < 16*n; j++)
+			out[16*i + j] = in[16*i + j] ^ zk[j];
+	}
+	if (!ctx->encdec_only && ctx->encdec) ghash_blocks(ctx, out, nblocks);
+}
+
+// Returns the number of bytes written to out; a trailing partial block is
+// held back until snowv_sw_final(). Nothing is written in auth_only mode.
+size_t snowv_sw_update(snowv_sw_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len)
+{
+	size_t done = 0, nblocks;
+	uint32_t n;
+
+	ctx->len_i += len;
+
+	if (ctx->buf_len > 0) {
+		n = 16 - ctx->buf_len;
+		if (n > len) n = len;
+		memcpy(ctx->buf + ctx->buf_len, in, n);
+		ctx->buf_len += n;
+		in += n;
+		len -= n;
+		if (ctx->buf_len < 16) return 0;
+		process_block(ctx, ctx->buf, out, 16);
+		ctx->buf_len = 0;
+		done = ctx->auth_only ? 0 : 16;
+	}
+
+	nblocks = len / 16;
+	process_blocks(ctx, in, out + done, nblocks, NULL);
+	if (!ctx->auth_only) done += 16*nblocks;
+	in += 16*nblocks;
+	len -= 16*nblocks;
+
+	memcpy(ctx->buf, in, len);
+	ctx->buf_len = len;
+	return done;
+}
+
+// snowv_sw_update() of nblocks full blocks whose keystream ks was already
+// generated from ctx->s, e.g. by snowv_mb_keystream() for several messages
+// at once. Only valid while no partial block is buffered.
+size_t snowv_sw_update_ks(snowv_sw_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t nblocks,
+                          const uint8_t *ks)
+{
+	if (ctx->buf_len > 0) return 0;
+	ctx->len_i += 16*nblocks;
+	process_blocks(ctx, in, out, nblocks, ks);
+	return ctx->auth_only ? 0 : 16*nblocks;
+}
+
+// Processes the last partial block (adj_len in snowv_gcm.v) and returns its
+// length. Writes the 16-byte tag unless encdec_only is set.
+size_t snowv_sw_final(snowv_sw_ctx_t *ctx, uint8_t *out, uint8_t *tag)
+{
+	uint8_t len_block[16];
+	uint64_t bits_ad = ctx->len_ad << 3, bits_i = ctx->len_i << 3;
+	size_t n = ctx->buf_len;
+	int i;
+
+	if (n > 0) process_block(ctx, ctx->buf, out, n);
+	ctx->buf_len = 0;
+
+	if (!ctx->encdec_only) {
+		for (i = 0; i < 8; i++) {
+			len_block[i] = bits_ad >> (56 - 8*i);
+			len_block[i + 8] = bits_i >> (56 - 8*i);
+		}
+		ghash_block(ctx, len_block);
+		for (i = 0; i < 8; i++) {
+			tag[i] = (ctx->X[0] >> (56 - 8*i)) ^ ctx->Mtag[i];
+			tag[i + 8] = (ctx->X[1] >> (56 - 8*i)) ^ ctx->Mtag[i + 8];
+		}
+	}
+	return ctx->auth_only ? 0 : n;
+}
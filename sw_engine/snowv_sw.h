@@ -0,0 +1,49 @@
+#ifndef _SNOWV_SW_H_
+#define _SNOWV_SW_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aes_ni.h"
+
+// SNOW-V keystream generator state
+typedef struct {
+	uint16_t A[16];
+	uint16_t B[16];
+	uint32_t R1[4];
+	uint32_t R2[4];
+	uint32_t R3[4];
+} snowv_sw_state_t;
+
+// State of one SNOW-V-GCM message
+typedef struct {
+	snowv_sw_state_t s;
+	int      encdec_only;   // Same meaning as the inputs of snowv_gcm.v
+	int      auth_only;
+	int      encdec;        // 1 : encrypt, 0 : decrypt
+	uint64_t HL[16];        // 4-bit multiplication table of the hash key H
+	uint64_t HH[16];
+	int      ni;            // AES-NI FSM and PCLMULQDQ GHASH, see aes_sw_select()
+	aes_ni_ghash_key_t hk;
+	uint64_t X[2];          // GHASH accumulator as big-endian halves
+	uint8_t  Mtag[16];
+	uint64_t len_ad;        // In bytes
+	uint64_t len_i;
+	uint8_t  buf[16];       // Input that is not processed yet, at most one block
+	uint32_t buf_len;
+} snowv_sw_ctx_t;
+
+void snowv_sw_keyiv_load(snowv_sw_state_t *s, const uint8_t *key, const uint8_t *iv, int aead);
+void snowv_sw_keyiv_setup(snowv_sw_state_t *s, const uint8_t *key, const uint8_t *iv, int aead);
+void snowv_sw_keystream(snowv_sw_state_t *s, uint8_t *z);
+
+int snowv_sw_init(snowv_sw_ctx_t *ctx, const uint8_t *key, const uint8_t *iv,
+                  const uint8_t *ad, size_t ad_len, int encdec_only, int auth_only, int encdec);
+int snowv_sw_init_state(snowv_sw_ctx_t *ctx, const uint8_t *ad, size_t ad_len,
+                        int encdec_only, int auth_only, int encdec);
+size_t snowv_sw_update(snowv_sw_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len);
+size_t snowv_sw_update_ks(snowv_sw_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t nblocks,
+                          const uint8_t *ks);
+size_t snowv_sw_final(snowv_sw_ctx_t *ctx, uint8_t *out, uint8_t *tag);
+
+#endif
@@ -0,0 +1,73 @@
+#include "sw_engine.h"
+
+// Common entry point for the software ciphers. update() returns the number
+// of output bytes written, final() the number of remaining output bytes
+// written and stores the tag, if the mode produces one.
+
+int sw_ctx_init(sw_ctx_t *ctx, const sw_params_t *params)
+{
+	ctx->cipher = params->cipher;
+
+	switch (params->cipher) {
+	case SW_AES_CTR:
+		return aes_sw_init(&ctx->u.aes, 0, params->key, params->keylen, params->iv);
+	case SW_AES_CMAC:
+		return aes_sw_init(&ctx->u.aes, 1, params->key, params->keylen, NULL);
+	case SW_SNOWV_GCM:
+		return snowv_sw_init(&ctx->u.snowv, params->key, params->iv, params->ad, params->ad_len,
+		                     params->encdec_only, params->auth_only, params->encdec);
+	case SW_ZUC256_CTR:
+		return zuc256_sw_init(&ctx->u.zuc, 0, params->key, params->iv, 0);
+	case SW_ZUC256_MAC:
+		return zuc256_sw_init(&ctx->u.zuc, 1, params->key, params->iv, params->tag_len);
+	default:
+		return -1;
+	}
+}
+
+size_t sw_ctx_update(sw_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len)
+{
+	switch (ctx->cipher) {
+	case SW_AES_CTR:
+	case SW_AES_CMAC:
+		return aes_sw_update(&ctx->u.aes, in, out, len);
+	case SW_SNOWV_GCM:
+		return snowv_sw_update(&ctx->u.snowv, in, out, len);
+	case SW_ZUC256_CTR:
+	case SW_ZUC256_MAC:
+		return zuc256_sw_update(&ctx->u.zuc, in, out, len);
+	default:
+		return 0;
+	}
+}
+
+size_t sw_ctx_final(sw_ctx_t *ctx, uint8_t *out, uint8_t *tag)
+{
+	switch (ctx->cipher) {
+	case SW_AES_CTR:
+	case SW_AES_CMAC:
+		return aes_sw_final(&ctx->u.aes, out, tag);
+	case SW_SNOWV_GCM:
+		return snowv_sw_final(&ctx->u.snowv, out, tag);
+	case SW_ZUC256_CTR:
+	case SW_ZUC256_MAC:
+		return zuc256_sw_final(&ctx->u.zuc, out, tag);
+	default:
+		return 0;
+	}
+}
+
+// Size of the tag that sw_ctx_final() writes for these parameters
+uint32_t sw_tag_bytes(const sw_params_t *params)
+{
+	switch (params->cipher) {
+	case SW_AES_CMAC:
+		return 16;
+	case SW_SNOWV_GCM:
+		return params->encdec_only ? 0 : 16;
+	case SW_ZUC256_MAC:
+		return params->tag_len >> 3;
+	default:
+		return 0;
+	}
+}
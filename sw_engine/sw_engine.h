@@ -0,0 +1,47 @@
+#ifndef _SW_ENGINE_H_
+#define _SW_ENGINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aes_sw.h"
+#include "snowv_sw.h"
+#include "zuc256_sw.h"
+
+typedef enum {
+	SW_AES_CTR = 0,
+	SW_AES_CMAC,
+	SW_SNOWV_GCM,
+	SW_ZUC256_CTR,
+	SW_ZUC256_MAC
+} sw_cipher_t;
+
+// Parameters of one message. Fields that the cipher does not use are ignored.
+typedef struct {
+	sw_cipher_t    cipher;
+	const uint8_t *key;          // 32 bytes, 16 bytes for AES with keylen = 0
+	int            keylen;       // AES: 0 -> 128-bit key, 1 -> 256-bit key
+	const uint8_t *iv;           // 16 bytes: AES-CTR counter, SNOW-V or ZUC-256 IV
+	const uint8_t *ad;           // SNOW-V-GCM associated data
+	size_t         ad_len;
+	int            encdec_only;  // SNOW-V-GCM modes, as in snowv_gcm.v
+	int            auth_only;
+	int            encdec;       // SNOW-V-GCM: 1 -> encrypt, 0 -> decrypt
+	uint32_t       tag_len;      // ZUC-256 MAC: 32, 64 or 128 bits
+} sw_params_t;
+
+typedef struct {
+	sw_cipher_t cipher;
+	union {
+		aes_sw_ctx_t    aes;
+		snowv_sw_ctx_t  snowv;
+		zuc256_sw_ctx_t zuc;
+	} u;
+} sw_ctx_t;
+
+int sw_ctx_init(sw_ctx_t *ctx, const sw_params_t *params);
+size_t sw_ctx_update(sw_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len);
+size_t sw_ctx_final(sw_ctx_t *ctx, uint8_t *out, uint8_t *tag);
+uint32_t sw_tag_bytes(const sw_params_t *params);
+
+#endif
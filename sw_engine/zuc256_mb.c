@@ -0,0 +1,280 @@
+#include <string.h>
+
+#include "zuc256_sw.h"
+#include "zuc256_mb.h"
+
+// Multi-lane ZUC-256: the key setup, the 48 initialization rounds and the
+// keystream of up to 16 states run in lockstep, one 32-bit SIMD lane per
+// state. The step follows zuc256_sw.c, with the modular additions of the
+// LFSR done one at a time so that every sum fits in 32 bits. The SIMD
+// versions are compiled for their target only and picked at runtime.
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ZUC256_MB_X86
+#include <immintrin.h>
+#endif
+
+// Scalar fallback, one lane after the other
+
+#define ROT(a, k)  (((a) << (k)) | ((a) >> (32 - (k))))
+
+static uint32_t addm(uint32_t a, uint32_t b)
+{
+	uint32_t c = a + b;
+	return (c & 0x7FFFFFFF) + (c >> 31);
+}
+
+static void mb_block_scalar(zuc256_mb_state_t *st, uint32_t (*z)[ZUC256_MB_LANES], int init)
+{
+	uint32_t X0, X1, X2, X3, W, W1, W2, u, v, f, l;
+	uint32_t S[16];
+	int k, i;
+
+	for (l = 0; l < st->nlanes; l++) {
+		for (i = 0; i < 16; i++)
+			S[i] = st->S[i][l];
+		for (k = 0; k < 16; k++) {
+			X0 = ((S[(k + 15) & 15] & 0x7FFF8000) << 1) | (S[(k + 14) & 15] & 0xFFFF);
+			X1 = (S[(k + 11) & 15] << 16) | (S[(k + 9) & 15] >> 15);
+			X2 = (S[(k + 7) & 15] << 16) | (S[(k + 5) & 15] >> 15);
+			X3 = (S[(k + 2) & 15] << 16) | (S[k] >> 15);
+			W = (X0 ^ st->R1[l]) + st->R2[l];
+			W1 = st->R1[l] + X1;
+			W2 = st->R2[l] ^ X2;
+			u = (W1 << 16) | (W2 >> 16);
+			v = (W2 << 16) | (W1 >> 16);
+			u = u ^ ROT(u, 2) ^ ROT(u, 10) ^ ROT(u, 18) ^ ROT(u, 24);
+			v = v ^ ROT(v, 8) ^ ROT(v, 14) ^ ROT(v, 22) ^ ROT(v, 30);
+			st->R1[l] = zuc256_sw_T0[u >> 24] ^ zuc256_sw_T1[(u >> 16) & 0xFF] ^
+			            zuc256_sw_T2[(u >> 8) & 0xFF] ^ zuc256_sw_T3[u & 0xFF];
+			st->R2[l] = zuc256_sw_T0[v >> 24] ^ zuc256_sw_T1[(v >> 16) & 0xFF] ^
+			            zuc256_sw_T2[(v >> 8) & 0xFF] ^ zuc256_sw_T3[v & 0xFF];
+
+			f = addm(S[k], ((S[k] << 8) | (S[k] >> 23)) & 0x7FFFFFFF);
+			f = addm(f, ((S[(k + 4) & 15] << 20) | (S[(k + 4) & 15] >> 11)) & 0x7FFFFFFF);
+			f = addm(f, ((S[(k + 10) & 15] << 21) | (S[(k + 10) & 15] >> 10)) & 0x7FFFFFFF);
+			f = addm(f, ((S[(k + 13) & 15] << 17) | (S[(k + 13) & 15] >> 14)) & 0x7FFFFFFF);
+			f = addm(f, ((S[(k + 15) & 15] << 15) | (S[(k + 15) & 15] >> 16)) & 0x7FFFFFFF);
+			if (init) f = addm(f, W >> 1);
+			else z[k][l] = W ^ X3;
+			S[k] = f;
+		}
+		for (i = 0; i < 16; i++)
+			st->S[i][l] = S[i];
+	}
+}
+
+#ifdef ZUC256_MB_X86
+
+// One step on a vector of lanes, written against the V_* operations below
+// so that the AVX2 and AVX-512 versions share it. The LFSR cells are the
+// vectors V[0..15], used as a circular buffer as in zuc256_sw.c.
+#define LF(k, i)  V[((k) + (i)) & 15]
+
+#define V_MULPOW2(x, n)  V_AND(V_OR(V_SLL(x, n), V_SRL(x, 31 - (n))), M31)
+#define V_ADDM(a, b)     (t = V_ADD(a, b), V_ADD(V_AND(t, M31), V_SRL(t, 31)))
+#define V_SBOX(x)        V_XOR(V_XOR(V_GATHER(zuc256_sw_T0, V_SRL(x, 24)),                 \
+                                     V_GATHER(zuc256_sw_T1, V_AND(V_SRL(x, 16), MFF))),    \
+                               V_XOR(V_GATHER(zuc256_sw_T2, V_AND(V_SRL(x, 8), MFF)),      \
+                                     V_GATHER(zuc256_sw_T3, V_AND(x, MFF))))
+
+#define MB_STEP(k, zk, init)                                                               \
+	do {                                                                                   \
+		X0 = V_OR(V_SLL(V_AND(LF(k, 15), MHI), 1), V_AND(LF(k, 14), MLO));                 \
+		X1 = V_OR(V_SLL(LF(k, 11), 16), V_SRL(LF(k, 9), 15));                              \
+		X2 = V_OR(V_SLL(LF(k, 7), 16), V_SRL(LF(k, 5), 15));                               \
+		X3 = V_OR(V_SLL(LF(k, 2), 16), V_SRL(LF(k, 0), 15));                               \
+		W = V_ADD(V_XOR(X0, R1), R2);                                                      \
+		W1 = V_ADD(R1, X1);                                                                \
+		W2 = V_XOR(R2, X2);                                                                \
+		u = V_OR(V_SLL(W1, 16), V_SRL(W2, 16));                                            \
+		v = V_OR(V_SLL(W2, 16), V_SRL(W1, 16));                                            \
+		u = V_XOR(V_XOR(V_XOR(u, V_ROL(u, 2)), V_XOR(V_ROL(u, 10), V_ROL(u, 18))),         \
+		          V_ROL(u, 24));                                                           \
+		v = V_XOR(V_XOR(V_XOR(v, V_ROL(v, 8)), V_XOR(V_ROL(v, 14), V_ROL(v, 22))),         \
+		          V_ROL(v, 30));                                                           \
+		R1 = V_SBOX(u);                                                                    \
+		R2 = V_SBOX(v);                                                                    \
+		f = V_ADDM(LF(k, 0), V_MULPOW2(LF(k, 0), 8));                                      \
+		f = V_ADDM(f, V_MULPOW2(LF(k, 4), 20));                                            \
+		f = V_ADDM(f, V_MULPOW2(LF(k, 10), 21));                                           \
+		f = V_ADDM(f, V_MULPOW2(LF(k, 13), 17));                                           \
+		f = V_ADDM(f, V_MULPOW2(LF(k, 15), 15));                                           \
+		if (init) f = V_ADDM(f, V_SRL(W, 1));                                              \
+		else V_STORE(zk, V_XOR(W, X3));                                                    \
+		LF(k, 0) = f;                                                                      \
+	} while (0)
+
+#define MB_BLOCK(z, off, init)                                                             \
+	do {                                                                                   \
+		MB_STEP(0, &z[0][off], init);   MB_STEP(1, &z[1][off], init);                      \
+		MB_STEP(2, &z[2][off], init);   MB_STEP(3, &z[3][off], init);                      \
+		MB_STEP(4, &z[4][off], init);   MB_STEP(5, &z[5][off], init);                      \
+		MB_STEP(6, &z[6][off], init);   MB_STEP(7, &z[7][off], init);                      \
+		MB_STEP(8, &z[8][off], init);   MB_STEP(9, &z[9][off], init);                      \
+		MB_STEP(10, &z[10][off], init); MB_STEP(11, &z[11][off], init);                    \
+		MB_STEP(12, &z[12][off], init); MB_STEP(13, &z[13][off], init);                    \
+		MB_STEP(14, &z[14][off], init); MB_STEP(15, &z[15][off], init);                    \
+	} while (0)
+
+// AVX2: lanes 8*g .. 8*g + 7
+
+#define V_AND(a, b)        _mm256_and_si256(a, b)
+#define V_OR(a, b)         _mm256_or_si256(a, b)
+#define V_XOR(a, b)        _mm256_xor_si256(a, b)
+#define V_ADD(a, b)        _mm256_add_epi32(a, b)
+#define V_SLL(a, n)        _mm256_slli_epi32(a, n)
+#define V_SRL(a, n)        _mm256_srli_epi32(a, n)
+#define V_ROL(a, n)        V_OR(V_SLL(a, n), V_SRL(a, 32 - (n)))
+#define V_GATHER(T, idx)   _mm256_i32gather_epi32((const int *) (T), idx, 4)
+#define V_STORE(p, a)      _mm256_store_si256((__m256i *) (p), a)
+
+__attribute__((target("avx2")))
+static void mb_block_avx2(zuc256_mb_state_t *st, uint32_t (*z)[ZUC256_MB_LANES], int init)
+{
+	const __m256i M31 = _mm256_set1_epi32(0x7FFFFFFF), MHI = _mm256_set1_epi32(0x7FFF8000);
+	const __m256i MLO = _mm256_set1_epi32(0xFFFF), MFF = _mm256_set1_epi32(0xFF);
+	__m256i V[16], R1, R2, X0, X1, X2, X3, W, W1, W2, u, v, f, t;
+	uint32_t g, i;
+
+	for (g = 0; 8*g < st->nlanes; g++) {
+		for (i = 0; i < 16; i++)
+			V[i] = _mm256_load_si256((const __m256i *) &st->S[i][8*g]);
+		R1 = _mm256_load_si256((const __m256i *) &st->R1[8*g]);
+		R2 = _mm256_load_si256((const __m256i *) &st->R2[8*g]);
+
+		if (init) MB_BLOCK(z, 8*g, 1);
+		else MB_BLOCK(z, 8*g, 0);
+
+		for (i = 0; i < 16; i++)
+			_mm256_store_si256((__m256i *) &st->S[i][8*g], V[i]);
+		_mm256_store_si256((__m256i *) &st->R1[8*g], R1);
+		_mm256_store_si256((__m256i *) &st->R2[8*g], R2);
+	}
+}
+
+#undef V_AND
+#undef V_OR
+#undef V_XOR
+#undef V_ADD
+#undef V_SLL
+#undef V_SRL
+#undef V_ROL
+#undef V_GATHER
+#undef V_STORE
+
+// AVX-512: all 16 lanes
+
+#define V_AND(a, b)        _mm512_and_si512(a, b)
+#define V_OR(a, b)         _mm512_or_si512(a, b)
+#define V_XOR(a, b)        _mm512_xor_si512(a, b)
+#define V_ADD(a, b)        _mm512_add_epi32(a, b)
+#define V_SLL(a, n)        _mm512_slli_epi32(a, n)
+#define V_SRL(a, n)        _mm512_srli_epi32(a, n)
+#define V_ROL(a, n)        _mm512_rol_epi32(a, n)
+#define V_GATHER(T, idx)   _mm512_i32gather_epi32(idx, (const void *) (T), 4)
+#define V_STORE(p, a)      _mm512_store_si512((void *) (p), a)
+
+__attribute__((target("avx512f")))
+static void mb_block_avx512(zuc256_mb_state_t *st, uint32_t (*z)[ZUC256_MB_LANES], int init)
+{
+	const __m512i M31 = _mm512_set1_epi32(0x7FFFFFFF), MHI = _mm512_set1_epi32(0x7FFF8000);
+	const __m512i MLO = _mm512_set1_epi32(0xFFFF), MFF = _mm512_set1_epi32(0xFF);
+	__m512i V[16], R1, R2, X0, X1, X2, X3, W, W1, W2, u, v, f, t;
+	uint32_t i;
+
+	for (i = 0; i < 16; i++)
+		V[i] = _mm512_load_si512((const void *) st->S[i]);
+	R1 = _mm512_load_si512((const void *) st->R1);
+	R2 = _mm512_load_si512((const void *) st->R2);
+
+	if (init) MB_BLOCK(z, 0, 1);
+	else MB_BLOCK(z, 0, 0);
+
+	for (i = 0; i < 16; i++)
+		_mm512_store_si512((void *) st->S[i], V[i]);
+	_mm512_store_si512((void *) st->R1, R1);
+	_mm512_store_si512((void *) st->R2, R2);
+}
+
+#endif
+
+zuc256_mb_impl_t zuc256_mb_detect(void)
+{
+#ifdef ZUC256_MB_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) return ZUC256_MB_AVX512;
+	if (__builtin_cpu_supports("avx2")) return ZUC256_MB_AVX2;
+#endif
+	return ZUC256_MB_SCALAR;
+}
+
+static void mb_block(zuc256_mb_state_t *st, uint32_t (*z)[ZUC256_MB_LANES], int init)
+{
+	switch (st->impl) {
+#ifdef ZUC256_MB_X86
+	case ZUC256_MB_AVX512:
+		mb_block_avx512(st, z, init);
+		break;
+	case ZUC256_MB_AVX2:
+		mb_block_avx2(st, z, init);
+		break;
+#endif
+	default:
+		mb_block_scalar(st, z, init);
+		break;
+	}
+}
+
+// Loads key[l] and iv[l] into lane l and runs the 48 initialization rounds
+// of all lanes together. As in zuc256_sw_setup(), the discarded first word
+// is part of the first keystream block. Lanes beyond nlanes are cleared.
+int zuc256_mb_setup(zuc256_mb_state_t *st, zuc256_mb_impl_t impl, uint32_t nlanes,
+                    const uint8_t *const *key, const uint8_t *const *iv, uint32_t tag_len)
+{
+	zuc256_sw_state_t s;
+	uint32_t l, i;
+
+	if ((nlanes == 0) || (nlanes > ZUC256_MB_LANES)) return -1;
+	if (impl == ZUC256_MB_AUTO) impl = zuc256_mb_detect();
+	else if ((impl != ZUC256_MB_SCALAR) && (impl > zuc256_mb_detect())) return -1;
+
+	memset(st->S, 0, sizeof(st->S));
+	memset(st->R1, 0, sizeof(st->R1));
+	memset(st->R2, 0, sizeof(st->R2));
+	st->nlanes = nlanes;
+	st->impl = impl;
+	for (l = 0; l < nlanes; l++) {
+		zuc256_sw_load(&s, key[l], iv[l], tag_len);
+		for (i = 0; i < 16; i++)
+			st->S[i][l] = s.S[i];
+	}
+
+	for (i = 0; i < 3; i++)
+		mb_block(st, NULL, 1);
+
+	mb_block(st, st->ks, 0);
+	st->ks_pos = 1;
+	return 0;
+}
+
+// Writes the next nwords keystream words of lane l to z[l]
+void zuc256_mb_keystream(zuc256_mb_state_t *st, uint32_t *const *z, size_t nwords)
+{
+	uint32_t l;
+	size_t j = 0, n, w;
+
+	while (j < nwords) {
+		if (st->ks_pos == 16) {
+			mb_block(st, st->ks, 0);
+			st->ks_pos = 0;
+		}
+		n = 16 - st->ks_pos;
+		if (n > nwords - j) n = nwords - j;
+		for (l = 0; l < st->nlanes; l++)
+			for (w = 0; w < n; w++)
+				z[l][j + w] = st->ks[st->ks_pos + w][l];
+		st->ks_pos += n;
+		j += n;
+	}
+}
@@ -0,0 +1,35 @@
+#ifndef _ZUC256_MB_H_
+#define _ZUC256_MB_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ZUC256_MB_LANES 16
+
+typedef enum {
+	ZUC256_MB_AUTO = 0,     // best implementation supported by the CPU
+	ZUC256_MB_SCALAR,
+	ZUC256_MB_AVX2,         // two groups of 8 lanes
+	ZUC256_MB_AVX512        // 16 lanes
+} zuc256_mb_impl_t;
+
+// Up to ZUC256_MB_LANES independent ZUC-256 states that are stepped in
+// lockstep. Cell i of the LFSR of lane l is S[i][l], so each cell is one
+// vector over all lanes.
+typedef struct {
+	uint32_t S[16][ZUC256_MB_LANES] __attribute__((aligned(64)));
+	uint32_t R1[ZUC256_MB_LANES] __attribute__((aligned(64)));
+	uint32_t R2[ZUC256_MB_LANES] __attribute__((aligned(64)));
+	uint32_t ks[16][ZUC256_MB_LANES] __attribute__((aligned(64)));  // last keystream block
+	uint32_t ks_pos;                                                 // next word of ks, 16 when empty
+	uint32_t nlanes;
+	zuc256_mb_impl_t impl;
+} zuc256_mb_state_t;
+
+zuc256_mb_impl_t zuc256_mb_detect(void);
+
+int zuc256_mb_setup(zuc256_mb_state_t *st, zuc256_mb_impl_t impl, uint32_t nlanes,
+                    const uint8_t *const *key, const uint8_t *const *iv, uint32_t tag_len);
+void zuc256_mb_keystream(zuc256_mb_state_t *st, uint32_t *const *z, size_t nwords);
+
+#endif
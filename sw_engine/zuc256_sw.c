@@ -0,0 +1,526 @@
+#include <string.h>
+
+#include "aes_sw.h"
+#include "zuc256_sw.h"
+
+// ZUC-256 for the host, with all state in a context so that any number of
+// streams can run side by side. Keystream generation follows
+// zuc-256_keygen_ref.c, the CTR and MAC modes follow zuc256_tot.v.
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ZUC256_SW_X86
+#include <immintrin.h>
+#endif
+
+// Message words per keystream call in the word-wise MAC
+#define MAC_CHUNK_WORDS 64
+
+// S-box tables with the output already in its byte position of R1/R2:
+// T0/T2 hold S0 in bytes 3/1, T1/T3 hold S1 in bytes 2/0.
+const uint32_t zuc256_sw_T0[256] = {
+	0x3e000000, 0x72000000, 0x5b000000, 0x47000000, 0xca000000, 0xe0000000, 0x00000000, 0x33000000,
+	0x04000000, 0xd1000000, 0x54000000, 0x98000000, 0x09000000, 0xb9000000, 0x6d000000, 0xcb000000,
+	0x7b000000, 0x1b000000, 0xf9000000, 0x32000000, 0xaf000000, 0x9d000000, 0x6a000000, 0xa5000000,
+	0xb8000000, 0x2d000000, 0xfc000000, 0x1d000000, 0x08000000, 0x53000000, 0x03000000, 0x90000000,
+	0x4d000000, 0x4e000000, 0x84000000, 0x99000000, 0xe4000000, 0xce000000, 0xd9000000, 0x91000000,
+	0xdd000000, 0xb6000000, 0x85000000, 0x48000000, 0x8b000000, 0x29000000, 0x6e000000, 0xac000000,
+	0xcd000000, 0xc1000000, 0xf8000000, 0x1e000000, 0x73000000, 0x43000000, 0x69000000, 0xc6000000,
+	0xb5000000, 0xbd000000, 0xfd000000, 0x39000000, 0x63000000, 0x20000000, 0xd4000000, 0x38000000,
+	0x76000000, 0x7d000000, 0xb2000000, 0xa7000000, 0xcf000000, 0xed000000, 0x57000000, 0xc5000000,
+	0xf3000000, 0x2c000000, 0xbb000000, 0x14000000, 0x21000000, 0x06000000, 0x55000000, 0x9b000000,
+	0xe3000000, 0xef000000, 0x5e000000, 0x31000000, 0x4f000000, 0x7f000000, 0x5a000000, 0xa4000000,
+	0x0d000000, 0x82000000, 0x51000000, 0x49000000, 0x5f000000, 0xba000000, 0x58000000, 0x1c000000,
+	0x4a000000, 0x16000000, 0xd5000000, 0x17000000, 0xa8000000, 0x92000000, 0x24000000, 0x1f000000,
+	0x8c000000, 0xff000000, 0xd8000000, 0xae000000, 0x2e000000, 0x01000000, 0xd3000000, 0xad000000,
+	0x3b000000, 0x4b000000, 0xda000000, 0x46000000, 0xeb000000, 0xc9000000, 0xde000000, 0x9a000000,
+	0x8f000000, 0x87000000, 0xd7000000, 0x3a000000, 0x80000000, 0x6f000000, 0x2f000000, 0xc8000000,
+	0xb1000000, 0xb4000000, 0x37000000, 0xf7000000, 0x0a000000, 0x22000000, 0x13000000, 0x28000000,
+	0x7c000000, 0xcc000000, 0x3c000000, 0x89000000, 0xc7000000, 0xc3000000, 0x96000000, 0x56000000,
+	0x07000000, 0xbf000000, 0x7e000000, 0xf0000000, 0x0b000000, 0x2b000000, 0x97000000, 0x52000000,
+	0x35000000, 0x41000000, 0x79000000, 0x61000000, 0xa6000000, 0x4c000000, 0x10000000, 0xfe000000,
+	0xbc000000, 0x26000000, 0x95000000, 0x88000000, 0x8a000000, 0xb0000000, 0xa3000000, 0xfb000000,
+	0xc0000000, 0x18000000, 0x94000000, 0xf2000000, 0xe1000000, 0xe5000000, 0xe9000000, 0x5d000000,
+	0xd0000000, 0xdc000000, 0x11000000, 0x66000000, 0x64000000, 0x5c000000, 0xec000000, 0x59000000,
+	0x42000000, 0x75000000, 0x12000000, 0xf5000000, 0x74000000, 0x9c000000, 0xaa000000, 0x23000000,
+	0x0e000000, 0x86000000, 0xab000000, 0xbe000000, 0x2a000000, 0x02000000, 0xe7000000, 0x67000000,
+	0xe6000000, 0x44000000, 0xa2000000, 0x6c000000, 0xc2000000, 0x93000000, 0x9f000000, 0xf1000000,
+	0xf6000000, 0xfa000000, 0x36000000, 0xd2000000, 0x50000000, 0x68000000, 0x9e000000, 0x62000000,
+	0x71000000, 0x15000000, 0x3d000000, 0xd6000000, 0x40000000, 0xc4000000, 0xe2000000, 0x0f000000,
+	0x8e000000, 0x83000000, 0x77000000, 0x6b000000, 0x25000000, 0x05000000, 0x3f000000, 0x0c000000,
+	0x30000000, 0xea000000, 0x70000000, 0xb7000000, 0xa1000000, 0xe8000000, 0xa9000000, 0x65000000,
+	0x8d000000, 0x27000000, 0x1a000000, 0xdb000000, 0x81000000, 0xb3000000, 0xa0000000, 0xf4000000,
+	0x45000000, 0x7a000000, 0x19000000, 0xdf000000, 0xee000000, 0x78000000, 0x34000000, 0x60000000
+};
+
+const uint32_t zuc256_sw_T1[256] = {
+	0x00550000, 0x00c20000, 0x00630000, 0x00710000, 0x003b0000, 0x00c80000, 0x00470000, 0x00860000,
+	0x009f0000, 0x003c0000, 0x00da0000, 0x005b0000, 0x00290000, 0x00aa0000, 0x00fd0000, 0x00770000,
+	0x008c0000, 0x00c50000, 0x00940000, 0x000c0000, 0x00a60000, 0x001a0000, 0x00130000, 0x00000000,
+	0x00e30000, 0x00a80000, 0x00160000, 0x00720000, 0x00400000, 0x00f90000, 0x00f80000, 0x00420000,
+	0x00440000, 0x00260000, 0x00680000, 0x00960000, 0x00810000, 0x00d90000, 0x00450000, 0x003e0000,
+	0x00100000, 0x00760000, 0x00c60000, 0x00a70000, 0x008b0000, 0x00390000, 0x00430000, 0x00e10000,
+	0x003a0000, 0x00b50000, 0x00560000, 0x002a0000, 0x00c00000, 0x006d0000, 0x00b30000, 0x00050000,
+	0x00220000, 0x00660000, 0x00bf0000, 0x00dc0000, 0x000b0000, 0x00fa0000, 0x00620000, 0x00480000,
+	0x00dd0000, 0x00200000, 0x00110000, 0x00060000, 0x00360000, 0x00c90000, 0x00c10000, 0x00cf0000,
+	0x00f60000, 0x00270000, 0x00520000, 0x00bb0000, 0x00690000, 0x00f50000, 0x00d40000, 0x00870000,
+	0x007f0000, 0x00840000, 0x004c0000, 0x00d20000, 0x009c0000, 0x00570000, 0x00a40000, 0x00bc0000,
+	0x004f0000, 0x009a0000, 0x00df0000, 0x00fe0000, 0x00d60000, 0x008d0000, 0x007a0000, 0x00eb0000,
+	0x002b0000, 0x00530000, 0x00d80000, 0x005c0000, 0x00a10000, 0x00140000, 0x00170000, 0x00fb0000,
+	0x00230000, 0x00d50000, 0x007d0000, 0x00300000, 0x00670000, 0x00730000, 0x00080000, 0x00090000,
+	0x00ee0000, 0x00b70000, 0x00700000, 0x003f0000, 0x00610000, 0x00b20000, 0x00190000, 0x008e0000,
+	0x004e0000, 0x00e50000, 0x004b0000, 0x00930000, 0x008f0000, 0x005d0000, 0x00db0000, 0x00a90000,
+	0x00ad0000, 0x00f10000, 0x00ae0000, 0x002e0000, 0x00cb0000, 0x000d0000, 0x00fc0000, 0x00f40000,
+	0x002d0000, 0x00460000, 0x006e0000, 0x001d0000, 0x00970000, 0x00e80000, 0x00d10000, 0x00e90000,
+	0x004d0000, 0x00370000, 0x00a50000, 0x00750000, 0x005e0000, 0x00830000, 0x009e0000, 0x00ab0000,
+	0x00820000, 0x009d0000, 0x00b90000, 0x001c0000, 0x00e00000, 0x00cd0000, 0x00490000, 0x00890000,
+	0x00010000, 0x00b60000, 0x00bd0000, 0x00580000, 0x00240000, 0x00a20000, 0x005f0000, 0x00380000,
+	0x00780000, 0x00990000, 0x00150000, 0x00900000, 0x00500000, 0x00b80000, 0x00950000, 0x00e40000,
+	0x00d00000, 0x00910000, 0x00c70000, 0x00ce0000, 0x00ed0000, 0x000f0000, 0x00b40000, 0x006f0000,
+	0x00a00000, 0x00cc0000, 0x00f00000, 0x00020000, 0x004a0000, 0x00790000, 0x00c30000, 0x00de0000,
+	0x00a30000, 0x00ef0000, 0x00ea0000, 0x00510000, 0x00e60000, 0x006b0000, 0x00180000, 0x00ec0000,
+	0x001b0000, 0x002c0000, 0x00800000, 0x00f70000, 0x00740000, 0x00e70000, 0x00ff0000, 0x00210000,
+	0x005a0000, 0x006a0000, 0x00540000, 0x001e0000, 0x00410000, 0x00310000, 0x00920000, 0x00350000,
+	0x00c40000, 0x00330000, 0x00070000, 0x000a0000, 0x00ba0000, 0x007e0000, 0x000e0000, 0x00340000,
+	0x00880000, 0x00b10000, 0x00980000, 0x007c0000, 0x00f30000, 0x003d0000, 0x00600000, 0x006c0000,
+	0x007b0000, 0x00ca0000, 0x00d30000, 0x001f0000, 0x00320000, 0x00650000, 0x00040000, 0x00280000,
+	0x00640000, 0x00be0000, 0x00850000, 0x009b0000, 0x002f0000, 0x00590000, 0x008a0000, 0x00d70000,
+	0x00b00000, 0x00250000, 0x00ac0000, 0x00af0000, 0x00120000, 0x00030000, 0x00e20000, 0x00f20000
+};
+
+const uint32_t zuc256_sw_T2[256] = {
+	0x00003e00, 0x00007200, 0x00005b00, 0x00004700, 0x0000ca00, 0x0000e000, 0x00000000, 0x00003300,
+	0x00000400, 0x0000d100, 0x00005400, 0x00009800, 0x00000900, 0x0000b900, 0x00006d00, 0x0000cb00,
+	0x00007b00, 0x00001b00, 0x0000f900, 0x00003200, 0x0000af00, 0x00009d00, 0x00006a00, 0x0000a500,
+	0x0000b800, 0x00002d00, 0x0000fc00, 0x00001d00, 0x00000800, 0x00005300, 0x00000300, 0x00009000,
+	0x00004d00, 0x00004e00, 0x00008400, 0x00009900, 0x0000e400, 0x0000ce00, 0x0000d900, 0x00009100,
+	0x0000dd00, 0x0000b600, 0x00008500, 0x00004800, 0x00008b00, 0x00002900, 0x00006e00, 0x0000ac00,
+	0x0000cd00, 0x0000c100, 0x0000f800, 0x00001e00, 0x00007300, 0x00004300, 0x00006900, 0x0000c600,
+	0x0000b500, 0x0000bd00, 0x0000fd00, 0x00003900, 0x00006300, 0x00002000, 0x0000d400, 0x00003800,
+	0x00007600, 0x00007d00, 0x0000b200, 0x0000a700, 0x0000cf00, 0x0000ed00, 0x00005700, 0x0000c500,
+	0x0000f300, 0x00002c00, 0x0000bb00, 0x00001400, 0x00002100, 0x00000600, 0x00005500, 0x00009b00,
+	0x0000e300, 0x0000ef00, 0x00005e00, 0x00003100, 0x00004f00, 0x00007f00, 0x00005a00, 0x0000a400,
+	0x00000d00, 0x00008200, 0x00005100, 0x00004900, 0x00005f00, 0x0000ba00, 0x00005800, 0x00001c00,
+	0x00004a00, 0x00001600, 0x0000d500, 0x00001700, 0x0000a800, 0x00009200, 0x00002400, 0x00001f00,
+	0x00008c00, 0x0000ff00, 0x0000d800, 0x0000ae00, 0x00002e00, 0x00000100, 0x0000d300, 0x0000ad00,
+	0x00003b00, 0x00004b00, 0x0000da00, 0x00004600, 0x0000eb00, 0x0000c900, 0x0000de00, 0x00009a00,
+	0x00008f00, 0x00008700, 0x0000d700, 0x00003a00, 0x00008000, 0x00006f00, 0x00002f00, 0x0000c800,
+	0x0000b100, 0x0000b400, 0x00003700, 0x0000f700, 0x00000a00, 0x00002200, 0x00001300, 0x00002800,
+	0x00007c00, 0x0000cc00, 0x00003c00, 0x00008900, 0x0000c700, 0x0000c300, 0x00009600, 0x00005600,
+	0x00000700, 0x0000bf00, 0x00007e00, 0x0000f000, 0x00000b00, 0x00002b00, 0x00009700, 0x00005200,
+	0x00003500, 0x00004100, 0x00007900, 0x00006100, 0x0000a600, 0x00004c00, 0x00001000, 0x0000fe00,
+	0x0000bc00, 0x00002600, 0x00009500, 0x00008800, 0x00008a00, 0x0000b000, 0x0000a300, 0x0000fb00,
+	0x0000c000, 0x00001800, 0x00009400, 0x0000f200, 0x0000e100, 0x0000e500, 0x0000e900, 0x00005d00,
+	0x0000d000, 0x0000dc00, 0x00001100, 0x00006600, 0x00006400, 0x00005c00, 0x0000ec00, 0x00005900,
+	0x00004200, 0x00007500, 0x00001200, 0x0000f500, 0x00007400, 0x00009c00, 0x0000aa00, 0x00002300,
+	0x00000e00, 0x00008600, 0x0000ab00, 0x0000be00, 0x00002a00, 0x00000200, 0x0000e700, 0x00006700,
+	0x0000e600, 0x00004400, 0x0000a200, 0x00006c00, 0x0000c200, 0x00009300, 0x00009f00, 0x0000f100,
+	0x0000f600, 0x0000fa00, 0x00003600, 0x0000d200, 0x00005000, 0x00006800, 0x00009e00, 0x00006200,
+	0x00007100, 0x00001500, 0x00003d00, 0x0000d600, 0x00004000, 0x0000c400, 0x0000e200, 0x00000f00,
+	0x00008e00, 0x00008300, 0x00007700, 0x00006b00, 0x00002500, 0x00000500, 0x00003f00, 0x00000c00,
+	0x00003000, 0x0000ea00, 0x00007000, 0x0000b700, 0x0000a100, 0x0000e800, 0x0000a900, 0x00006500,
+	0x00008d00, 0x00002700, 0x00001a00, 0x0000db00, 0x00008100, 0x0000b300, 0x0000a000, 0x0000f400,
+	0x00004500, 0x00007a00, 0x00001900, 0x0000df00, 0x0000ee00, 0x00007800, 0x00003400, 0x00006000
+};
+
+const uint32_t zuc256_sw_T3[256] = {
+	0x00000055, 0x000000c2, 0x00000063, 0x00000071, 0x0000003b, 0x000000c8, 0x00000047, 0x00000086,
+	0x0000009f, 0x0000003c, 0x000000da, 0x0000005b, 0x00000029, 0x000000aa, 0x000000fd, 0x00000077,
+	0x0000008c, 0x000000c5, 0x00000094, 0x0000000c, 0x000000a6, 0x0000001a, 0x00000013, 0x00000000,
+	0x000000e3, 0x000000a8, 0x00000016, 0x00000072, 0x00000040, 0x000000f9, 0x000000f8, 0x00000042,
+	0x00000044, 0x00000026, 0x00000068, 0x00000096, 0x00000081, 0x000000d9, 0x00000045, 0x0000003e,
+	0x00000010, 0x00000076, 0x000000c6, 0x000000a7, 0x0000008b, 0x00000039, 0x00000043, 0x000000e1,
+	0x0000003a, 0x000000b5, 0x00000056, 0x0000002a, 0x000000c0, 0x0000006d, 0x000000b3, 0x00000005,
+	0x00000022, 0x00000066, 0x000000bf, 0x000000dc, 0x0000000b, 0x000000fa, 0x00000062, 0x00000048,
+	0x000000dd, 0x00000020, 0x00000011, 0x00000006, 0x00000036, 0x000000c9, 0x000000c1, 0x000000cf,
+	0x000000f6, 0x00000027, 0x00000052, 0x000000bb, 0x00000069, 0x000000f5, 0x000000d4, 0x00000087,
+	0x0000007f, 0x00000084, 0x0000004c, 0x000000d2, 0x0000009c, 0x00000057, 0x000000a4, 0x000000bc,
+	0x0000004f, 0x0000009a, 0x000000df, 0x000000fe, 0x000000d6, 0x0000008d, 0x0000007a, 0x000000eb,
+	0x0000002b, 0x00000053, 0x000000d8, 0x0000005c, 0x000000a1, 0x00000014, 0x00000017, 0x000000fb,
+	0x00000023, 0x000000d5, 0x0000007d, 0x00000030, 0x00000067, 0x00000073, 0x00000008, 0x00000009,
+	0x000000ee, 0x000000b7, 0x00000070, 0x0000003f, 0x00000061, 0x000000b2, 0x00000019, 0x0000008e,
+	0x0000004e, 0x000000e5, 0x0000004b, 0x00000093, 0x0000008f, 0x0000005d, 0x000000db, 0x000000a9,
+	0x000000ad, 0x000000f1, 0x000000ae, 0x0000002e, 0x000000cb, 0x0000000d, 0x000000fc, 0x000000f4,
+	0x0000002d, 0x00000046, 0x0000006e, 0x0000001d, 0x00000097, 0x000000e8, 0x000000d1, 0x000000e9,
+	0x0000004d, 0x00000037, 0x000000a5, 0x00000075, 0x0000005e, 0x00000083, 0x0000009e, 0x000000ab,
+	0x00000082, 0x0000009d, 0x000000b9, 0x0000001c, 0x000000e0, 0x000000cd, 0x00000049, 0x00000089,
+	0x00000001, 0x000000b6, 0x000000bd, 0x00000058, 0x00000024, 0x000000a2, 0x0000005f, 0x00000038,
+	0x00000078, 0x00000099, 0x00000015, 0x00000090, 0x00000050, 0x000000b8, 0x00000095, 0x000000e4,
+	0x000000d0, 0x00000091, 0x000000c7, 0x000000ce, 0x000000ed, 0x0000000f, 0x000000b4, 0x0000006f,
+	0x000000a0, 0x000000cc, 0x000000f0, 0x00000002, 0x0000004a, 0x00000079, 0x000000c3, 0x000000de,
+	0x000000a3, 0x000000ef, 0x000000ea, 0x00000051, 0x000000e6, 0x0000006b, 0x00000018, 0x000000ec,
+	0x0000001b, 0x0000002c, 0x00000080, 0x000000f7, 0x00000074, 0x000000e7, 0x000000ff, 0x00000021,
+	0x0000005a, 0x0000006a, 0x00000054, 0x0000001e, 0x00000041, 0x00000031, 0x00000092, 0x00000035,
+	0x000000c4, 0x00000033, 0x00000007, 0x0000000a, 0x000000ba, 0x0000007e, 0x0000000e, 0x00000034,
+	0x00000088, 0x000000b1, 0x00000098, 0x0000007c, 0x000000f3, 0x0000003d, 0x00000060, 0x0000006c,
+	0x0000007b, 0x000000ca, 0x000000d3, 0x0000001f, 0x00000032, 0x00000065, 0x00000004, 0x00000028,
+	0x00000064, 0x000000be, 0x00000085, 0x0000009b, 0x0000002f, 0x00000059, 0x0000008a, 0x000000d7,
+	0x000000b0, 0x00000025, 0x000000ac, 0x000000af, 0x00000012, 0x00000003, 0x000000e2, 0x000000f2
+};
+
+// The constants D, as in zuc256_core.v. d[0] and d[2] depend on the tag length.
+static const uint8_t EK_d[16] = {
+	0x64, 0x43, 0x7B, 0x2A, 0x11, 0x05, 0x51, 0x42,
+	0x1A, 0x31, 0x18, 0x66, 0x14, 0x2E, 0x01, 0x5C
+};
+
+#define ROT(a, k)            (((a) << (k)) | ((a) >> (32 - (k))))
+#define MulByPow2(x, k)      ((((x) << (k)) | ((x) >> (31 - (k)))) & 0x7FFFFFFF)
+#define MAKEU31(a, b, c, d)  (((uint32_t) (a) << 23) | ((uint32_t) (b) << 16) | ((uint32_t) (c) << 8) | (uint32_t) (d))
+
+#define L1(X)  ((X) ^ ROT(X, 2) ^ ROT(X, 10) ^ ROT(X, 18) ^ ROT(X, 24))
+#define L2(X)  ((X) ^ ROT(X, 8) ^ ROT(X, 14) ^ ROT(X, 22) ^ ROT(X, 30))
+
+#define SBOX32(x)  (zuc256_sw_T0[(x) >> 24] ^ zuc256_sw_T1[((x) >> 16) & 0xFF] ^ \
+                    zuc256_sw_T2[((x) >> 8) & 0xFF] ^ zuc256_sw_T3[(x) & 0xFF])
+
+// Sum of the feedback terms mod (2^31 - 1). The sum of up to six 31-bit
+// values fits in 34 bits, so two folds give the same result as the chain
+// of AddM() calls in the reference code.
+static inline uint32_t lfsr_feedback(uint32_t s0, uint32_t s4, uint32_t s10, uint32_t s13,
+                                     uint32_t s15, uint32_t u)
+{
+	uint64_t f = (uint64_t) s0 + MulByPow2(s0, 8) + MulByPow2(s4, 20) + MulByPow2(s10, 21) +
+	             MulByPow2(s13, 17) + MulByPow2(s15, 15) + u;
+
+	f = (f & 0x7FFFFFFF) + (f >> 31);
+	return (uint32_t) ((f & 0x7FFFFFFF) + (f >> 31));
+}
+
+// The LFSR is a circular buffer: at step k of a block, cell S_i is
+// S[(k + i) % 16] and the new S_15 overwrites the old S_0. After 16 steps
+// the cells are back in place, so blocks of 16 steps are unrolled with
+// constant indices and nothing is shifted.
+#define LFSR(k, i)  S[((k) + (i)) & 15]
+
+// One step of bit reorganization, F and the LFSR. In initialization mode
+// (init = 1) z receives W >> 1, which is also fed back into the LFSR,
+// otherwise z receives the keystream word W ^ X3.
+#define ZUC_STEP(k, z, init)                                                             \
+	do {                                                                                 \
+		uint32_t X0, X1, X2, X3, W, W1, W2, u, v;                                        \
+		X0 = ((LFSR(k, 15) & 0x7FFF8000) << 1) | (LFSR(k, 14) & 0xFFFF);                 \
+		X1 = ((LFSR(k, 11) & 0xFFFF) << 16) | (LFSR(k, 9) >> 15);                        \
+		X2 = ((LFSR(k, 7) & 0xFFFF) << 16) | (LFSR(k, 5) >> 15);                         \
+		X3 = ((LFSR(k, 2) & 0xFFFF) << 16) | (LFSR(k, 0) >> 15);                         \
+		W = (X0 ^ R1) + R2;                                                              \
+		W1 = R1 + X1;                                                                    \
+		W2 = R2 ^ X2;                                                                    \
+		u = (W1 << 16) | (W2 >> 16);                                                     \
+		v = (W2 << 16) | (W1 >> 16);                                                     \
+		u = L1(u);                                                                       \
+		v = L2(v);                                                                       \
+		R1 = SBOX32(u);                                                                  \
+		R2 = SBOX32(v);                                                                  \
+		(z) = (init) ? (W >> 1) : (W ^ X3);                                              \
+		LFSR(k, 0) = lfsr_feedback(LFSR(k, 0), LFSR(k, 4), LFSR(k, 10), LFSR(k, 13),     \
+		                           LFSR(k, 15), (init) ? (z) : 0);                       \
+	} while (0)
+
+#define ZUC_BLOCK(z, init)                                                               \
+	do {                                                                                 \
+		ZUC_STEP(0, z[0], init);   ZUC_STEP(1, z[1], init);                              \
+		ZUC_STEP(2, z[2], init);   ZUC_STEP(3, z[3], init);                              \
+		ZUC_STEP(4, z[4], init);   ZUC_STEP(5, z[5], init);                              \
+		ZUC_STEP(6, z[6], init);   ZUC_STEP(7, z[7], init);                              \
+		ZUC_STEP(8, z[8], init);   ZUC_STEP(9, z[9], init);                              \
+		ZUC_STEP(10, z[10], init); ZUC_STEP(11, z[11], init);                            \
+		ZUC_STEP(12, z[12], init); ZUC_STEP(13, z[13], init);                            \
+		ZUC_STEP(14, z[14], init); ZUC_STEP(15, z[15], init);                            \
+	} while (0)
+
+// 16 keystream words
+static void zuc_block(zuc256_sw_state_t *s, uint32_t *z)
+{
+	uint32_t *S = s->S, R1 = s->R1, R2 = s->R2;
+
+	ZUC_BLOCK(z, 0);
+	s->R1 = R1;
+	s->R2 = R2;
+}
+
+// 16 initialization rounds
+static void zuc_init_block(zuc256_sw_state_t *s)
+{
+	uint32_t *S = s->S, R1 = s->R1, R2 = s->R2, w[16];
+
+	ZUC_BLOCK(w, 1);
+	s->R1 = R1;
+	s->R2 = R2;
+}
+
+// Load key and IV into the LFSR and clear R1/R2. tag_len is 0 for
+// keystream generation (CTR mode).
+void zuc256_sw_load(zuc256_sw_state_t *s, const uint8_t *key, const uint8_t *iv, uint32_t tag_len)
+{
+	uint8_t d[16];
+	int i;
+
+	memcpy(d, EK_d, 16);
+	if ((tag_len == 64) || (tag_len == 128)) d[0] = 0x65;
+	if ((tag_len == 32) || (tag_len == 128)) d[2] = 0x7A;
+
+	for (i = 0; i < 7; i++)
+		s->S[i] = MAKEU31(key[i], d[i], key[16 + i], key[24 + i]);
+	for (i = 7; i < 15; i++)
+		s->S[i] = MAKEU31(key[i], d[i], iv[i - 7], iv[i + 1]);
+	s->S[15] = MAKEU31(key[15], d[15], key[23], key[31]);
+	s->R1 = 0;
+	s->R2 = 0;
+}
+
+// Load key and IV and run the 48 initialization rounds. The first output
+// word is discarded: it is generated as part of the first keystream block,
+// which is kept in the state.
+void zuc256_sw_setup(zuc256_sw_state_t *s, const uint8_t *key, const uint8_t *iv, uint32_t tag_len)
+{
+	int i;
+
+	zuc256_sw_load(s, key, iv, tag_len);
+	for (i = 0; i < 3; i++)
+		zuc_init_block(s);
+
+	zuc_block(s, s->ks);
+	s->ks_pos = 1;
+}
+
+// Writes the next nwords keystream words to z. Whole blocks go straight to
+// z, a trailing partial block is kept in the state for the next call.
+void zuc256_sw_keystream(zuc256_sw_state_t *s, uint32_t *z, size_t nwords)
+{
+	size_t n;
+
+	n = 16 - s->ks_pos;
+	if (n > nwords) n = nwords;
+	memcpy(z, s->ks + s->ks_pos, 4*n);
+	s->ks_pos += n;
+	z += n;
+	nwords -= n;
+
+	for (; nwords >= 16; nwords -= 16, z += 16)
+		zuc_block(s, z);
+
+	if (nwords > 0) {
+		zuc_block(s, s->ks);
+		memcpy(z, s->ks, 4*nwords);
+		s->ks_pos = nwords;
+	}
+}
+
+int zuc256_sw_init(zuc256_sw_ctx_t *ctx, int mac, const uint8_t *key, const uint8_t *iv, uint32_t tag_len)
+{
+	uint32_t nw = tag_len >> 5;
+
+	if ((key == NULL) || (iv == NULL)) return -1;
+	if (mac && (tag_len != 32) && (tag_len != 64) && (tag_len != 128)) return -1;
+
+	ctx->mac = mac;
+	ctx->tag_len = mac ? tag_len : 0;
+	ctx->ks_len = 0;
+	ctx->clmul = mac && (aes_sw_impl() == AES_SW_NI);
+	zuc256_sw_setup(&ctx->s, key, iv, ctx->tag_len);
+
+	if (mac) {
+		// The tag starts as the first tag_len keystream bits, the window
+		// for message bit i starts at keystream bit tag_len + i
+		zuc256_sw_keystream(&ctx->s, ctx->tag, nw);
+		zuc256_sw_keystream(&ctx->s, ctx->win, nw + 1);
+		ctx->win_off = 0;
+	}
+	return 0;
+}
+
+// tag ^= keystream bits [tag_len + i, 2*tag_len + i)
+static void mac_add_window(zuc256_sw_ctx_t *ctx)
+{
+	uint32_t off = ctx->win_off, nw = ctx->tag_len >> 5, j;
+
+	for (j = 0; j < nw; j++)
+		ctx->tag[j] ^= off ? ((ctx->win[j] << off) | (ctx->win[j + 1] >> (32 - off))) : ctx->win[j];
+}
+
+static void mac_next_bit(zuc256_sw_ctx_t *ctx)
+{
+	uint32_t nw = ctx->tag_len >> 5, j;
+
+	if (++ctx->win_off < 32) return;
+
+	for (j = 0; j < nw; j++)
+		ctx->win[j] = ctx->win[j + 1];
+	zuc256_sw_keystream(&ctx->s, &ctx->win[nw], 1);
+	ctx->win_off = 0;
+}
+
+static void mac_byte(zuc256_sw_ctx_t *ctx, uint8_t m)
+{
+	int b;
+
+	for (b = 7; b >= 0; b--) {
+		if ((m >> b) & 1) mac_add_window(ctx);
+		mac_next_bit(ctx);
+	}
+}
+
+static uint32_t load32_be(const uint8_t *p)
+{
+	return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | p[3];
+}
+
+// The windows of the 32 bits of message word i, with k[i] the keystream
+// word at the window of its first bit, add up to
+//
+//   tag[w] ^= sum over set bits j (MSB first) of (k[i+w]:k[i+w+1]) << j >> 32
+//
+// which is bits 32..63 of the carry-less product of the bit-reversed
+// message word with the 64-bit k[i+w]:k[i+w+1]. All of it is linear, so
+// the products are summed in 64 bits and shifted down once at the end.
+//
+// Without PCLMULQDQ the product is done a nibble at a time with a table
+// of the 16 multiples of k[q]:k[q+1], in bit-reversed nibble order. That
+// pair is used by message word q - w for every tag word w, so the table is
+// built once per q.
+static void mac_words_portable(uint32_t *tag, uint32_t nw, const uint32_t *k, const uint8_t *in, size_t n)
+{
+	uint64_t U[16], acc[4] = { 0, 0, 0, 0 }, kk;
+	uint32_t m, v, w;
+	size_t q;
+	int g;
+
+	U[0] = 0;
+	for (q = 0; q < n + nw - 1; q++) {
+		kk = ((uint64_t) k[q] << 32) | k[q + 1];
+		U[8] = kk;
+		U[4] = kk << 1;
+		U[2] = kk << 2;
+		U[1] = kk << 3;
+		for (v = 3; v < 16; v++)
+			if (v & (v - 1)) U[v] = U[v & (v - 1)] ^ U[v & (0 - v)];
+
+		for (w = 0; w < nw; w++) {
+			if ((q < w) || (q - w >= n)) continue;
+			m = load32_be(in + 4*(q - w));
+			for (g = 0; g < 8; g++)
+				acc[w] ^= U[(m >> 4*g) & 15] << (28 - 4*g);
+		}
+	}
+	for (w = 0; w < nw; w++)
+		tag[w] ^= (uint32_t) (acc[w] >> 32);
+}
+
+#ifdef ZUC256_SW_X86
+
+static uint32_t rev32(uint32_t x)
+{
+	x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+	x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+	x = ((x >> 4) & 0x0f0f0f0f) | ((x & 0x0f0f0f0f) << 4);
+	return __builtin_bswap32(x);
+}
+
+__attribute__((target("pclmul,sse2")))
+static void mac_words_clmul(uint32_t *tag, uint32_t nw, const uint32_t *k, const uint8_t *in, size_t n)
+{
+	__m128i acc[4], m;
+	uint32_t w;
+	size_t i;
+
+	for (w = 0; w < nw; w++)
+		acc[w] = _mm_setzero_si128();
+	for (i = 0; i < n; i++) {
+		m = _mm_cvtsi32_si128((int) rev32(load32_be(in + 4*i)));
+		for (w = 0; w < nw; w++)
+			acc[w] = _mm_xor_si128(acc[w], _mm_clmulepi64_si128(m,
+			             _mm_set_epi32(0, 0, (int) k[i + w], (int) k[i + w + 1]), 0x00));
+	}
+	for (w = 0; w < nw; w++)
+		tag[w] ^= (uint32_t) _mm_cvtsi128_si32(_mm_srli_si128(acc[w], 4));
+}
+
+#endif
+
+// MAC over nwords whole message words, starting at a word boundary of the
+// message (win_off == 0)
+static void mac_words(zuc256_sw_ctx_t *ctx, const uint8_t *in, size_t nwords)
+{
+	uint32_t k[MAC_CHUNK_WORDS + 5];
+	uint32_t nw = ctx->tag_len >> 5;
+	size_t n;
+
+	while (nwords > 0) {
+		n = (nwords < MAC_CHUNK_WORDS) ? nwords : MAC_CHUNK_WORDS;
+		memcpy(k, ctx->win, 4*(nw + 1));
+		zuc256_sw_keystream(&ctx->s, k + nw + 1, n);
+#ifdef ZUC256_SW_X86
+		if (ctx->clmul) mac_words_clmul(ctx->tag, nw, k, in, n);
+		else
+#endif
+			mac_words_portable(ctx->tag, nw, k, in, n);
+		memcpy(ctx->win, k + n, 4*(nw + 1));
+		in += 4*n;
+		nwords -= n;
+	}
+}
+
+// CTR: encrypts len bytes, most significant byte of each keystream word
+// first, and returns len. MAC: absorbs the message bits, MSB first, bit by
+// bit up to the next word boundary of the message and a word at a time
+// from there.
+size_t zuc256_sw_update(zuc256_sw_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len)
+{
+	uint32_t z[64];
+	size_t i = 0, j, n;
+
+	if (ctx->mac) {
+		for (; (i < len) && (ctx->win_off != 0); i++)
+			mac_byte(ctx, in[i]);
+		n = (len - i) >> 2;
+		mac_words(ctx, in + i, n);
+		for (i += 4*n; i < len; i++)
+			mac_byte(ctx, in[i]);
+		return 0;
+	}
+
+	for (; (ctx->ks_len > 0) && (i < len); i++, ctx->ks_len--)
+		out[i] = in[i] ^ ctx->ks[4 - ctx->ks_len];
+
+	while (i + 4 <= len) {
+		n = (len - i) >> 2;
+		if (n > 64) n = 64;
+		zuc256_sw_keystream(&ctx->s, z, n);
+		for (j = 0; j < n; j++, i += 4) {
+			out[i]     = in[i]     ^ (z[j] >> 24);
+			out[i + 1] = in[i + 1] ^ (z[j] >> 16);
+			out[i + 2] = in[i + 2] ^ (z[j] >> 8);
+			out[i + 3] = in[i + 3] ^ z[j];
+		}
+	}
+
+	if (i < len) {
+		zuc256_sw_keystream(&ctx->s, z, 1);
+		ctx->ks[0] = z[0] >> 24;
+		ctx->ks[1] = z[0] >> 16;
+		ctx->ks[2] = z[0] >> 8;
+		ctx->ks[3] = z[0];
+		for (ctx->ks_len = 4; i < len; i++, ctx->ks_len--)
+			out[i] = in[i] ^ ctx->ks[4 - ctx->ks_len];
+	}
+	return len;
+}
+
+// MAC: writes the tag_len/8 byte tag, most significant byte first.
+// Nothing is held back in CTR mode, so 0 is returned.
+size_t zuc256_sw_final(zuc256_sw_ctx_t *ctx, uint8_t *out, uint8_t *tag)
+{
+	uint32_t nw = ctx->tag_len >> 5, j;
+
+	(void) out;
+	if (!ctx->mac) return 0;
+
+	mac_add_window(ctx);
+	for (j = 0; j < nw; j++) {
+		tag[4*j]     = ctx->tag[j] >> 24;
+		tag[4*j + 1] = ctx->tag[j] >> 16;
+		tag[4*j + 2] = ctx->tag[j] >> 8;
+		tag[4*j + 3] = ctx->tag[j];
+	}
+	return 0;
+}
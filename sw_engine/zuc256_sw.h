@@ -0,0 +1,41 @@
+#ifndef _ZUC256_SW_H_
+#define _ZUC256_SW_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ZUC-256 keystream generator state. The LFSR is kept as a circular buffer
+// that is aligned again after every block of 16 words.
+typedef struct {
+	uint32_t S[16];
+	uint32_t R1;
+	uint32_t R2;
+	uint32_t ks[16];        // last generated keystream block
+	uint32_t ks_pos;        // next word of ks to hand out, 16 when empty
+} zuc256_sw_state_t;
+
+// State of one ZUC-256 CTR or MAC message
+typedef struct {
+	zuc256_sw_state_t s;
+	int      mac;           // 0 : CTR, 1 : MAC (same as enc_auth in zuc256_tot.v)
+	uint32_t tag_len;       // MAC: 32, 64 or 128 bits
+	uint8_t  ks[4];         // CTR: keystream bytes left over from the last word
+	uint32_t ks_len;
+	uint32_t tag[4];        // MAC: tag and the keystream window at the next message bit
+	uint32_t win[5];
+	uint32_t win_off;
+	int      clmul;         // MAC with PCLMULQDQ, see aes_sw_select()
+} zuc256_sw_ctx_t;
+
+// S-boxes with the output in its byte position of R1/R2 (S0, S1, S0, S1)
+extern const uint32_t zuc256_sw_T0[256], zuc256_sw_T1[256], zuc256_sw_T2[256], zuc256_sw_T3[256];
+
+void zuc256_sw_load(zuc256_sw_state_t *s, const uint8_t *key, const uint8_t *iv, uint32_t tag_len);
+void zuc256_sw_setup(zuc256_sw_state_t *s, const uint8_t *key, const uint8_t *iv, uint32_t tag_len);
+void zuc256_sw_keystream(zuc256_sw_state_t *s, uint32_t *z, size_t nwords);
+
+int zuc256_sw_init(zuc256_sw_ctx_t *ctx, int mac, const uint8_t *key, const uint8_t *iv, uint32_t tag_len);
+size_t zuc256_sw_update(zuc256_sw_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len);
+size_t zuc256_sw_final(zuc256_sw_ctx_t *ctx, uint8_t *out, uint8_t *tag);
+
+#endif
@@ -30,6 +30,10 @@ module zuc256_core(
            input wire [127 : 0]  iv,
            input wire [7 : 0]    tag_len,
            
+           input wire            ctx_load,  // Load the state from ctx_i, only when idle
+           input wire [591 : 0]  ctx_i,
+           output wire [591 : 0] ctx_o,     // {z, R2, R1, s15, ..., s0}
+           
            output wire [31 : 0] keystream_z,
            output wire          ready
           );
@@ -148,6 +152,11 @@ module zuc256_core(
   //----------------------------------------------------------------
   assign ready                        = ready_reg; 
   assign keystream_z                  = z_reg;
+  assign ctx_o                        = {z_reg, R2_reg, R1_reg,
+                                         lfsr_reg[15], lfsr_reg[14], lfsr_reg[13], lfsr_reg[12],
+                                         lfsr_reg[11], lfsr_reg[10], lfsr_reg[9],  lfsr_reg[8],
+                                         lfsr_reg[7],  lfsr_reg[6],  lfsr_reg[5],  lfsr_reg[4],
+                                         lfsr_reg[3],  lfsr_reg[2],  lfsr_reg[1],  lfsr_reg[0]};
   
   assign zuc256_modadd_s15            = lfsr_reg [15]; 
   assign zuc256_modadd_s13            = lfsr_reg [13]; 
@@ -317,6 +326,13 @@ module zuc256_core(
           lfsr_new [14] = {key[119 : 112], d [14], iv[63 : 56], iv[127 : 120]};
           lfsr_new [15] = {key[127 : 120], d [15], key[191 : 184], key[255 : 248]};
         end
+      else if ((zuc256_ctrl_reg == CTRL_IDLE) && ctx_load)
+        begin
+          for (i = 0 ; i < 16 ; i = i + 1)
+            begin
+              lfsr_new [i] = ctx_i[31 * i +: 31];
+            end
+        end
       else
         begin
           for (i = 0 ; i < 15 ; i = i + 1)
@@ -380,6 +396,11 @@ module zuc256_core(
           R1_new  = 64'h0;
           R2_new  = 64'h0;
         end
+     else if ((zuc256_ctrl_reg == CTRL_IDLE) && ctx_load)
+       begin
+          R1_new = ctx_i[527 : 496];
+          R2_new = ctx_i[559 : 528];
+       end
      else
        begin
           R1_new = zuc256_sboxw_o;
@@ -389,6 +410,8 @@ module zuc256_core(
       // -- FSM output logic
       W_new = (X0 ^ R1_reg) + R2_reg;
       z_new = W_reg ^ X3;
+      if ((zuc256_ctrl_reg == CTRL_IDLE) && ctx_load)
+        z_new = ctx_i[591 : 560];
       
     end // fsm_logic
   
@@ -449,6 +472,13 @@ module zuc256_core(
                 came_from_init_new  = 1'b1;
                 came_from_init_we   = 1'b1;
               end
+            else if (ctx_load)
+              begin
+                lfsr_we             = 1'b1;
+                R1_we               = 1'b1;
+                R2_we               = 1'b1;
+                z_we                = 1'b1;
+              end
             else if (next)
               begin
                 zuc256_ctrl_new     = CTRL_NEXT;
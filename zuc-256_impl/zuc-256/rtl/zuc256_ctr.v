@@ -20,7 +20,7 @@
 
 `default_nettype none
 
-module zuc256_ctr(
+module zuc256_ctr #(parameter FAST_CORE = 0)(
            input wire            clk,
            input wire            reset_n,
            
@@ -67,19 +67,49 @@ module zuc256_ctr(
   //----------------------------------------------------------------
   // Instantiations.
   //----------------------------------------------------------------
-  zuc256_core core(
-                   .clk(clk),
-                   .reset_n(reset_n),
-      
-                   .init(core_init),
-                   .next(core_next),
-                   .key(core_key),
-                   .iv(core_iv),
-                   .tag_len(core_tag_len),
-                     
-                   .keystream_z(core_z),
-                   .ready(core_ready)
-                  );
+  // FAST_CORE: 0 = zuc256_core, 1 = single-cycle zuc256_core_fast
+  generate
+    if (FAST_CORE)
+      begin : core_gen
+        zuc256_core_fast core(
+                              .clk(clk),
+                              .reset_n(reset_n),
+
+                              .init(core_init),
+                              .next(core_next),
+                              .key(core_key),
+                              .iv(core_iv),
+                              .tag_len(core_tag_len),
+
+                              .ctx_load(1'b0),
+                              .ctx_i(592'h0),
+                              .ctx_o(),
+
+                              .keystream_z(core_z),
+                              .ready(core_ready)
+                              );
+      end
+    else
+      begin : core_gen
+        zuc256_core core(
+                         .clk(clk),
+                         .reset_n(reset_n),
+
+                         .init(core_init),
+                         .next(core_next),
+                         .key(core_key),
+                         .iv(core_iv),
+                         .tag_len(core_tag_len),
+
+                         .ctx_load(1'b0),
+                         .ctx_i(592'h0),
+                         .ctx_o(),
+
+                         .keystream_z(core_z),
+                         .ready(core_ready)
+                         );
+      end
+  endgenerate
  
     //----------------------------------------------------------------
     // Concurrent connectivity for ports etc.
@@ -27,6 +27,9 @@ module zuc256_ctr_ext(
            input wire            init,
            input wire            next,
            input wire [31 : 0]   word_i,
+           input wire            burst,     // process num_words words of words_i
+           input wire [4 : 0]    num_words, // up to 24
+           input wire [767 : 0]  words_i,
            
            input wire [31 : 0]   core_z,
            input wire            core_ready,
@@ -35,30 +38,53 @@ module zuc256_ctr_ext(
            output reg            core_next,
            
            output wire [31 : 0]  word_o,
+           output wire [767 : 0] words_o,
            output wire           ready
           );
   
   //----------------------------------------------------------------
   // Internal constant and parameter definitions.
   //----------------------------------------------------------------        
-  localparam CTRL_IDLE = 1'b0;
-  localparam CTRL_COMP = 1'b1;
+  localparam CTRL_IDLE  = 2'h0;
+  localparam CTRL_COMP  = 2'h1;
+  localparam CTRL_BURST = 2'h2;
+  
+  localparam BURST_WORDS = 24;
   
   //----------------------------------------------------------------
   // Registers + update variables and write enable.
   //----------------------------------------------------------------
-  reg         ctr_ctrl_reg;
-  reg         ctr_ctrl_new;
+  reg [1 : 0] ctr_ctrl_reg;
+  reg [1 : 0] ctr_ctrl_new;
   reg         ctr_ctrl_we;
   
+  reg [31 : 0] words_o_reg [0 : BURST_WORDS - 1];
+  reg          words_o_we;
+  
+  reg [4 : 0]  word_ctr_reg;
+  reg [4 : 0]  word_ctr_new;
+  reg          word_ctr_we;
+  
   reg         ready_reg;
   reg         ready_new;
   reg         ready_we;
+  
+  //----------------------------------------------------------------
+  // Wires.
+  //----------------------------------------------------------------
+  wire [767 : 0] burst_words_i;
+  wire [31 : 0]  burst_word_o;
  
   //----------------------------------------------------------------
   // Concurrent connectivity for ports etc.
   //----------------------------------------------------------------
-  assign ready = ready_reg;
+  assign ready   = ready_reg;
+  assign words_o = {words_o_reg[23], words_o_reg[22], words_o_reg[21], words_o_reg[20],
+                    words_o_reg[19], words_o_reg[18], words_o_reg[17], words_o_reg[16],
+                    words_o_reg[15], words_o_reg[14], words_o_reg[13], words_o_reg[12],
+                    words_o_reg[11], words_o_reg[10], words_o_reg[9],  words_o_reg[8],
+                    words_o_reg[7],  words_o_reg[6],  words_o_reg[5],  words_o_reg[4],
+                    words_o_reg[3],  words_o_reg[2],  words_o_reg[1],  words_o_reg[0]};
 
   //----------------------------------------------------------------
   // reg_update
@@ -69,10 +95,15 @@ module zuc256_ctr_ext(
   //----------------------------------------------------------------
   always @ (posedge clk or negedge reset_n)
     begin: reg_update
+      integer i;
+      
       if (!reset_n)
         begin
+          for (i = 0 ; i < BURST_WORDS ; i = i + 1)
+            words_o_reg[i] <= 32'h0;
           ctr_ctrl_reg  <= CTRL_IDLE;
           ready_reg     <= 1'b0;
+          word_ctr_reg  <= 5'h0;
         end
       else
         begin
@@ -80,6 +111,10 @@ module zuc256_ctr_ext(
             ctr_ctrl_reg <= ctr_ctrl_new;
           if (ready_we)
             ready_reg <= ready_new;
+          if (words_o_we)
+            words_o_reg[word_ctr_reg] <= burst_word_o;
+          if (word_ctr_we)
+            word_ctr_reg <= word_ctr_new;
         end
     end // reg_update
     
@@ -88,6 +123,10 @@ module zuc256_ctr_ext(
   //----------------------------------------------------------------
   assign word_o = word_i ^ core_z;
   
+  // In burst mode word word_ctr_reg of words_i is encrypted
+  assign burst_words_i = words_i >> {word_ctr_reg, 5'h0};
+  assign burst_word_o  = burst_words_i[31 : 0] ^ core_z;
+  
   //----------------------------------------------------------------
   // ctr_ctrl
   //
@@ -102,6 +141,9 @@ module zuc256_ctr_ext(
       
       core_init    = 1'b0;
       core_next    = 1'b0;
+      words_o_we   = 1'b0;
+      word_ctr_new = 5'h0;
+      word_ctr_we  = 1'b0;
       
       case (ctr_ctrl_reg)
         CTRL_IDLE:
@@ -120,6 +162,19 @@ module zuc256_ctr_ext(
                 ctr_ctrl_we  = 1'b1;
                 core_next    = 1'b1;
               end
+            else if (burst)
+              begin
+                word_ctr_new = 5'h0;
+                word_ctr_we  = 1'b1;
+                if (num_words == 5'h0)
+                  ready_new = 1'b1;
+                else
+                  begin
+                    ctr_ctrl_new = CTRL_BURST;
+                    ctr_ctrl_we  = 1'b1;
+                    core_next    = 1'b1;
+                  end
+              end
           end
         CTRL_COMP:
           begin
@@ -131,6 +186,26 @@ module zuc256_ctr_ext(
                 ready_we     = 1'b1;
               end
           end
+        CTRL_BURST:
+          begin
+            if (core_ready)
+              begin
+                words_o_we = 1'b1;
+                if (word_ctr_reg == num_words - 5'h1)
+                  begin
+                    ctr_ctrl_new = CTRL_IDLE;
+                    ctr_ctrl_we  = 1'b1;
+                    ready_new    = 1'b1;
+                    ready_we     = 1'b1;
+                  end
+                else
+                  begin
+                    word_ctr_new = word_ctr_reg + 5'h1;
+                    word_ctr_we  = 1'b1;
+                    core_next    = 1'b1;
+                  end
+              end
+          end
         default: 
           begin
         
@@ -0,0 +1,361 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer:
+//
+// Create Date:
+// Design Name:
+// Module Name: zuc256_ks_fifo
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description: Keystream prefetch FIFO between a ZUC-256 keystream
+//              generator and its user. As soon as init (or a context
+//              restore) is done, the core is kept running with next until
+//              2**KS_FIFO_BITS words are waiting, so a next of the user
+//              only pops the FIFO and the keystream computation overlaps
+//              with whatever the user does in between. The FIFO is flushed
+//              on init and ctx_load.
+//
+// Dependencies: zuc256_core or zuc256_core_fast
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments: The user side behaves like zuc256_core_fast: ready
+//                      is a level that is only low while init or a next
+//                      waits for the core, and keystream_z holds the word
+//                      of the last next. With every word the FIFO keeps
+//                      the core state from before that word, so ctx_o is
+//                      the state after the last popped word and not that
+//                      of the core, which runs ahead.
+//                      init, next and ctx_load must be high for one
+//                      cycle per command.
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module zuc256_ks_fifo #(parameter KS_FIFO_BITS = 1)(
+           input wire            clk,
+           input wire            reset_n,
+
+           input wire            init,
+           input wire            next,
+           input wire            ctx_load,  // Restore the state from ctx_i, hold ctx_i until the next init or next is ready
+           input wire [591 : 0]  ctx_i,
+           output wire [591 : 0] ctx_o,     // {z, R2, R1, s15, ..., s0} after the last popped word
+
+           output wire [31 : 0]  keystream_z,
+           output wire           ready,
+
+           output reg            core_init,
+           output reg            core_next,
+           output reg            core_ctx_load,
+           input wire [591 : 0]  core_ctx_o,
+           input wire [31 : 0]   core_z,
+           input wire            core_ready
+          );
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  localparam KS_FIFO_DEPTH = 1 << KS_FIFO_BITS;
+
+  //----------------------------------------------------------------
+  // Registers + update variables and write enable.
+  //----------------------------------------------------------------
+  reg            ready_reg;
+  reg            ready_new;
+  reg            ready_we;
+
+  reg [31 : 0]   z_reg;
+  reg [31 : 0]   z_new;
+  reg            z_we;
+
+  // A next of the user that waits for the core
+  reg            wait_reg;
+  reg            wait_new;
+  reg            wait_we;
+
+  // The core has a valid state to prefetch from
+  reg            run_reg;
+  reg            run_new;
+  reg            run_we;
+
+  // init and ctx_load that wait until the core is done with a word
+  reg            init_pend_reg;
+  reg            init_pend_new;
+  reg            init_pend_we;
+
+  reg            load_pend_reg;
+  reg            load_pend_new;
+  reg            load_pend_we;
+
+  // Command the core is busy with, and whether its word is flushed
+  reg            init_busy_reg;
+  reg            init_busy_new;
+  reg            fill_busy_reg;
+  reg            fill_busy_new;
+  reg            busy_we;
+
+  reg            stale_reg;
+  reg            stale_new;
+  reg            stale_we;
+
+  // Keystream FIFO: word and the core state before that word
+  reg [31 : 0]   ks_z_mem [0 : KS_FIFO_DEPTH - 1];
+  reg [591 : 0]  ks_ctx_mem [0 : KS_FIFO_DEPTH - 1];
+  reg [KS_FIFO_BITS - 1 : 0] ks_ctx_addr;
+  reg            ks_ctx_we;
+  reg [KS_FIFO_BITS : 0] ks_wr_ptr_reg;
+  reg [KS_FIFO_BITS : 0] ks_rd_ptr_reg;
+  reg            ks_push;
+  reg            ks_pop;
+  reg            ks_clear;
+
+  //----------------------------------------------------------------
+  // Wires.
+  //----------------------------------------------------------------
+  wire           ks_empty;
+  wire           core_free;
+  wire           init_done;
+  wire           fill_done;
+  wire           bypass;
+
+  //----------------------------------------------------------------
+  // Concurrent connectivity for ports etc.
+  //----------------------------------------------------------------
+  assign ks_empty    = (ks_wr_ptr_reg == ks_rd_ptr_reg);
+
+  // The core takes a new command in the cycle it is ready with the last
+  assign core_free   = !(init_busy_reg || fill_busy_reg) || core_ready;
+  assign init_done   = init_busy_reg && core_ready;
+  assign fill_done   = fill_busy_reg && core_ready && !stale_reg && !init && !ctx_load;
+
+  // The end of init and a word for a waiting next go straight to the user
+  assign bypass      = init_done || (wait_reg && fill_done);
+
+  assign ready       = ready_reg || bypass;
+  assign keystream_z = bypass ? core_z : z_reg;
+
+  assign ctx_o       = load_pend_reg ? ctx_i :
+                       !ks_empty ? ks_ctx_mem[ks_rd_ptr_reg[KS_FIFO_BITS - 1 : 0]] :
+                       (fill_busy_reg && !stale_reg) ? ks_ctx_mem[ks_wr_ptr_reg[KS_FIFO_BITS - 1 : 0]] :
+                       core_ctx_o;
+
+  //----------------------------------------------------------------
+  // reg_update
+  //
+  // Update functionality for all registers in the core.
+  // All registers are positive edge triggered with asynchronous
+  // active low reset. All registers have write enable.
+  //----------------------------------------------------------------
+  always @ (posedge clk or negedge reset_n)
+    begin: reg_update
+      if (!reset_n)
+        begin
+          ready_reg     <= 1'b0;
+          z_reg         <= 32'h0;
+          wait_reg      <= 1'b0;
+          run_reg       <= 1'b0;
+          init_pend_reg <= 1'b0;
+          load_pend_reg <= 1'b0;
+          init_busy_reg <= 1'b0;
+          fill_busy_reg <= 1'b0;
+          stale_reg     <= 1'b0;
+          ks_wr_ptr_reg <= {(KS_FIFO_BITS + 1){1'b0}};
+          ks_rd_ptr_reg <= {(KS_FIFO_BITS + 1){1'b0}};
+        end
+      else
+        begin
+          if (ready_we)
+            ready_reg <= ready_new;
+          if (z_we)
+            z_reg <= z_new;
+          if (wait_we)
+            wait_reg <= wait_new;
+          if (run_we)
+            run_reg <= run_new;
+          if (init_pend_we)
+            init_pend_reg <= init_pend_new;
+          if (load_pend_we)
+            load_pend_reg <= load_pend_new;
+          if (busy_we)
+            begin
+              init_busy_reg <= init_busy_new;
+              fill_busy_reg <= fill_busy_new;
+            end
+          if (stale_we)
+            stale_reg <= stale_new;
+          if (ks_clear)
+            begin
+              ks_wr_ptr_reg <= {(KS_FIFO_BITS + 1){1'b0}};
+              ks_rd_ptr_reg <= {(KS_FIFO_BITS + 1){1'b0}};
+            end
+          else
+            begin
+              if (ks_push)
+                ks_wr_ptr_reg <= ks_wr_ptr_reg + 1'b1;
+              if (ks_pop)
+                ks_rd_ptr_reg <= ks_rd_ptr_reg + 1'b1;
+            end
+        end
+    end // reg_update
+
+  //----------------------------------------------------------------
+  // ks_fifo_update
+  //
+  // Write ports of the keystream FIFO, without reset.
+  //----------------------------------------------------------------
+  always @ (posedge clk)
+    begin: ks_fifo_update
+      if (ks_push)
+        ks_z_mem[ks_wr_ptr_reg[KS_FIFO_BITS - 1 : 0]] <= core_z;
+      if (ks_ctx_we)
+        ks_ctx_mem[ks_ctx_addr] <= core_ctx_o;
+    end // ks_fifo_update
+
+  //----------------------------------------------------------------
+  // ks_ctrl
+  //
+  // The user side pops words or waits for the core, the core side
+  // pushes words and issues the next command to the core.
+  //----------------------------------------------------------------
+  always @*
+    begin: ks_ctrl
+      reg                    fill_taken;
+      reg [KS_FIFO_BITS : 0] wr_ptr;
+      reg [KS_FIFO_BITS : 0] rd_ptr;
+      ready_new     = 1'b0;
+      ready_we      = 1'b0;
+      z_new         = core_z;
+      z_we          = 1'b0;
+      wait_new      = 1'b0;
+      wait_we       = 1'b0;
+      run_new       = 1'b0;
+      run_we        = 1'b0;
+      init_pend_new = 1'b0;
+      init_pend_we  = 1'b0;
+      load_pend_new = 1'b0;
+      load_pend_we  = 1'b0;
+      init_busy_new = 1'b0;
+      fill_busy_new = 1'b0;
+      busy_we       = 1'b0;
+      stale_new     = 1'b0;
+      stale_we      = 1'b0;
+      ks_push       = 1'b0;
+      ks_pop        = 1'b0;
+      ks_clear      = 1'b0;
+      ks_ctx_addr   = {KS_FIFO_BITS{1'b0}};
+      ks_ctx_we     = 1'b0;
+
+      core_init     = 1'b0;
+      core_next     = 1'b0;
+      core_ctx_load = 1'b0;
+
+      fill_taken    = 1'b0;
+
+      // User side
+      if (init_done)
+        begin
+          ready_new = 1'b1;
+          ready_we  = 1'b1;
+          z_we      = 1'b1;
+          run_new   = 1'b1;
+          run_we    = 1'b1;
+        end
+
+      if (wait_reg && fill_done)
+        begin
+          ready_new  = 1'b1;
+          ready_we   = 1'b1;
+          z_we       = 1'b1;
+          wait_new   = 1'b0;
+          wait_we    = 1'b1;
+          fill_taken = 1'b1;
+        end
+
+      if (init || ctx_load)
+        begin
+          ks_clear = 1'b1;
+          run_new  = 1'b0;
+          run_we   = 1'b1;
+          wait_new = 1'b0;
+          wait_we  = 1'b1;
+          if (init)
+            begin
+              ready_new = 1'b0;
+              ready_we  = 1'b1;
+            end
+          if (!core_free)
+            begin
+              init_pend_new = init;
+              init_pend_we  = init;
+              load_pend_new = ctx_load;
+              load_pend_we  = ctx_load;
+              stale_new     = fill_busy_reg;
+              stale_we      = 1'b1;
+            end
+        end
+      else if (next)
+        begin
+          ready_new = 1'b1;
+          ready_we  = 1'b1;
+          if (!ks_empty)
+            begin
+              z_new  = ks_z_mem[ks_rd_ptr_reg[KS_FIFO_BITS - 1 : 0]];
+              z_we   = 1'b1;
+              ks_pop = 1'b1;
+            end
+          else if (fill_done && !fill_taken)
+            begin
+              z_we       = 1'b1;
+              fill_taken = 1'b1;
+            end
+          else
+            begin
+              ready_new = 1'b0;
+              wait_new  = 1'b1;
+              wait_we   = 1'b1;
+            end
+        end
+
+      ks_push = fill_done && !fill_taken;
+
+      // Core side
+      wr_ptr = ks_clear ? {(KS_FIFO_BITS + 1){1'b0}} : ks_wr_ptr_reg + ks_push;
+      rd_ptr = ks_clear ? {(KS_FIFO_BITS + 1){1'b0}} : ks_rd_ptr_reg + ks_pop;
+
+      if (core_free)
+        begin
+          busy_we   = 1'b1;
+          stale_new = 1'b0;
+          stale_we  = 1'b1;
+          if (init || init_pend_reg)
+            begin
+              core_init     = 1'b1;
+              init_busy_new = 1'b1;
+              init_pend_new = 1'b0;
+              init_pend_we  = 1'b1;
+              load_pend_new = 1'b0;
+              load_pend_we  = 1'b1;
+            end
+          else if (ctx_load || load_pend_reg)
+            begin
+              core_ctx_load = 1'b1;
+              load_pend_new = 1'b0;
+              load_pend_we  = 1'b1;
+              run_new       = 1'b1;
+              run_we        = 1'b1;
+            end
+          else if ((run_reg || init_done) &&
+                   (wr_ptr != {~rd_ptr[KS_FIFO_BITS], rd_ptr[KS_FIFO_BITS - 1 : 0]}))
+            begin
+              core_next     = 1'b1;
+              fill_busy_new = 1'b1;
+              ks_ctx_addr   = wr_ptr[KS_FIFO_BITS - 1 : 0];
+              ks_ctx_we     = 1'b1;
+            end
+        end
+    end // ks_ctrl
+
+endmodule // zuc256_ks_fifo
@@ -20,7 +20,7 @@
 
 `default_nettype none
 
-module zuc256_mac(
+module zuc256_mac #(parameter FAST_CORE = 0, parameter S = 4)(
            input wire            clk,
            input wire            reset_n,
            
@@ -48,7 +48,7 @@ module zuc256_mac(
   localparam CTRL_COMP      = 3'h5;
   localparam CTRL_FINAL     = 3'h6;
   
-  localparam S = 4;
+  // S: message bits processed per cycle, must divide 128
   localparam S_min1 = S - 1;
 
   //----------------------------------------------------------------
@@ -106,19 +106,49 @@ module zuc256_mac(
   //----------------------------------------------------------------
   // Instantiations.
   //----------------------------------------------------------------
-  zuc256_core core(
-                   .clk(clk),
-                   .reset_n(reset_n),
-                   
-                   .init(core_init),
-                   .next(core_next),
-                   .key(core_key),
-                   .iv(core_iv),
-                   .tag_len(tag_len),
-                   
-                   .keystream_z(core_z),
-                   .ready(core_ready)
-                   );
+  // FAST_CORE: 0 = zuc256_core, 1 = single-cycle zuc256_core_fast
+  generate
+    if (FAST_CORE)
+      begin : core_gen
+        zuc256_core_fast core(
+                              .clk(clk),
+                              .reset_n(reset_n),
+
+                              .init(core_init),
+                              .next(core_next),
+                              .key(core_key),
+                              .iv(core_iv),
+                              .tag_len(tag_len),
+
+                              .ctx_load(1'b0),
+                              .ctx_i(592'h0),
+                              .ctx_o(),
+
+                              .keystream_z(core_z),
+                              .ready(core_ready)
+                              );
+      end
+    else
+      begin : core_gen
+        zuc256_core core(
+                         .clk(clk),
+                         .reset_n(reset_n),
+
+                         .init(core_init),
+                         .next(core_next),
+                         .key(core_key),
+                         .iv(core_iv),
+                         .tag_len(tag_len),
+
+                         .ctx_load(1'b0),
+                         .ctx_i(592'h0),
+                         .ctx_o(),
+
+                         .keystream_z(core_z),
+                         .ready(core_ready)
+                         );
+      end
+  endgenerate
 
   //----------------------------------------------------------------
   // Concurrent connectivity for ports etc.
@@ -330,6 +360,7 @@ module zuc256_mac(
           begin
             if (core_ready)
               begin
+                keystream_we        = 1'b1;
                 zuc256_mac_ctrl_new = CTRL_LOAD;
                 zuc256_mac_ctrl_we  = 1'b1;
                 if (counter_reg < exit_len)
@@ -339,7 +370,6 @@ module zuc256_mac(
         CTRL_LOAD:
           begin
             counter_inc  = 1'b1;
-            keystream_we = 1'b1;
             if (counter_reg < exit_len)
               begin
                 zuc256_mac_ctrl_new = CTRL_NEXT_CORE;
@@ -20,7 +20,7 @@
 
 `default_nettype none
 
-module zuc256_mac_ext(
+module zuc256_mac_ext #(parameter S = 128)(
            input wire            clk,
            input wire            reset_n,
            
@@ -34,6 +34,10 @@ module zuc256_mac_ext(
            input wire [31 : 0]   core_z,
            input wire            core_ready,
            
+           input wire            ctx_load,  // Load the tag and keystream from ctx_i, only when idle
+           input wire [383 : 0]  ctx_i,
+           output wire [383 : 0] ctx_o,     // {tag, keystream words 0 to 7}
+           
            output reg            core_init,
            output reg            core_next,
 
@@ -52,7 +56,7 @@ module zuc256_mac_ext(
   localparam CTRL_COMP      = 3'h5;
   localparam CTRL_FINAL     = 3'h6;
   
-  localparam S = 128;
+  // S: message bits processed per cycle, must divide 128
   localparam S_min1 = S - 1;
 
   //----------------------------------------------------------------
@@ -74,6 +78,8 @@ module zuc256_mac_ext(
   reg [31 : 0]  keystream_new [7 : 0];
   reg           keystream_we;
   
+  reg           ctx_we;
+  
   // Counter
   reg [8 : 0]   counter_reg;
   reg [8 : 0]   counter_new;
@@ -105,6 +111,7 @@ module zuc256_mac_ext(
   //----------------------------------------------------------------
   assign tag   = tag_reg;
   assign ready = ready_reg;
+  assign ctx_o = {tag_reg, long_keystream};
   
   assign long_keystream = {keystream_reg [0], keystream_reg [1],
                            keystream_reg [2], keystream_reg [3],
@@ -149,6 +156,12 @@ module zuc256_mac_ext(
             came_from_init_reg <= came_from_init_new;
           if (came_from_next_we)
             came_from_next_reg <= came_from_next_new;
+          if (ctx_we)
+            begin
+              tag_reg <= ctx_i[383 : 256];
+              for (i = 0; i < 8; i = i + 1)
+                keystream_reg [i] <= ctx_i[255 - 32 * i -: 32];
+            end
         end
     end // reg_update
     
@@ -255,6 +268,7 @@ module zuc256_mac_ext(
       ready_we            = 1'b0;
       tag_we              = 1'b0;
       keystream_we        = 1'b0;
+      ctx_we              = 1'b0;
       core_init           = 1'b0;
       core_next           = 1'b0;
       counter_inc         = 1'b0;
@@ -292,6 +306,8 @@ module zuc256_mac_ext(
                 zuc256_mac_ctrl_new = CTRL_FINAL;
                 zuc256_mac_ctrl_we  = 1'b1;
               end
+            else if (ctx_load)
+              ctx_we              = 1'b1;
           end
         CTRL_INIT_CORE:
           begin
@@ -307,6 +323,7 @@ module zuc256_mac_ext(
           begin
             if (core_ready)
               begin
+                keystream_we        = 1'b1;
                 zuc256_mac_ctrl_new = CTRL_LOAD;
                 zuc256_mac_ctrl_we  = 1'b1;
                 if (counter_reg < exit_len)
@@ -316,7 +333,6 @@ module zuc256_mac_ext(
         CTRL_LOAD:
           begin
             counter_inc  = 1'b1;
-            keystream_we = 1'b1;
             if (counter_reg < exit_len)
               begin
                 zuc256_mac_ctrl_new = CTRL_NEXT_CORE;
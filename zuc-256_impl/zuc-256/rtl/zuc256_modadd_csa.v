@@ -0,0 +1,82 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer:
+//
+// Create Date:
+// Design Name:
+// Module Name: zuc256_modadd_csa
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description: Single-cycle version of zuc256_modadd. The six (seven in
+//              initialisation mode) terms of the LFSR feedback are reduced
+//              to two with a tree of carry-save adders. Modulo 2^31 - 1 the
+//              carry out of bit 30 has weight 1, so every carry vector is
+//              rotated instead of shifted (end-around carry). A single
+//              31-bit addition with end-around carry gives the result.
+//
+// Dependencies:
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments: As in the reference code, a result of 0 is returned
+//                      as 2^31 - 1.
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module zuc256_modadd_csa(
+                input wire [30 : 0]  s15,
+                input wire [30 : 0]  s13,
+                input wire [30 : 0]  s10,
+                input wire [30 : 0]  s4,
+                input wire [30 : 0]  s0,
+                input wire [30 : 0]  W_shifted,
+                input wire           came_from_init,
+                output wire [30 : 0] out
+               );
+
+  //----------------------------------------------------------------
+  // Carry-save adder modulo 2^31 - 1.
+  //----------------------------------------------------------------
+  function [61 : 0] csa(input [30 : 0] a, input [30 : 0] b, input [30 : 0] c);
+    reg [30 : 0] maj;
+    begin
+      maj = (a & b) | (a & c) | (b & c);
+      csa = {a ^ b ^ c, maj[29 : 0], maj[30]};
+    end
+  endfunction
+
+  //----------------------------------------------------------------
+  // Wires.
+  //----------------------------------------------------------------
+  wire [30 : 0] t0, t1, t2, t3, t4, t5, t6;
+  wire [61 : 0] l0, l1, l2, l3, l4;
+  wire [31 : 0] sum;
+  wire [30 : 0] sum_mod;
+
+  //----------------------------------------------------------------
+  // Concurrent connectivity for ports etc.
+  //----------------------------------------------------------------
+  // s0 + 2^8 s0 + 2^20 s4 + 2^21 s10 + 2^17 s13 + 2^15 s15 (+ W >> 1)
+  assign t0 = s0;
+  assign t1 = {s0[22 : 0], s0[30 : 23]};
+  assign t2 = {s4[10 : 0], s4[30 : 11]};
+  assign t3 = {s10[9 : 0], s10[30 : 10]};
+  assign t4 = {s13[13 : 0], s13[30 : 14]};
+  assign t5 = {s15[15 : 0], s15[30 : 16]};
+  assign t6 = came_from_init ? W_shifted : 31'h0;
+
+  // 7 -> 5 -> 4 -> 3 -> 2 terms
+  assign l0 = csa(t0, t1, t2);
+  assign l1 = csa(t3, t4, t5);
+  assign l2 = csa(l0[61 : 31], l0[30 : 0], l1[61 : 31]);
+  assign l3 = csa(l2[61 : 31], l2[30 : 0], l1[30 : 0]);
+  assign l4 = csa(l3[61 : 31], l3[30 : 0], t6);
+
+  assign sum     = l4[61 : 31] + l4[30 : 0];
+  assign sum_mod = sum[30 : 0] + sum[31];
+  assign out     = (sum_mod == 31'h0) ? 31'h7fffffff : sum_mod;
+
+endmodule // zuc256_modadd_csa
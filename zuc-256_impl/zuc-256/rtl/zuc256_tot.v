@@ -20,7 +20,7 @@
 
 `default_nettype none
 
-module zuc256_tot(
+module zuc256_tot #(parameter FAST_CORE = 0, parameter MAC_S = 128, parameter KS_PREFETCH = 0, parameter KS_FIFO_BITS = 1)(
            input wire            clk,
            input wire            reset_n,
            
@@ -33,8 +33,16 @@ module zuc256_tot(
            input wire [127 : 0]  block_i,
            input wire [7 : 0]    i_len,
            input wire [7 : 0]    tag_len,  // Either 32, 64, or 128
+           input wire            burst,    // Only used for encryption
+           input wire [4 : 0]    num_words,
+           input wire [767 : 0]  words_i,
+           
+           input wire            ctx_load,  // Restore the message state from ctx_i, only when idle
+           input wire [975 : 0]  ctx_i,
+           output wire [975 : 0] ctx_o,     // {MAC tag and keystream, keystream generator}
 
            output reg [127 : 0]  block_o,
+           output wire [767 : 0] words_o,
            output reg            ready
           );
 
@@ -50,16 +58,30 @@ module zuc256_tot(
   wire [7 : 0]   core_tag_len;
   wire [31 : 0]  core_z;
   wire           core_ready;  
+  wire [591 : 0] core_ctx_i;
+  wire [591 : 0] core_ctx_o;
+  
+  // -- ZUC-256 core, behind the keystream FIFO when KS_PREFETCH
+  wire           zuc_init;
+  wire           zuc_next;
+  wire           zuc_ctx_load;
+  wire [591 : 0] zuc_ctx_o;
+  wire [31 : 0]  zuc_z;
+  wire           zuc_ready;
   
   // -- CTR-mode core
   reg            ctr_core_init;
   reg            ctr_core_next;
+  reg            ctr_core_burst;
   wire [31 : 0]  ctr_core_word_i;
+  wire [4 : 0]   ctr_core_num_words;
+  wire [767 : 0] ctr_core_words_i;
   wire [31 : 0]  ctr_core_keystream_z;
   wire           ctr_core_keystream_ready;
   wire           ctr_core_keystream_init;
   wire           ctr_core_keystream_next;
   wire [31 : 0]  ctr_core_word_o;
+  wire [767 : 0] ctr_core_words_o;
   wire           ctr_core_ready;
   
   // -- MAC core
@@ -75,23 +97,92 @@ module zuc256_tot(
   wire           mac_core_keystream_next;
   wire [127 : 0] mac_core_tag;
   wire           mac_core_ready;
+  wire [383 : 0] mac_core_ctx_i;
+  wire [383 : 0] mac_core_ctx_o;
   
   //----------------------------------------------------------------
   // Instantiations.
   //----------------------------------------------------------------
-  zuc256_core core(
-                   .clk(clk),
-                   .reset_n(reset_n),
-                   
-                   .init(core_init),
-                   .next(core_next),
-                   .key(core_key),
-                   .iv(core_iv),
-                   .tag_len(core_tag_len),
-                   
-                   .keystream_z(core_z),
-                   .ready(core_ready)
-                   );
+  // FAST_CORE: 0 = zuc256_core, 1 = single-cycle zuc256_core_fast
+  generate
+    if (FAST_CORE)
+      begin : core_gen
+        zuc256_core_fast core(
+                              .clk(clk),
+                              .reset_n(reset_n),
+
+                              .init(zuc_init),
+                              .next(zuc_next),
+                              .key(core_key),
+                              .iv(core_iv),
+                              .tag_len(core_tag_len),
+
+                              .ctx_load(zuc_ctx_load),
+                              .ctx_i(core_ctx_i),
+                              .ctx_o(zuc_ctx_o),
+
+                              .keystream_z(zuc_z),
+                              .ready(zuc_ready)
+                              );
+      end
+    else
+      begin : core_gen
+        zuc256_core core(
+                         .clk(clk),
+                         .reset_n(reset_n),
+
+                         .init(zuc_init),
+                         .next(zuc_next),
+                         .key(core_key),
+                         .iv(core_iv),
+                         .tag_len(core_tag_len),
+
+                         .ctx_load(zuc_ctx_load),
+                         .ctx_i(core_ctx_i),
+                         .ctx_o(zuc_ctx_o),
+
+                         .keystream_z(zuc_z),
+                         .ready(zuc_ready)
+                         );
+      end
+  endgenerate
+  
+  // KS_PREFETCH: 0 = keystream on demand, 1 = the core runs up to
+  // 2**KS_FIFO_BITS words ahead of the modes (only pays off without FAST_CORE)
+  generate
+    if (KS_PREFETCH)
+      begin : ks_gen
+        zuc256_ks_fifo #(.KS_FIFO_BITS(KS_FIFO_BITS)) ks_fifo(
+                                                              .clk(clk),
+                                                              .reset_n(reset_n),
+
+                                                              .init(core_init),
+                                                              .next(core_next),
+                                                              .ctx_load(ctx_load),
+                                                              .ctx_i(core_ctx_i),
+                                                              .ctx_o(core_ctx_o),
+
+                                                              .keystream_z(core_z),
+                                                              .ready(core_ready),
+
+                                                              .core_init(zuc_init),
+                                                              .core_next(zuc_next),
+                                                              .core_ctx_load(zuc_ctx_load),
+                                                              .core_ctx_o(zuc_ctx_o),
+                                                              .core_z(zuc_z),
+                                                              .core_ready(zuc_ready)
+                                                              );
+      end
+    else
+      begin : ks_gen
+        assign zuc_init     = core_init;
+        assign zuc_next     = core_next;
+        assign zuc_ctx_load = ctx_load;
+        assign core_ctx_o   = zuc_ctx_o;
+        assign core_z       = zuc_z;
+        assign core_ready   = zuc_ready;
+      end
+  endgenerate
   
    zuc256_ctr_ext ctr_core(
                            .clk(clk),
@@ -100,6 +191,9 @@ module zuc256_tot(
                            .init(ctr_core_init),
                            .next(ctr_core_next),
                            .word_i(ctr_core_word_i),
+                           .burst(ctr_core_burst),
+                           .num_words(ctr_core_num_words),
+                           .words_i(ctr_core_words_i),
                            
                            .core_z(ctr_core_keystream_z),
                            .core_ready(ctr_core_keystream_ready),
@@ -108,10 +202,11 @@ module zuc256_tot(
                            .core_next(ctr_core_keystream_next),
                            
                            .word_o(ctr_core_word_o),
+                           .words_o(ctr_core_words_o),
                            .ready(ctr_core_ready)
                            );
                    
-  zuc256_mac_ext mac_core(
+  zuc256_mac_ext #(.S(MAC_S)) mac_core(
                           .clk(clk),
                           .reset_n(reset_n),
                           
@@ -125,6 +220,10 @@ module zuc256_tot(
                           .core_z(mac_core_keystream_z),
                           .core_ready(mac_core_keystream_ready),
                           
+                          .ctx_load(ctx_load),
+                          .ctx_i(mac_core_ctx_i),
+                          .ctx_o(mac_core_ctx_o),
+                          
                           .core_init(mac_core_keystream_init),
                           .core_next(mac_core_keystream_next),
                           
@@ -138,8 +237,12 @@ module zuc256_tot(
   assign core_key                 = key;
   assign core_iv                  = iv;
   assign core_tag_len             = tag_len;
+  assign core_ctx_i               = ctx_i[591 : 0];
   
   assign ctr_core_word_i          = block_i[31 : 0];
+  assign ctr_core_num_words       = num_words;
+  assign ctr_core_words_i         = words_i;
+  assign words_o                  = ctr_core_words_o;
   assign ctr_core_keystream_z     = core_z;
   assign ctr_core_keystream_ready = core_ready; 
   
@@ -148,6 +251,10 @@ module zuc256_tot(
   assign mac_core_tag_len         = tag_len;
   assign mac_core_keystream_z     = core_z;
   assign mac_core_keystream_ready = core_ready;
+  assign mac_core_ctx_i           = ctx_i[975 : 592];
+  
+  // The CTR-mode core keeps nothing between words
+  assign ctx_o                    = {mac_core_ctx_o, core_ctx_o};
     
   //----------------------------------------------------------------
   // Logic
@@ -159,6 +266,7 @@ module zuc256_tot(
       mac_core_next  = 1'b0;
       ctr_core_init  = 1'b0;
       ctr_core_next  = 1'b0;
+      ctr_core_burst = 1'b0;
       
       if (enc_auth)
         begin
@@ -171,12 +279,13 @@ module zuc256_tot(
         end
       else
         begin
-          ctr_core_init = init;
-          ctr_core_next = next;
-          core_init     = ctr_core_keystream_init;
-          core_next     = ctr_core_keystream_next;
-          block_o       = {96'h0, ctr_core_word_o};
-          ready         = ctr_core_ready;
+          ctr_core_init  = init;
+          ctr_core_next  = next;
+          ctr_core_burst = burst;
+          core_init      = ctr_core_keystream_init;
+          core_next      = ctr_core_keystream_next;
+          block_o        = {96'h0, ctr_core_word_o};
+          ready          = ctr_core_ready;
         end
     end // logic
     
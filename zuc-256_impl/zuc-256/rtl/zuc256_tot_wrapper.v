@@ -20,7 +20,7 @@
 
 `default_nettype none
 
-module zuc256_tot_wrapper(
+module zuc256_tot_wrapper #(parameter FAST_CORE = 0, parameter MAC_S = 128)(
                    input wire             clk,
                    input wire             resetn,
                    
@@ -43,6 +43,9 @@ module zuc256_tot_wrapper(
     //----------------------------------------------------------------
     // Internal constant and parameter definitions.
     //----------------------------------------------------------------
+    localparam CTX_BITS           = 2;  // Number of message contexts: 4
+    localparam CTX_WIDTH          = 976;
+    
       // States
     localparam CTRL_WAIT_FOR_CMD  = 4'h0;  
     localparam CTRL_READ          = 4'h1;
@@ -52,6 +55,12 @@ module zuc256_tot_wrapper(
     localparam CTRL_BUSY          = 4'h5;
     localparam CTRL_WRITE         = 4'h6;
     localparam CTRL_ASSERT_DONE   = 4'h7;
+    localparam CTRL_ENC_READ      = 4'h8;
+    localparam CTRL_ENC           = 4'h9;
+    localparam CTRL_ENC_BUSY      = 4'ha;
+    localparam CTRL_ENC_WRITE     = 4'hb;
+    localparam CTRL_STATS_WRITE   = 4'hc;
+    localparam CTRL_LOAD          = 4'hd;
     
       // Wrapper commands
     localparam CMD_READ           = 32'h0;
@@ -59,6 +68,12 @@ module zuc256_tot_wrapper(
     localparam CMD_COMPUTE_NEXT   = 32'h2;
     localparam CMD_COMPUTE_FINAL  = 32'h3;
     localparam CMD_WRITE          = 32'h4;
+    localparam CMD_COMPUTE_ENCRYPT = 32'h5;
+    localparam CMD_WRITE_PREV     = 32'hc;  // CMD_WRITE with bit 3 set
+    localparam CMD_READ_STATS     = 32'h7;
+    localparam CMD_READ_STATS_HI  = 32'hf;  // CMD_READ_STATS with bit 3 set
+    localparam CMD_RESTORE_CTX    = 32'h8;  // CMD_READ with bit 3 set
+    localparam CMD_SAVE_CTX       = 32'h9;
 
     //----------------------------------------------------------------
     // Registers + update variables and write enable.
@@ -85,12 +100,77 @@ module zuc256_tot_wrapper(
     reg [7 : 0]    tag_len_reg;
     wire [7 : 0]   tag_len_new;
     
+    reg [7 : 0]    ctx_id_reg;
+    wire [7 : 0]   ctx_id_new;
+    
     reg            inputs_we;
     
+      // Double buffering: READ fills in_buf_reg, which is copied into the
+      // registers above when the next command starts on the core. The core
+      // runs in the background (core_busy_reg), so the host can upload the
+      // next frame and fetch the previous result (out_buf_reg, saved when
+      // a new compute starts) while it computes.
+    reg [536 : 0]  in_buf_reg;
+    reg            in_buf_we;
+    
+    reg [3 : 0]    start_state_reg;
+    reg [3 : 0]    start_state_new;
+    reg            start_state_we;
+    
+    reg            core_busy_reg;
+    reg            core_busy_new;
+    reg            core_busy_we;
+    
     reg [127 : 0]  result_reg;
     wire [127 : 0] result_new;
     reg            result_we;
     
+    reg [127 : 0]  out_buf_reg;
+    reg            out_buf_we;
+    
+    reg            write_prev_reg;
+    reg            write_prev_new;
+    reg            write_prev_we;
+    
+    reg [767 : 0]  words_i_reg;
+    wire [767 : 0] words_i_new;
+    
+    reg [4 : 0]    num_words_reg;
+    wire [4 : 0]   num_words_new;
+    
+    reg            words_we;
+    
+    reg            enc_mode_reg;
+    reg            enc_mode_new;
+    reg            enc_mode_we;
+    
+    reg            stats_mode_reg;
+    reg            stats_mode_new;
+    reg            stats_mode_we;
+    
+      // Contexts: the state of up to 2**CTX_BITS messages, selected by the
+      // ctx_id of the frame. The core holds the state of context
+      // ctx_cur_reg (while ctx_live_reg), ctx_mem that of the others. A
+      // compute command for another context first swaps the two.
+      // CMD_SAVE_CTX and CMD_RESTORE_CTX move a context to and from the
+      // host. CMD_COMPUTE_ENCRYPT has no ctx_id and continues the context
+      // of the last compute command.
+    reg [CTX_WIDTH - 1 : 0] ctx_mem [0 : (1 << CTX_BITS) - 1];
+    reg [CTX_WIDTH - 1 : 0] ctx_mem_new;
+    reg [CTX_BITS - 1 : 0]  ctx_mem_addr;
+    reg            ctx_mem_we;
+    
+    reg [CTX_BITS - 1 : 0]  ctx_cur_reg;
+    reg            ctx_cur_we;
+    
+    reg            ctx_live_reg;
+    reg            ctx_live_new;
+    reg            ctx_live_we;
+    
+    reg            ctx_mode_reg;
+    reg            ctx_mode_new;
+    reg            ctx_mode_we;
+    
     reg            fpga_to_arm_data_valid_reg;
     wire           fpga_to_arm_data_valid_new;
     
@@ -107,20 +187,47 @@ module zuc256_tot_wrapper(
     reg            core_init;
     reg            core_next;
     reg            core_final;
+    reg            core_burst;
     wire           core_enc_auth;
     wire [255 : 0] core_key;
     wire [127 : 0] core_iv;
     wire [127 : 0] core_block_i;
     wire [7 : 0]   core_i_len;
     wire [7 : 0]   core_tag_len;
+    wire [4 : 0]   core_num_words;
+    wire [767 : 0] core_words_i;
     
     wire [127 : 0] core_result;
+    wire [767 : 0] core_words_o;
     wire           core_ready;
     
+    reg            core_ctx_load;
+    wire [975 : 0] core_ctx_i;
+    wire [975 : 0] core_ctx_o;
+    
+      // Contexts
+    wire           ctx_swap;
+    wire [CTX_BITS - 1 : 0] ctx_save_slot;
+    wire [CTX_WIDTH - 1 : 0] ctx_save;
+    wire [CTX_BITS - 1 : 0] ctx_restore_slot;
+    
+      // Statistics
+    wire           stats_cmd_accept;
+    wire [1023 : 0] stats;
+    
     //----------------------------------------------------------------
     // Instantiations.
     //----------------------------------------------------------------
-    zuc256_tot tot(
+    wrapper_stats wrapper_stats(
+                                .clk(clk),
+                                .reset_n(resetn),
+                                .state(zuc256_tot_wrapper_ctrl_reg),
+                                .cmd_accept(stats_cmd_accept),
+                                .cmd(arm_to_fpga_cmd[3 : 0]),
+                                .stats(stats)
+                                );
+    
+    zuc256_tot #(.FAST_CORE(FAST_CORE), .MAC_S(MAC_S)) tot(
                    .clk(clk),
                    .reset_n(resetn),
                    .init(core_init),
@@ -132,8 +239,16 @@ module zuc256_tot_wrapper(
                    .block_i(core_block_i),
                    .i_len(core_i_len),
                    .tag_len(core_tag_len),
+                   .burst(core_burst),
+                   .num_words(core_num_words),
+                   .words_i(core_words_i),
+                   
+                   .ctx_load(core_ctx_load),
+                   .ctx_i(core_ctx_i),
+                   .ctx_o(core_ctx_o),
                    
                    .block_o(core_result),
+                   .words_o(core_words_o),
                    .ready(core_ready)
                    );
 
@@ -147,22 +262,47 @@ module zuc256_tot_wrapper(
     assign core_block_i    = block_i_reg;
     assign core_i_len      = i_len_reg;
     assign core_tag_len    = tag_len_reg;
+    assign core_num_words  = num_words_reg;
+    assign core_words_i    = words_i_reg;
+    assign core_ctx_i      = ctx_mem[ctx_id_reg[CTX_BITS - 1 : 0]];
     assign result_new      = core_result;
     
       // ARM to FPGA data decomposition
-    assign enc_auth_new   = arm_to_fpga_data[528];
-    assign key_new        = arm_to_fpga_data[527 : 272];
-    assign iv_new         = arm_to_fpga_data[271 : 144];
-    assign block_i_new    = arm_to_fpga_data[143 : 16];
-    assign i_len_new      = arm_to_fpga_data[15 : 8];
-    assign tag_len_new    = arm_to_fpga_data[7 : 0];
-    
-      // Wrapper I/O
-    assign fpga_to_arm_data       = {896'h0, result_reg};
+    assign ctx_id_new     = in_buf_reg[536 : 529];
+    assign enc_auth_new   = in_buf_reg[528];
+    assign key_new        = in_buf_reg[527 : 272];
+    assign iv_new         = in_buf_reg[271 : 144];
+    assign block_i_new    = in_buf_reg[143 : 16];
+    assign i_len_new      = in_buf_reg[15 : 8];
+    assign tag_len_new    = in_buf_reg[7 : 0];
+    
+      // ARM to FPGA encrypt frame decomposition: up to 24 words and their number.
+    assign num_words_new  = arm_to_fpga_data[772 : 768];
+    assign words_i_new    = arm_to_fpga_data[767 : 0];
+    
+      // Contexts: a compute command swaps first if its frame is for
+      // another context than the live one. CMD_SAVE_CTX returns the context
+      // named in the last frame read, from the core if it is the live one.
+      // A context frame holds the state in its lower CTX_WIDTH bits and
+      // the ctx_id in bits 1023 to 1016.
+    assign ctx_swap         = (ctx_id_reg[CTX_BITS - 1 : 0] != ctx_cur_reg) || !ctx_live_reg;
+    assign ctx_save_slot    = ctx_id_new[CTX_BITS - 1 : 0];
+    assign ctx_save         = (ctx_live_reg && (ctx_save_slot == ctx_cur_reg)) ? core_ctx_o : ctx_mem[ctx_save_slot];
+    assign ctx_restore_slot = arm_to_fpga_data[1016 + CTX_BITS - 1 : 1016];
+    
+      // Wrapper I/O. An encrypt frame in a MAC context is dropped:
+      // nothing is computed and the frame returned is all zeros.
+    assign fpga_to_arm_data       = stats_mode_reg ? stats :
+                                    ctx_mode_reg ? {ctx_id_new, {(1016 - CTX_WIDTH){1'b0}}, ctx_save} :
+                                    enc_mode_reg ? {256'h0, enc_auth_reg ? 768'h0 : core_words_o} :
+                                    {896'h0, write_prev_reg ? out_buf_reg : result_reg};
     assign fpga_to_arm_data_valid = fpga_to_arm_data_valid_reg;
     assign arm_to_fpga_data_ready = arm_to_fpga_data_ready_reg;
     assign fpga_to_arm_done       = fpga_to_arm_done_reg;
     
+      // Statistics: every command that leaves CTRL_WAIT_FOR_CMD is counted
+    assign stats_cmd_accept = (zuc256_tot_wrapper_ctrl_reg == CTRL_WAIT_FOR_CMD) && zuc256_tot_wrapper_ctrl_we;
+    
       // The four LEDs on the board are used as debug signals.
     assign leds = zuc256_tot_wrapper_ctrl_reg;
 
@@ -175,8 +315,12 @@ module zuc256_tot_wrapper(
     //----------------------------------------------------------------
     always @ (posedge clk or negedge resetn)
       begin: reg_update
+        integer i;
+        
         if (!resetn)
           begin
+            for (i = 0; i < (1 << CTX_BITS); i = i + 1)
+              ctx_mem[i] <= {CTX_WIDTH{1'b0}};
             zuc256_tot_wrapper_ctrl_reg <= CTRL_WAIT_FOR_CMD;
             enc_auth_reg                <= 1'b0;
             key_reg                     <= 256'h0;
@@ -184,7 +328,20 @@ module zuc256_tot_wrapper(
             block_i_reg                 <= 128'h0;
             i_len_reg                   <= 8'b0;
             tag_len_reg                 <= 8'b0;
+            ctx_id_reg                  <= 8'h0;
+            in_buf_reg                  <= 537'h0;
+            start_state_reg             <= CTRL_WAIT_FOR_CMD;
+            core_busy_reg               <= 1'b0;
             result_reg                  <= 128'h0;
+            out_buf_reg                 <= 128'h0;
+            write_prev_reg              <= 1'b0;
+            words_i_reg                 <= 768'h0;
+            num_words_reg               <= 5'h0;
+            enc_mode_reg                <= 1'b0;
+            stats_mode_reg              <= 1'b0;
+            ctx_cur_reg                 <= {CTX_BITS{1'b0}};
+            ctx_live_reg                <= 1'b0;
+            ctx_mode_reg                <= 1'b0;
             fpga_to_arm_data_valid_reg  <= 1'b0;
             arm_to_fpga_data_ready_reg  <= 1'b0;
             fpga_to_arm_done_reg        <= 1'b0;
@@ -201,9 +358,37 @@ module zuc256_tot_wrapper(
                 block_i_reg  <= block_i_new;
                 i_len_reg    <= i_len_new;
                 tag_len_reg  <= tag_len_new;
+                ctx_id_reg   <= ctx_id_new;
               end
+            if (in_buf_we)
+              in_buf_reg <= arm_to_fpga_data[536 : 0];
+            if (start_state_we)
+              start_state_reg <= start_state_new;
+            if (core_busy_we)
+              core_busy_reg <= core_busy_new;
             if (result_we)
               result_reg   <= result_new;
+            if (out_buf_we)
+              out_buf_reg <= result_reg;
+            if (words_we)
+              begin
+                words_i_reg   <= words_i_new;
+                num_words_reg <= num_words_new;
+              end
+            if (enc_mode_we)
+              enc_mode_reg <= enc_mode_new;
+            if (stats_mode_we)
+              stats_mode_reg <= stats_mode_new;
+            if (write_prev_we)
+              write_prev_reg <= write_prev_new;
+            if (ctx_mem_we)
+              ctx_mem[ctx_mem_addr] <= ctx_mem_new;
+            if (ctx_cur_we)
+              ctx_cur_reg <= ctx_id_reg[CTX_BITS - 1 : 0];
+            if (ctx_live_we)
+              ctx_live_reg <= ctx_live_new;
+            if (ctx_mode_we)
+              ctx_mode_reg <= ctx_mode_new;
             
             // Wrapper control signals don't have a write enable
             fpga_to_arm_data_valid_reg <= fpga_to_arm_data_valid_new;
@@ -224,8 +409,40 @@ module zuc256_tot_wrapper(
         core_init             = 1'b0;
         core_next             = 1'b0;
         core_final            = 1'b0;
+        core_burst            = 1'b0;
         inputs_we             = 1'b0;
+        in_buf_we             = 1'b0;
+        start_state_new       = CTRL_WAIT_FOR_CMD;
+        start_state_we        = 1'b0;
+        core_busy_new         = 1'b0;
+        core_busy_we          = 1'b0;
         result_we             = 1'b0;
+        out_buf_we            = 1'b0;
+        words_we              = 1'b0;
+        enc_mode_new          = 1'b0;
+        enc_mode_we           = 1'b0;
+        stats_mode_new        = 1'b0;
+        stats_mode_we         = 1'b0;
+        write_prev_new        = 1'b0;
+        write_prev_we         = 1'b0;
+        core_ctx_load         = 1'b0;
+        ctx_mem_new           = core_ctx_o;
+        ctx_mem_addr          = ctx_cur_reg;
+        ctx_mem_we            = 1'b0;
+        ctx_cur_we            = 1'b0;
+        ctx_live_new          = 1'b0;
+        ctx_live_we           = 1'b0;
+        ctx_mode_new          = 1'b0;
+        ctx_mode_we           = 1'b0;
+        
+        // The result of the core is captured whatever command the FSM
+        // is handling in the meantime
+        if (core_busy_reg && core_ready)
+          begin
+            result_we     = 1'b1;
+            core_busy_new = 1'b0;
+            core_busy_we  = 1'b1;
+          end
         
         case (zuc256_tot_wrapper_ctrl_reg)
           CTRL_WAIT_FOR_CMD:
@@ -233,19 +450,57 @@ module zuc256_tot_wrapper(
               if (arm_to_fpga_cmd_valid)
                 begin
                   zuc256_tot_wrapper_ctrl_we  = 1'b1;
+                  enc_mode_we                 = 1'b1;
+                  stats_mode_we               = 1'b1;
+                  write_prev_we               = 1'b1;
+                  ctx_mode_we                 = 1'b1;
+                  start_state_we              = 1'b1;
+                  zuc256_tot_wrapper_ctrl_new = CTRL_LOAD;
                   case (arm_to_fpga_cmd)
                     CMD_READ:
                       zuc256_tot_wrapper_ctrl_new = CTRL_READ;
                     CMD_COMPUTE_INIT:
-                      zuc256_tot_wrapper_ctrl_new = CTRL_INIT;
+                      start_state_new             = CTRL_INIT;
                     CMD_COMPUTE_NEXT:
-                      zuc256_tot_wrapper_ctrl_new = CTRL_NEXT;
+                      start_state_new             = CTRL_NEXT;
                     CMD_COMPUTE_FINAL:
-                      zuc256_tot_wrapper_ctrl_new = CTRL_FINAL;
+                      start_state_new             = CTRL_FINAL;
                     CMD_WRITE:
-                      zuc256_tot_wrapper_ctrl_new = CTRL_WRITE;
+                      zuc256_tot_wrapper_ctrl_new = CTRL_BUSY;
+                    CMD_WRITE_PREV:
+                      begin
+                        zuc256_tot_wrapper_ctrl_new = CTRL_WRITE;
+                        write_prev_new              = 1'b1;
+                      end
+                    CMD_COMPUTE_ENCRYPT:
+                      begin
+                        zuc256_tot_wrapper_ctrl_new = CTRL_ENC_READ;
+                        enc_mode_new                = 1'b1;
+                      end
+                    CMD_READ_STATS, CMD_READ_STATS_HI:
+                      begin
+                        zuc256_tot_wrapper_ctrl_new = CTRL_STATS_WRITE;
+                        stats_mode_new              = 1'b1;
+                      end
+                    CMD_RESTORE_CTX:
+                      begin
+                        zuc256_tot_wrapper_ctrl_new = CTRL_READ;
+                        ctx_mode_new                = 1'b1;
+                      end
+                    CMD_SAVE_CTX:
+                      begin
+                        zuc256_tot_wrapper_ctrl_new = CTRL_BUSY;
+                        ctx_mode_new                = 1'b1;
+                      end
                     default:
-                      zuc256_tot_wrapper_ctrl_we  = 1'b0;
+                      begin
+                        zuc256_tot_wrapper_ctrl_we  = 1'b0;
+                        enc_mode_we                 = 1'b0;
+                        stats_mode_we               = 1'b0;
+                        write_prev_we               = 1'b0;
+                        ctx_mode_we                 = 1'b0;
+                        start_state_we              = 1'b0;
+                      end
                   endcase
                 end
             end
@@ -254,34 +509,114 @@ module zuc256_tot_wrapper(
               begin
                 zuc256_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 zuc256_tot_wrapper_ctrl_we  = 1'b1;
-                inputs_we                   = 1'b1;
+                  // A context frame goes straight into the context table.
+                  // Restoring the live context drops the state in the core.
+                if (ctx_mode_reg)
+                  begin
+                    ctx_mem_new  = arm_to_fpga_data[CTX_WIDTH - 1 : 0];
+                    ctx_mem_addr = ctx_restore_slot;
+                    ctx_mem_we   = 1'b1;
+                    if (ctx_restore_slot == ctx_cur_reg)
+                      ctx_live_we = 1'b1;
+                  end
+                else
+                  in_buf_we                   = 1'b1;
+              end
+          CTRL_LOAD:
+            if (!core_busy_reg)
+              begin
+                  // The inputs are loaded first. A frame for another
+                  // context than the live one then swaps the contexts and
+                  // loads the inputs again, two cycles more.
+                if (ctx_swap)
+                  begin
+                    core_ctx_load = 1'b1;
+                    ctx_mem_we    = ctx_live_reg;
+                    ctx_cur_we    = 1'b1;
+                    ctx_live_new  = 1'b1;
+                    ctx_live_we   = 1'b1;
+                  end
+                else
+                  begin
+                    inputs_we = 1'b1;
+                    if (ctx_id_new[CTX_BITS - 1 : 0] == ctx_cur_reg)
+                      begin
+                        zuc256_tot_wrapper_ctrl_new = start_state_reg;
+                        zuc256_tot_wrapper_ctrl_we  = 1'b1;
+                      end
+                  end
               end
           CTRL_INIT:
             begin
               core_init                   = 1'b1;
-              zuc256_tot_wrapper_ctrl_new = CTRL_BUSY;
+              core_busy_new               = 1'b1;
+              core_busy_we                = 1'b1;
+              out_buf_we                  = 1'b1;
+              zuc256_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               zuc256_tot_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_NEXT:
             begin
               core_next                   = 1'b1;
-              zuc256_tot_wrapper_ctrl_new = CTRL_BUSY;
+              core_busy_new               = 1'b1;
+              core_busy_we                = 1'b1;
+              out_buf_we                  = 1'b1;
+              zuc256_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               zuc256_tot_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_FINAL:
             begin
               core_final                  = 1'b1;
-              zuc256_tot_wrapper_ctrl_new = CTRL_BUSY;
+              core_busy_new               = 1'b1;
+              core_busy_we                = 1'b1;
+              out_buf_we                  = 1'b1;
+              zuc256_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
               zuc256_tot_wrapper_ctrl_we  = 1'b1;
             end
           CTRL_BUSY:
+            if (!core_busy_reg)
+              begin
+                zuc256_tot_wrapper_ctrl_new = CTRL_WRITE;
+                zuc256_tot_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_WRITE:
+            if (fpga_to_arm_data_ready)
+              begin
+                zuc256_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
+                zuc256_tot_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_ENC_READ:
+            if (arm_to_fpga_data_valid)
+              begin
+                zuc256_tot_wrapper_ctrl_new = CTRL_ENC;
+                zuc256_tot_wrapper_ctrl_we  = 1'b1;
+                words_we                    = 1'b1;
+              end
+          CTRL_ENC:
+            if (!core_busy_reg)
+              begin
+                // Burst encryption is only supported by the CTR-mode core,
+                // a MAC context answers with an all-zero frame
+                core_burst                  = !enc_auth_reg;
+                zuc256_tot_wrapper_ctrl_we  = 1'b1;
+                if (enc_auth_reg)
+                  zuc256_tot_wrapper_ctrl_new = CTRL_ENC_WRITE;
+                else
+                  zuc256_tot_wrapper_ctrl_new = CTRL_ENC_BUSY;
+              end
+          CTRL_ENC_BUSY:
             if (core_ready)
+              begin
+                zuc256_tot_wrapper_ctrl_new = CTRL_ENC_WRITE;
+                zuc256_tot_wrapper_ctrl_we  = 1'b1;
+              end
+          CTRL_ENC_WRITE:
+            if (fpga_to_arm_data_ready)
               begin
                 zuc256_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
                 zuc256_tot_wrapper_ctrl_we  = 1'b1;
-                result_we                   = 1'b1;
               end
-          CTRL_WRITE:
+          CTRL_STATS_WRITE:
             if (fpga_to_arm_data_ready)
               begin
                 zuc256_tot_wrapper_ctrl_new = CTRL_ASSERT_DONE;
@@ -305,8 +640,11 @@ module zuc256_tot_wrapper(
     //
     // Set the control signals based on the current state of the FSM.
     //----------------------------------------------------------------
-    assign fpga_to_arm_data_valid_new = (zuc256_tot_wrapper_ctrl_reg == CTRL_WRITE);
-    assign arm_to_fpga_data_ready_new = (zuc256_tot_wrapper_ctrl_reg == CTRL_READ);
+    assign fpga_to_arm_data_valid_new = (zuc256_tot_wrapper_ctrl_reg == CTRL_WRITE) ||
+                                        (zuc256_tot_wrapper_ctrl_reg == CTRL_ENC_WRITE) ||
+                                        (zuc256_tot_wrapper_ctrl_reg == CTRL_STATS_WRITE);
+    assign arm_to_fpga_data_ready_new = (zuc256_tot_wrapper_ctrl_reg == CTRL_READ) ||
+                                        (zuc256_tot_wrapper_ctrl_reg == CTRL_ENC_READ);
     assign fpga_to_arm_done_new       = (zuc256_tot_wrapper_ctrl_reg == CTRL_ASSERT_DONE);
 
 endmodule
\ No newline at end of file
@@ -62,6 +62,10 @@ module tb_zuc256_core();
                   .iv(tb_iv),
                   .tag_len(tb_tag_len),
 
+                  .ctx_load(1'b0),
+                  .ctx_i(592'h0),
+                  .ctx_o(),
+
                   .keystream_z(tb_keystream_z),
                   .ready(tb_ready)
                   );
@@ -0,0 +1,338 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer:
+//
+// Create Date:
+// Design Name:
+// Module Name: tb_zuc256_core_fast
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description:
+//
+// Dependencies:
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments:
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module tb_zuc256_core_fast();
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  parameter DEBUG     = 0;
+  parameter DUMP_WAIT = 0;
+
+  parameter CLK_HALF_PERIOD = 1;
+  parameter CLK_PERIOD = 2 * CLK_HALF_PERIOD;
+
+  parameter NUM_WORDS = 20;
+
+  //----------------------------------------------------------------
+  // Register and Wire declarations.
+  //----------------------------------------------------------------
+  reg [31 : 0]   cycle_ctr;
+  reg [31 : 0]   error_ctr;
+  reg [31 : 0]   tc_ctr;
+
+  reg            tb_clk;
+  reg            tb_reset_n;
+  reg            tb_init;
+  reg            tb_next;
+  reg [255 : 0]  tb_key;
+  reg [127 : 0]  tb_iv;
+  reg [7 : 0]    tb_tag_len;
+  wire [31 : 0]  tb_keystream_z;
+  wire           tb_ready;
+
+  reg [31 : 0]   expected [0 : NUM_WORDS - 1];
+
+
+  //----------------------------------------------------------------
+  // Device Under Test.
+  //----------------------------------------------------------------
+  zuc256_core_fast dut(
+                       .clk(tb_clk),
+                       .reset_n(tb_reset_n),
+
+                       .init(tb_init),
+                       .next(tb_next),
+                       .key(tb_key),
+                       .iv(tb_iv),
+                       .tag_len(tb_tag_len),
+
+                       .ctx_load(1'b0),
+                       .ctx_i(592'h0),
+                       .ctx_o(),
+
+                       .keystream_z(tb_keystream_z),
+                       .ready(tb_ready)
+                       );
+
+  //----------------------------------------------------------------
+  // clk_gen
+  //
+  // Always running clock generator process.
+  //----------------------------------------------------------------
+  always
+    begin : clk_gen
+      #CLK_HALF_PERIOD;
+      tb_clk = !tb_clk;
+    end // clk_gen
+
+
+  //----------------------------------------------------------------
+  // sys_monitor()
+  //
+  // An always running process that creates a cycle counter and
+  // conditionally displays information about the DUT.
+  //----------------------------------------------------------------
+  always
+    begin : sys_monitor
+      cycle_ctr = cycle_ctr + 1;
+      #(CLK_PERIOD);
+      if (DEBUG)
+        begin
+          dump_dut_state();
+        end
+    end
+
+
+  //----------------------------------------------------------------
+  // dump_dut_state()
+  //
+  // Dump the state of the dump when needed.
+  //----------------------------------------------------------------
+  task dump_dut_state;
+    begin
+      $display("State of DUT");
+      $display("------------");
+      $display("Inputs and outputs:");
+      $display("init = 0x%01x, next = 0x%01x",
+                dut.init, dut.next);
+      $display("key  = 0x%064x ", dut.key);
+      $display("iv   = 0x%032x", dut.iv);
+      $display("");
+      $display("ready  = 0x%01x", dut.ready);
+      $display("keystream_z = 0x%08x", dut.keystream_z);
+      $display("------------");
+      $display("");
+    end
+  endtask // dump_dut_state
+
+
+  //----------------------------------------------------------------
+  // reset_dut()
+  //
+  // Toggle reset to put the DUT into a well known state.
+  //----------------------------------------------------------------
+  task reset_dut;
+    begin
+      $display("*** Toggle reset.");
+      tb_reset_n = 0;
+      #(2 * CLK_PERIOD);
+      tb_reset_n = 1;
+    end
+  endtask // reset_dut
+
+
+  //----------------------------------------------------------------
+  // init_sim()
+  //
+  // Initialize all counters and testbed functionality as well
+  // as setting the DUT inputs to defined values.
+  //----------------------------------------------------------------
+  task init_sim;
+    begin
+      cycle_ctr    = 0;
+      error_ctr    = 0;
+      tc_ctr       = 0;
+
+      tb_clk       = 0;
+      tb_reset_n   = 1;
+      tb_init      = 0;
+      tb_next      = 0;
+      tb_key       = {8{32'h00000000}};
+      tb_iv        = {4{32'h00000000}};
+      tb_tag_len   = 8'h0;
+    end
+  endtask // init_sim
+
+
+  //----------------------------------------------------------------
+  // display_test_result()
+  //
+  // Display the accumulated test results.
+  //----------------------------------------------------------------
+  task display_test_result;
+    begin
+      if (error_ctr == 0)
+        begin
+          $display("*** All %02d test cases completed successfully", tc_ctr);
+        end
+      else
+        begin
+          $display("*** %02d tests completed - %02d test cases did not complete successfully.",
+                   tc_ctr, error_ctr);
+        end
+    end
+  endtask // display_test_result
+
+
+  //----------------------------------------------------------------
+  // wait_ready()
+  //
+  // Wait for the ready flag in the dut to be set.
+  //
+  // Note: It is the callers responsibility to call the function
+  // when the dut is actively processing and will in fact at some
+  // point set the flag.
+  //----------------------------------------------------------------
+  task wait_ready;
+    begin
+      while (!tb_ready)
+        begin
+          #(CLK_PERIOD);
+          if (DUMP_WAIT)
+            begin
+              dump_dut_state();
+            end
+        end
+    end
+  endtask // wait_ready
+
+
+  //----------------------------------------------------------------
+  // keystream_test()
+  //
+  // Initialises the core with key and iv and compares the first
+  // NUM_WORDS keystream words with expected. With stream set, next
+  // is kept high and a word is read every cycle, otherwise every
+  // word gets its own single-cycle next pulse.
+  //----------------------------------------------------------------
+  task keystream_test(input [7 : 0] tc_number, input [255 : 0] key,
+                      input [127 : 0] iv, input stream);
+    begin : keystream_test
+      integer i;
+      reg [31 : 0] got [0 : NUM_WORDS - 1];
+      reg ok;
+
+      tc_ctr = tc_ctr + 1;
+      tb_key = key;
+      tb_iv  = iv;
+
+      tb_init = 1;
+      #(2 * CLK_PERIOD);
+      tb_init = 0;
+      wait_ready();
+
+      $display("Init done");
+
+      ok = 1;
+      if (stream)
+        begin
+          tb_next = 1;
+          for (i = 0 ; i < NUM_WORDS ; i = i + 1)
+            begin
+              #(CLK_PERIOD);
+              if (i == NUM_WORDS - 1)
+                tb_next = 0;
+              got[i] = tb_keystream_z;
+              if (!tb_ready)
+                ok = 0;
+            end
+        end
+      else
+        begin
+          for (i = 0 ; i < NUM_WORDS ; i = i + 1)
+            begin
+              tb_next = 1;
+              #(CLK_PERIOD);
+              tb_next = 0;
+              wait_ready();
+              got[i] = tb_keystream_z;
+            end
+        end
+
+      for (i = 0 ; i < NUM_WORDS ; i = i + 1)
+        begin
+          $display("keystream[%1x] = 0x%08x", i, got[i]);
+          if (got[i] != expected[i])
+            begin
+              $display("Expected: 0x%08x", expected[i]);
+              ok = 0;
+            end
+        end
+
+      if (ok)
+        begin
+          $display("*** TC %0d successful.", tc_number);
+          $display("");
+        end
+      else
+        begin
+          $display("*** ERROR: TC %0d NOT successful.", tc_number);
+          $display("");
+          error_ctr = error_ctr + 1;
+        end
+    end
+  endtask // keystream_test
+
+
+  //----------------------------------------------------------------
+  // zuc256_core_fast_test
+  // The main test functionality.
+  //----------------------------------------------------------------
+  initial
+    begin : zuc256_core_fast_test
+      init_sim();
+      dump_dut_state();
+      reset_dut();
+      dump_dut_state();
+
+      // testvectors #1 from http://www.is.cas.cn/ztzl2016/zouchongzhi/201801/W020230201389233346416.pdf
+      $display("--- Testvectors #1");
+      expected[0]  = 32'h0234e932; expected[1]  = 32'hf0c22292;
+      expected[2]  = 32'h38853662; expected[3]  = 32'haa624def;
+      expected[4]  = 32'h7f99a4c7; expected[5]  = 32'he47a0282;
+      expected[6]  = 32'hb2fde38d; expected[7]  = 32'hf4cb89c5;
+      expected[8]  = 32'h3c17ab18; expected[9]  = 32'h87ef5093;
+      expected[10] = 32'h15c53d45; expected[11] = 32'haf1de542;
+      expected[12] = 32'h7d278dbb; expected[13] = 32'h839af54e;
+      expected[14] = 32'he9375674; expected[15] = 32'h01d3207e;
+      expected[16] = 32'h7f1d6fb3; expected[17] = 32'hb5770472;
+      expected[18] = 32'hc4f98e41; expected[19] = 32'h637788d9;
+
+      keystream_test(8'h01, 256'h0, 128'h0, 1'b0);
+      keystream_test(8'h02, 256'h0, 128'h0, 1'b1);
+
+      // testvectors #2 http://www.is.cas.cn/ztzl2016/zouchongzhi/201801/W020230201389233346416.pdf
+      $display("--- Testvectors #2");
+      expected[0]  = 32'h3985e2af; expected[1]  = 32'h3533d429;
+      expected[2]  = 32'h338580f0; expected[3]  = 32'he0d80ce9;
+      expected[4]  = 32'h0649e5be; expected[5]  = 32'h4961b8a2;
+      expected[6]  = 32'hd23a44d3; expected[7]  = 32'h9c18ce98;
+      expected[8]  = 32'h75f7c424; expected[9]  = 32'h082ecf47;
+      expected[10] = 32'he1d384b8; expected[11] = 32'h91ace320;
+      expected[12] = 32'he46f0b16; expected[13] = 32'hcf903c77;
+      expected[14] = 32'hf097f1a9; expected[15] = 32'h4bcb2079;
+      expected[16] = 32'hfb5c6cc1; expected[17] = 32'h6e9f3e05;
+      expected[18] = 32'h6eff3261; expected[19] = 32'h89ea0373;
+
+      keystream_test(8'h03, {8{32'hffffffff}}, {4{32'hffffffff}}, 1'b0);
+      keystream_test(8'h04, {8{32'hffffffff}}, {4{32'hffffffff}}, 1'b1);
+
+      display_test_result();
+      $display("");
+      $display("*** ZUC-256 fast core simulation done. ***");
+      $finish;
+    end // zuc256_core_fast_test
+endmodule // tb_zuc256_core_fast
+
+//======================================================================
+// EOF tb_zuc256_core_fast.v
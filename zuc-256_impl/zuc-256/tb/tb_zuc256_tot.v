@@ -31,6 +31,10 @@ module tb_zuc256_tot();
   parameter CLK_HALF_PERIOD = 1;
   parameter CLK_PERIOD = 2 * CLK_HALF_PERIOD;
 
+  // Keystream core of the DUT. The test cases are the same for both,
+  // e.g. iverilog -Ptb_zuc256_tot.FAST_CORE=1.
+  parameter FAST_CORE = 0;
+
   //----------------------------------------------------------------
   // Register and Wire declarations.
   //----------------------------------------------------------------
@@ -49,14 +53,18 @@ module tb_zuc256_tot();
   reg [127 : 0]  tb_block_i;
   reg [7 : 0]    tb_i_len;
   reg [7 : 0]    tb_tag_len;
+  reg            tb_burst;
+  reg [4 : 0]    tb_num_words;
+  reg [767 : 0]  tb_words_i;
   wire [127 : 0] tb_block_o;
+  wire [767 : 0] tb_words_o;
   wire           tb_ready;
 
 
   //----------------------------------------------------------------
   // Device Under Test.
   //----------------------------------------------------------------
-  zuc256_tot dut(
+  zuc256_tot #(.FAST_CORE(FAST_CORE)) dut(
                  .clk(tb_clk),
                  .reset_n(tb_reset_n),
 
@@ -69,8 +77,16 @@ module tb_zuc256_tot();
                  .block_i(tb_block_i),
                  .i_len(tb_i_len),
                  .tag_len(tb_tag_len),
+                 .burst(tb_burst),
+                 .num_words(tb_num_words),
+                 .words_i(tb_words_i),
+
+                 .ctx_load(1'b0),
+                 .ctx_i(976'h0),
+                 .ctx_o(),
 
                  .block_o(tb_block_o),
+                 .words_o(tb_words_o),
                  .ready(tb_ready)
                  );
 
@@ -166,6 +182,9 @@ module tb_zuc256_tot();
       tb_block_i   = {4{32'h00000000}};
       tb_tag_len   = 8'h0;
       tb_i_len     = 8'h0;
+      tb_burst     = 0;
+      tb_num_words = 5'h0;
+      tb_words_i   = {24{32'h00000000}};
     end
   endtask // init_sim
 
@@ -955,6 +974,31 @@ module tb_zuc256_tot();
           $display("*** Ciphertext %0d incorrect.", 4);
           error_ctr = error_ctr + 1;
         end
+      
+      // CTR Test 2 again, with all four words in one burst
+      $display("--- Test #2 (burst)");
+      tc_ctr = tc_ctr + 1;
+
+      tb_init = 1;
+      #(2 * CLK_PERIOD);
+      tb_init = 0;
+      wait_ready();
+      $display("Init done");
+      
+      tb_words_i   = {640'h0, 32'h0d0e0f00, 32'h090a0b0c, 32'h05060708, 32'h01020304};
+      tb_num_words = 5'd4;
+
+      tb_burst = 1;
+      #(2 * CLK_PERIOD);
+      tb_burst = 0;
+      wait_ready();
+      if (tb_words_o[127 : 0] == 128'hedd603e9_3a8f8bfc_3035d321_3887e1ab)
+        $display("*** Burst ciphertext correct.");
+      else
+        begin
+          $display("*** Burst ciphertext incorrect: 0x%032x", tb_words_o[127 : 0]);
+          error_ctr = error_ctr + 1;
+        end
 
       display_test_result();
       $display("");
@@ -0,0 +1,532 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company: 
+// Engineer: Ryan De Koninck
+// 
+// Create Date: 
+// Design Name: 
+// Module Name: tb_zuc256_tot_array_wrapper
+// Project Name: 
+// Target Devices: 
+// Tool Versions: 
+// Description: 
+// 
+// Dependencies: 
+// 
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments:
+// 
+//////////////////////////////////////////////////////////////////////////////////
+
+`default_nettype none
+
+module tb_zuc256_tot_array_wrapper();
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  parameter DEBUG            = 0;
+  parameter DUMP_WAIT        = 0;
+    
+  parameter CLK_HALF_PERIOD  = 5;
+  parameter CLK_PERIOD       = 2 * CLK_HALF_PERIOD;
+  parameter RESET_TIME       = 25;
+  
+  parameter NUM_CORES        = 4;
+  
+  // Wrapper commands
+  parameter CMD_READ            = 32'h0;
+  parameter CMD_COMPUTE_INIT    = 32'h1;
+  parameter CMD_COMPUTE_NEXT    = 32'h2;
+  parameter CMD_COMPUTE_FINAL   = 32'h3;
+  parameter CMD_WRITE           = 32'h4;
+  parameter CMD_READ_STATS      = 32'h7;
+  parameter CMD_COMPUTE_BATCH   = 32'hb;
+  
+  //----------------------------------------------------------------
+  // Register and Wire declarations.
+  //----------------------------------------------------------------
+  reg [31 : 0]    cycle_ctr;
+  reg [31 : 0]    error_ctr;
+  reg [31 : 0]    tc_ctr;  
+  reg             tc_correct;
+  
+  reg             tb_clk;
+  reg             tb_resetn;
+  reg  [31 : 0]   tb_arm_to_fpga_cmd;
+  reg             tb_arm_to_fpga_cmd_valid;
+  wire            tb_fpga_to_arm_done;
+  reg             tb_fpga_to_arm_done_read;
+
+  reg             tb_arm_to_fpga_data_valid;
+  wire            tb_arm_to_fpga_data_ready;
+  reg  [1023 : 0] tb_arm_to_fpga_data;
+
+  wire            tb_fpga_to_arm_data_valid;
+  reg             tb_fpga_to_arm_data_ready;
+  wire [1023 : 0] tb_fpga_to_arm_data;
+
+  wire [3 : 0]    tb_leds;
+
+  wire [1023 : 0] tb_input_data;
+  reg  [1023 : 0] tb_output_data;
+  
+  reg  [7 : 0]    tb_lane;
+  reg             tb_enc_auth;
+  reg  [255 : 0]  tb_key;
+  reg  [127 : 0]  tb_iv;
+  reg  [127 : 0]  tb_block_i;
+  reg  [7 : 0]    tb_i_len;
+  reg  [7 : 0]    tb_tag_len;
+  
+  assign tb_input_data = {487'h0, tb_lane, tb_enc_auth, tb_key, tb_iv, 
+                          tb_block_i, tb_i_len, tb_tag_len};
+
+  //----------------------------------------------------------------
+  // Device Under Test.
+  //----------------------------------------------------------------
+  zuc256_tot_array_wrapper #(.NUM_CORES(NUM_CORES)) dut(
+                   .clk                    (tb_clk                    ),
+                   .resetn                 (tb_resetn                 ),
+             
+                   .arm_to_fpga_cmd        (tb_arm_to_fpga_cmd        ),
+                   .arm_to_fpga_cmd_valid  (tb_arm_to_fpga_cmd_valid  ),
+                   .fpga_to_arm_done       (tb_fpga_to_arm_done       ),
+                   .fpga_to_arm_done_read  (tb_fpga_to_arm_done_read  ),
+            
+                   .arm_to_fpga_data_valid (tb_arm_to_fpga_data_valid ),
+                   .arm_to_fpga_data_ready (tb_arm_to_fpga_data_ready ),
+                   .arm_to_fpga_data       (tb_arm_to_fpga_data       ),
+            
+                   .fpga_to_arm_data_valid (tb_fpga_to_arm_data_valid ),
+                   .fpga_to_arm_data_ready (tb_fpga_to_arm_data_ready ),
+                   .fpga_to_arm_data       (tb_fpga_to_arm_data       ),
+            
+                   .leds                   (tb_leds                   )
+                   );
+
+  //----------------------------------------------------------------
+  // clk_gen
+  //
+  // Always running clock generator process.
+  //----------------------------------------------------------------
+  always
+    begin : clk_gen
+      #CLK_HALF_PERIOD;
+      tb_clk = !tb_clk;
+    end // clk_gen
+  
+  //----------------------------------------------------------------
+  // sys_monitor()
+  //
+  // An always running process that creates a cycle counter and
+  // conditionally displays information about the DUT.
+  //----------------------------------------------------------------
+  always
+    begin : sys_monitor
+      cycle_ctr = cycle_ctr + 1;
+      #(CLK_PERIOD);
+      if (DEBUG)
+        begin
+          dump_dut_state();
+        end
+    end
+    
+  //----------------------------------------------------------------
+  // dump_dut_state()
+  //
+  // Dump the state of the dump when needed.
+  //----------------------------------------------------------------
+  task dump_dut_state;
+    begin
+      $display("cycle: 0x%016x", cycle_ctr);
+      $display("State of DUT");
+      $display("------------");
+      $display("ctrl_reg = 0x%01x", dut.zuc256_tot_array_wrapper_ctrl_reg);
+      $display("");
+      $display("lane_busy = 0x%02x", dut.lane_busy_reg);
+      $display("batch_mask = 0x%02x", dut.batch_mask_reg);
+      $display("");
+    end
+  endtask // dump_dut_state
+
+  //----------------------------------------------------------------
+  // reset_dut()
+  //
+  // Toggle reset to put the DUT into a well known state.
+  //----------------------------------------------------------------
+  task reset_dut;
+    begin
+      $display("*** Toggle reset.");
+      tb_resetn = 0;
+      #(RESET_TIME);
+      tb_resetn = 1;
+    end
+  endtask // reset_dut
+
+  //----------------------------------------------------------------
+  // init_sim()
+  //
+  // Initialize all counters and testbed functionality as well
+  // as setting the DUT inputs to defined values.
+  //----------------------------------------------------------------
+  task init_sim;
+    begin
+      cycle_ctr                 = 0;
+      error_ctr                 = 0;
+      tc_ctr                    = 0;
+
+      tb_clk                    = 0;
+      tb_resetn                 = 1;
+      tb_arm_to_fpga_cmd        = {32'h00000000};
+      tb_arm_to_fpga_cmd_valid  = 0;
+      tb_fpga_to_arm_done_read  = 0;
+      tb_arm_to_fpga_data_valid = 0;
+      tb_arm_to_fpga_data       = {32{32'h00000000}};
+      tb_fpga_to_arm_data_ready = 0;
+      
+      tb_output_data            = {32{32'h00000000}};
+      
+      tb_lane                   = 8'h0;
+      tb_enc_auth               = 1'b0;
+      tb_key                    = {8{32'h00000000}};
+      tb_iv                     = {4{32'h00000000}};
+      tb_block_i                = {4{32'h00000000}};
+      tb_i_len                  = 8'h0;
+      tb_tag_len                = 8'h0;
+    end
+  endtask // init_sim
+
+  //----------------------------------------------------------------
+  // inc_tc_ctr
+  //----------------------------------------------------------------
+  task inc_tc_ctr;
+    tc_ctr = tc_ctr + 1;
+  endtask // inc_tc_ctr
+
+
+  //----------------------------------------------------------------
+  // inc_error_ctr
+  //----------------------------------------------------------------
+  task inc_error_ctr;
+    error_ctr = error_ctr + 1;
+  endtask // inc_error_ctr
+
+  //----------------------------------------------------------------
+  // display_test_result()
+  //
+  // Display the accumulated test results.
+  //----------------------------------------------------------------
+  task display_test_result;
+    begin
+      if (error_ctr == 0)
+        begin
+          $display("*** All %02d test cases completed successfully", tc_ctr);
+        end
+      else
+        begin
+          $display("*** %02d tests completed - %02d test cases did not complete successfully.",
+                   tc_ctr, error_ctr);
+        end
+    end
+  endtask // display_test_result
+
+  //----------------------------------------------------------------
+  // send_cmd_to_hw()
+  //
+  // Send the given command to the FPGA.
+  //----------------------------------------------------------------
+  task send_cmd_to_hw(input [31 : 0] command);
+    begin
+        // Assert the command and valid
+        tb_arm_to_fpga_cmd <= command;
+        tb_arm_to_fpga_cmd_valid <= 1'b1;
+        #(CLK_PERIOD);
+        // Desassert the valid signal after one cycle
+        tb_arm_to_fpga_cmd_valid <= 1'b0;
+        #(CLK_PERIOD);
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // send_data_to_hw()
+  //
+  // Send the given data to the FPGA.
+  //----------------------------------------------------------------
+  task send_data_to_hw(input [1023 : 0] data);
+    begin
+        // Assert data and valid
+        tb_arm_to_fpga_data <= data;
+        tb_arm_to_fpga_data_valid <= 1'b1;
+        #(CLK_PERIOD);
+        // Wait till accelerator is ready to read it
+        wait(tb_arm_to_fpga_data_ready == 1'b1);
+        // It is read, do not continue asserting valid
+        tb_arm_to_fpga_data_valid <= 1'b0;
+        #(CLK_PERIOD);
+    end
+  endtask
+
+  //----------------------------------------------------------------
+  // read_data_from_hw()
+  //
+  // Read data from the FPGA.
+  //----------------------------------------------------------------
+  task read_data_from_hw(output [1023:0] odata);
+    begin
+        // Assert ready signal
+        tb_fpga_to_arm_data_ready <= 1'b1;
+        #(CLK_PERIOD);
+        // Wait for valid signal
+        wait(tb_fpga_to_arm_data_valid == 1'b1);
+        // If valid read the output data
+        odata <= tb_fpga_to_arm_data;
+        // Do not continue asserting ready
+        tb_fpga_to_arm_data_ready <= 1'b0;
+        #(CLK_PERIOD);
+    end
+    endtask
+
+  //----------------------------------------------------------------
+  // wait_done()
+  //
+  // Wait until accelerator is done.
+  //----------------------------------------------------------------
+  task wait_done;
+    begin
+      // Wait for accelerator's done
+      wait(tb_fpga_to_arm_done == 1'b1);
+      // Signal that it is read
+      tb_fpga_to_arm_done_read <= 1'b1;
+      #(CLK_PERIOD);
+      // Desassert the signal after one cycle
+      tb_fpga_to_arm_done_read <= 1'b0;
+      #(CLK_PERIOD);
+    end
+  endtask
+
+
+  //----------------------------------------------------------------
+  // load_and_init()
+  //
+  // Load inputs, initialize, and wait until done.
+  //----------------------------------------------------------------
+  task load_and_init(input [1023 : 0] in);
+    begin
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(in);
+      wait_done();
+      
+      $display("Sending COMPUTE_INIT command");
+      send_cmd_to_hw(CMD_COMPUTE_INIT);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // load_and_next()
+  //
+  // Load inputs, process next block, and wait until done.
+  //----------------------------------------------------------------
+  task load_and_next(input  [1023 : 0] in,
+                     output [1023 : 0] out);
+    begin
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(in);
+      wait_done();
+        
+      $display("Sending COMPUTE_NEXT command");
+      send_cmd_to_hw(CMD_COMPUTE_NEXT);
+      wait_done();
+        
+      $display("Sending WRITE command");
+      send_cmd_to_hw(CMD_WRITE);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // batch()
+  //
+  // Send a batch frame, process the blocks of all its lanes, and read
+  // back their results in a single command.
+  //----------------------------------------------------------------
+  task batch(input  [1023 : 0] in,
+             output [1023 : 0] out);
+    begin
+      $display("Sending COMPUTE_BATCH command");
+      send_cmd_to_hw(CMD_COMPUTE_BATCH);
+      send_data_to_hw(in);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // batch_add()
+  //
+  // Add a block for the given lane to a batch frame.
+  //----------------------------------------------------------------
+  task batch_add(inout [1023 : 0] frame,
+                 input [2 : 0]    lane,
+                 input [127 : 0]  block,
+                 input            last,
+                 input [7 : 0]    i_len);
+    begin
+      frame[128 * lane +: 128]   = block;
+      frame[896 + lane]          = 1'b1;
+      frame[904 + lane]          = last;
+      frame[912 + 8 * lane +: 8] = i_len;
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // batch_test()
+  //
+  // CTR Test #2 on lane 1 and the MAC of Testvectors #4 on lane 2,
+  // both initialized with single commands. The blocks of both lanes
+  // then go in batch frames, and the MAC is finalized in the last one.
+  //----------------------------------------------------------------
+  task batch_test;
+    begin : batch_test
+      reg [31 : 0]   words [0 : 3];
+      reg [31 : 0]   expected [0 : 3];
+      reg [1023 : 0] frame;
+      integer i;
+      reg ok;
+
+      $display("--- Batch: CTR Test #2 and Testvectors #4");
+      tc_ctr = tc_ctr + 1;
+      ok = 1;
+
+      words[0]    = 32'h01020304;
+      words[1]    = 32'h05060708;
+      words[2]    = 32'h090a0b0c;
+      words[3]    = 32'h0d0e0f00;
+      expected[0] = 32'h3887e1ab;
+      expected[1] = 32'h3035d321;
+      expected[2] = 32'h3a8f8bfc;
+      expected[3] = 32'hedd603e9;
+
+      tb_key      = 256'hffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff;
+      tb_iv       = 128'hffffffffffffffffffffffffffffffff;
+
+      tb_lane     = 8'h1;
+      tb_enc_auth = 1'b0;
+      tb_block_i  = 128'h0;
+      tb_i_len    = 8'h0;
+      tb_tag_len  = 8'h0;
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+
+      tb_lane     = 8'h2;
+      tb_enc_auth = 1'b1;
+      tb_block_i  = 128'h11111111111111111111111111111111;
+      tb_i_len    = 8'd32;
+      tb_tag_len  = 8'd128;
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+
+      for (i = 0 ; i < 32 ; i = i + 1)
+        begin
+          frame = 1024'h0;
+          if (i < 4)
+            batch_add(frame, 3'h1, {96'h0, words[i]}, 1'b0, 8'h0);
+          if (i == 31)
+            batch_add(frame, 3'h2, 128'h11111111000000000000000000000000, 1'b0, 8'd32);
+          else
+            batch_add(frame, 3'h2, 128'h11111111111111111111111111111111, 1'b0, 8'd32);
+          batch(frame, tb_output_data);
+          if ((i < 4) && (tb_output_data[128 +: 32] != expected[i]))
+            begin
+              $display("*** Ciphertext %0d - Expected: 0x%08x, got: 0x%08x", i + 1, expected[i], tb_output_data[128 +: 32]);
+              ok = 0;
+            end
+          if (tb_output_data[903 : 896] != (i < 4 ? 8'h06 : 8'h04))
+            begin
+              $display("*** Batch %0d - Wrong lanes: 0x%02x", i, tb_output_data[903 : 896]);
+              ok = 0;
+            end
+        end
+
+      frame = 1024'h0;
+      batch_add(frame, 3'h2, 128'h0, 1'b1, 8'd32);
+      batch(frame, tb_output_data);
+
+      if (tb_output_data[256 +: 128] != 128'hdd3a4017_357803a5_1c3fb9a5_7a96feda)
+        begin
+          $display("*** Tag - Expected: 0xdd3a4017_357803a5_1c3fb9a5_7a96feda, got: 0x%032x",
+                   tb_output_data[256 +: 128]);
+          ok = 0;
+        end
+
+      if (ok)
+        begin
+          $display("*** Batch successful.");
+          $display("");
+        end
+      else
+        begin
+          $display("*** ERROR: Batch NOT successful.");
+          $display("");
+          error_ctr = error_ctr + 1;
+        end
+    end
+  endtask // batch_test
+
+  //----------------------------------------------------------------
+  // zuc256_tot_array_wrapper_test
+  //
+  // The main test functionality.
+  //----------------------------------------------------------------
+  initial
+    begin : zuc256_tot_array_wrapper_test
+      reg [127 : 0]  expected_final;
+      integer i;
+      
+      $display("*** Testbench for zuc256_tot_ARRAY_WRAPPER started ***");
+      $display("");
+
+      init_sim();
+      reset_dut();
+      
+      // CTR Test 2 on the last lane, with the single commands
+      $display("--- CTR Test #2 (lane %0d)", NUM_CORES - 1);
+      tc_ctr = tc_ctr + 1;
+      tb_lane = NUM_CORES - 1;
+      tb_enc_auth = 1'b0;
+      tb_key = 256'hffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff;
+      tb_iv = 128'hffffffffffffffffffffffffffffffff;
+      tb_block_i = 128'h0;
+      tb_i_len = 8'h0;
+      tb_tag_len = 8'h0;
+
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+      $display("Init done");
+      
+      tb_block_i = {96'h0, 32'h01020304};
+      expected_final = {96'h0, 32'h3887e1ab};
+
+      #(CLK_PERIOD);
+      load_and_next(tb_input_data, tb_output_data);
+      
+      if (tb_output_data[127 : 0] == expected_final)
+        $display("*** Ciphertext %0d correct.", 1);
+      else
+        begin
+          $display("*** Ciphertext %0d incorrect.", 1);
+          error_ctr = error_ctr + 1;
+        end
+
+      batch_test();
+
+      display_test_result();
+      $display("*** zuc256_tot_ARRAY_WRAPPER simulation done. ***");
+      $finish;
+    end // zuc256_tot_array_wrapper_test
+    
+endmodule // tb_zuc256_tot_array_wrapper
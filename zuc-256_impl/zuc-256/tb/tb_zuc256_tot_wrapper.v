@@ -31,6 +31,10 @@ module tb_zuc256_tot_wrapper();
   parameter CLK_HALF_PERIOD  = 5;
   parameter CLK_PERIOD       = 2 * CLK_HALF_PERIOD;
   parameter RESET_TIME       = 25;
+
+  // Keystream core of the DUT. The test cases are the same for both,
+  // e.g. iverilog -Ptb_zuc256_tot_wrapper.FAST_CORE=1.
+  parameter FAST_CORE        = 0;
   
   // Wrapper commands
   parameter CMD_READ            = 32'h0;
@@ -38,6 +42,12 @@ module tb_zuc256_tot_wrapper();
   parameter CMD_COMPUTE_NEXT    = 32'h2;
   parameter CMD_COMPUTE_FINAL   = 32'h3;
   parameter CMD_WRITE           = 32'h4;
+  parameter CMD_COMPUTE_ENCRYPT = 32'h5;
+  parameter CMD_WRITE_PREV      = 32'hc;
+  parameter CMD_READ_STATS      = 32'h7;
+  parameter CMD_READ_STATS_HI   = 32'hf;
+  parameter CMD_RESTORE_CTX     = 32'h8;
+  parameter CMD_SAVE_CTX        = 32'h9;
   
   //----------------------------------------------------------------
   // Register and Wire declarations.
@@ -80,7 +90,7 @@ module tb_zuc256_tot_wrapper();
   //----------------------------------------------------------------
   // Device Under Test.
   //----------------------------------------------------------------
-  zuc256_tot_wrapper dut(
+  zuc256_tot_wrapper #(.FAST_CORE(FAST_CORE)) dut(
                    .clk                    (tb_clk                    ),
                    .resetn                 (tb_resetn                 ),
              
@@ -342,6 +352,48 @@ module tb_zuc256_tot_wrapper();
     end
   endtask
   
+  //----------------------------------------------------------------
+  // load_and_next_pipelined()
+  //
+  // Load inputs and start the next block, then fetch the result of
+  // the previous block while the core is busy.
+  //----------------------------------------------------------------
+  task load_and_next_pipelined(input  [1023 : 0] in,
+                               output [1023 : 0] prev_out);
+    begin
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(in);
+      wait_done();
+        
+      $display("Sending COMPUTE_NEXT command");
+      send_cmd_to_hw(CMD_COMPUTE_NEXT);
+      wait_done();
+        
+      $display("Sending WRITE_PREV command");
+      send_cmd_to_hw(CMD_WRITE_PREV);
+      read_data_from_hw(prev_out);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // load_and_encrypt()
+  //
+  // Send an encrypt frame, encrypt all of its words, and read back
+  // the resulting words in a single command.
+  //----------------------------------------------------------------
+  task load_and_encrypt(input  [1023 : 0] in,
+                        output [1023 : 0] out);
+    begin
+      $display("Sending COMPUTE_ENCRYPT command");
+      send_cmd_to_hw(CMD_COMPUTE_ENCRYPT);
+      send_data_to_hw(in);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+
   //----------------------------------------------------------------
   // finalize()
   //
@@ -360,7 +412,247 @@ module tb_zuc256_tot_wrapper();
     end
   endtask
   
+  //----------------------------------------------------------------
+  // ctx_frame()
+  //
+  // The normal input frame for the given context.
+  //----------------------------------------------------------------
+  function [1023 : 0] ctx_frame(input [1023 : 0] in,
+                                input [7 : 0]    ctx_id);
+    begin
+      ctx_frame = {487'h0, ctx_id, in[528 : 0]};
+    end
+  endfunction
+  
+  //----------------------------------------------------------------
+  // save_ctx()
+  //
+  // Fetch context ctx_id from the accelerator.
+  //----------------------------------------------------------------
+  task save_ctx(input [7 : 0] ctx_id, output [1023 : 0] out);
+    begin
+      $display("Sending READ command");
+      send_cmd_to_hw(CMD_READ);
+      send_data_to_hw(ctx_frame(1024'h0, ctx_id));
+      wait_done();
+      
+      $display("Sending SAVE_CTX command");
+      send_cmd_to_hw(CMD_SAVE_CTX);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+  
+  //----------------------------------------------------------------
+  // restore_ctx()
+  //
+  // Load a saved context into context ctx_id.
+  //----------------------------------------------------------------
+  task restore_ctx(input [7 : 0] ctx_id, input [1023 : 0] in);
+    begin
+      $display("Sending RESTORE_CTX command");
+      send_cmd_to_hw(CMD_RESTORE_CTX);
+      send_data_to_hw({ctx_id, in[1015 : 0]});
+      wait_done();
+    end
+  endtask
   
+  //----------------------------------------------------------------
+  // ctx_interleave_test()
+  //
+  // CTR Test #2 in context 1 and the MAC of Testvectors #4 in
+  // context 2, a word or block of each in turn. After four blocks
+  // the MAC is saved to the host and finished in context 3.
+  //----------------------------------------------------------------
+  task ctx_interleave_test;
+    begin : ctx_interleave_test
+      reg [31 : 0]   words [0 : 3];
+      reg [31 : 0]   expected [0 : 3];
+      reg [1023 : 0] ctr_frame;
+      reg [1023 : 0] mac_frame;
+      reg [1023 : 0] saved;
+      integer i;
+      reg ok;
+
+      $display("--- Interleaved contexts");
+      tc_ctr = tc_ctr + 1;
+      ok = 1;
+
+      words[0]    = 32'h01020304;
+      words[1]    = 32'h05060708;
+      words[2]    = 32'h090a0b0c;
+      words[3]    = 32'h0d0e0f00;
+      expected[0] = 32'h3887e1ab;
+      expected[1] = 32'h3035d321;
+      expected[2] = 32'h3a8f8bfc;
+      expected[3] = 32'hedd603e9;
+
+      tb_key     = 256'hffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff;
+      tb_iv      = 128'hffffffffffffffffffffffffffffffff;
+
+      tb_enc_auth = 1'b0;
+      tb_block_i  = 128'h0;
+      tb_i_len    = 8'h0;
+      tb_tag_len  = 8'h0;
+      #(CLK_PERIOD);
+      ctr_frame = ctx_frame(tb_input_data, 8'h1);
+      load_and_init(ctr_frame);
+
+      tb_enc_auth = 1'b1;
+      tb_block_i  = 128'h11111111111111111111111111111111;
+      tb_i_len    = 8'd32;
+      tb_tag_len  = 8'd128;
+      #(CLK_PERIOD);
+      mac_frame = ctx_frame(tb_input_data, 8'h2);
+      load_and_init(mac_frame);
+
+      // An encrypt frame in the MAC context is dropped and returns zeros
+      load_and_encrypt({251'h0, 5'd4, 640'h0, 128'hffffffffffffffffffffffffffffffff}, tb_output_data);
+      if (tb_output_data != 1024'h0)
+        begin
+          $display("*** Encrypt in MAC context - Expected all zeros, got: 0x%0192x", tb_output_data[767 : 0]);
+          ok = 0;
+        end
+
+      for (i = 0 ; i < 4 ; i = i + 1)
+        begin
+          ctr_frame[47 : 16] = words[i];
+          load_and_next(ctr_frame, tb_output_data);
+          if (tb_output_data[31 : 0] != expected[i])
+            begin
+              $display("*** Ciphertext %0d - Expected: 0x%08x, got: 0x%08x", i + 1, expected[i], tb_output_data[31 : 0]);
+              ok = 0;
+            end
+          load_and_next(mac_frame, tb_output_data);
+        end
+
+      // Move the MAC to the host and on to context 3
+      save_ctx(8'h2, saved);
+      restore_ctx(8'h3, saved);
+      mac_frame = ctx_frame(mac_frame, 8'h3);
+
+      for (i = 4 ; i < 32 ; i = i + 1)
+        begin
+          if (i == 31)
+            mac_frame[143 : 16] = 128'h11111111000000000000000000000000;
+          load_and_next(mac_frame, tb_output_data);
+        end
+      finalize(tb_output_data);
+
+      if (tb_output_data[127 : 0] != 128'hdd3a4017_357803a5_1c3fb9a5_7a96feda)
+        begin
+          $display("*** Tag - Expected: 0xdd3a4017_357803a5_1c3fb9a5_7a96feda, got: 0x%032x",
+                   tb_output_data[127 : 0]);
+          ok = 0;
+        end
+
+      if (ok)
+        begin
+          $display("*** Interleaved contexts successful.");
+          $display("");
+        end
+      else
+        begin
+          $display("*** ERROR: Interleaved contexts NOT successful.");
+          $display("");
+          error_ctr = error_ctr + 1;
+        end
+    end
+  endtask // ctx_interleave_test
+  
+  //----------------------------------------------------------------
+  // read_stats()
+  //
+  // Read the cycle counters of the wrapper.
+  //----------------------------------------------------------------
+  task read_stats(output [1023 : 0] out);
+    begin
+      $display("Sending READ_STATS command");
+      send_cmd_to_hw(CMD_READ_STATS);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+
+  //----------------------------------------------------------------
+  // read_stats_hi()
+  //
+  // Read the counters of the commands 8 to 15.
+  //----------------------------------------------------------------
+  task read_stats_hi(output [1023 : 0] out);
+    begin
+      $display("Sending READ_STATS_HI command");
+      send_cmd_to_hw(CMD_READ_STATS_HI);
+      read_data_from_hw(out);
+      wait_done();
+    end
+  endtask
+
+  //----------------------------------------------------------------
+  // test_stats
+  //
+  // Check that the cycle counters account for one init sequence, and
+  // that saving a context is counted on its own command code.
+  // Word i of the stats frame holds counter i, see wrapper_stats.v.
+  //----------------------------------------------------------------
+  task test_stats;
+    begin : test_stats
+      reg [1023 : 0] stats_before, stats_after;
+      reg [1023 : 0] stats_hi_before, stats_hi_after;
+      reg [1023 : 0] ctx_frame_out;
+
+      $display("*** Statistics BEGIN");
+      inc_tc_ctr();
+
+      read_stats(stats_before);
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+      #(CLK_PERIOD);
+      read_stats(stats_after);
+
+      // Command counters: READ, COMPUTE_INIT and READ_STATS once each
+      if ((stats_after[(24 + CMD_READ) * 32 +: 32] - stats_before[(24 + CMD_READ) * 32 +: 32] != 32'd1) ||
+          (stats_after[(24 + CMD_COMPUTE_INIT) * 32 +: 32] - stats_before[(24 + CMD_COMPUTE_INIT) * 32 +: 32] != 32'd1) ||
+          (stats_after[(24 + CMD_READ_STATS) * 32 +: 32] - stats_before[(24 + CMD_READ_STATS) * 32 +: 32] != 32'd1))
+        begin
+          $display("Command counters incorrect - got 0x%064x", stats_after[1023 : 768]);
+          inc_error_ctr();
+        end
+      else
+        $display("Command counters correct!");
+
+      // The init command and the idle state both took cycles
+      if ((stats_after[(16 + CMD_COMPUTE_INIT) * 32 +: 32] == stats_before[(16 + CMD_COMPUTE_INIT) * 32 +: 32]) ||
+          (stats_after[31 : 0] == stats_before[31 : 0]))
+        begin
+          $display("Cycle counters incorrect - got 0x%0128x", stats_after[511 : 0]);
+          inc_error_ctr();
+        end
+      else
+        $display("Cycle counters correct!");
+
+      // SAVE_CTX only move their own counters on the upper page
+      read_stats(stats_before);
+      read_stats_hi(stats_hi_before);
+      save_ctx(8'h1, ctx_frame_out);
+      read_stats(stats_after);
+      read_stats_hi(stats_hi_after);
+
+      if ((stats_hi_after[(24 + CMD_SAVE_CTX - 8) * 32 +: 32] - stats_hi_before[(24 + CMD_SAVE_CTX - 8) * 32 +: 32] != 32'd1) ||
+          (stats_after[(24 + CMD_COMPUTE_INIT) * 32 +: 32] != stats_before[(24 + CMD_COMPUTE_INIT) * 32 +: 32]) ||
+          (stats_hi_after[511 : 0] != 512'h0))
+        begin
+          $display("Context command counters incorrect - got 0x%064x", stats_hi_after[1023 : 768]);
+          inc_error_ctr();
+        end
+      else
+        $display("Context command counters correct!");
+
+      $display("*** Statistics END");
+      $display("");
+    end
+  endtask // test_stats
+
   //----------------------------------------------------------------
   // zuc256_tot_wrapper_test
   //
@@ -368,7 +660,8 @@ module tb_zuc256_tot_wrapper();
   //----------------------------------------------------------------
   initial
     begin : zuc256_tot_wrapper_test
-      reg [127 : 0] expected_final;
+      reg [127 : 0]  expected_final;
+      reg [1023 : 0] encrypt_frame;
       integer i;
       
       $display("*** Testbench for zuc256_tot_WRAPPER started ***");
@@ -442,6 +735,29 @@ module tb_zuc256_tot_wrapper();
           error_ctr = error_ctr + 1;
         end
       
+      // CTR Test 2 again, with all four words in one encrypt frame
+      $display("--- CTR Test #2 (encrypt frame)");
+      tc_ctr = tc_ctr + 1;
+      tb_block_i = 128'h0;
+
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+      $display("Init done");
+      
+      encrypt_frame  = {251'h0, 5'd4, 640'h0, 32'h0d0e0f00, 32'h090a0b0c, 32'h05060708, 32'h01020304};
+      expected_final = 128'hedd603e9_3a8f8bfc_3035d321_3887e1ab;
+      
+      #(CLK_PERIOD);
+      load_and_encrypt(encrypt_frame, tb_output_data);
+      
+      if (tb_output_data[127 : 0] == expected_final)
+        $display("*** Ciphertext words correct.");
+      else
+        begin
+          $display("*** Ciphertext words incorrect.");
+          error_ctr = error_ctr + 1;
+        end
+      
       $display("--- Testvectors #4: 128 bits");
       tc_ctr = tc_ctr + 1;
       tb_enc_auth = 1'b1;
@@ -488,6 +804,45 @@ module tb_zuc256_tot_wrapper();
           error_ctr = error_ctr + 1;
         end
 
+      $display("--- Testvectors #4: 128 bits (pipelined)");
+      tc_ctr = tc_ctr + 1;
+      tb_block_i = 128'h11111111111111111111111111111111;
+
+      #(CLK_PERIOD);
+      load_and_init(tb_input_data);
+
+      $display("Init done");
+
+      for (i = 0 ; i < 32 ; i = i + 1)
+        begin
+          if (i == 31)
+            tb_block_i = 128'h11111111000000000000000000000000;
+          #(CLK_PERIOD);
+          load_and_next_pipelined(tb_input_data, tb_output_data);
+        end
+        
+      #(CLK_PERIOD);
+      finalize(tb_output_data);
+
+      if (tb_output_data[127 : 0] == expected_final)
+        begin
+          $display("*** TC %0d successful.", 5);
+          $display("");
+        end
+      else
+        begin
+          $display("*** ERROR: TC %0d NOT successful.", 5);
+          $display("Expected: 0x%08x", expected_final);
+          $display("Got:      0x%08x", tb_output_data[127 : 0]);
+          $display("");
+
+          error_ctr = error_ctr + 1;
+        end
+
+      ctx_interleave_test();
+
+      test_stats();
+
       display_test_result();
       $display("*** zuc256_tot_WRAPPER simulation done. ***");
       $finish;
@@ -1,6 +1,8 @@
 #include "common.h"
 #include "platform/interface.h"
 
+#include <string.h>
+
 #include "hw_accelerator.h"
 
 // Note that these tree CMDs are same as
@@ -10,6 +12,13 @@
 #define CMD_COMPUTE_NEXT    2
 #define CMD_COMPUTE_FINAL   3
 #define CMD_WRITE           4
+#define CMD_COMPUTE_ENCRYPT 5
+#define CMD_WRITE_PREV      (CMD_WRITE | 8)
+#define CMD_READ_STATS      7
+#define CMD_READ_STATS_HI   (CMD_READ_STATS | 8)
+#define CMD_RESTORE_CTX     (CMD_READ | 8)
+#define CMD_SAVE_CTX        9
+#define CMD_COMPUTE_BATCH   11  // zuc256_tot_array_wrapper.v only
 
 void init_HW_access(void)
 {
@@ -64,6 +73,39 @@ void zuc256_tot_HW_next(uint32_t *input, uint32_t *output)
 	while(!is_done());
 }
 
+// Runs zuc256_tot_HW_next() on nblocks input frames of 32 words. The wrapper
+// computes in the background, so the upload of block i and the download of
+// block i-1 overlap the computation of block i-1 and block i respectively.
+void zuc256_tot_HW_next_pipelined(uint32_t *input, uint32_t *output, int nblocks)
+{
+	int i;
+
+	for (i = 0; i < nblocks; i++) {
+		//// --- Send the read command and transfer input data to FPGA
+		send_cmd_to_hw(CMD_READ);
+		send_data_to_hw(input + 32*i);
+		while(!is_done());
+
+		//// --- Start the compute operation, once the previous block is done
+		send_cmd_to_hw(CMD_COMPUTE_NEXT);
+		while(!is_done());
+
+		//// --- Transfer the output data of the previous block from FPGA
+		if (i > 0) {
+			send_cmd_to_hw(CMD_WRITE_PREV);
+			read_data_from_hw(output + 32*(i-1));
+			while(!is_done());
+		}
+	}
+
+	//// --- Wait for the last block and transfer its output data from FPGA
+	if (nblocks > 0) {
+		send_cmd_to_hw(CMD_WRITE);
+		read_data_from_hw(output + 32*(nblocks-1));
+		while(!is_done());
+	}
+}
+
 void zuc256_tot_HW_finalize(uint32_t *output)
 {
 	//// --- Perform the compute operation
@@ -75,3 +117,215 @@ void zuc256_tot_HW_finalize(uint32_t *output)
 	read_data_from_hw(output);
 	while(!is_done());
 }
+
+// Load key and IV from the input frame (with enc_auth = 0) and initialize
+// the keystream generator. The message is then passed to zuc256_tot_HW_encrypt().
+void zuc256_tot_HW_start(zuc256_ctx_t *ctx, uint32_t *input)
+{
+	ctx->ks_len = 0;
+	zuc256_tot_HW_init(input);
+}
+
+// Encrypt/decrypt nbytes, ENCRYPT_WORDS keystream words per command.
+// Bytes are taken most significant byte first from each keystream word,
+// so consecutive calls may split the message at any byte.
+void zuc256_tot_HW_encrypt(zuc256_ctx_t *ctx, const uint8_t *in, uint8_t *out, uint32_t nbytes)
+{
+	uint32_t chunk, nwords, i;
+	uint8_t b;
+
+	// Use up the keystream of the last, partially used word first
+	while ((ctx->ks_len > 0) && (nbytes > 0)) {
+		*out++ = *in++ ^ ctx->ks[4 - ctx->ks_len];
+		ctx->ks_len--;
+		nbytes--;
+	}
+
+	while (nbytes > 0) {
+		chunk = (nbytes > 4*ENCRYPT_WORDS) ? 4*ENCRYPT_WORDS : nbytes;
+		nwords = (chunk + 3) >> 2;
+
+		memset(ctx->frame_in, 0, sizeof(ctx->frame_in));
+		for (i = 0; i < chunk; i++)
+			ctx->frame_in[i >> 2] |= (uint32_t) in[i] << (24 - 8*(i & 3));
+		ctx->frame_in[24] = nwords;
+
+		//// --- Send the encrypt command, transfer the words and read back the result
+		send_cmd_to_hw(CMD_COMPUTE_ENCRYPT);
+		send_data_to_hw(ctx->frame_in);
+		read_data_from_hw(ctx->frame_out);
+		while(!is_done());
+
+		// The zero padding of the last word returns its unused keystream bytes
+		for (i = 0; i < 4*nwords; i++) {
+			b = ctx->frame_out[i >> 2] >> (24 - 8*(i & 3));
+			if (i < chunk) out[i] = b;
+			else ctx->ks[i & 3] = b;
+		}
+		ctx->ks_len = 4*nwords - chunk;
+
+		in += chunk;
+		out += chunk;
+		nbytes -= chunk;
+	}
+}
+
+// Contexts in use, context 0 is never handed out
+static uint32_t ctx_used = 1;
+
+// Reserves an on-chip message context. Returns -1 if all are in use.
+int zuc256_tot_HW_ctx_alloc(zuc256_ctx_handle_t *ctx)
+{
+	uint32_t id;
+
+	for (id = 1; id < ZUC256_TOT_CTX_SLOTS; id++) {
+		if (!(ctx_used & (1u << id))) {
+			ctx_used |= 1u << id;
+			ctx->id = id;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+void zuc256_tot_HW_ctx_free(zuc256_ctx_handle_t *ctx)
+{
+	ctx_used &= ~(1u << ctx->id);
+	ctx->id = 0;
+}
+
+// Makes input a frame of the message in ctx. The ctx_id is in bits 536..529
+// of the input frame. The wrapper switches contexts by itself, so messages
+// in different contexts can be interleaved frame by frame. Encrypt frames
+// have no ctx_id: zuc256_tot_HW_encrypt() continues the context of the last
+// init, next or finalize, which must be a CTR context (in a MAC context the
+// wrapper returns all zeros).
+void zuc256_tot_HW_set_ctx(const zuc256_ctx_handle_t *ctx, uint32_t *input)
+{
+	input[16] = (input[16] & ~(0xffu << 17)) | ((ctx->id & 0xffu) << 17);
+}
+
+// Copies the state of the message in ctx to state, 32 words. The message
+// can then be continued in any context with zuc256_tot_HW_ctx_restore().
+void zuc256_tot_HW_ctx_save(const zuc256_ctx_handle_t *ctx, uint32_t *state)
+{
+	uint32_t frame[32] = {0};
+
+	zuc256_tot_HW_set_ctx(ctx, frame);
+
+	//// --- Select the context
+	send_cmd_to_hw(CMD_READ);
+	send_data_to_hw(frame);
+	while(!is_done());
+
+	//// --- Transfer the context from FPGA
+	send_cmd_to_hw(CMD_SAVE_CTX);
+	read_data_from_hw(state);
+	while(!is_done());
+}
+
+// Loads a state saved by zuc256_tot_HW_ctx_save() into ctx. The ctx_id is in
+// the top byte of the state.
+void zuc256_tot_HW_ctx_restore(const zuc256_ctx_handle_t *ctx, uint32_t *state)
+{
+	state[31] = (state[31] & 0x00ffffffu) | ((ctx->id & 0xffu) << 24);
+
+	//// --- Send the restore command and transfer the context to FPGA
+	send_cmd_to_hw(CMD_RESTORE_CTX);
+	send_data_to_hw(state);
+	while(!is_done());
+}
+
+// Batch frames of zuc256_tot_array_wrapper.v, where the ctx_id of a frame
+// is the core (lane) it runs on. A batch frame holds one block per lane in
+// words 4*lane to 4*lane+3, the lanes with a block in bits 903..896, the
+// lanes for which it is the final block in bits 911..904 and the i_len of
+// every lane in bits 912+8*lane+7..912+8*lane.
+void zuc256_tot_HW_batch_clear(uint32_t *frame)
+{
+	memset(frame, 0, 32*sizeof(uint32_t));
+}
+
+// Adds block to frame for lane. Returns -1 if the array has no such lane.
+int zuc256_tot_HW_batch_add(uint32_t *frame, int lane, const uint32_t *block, int final, uint8_t i_len)
+{
+	uint32_t bit;
+
+	if (lane < 0 || lane >= ZUC256_TOT_BATCH_LANES) return -1;
+	bit = 912 + 8*lane;
+
+	memcpy(&frame[4*lane], block, 4*sizeof(uint32_t));
+	frame[28] |= 1u << lane;
+	if (final) frame[28] |= 1u << (8+lane);
+	frame[bit/32] = (frame[bit/32] & ~(0xffu << (bit%32))) | ((uint32_t)i_len << (bit%32));
+	return 0;
+}
+
+// Runs the blocks of all lanes in frame in parallel. The result of a lane
+// is in the words of its block in output, the lanes in bits 903..896.
+void zuc256_tot_HW_batch(uint32_t *frame, uint32_t *output)
+{
+	//// --- Send the batch command and transfer input data to FPGA
+	send_cmd_to_hw(CMD_COMPUTE_BATCH);
+	send_data_to_hw(frame);
+
+	//// --- Transfer output data from FPGA once all lanes are done
+	read_data_from_hw(output);
+	while(!is_done());
+}
+
+// Descriptor ring in front of the wrapper, see hw_queue.h. The frames of
+// the descriptors are read from and written to mem.
+void zuc256_tot_HW_queue_init(hw_queue_t *q, uint32_t *mem)
+{
+	hw_queue_init(q, mem, CMD_READ, CMD_WRITE);
+}
+
+void zuc256_tot_HW_read_stats(hw_stats_t *stats)
+{
+	uint32_t frame[32];
+	int i;
+
+	//// --- Send read stats command and transfer the counters from FPGA
+	send_cmd_to_hw(CMD_READ_STATS);
+	read_data_from_hw(frame);
+	while(!is_done());
+
+	for (i = 0; i < 16; i++) stats->state_cycles[i] = frame[i];
+	for (i = 0; i < 8; i++) {
+		stats->cmd_cycles[i] = frame[16+i];
+		stats->cmd_count[i]  = frame[24+i];
+	}
+
+	//// --- Same for the counters of the commands 8 to 15
+	send_cmd_to_hw(CMD_READ_STATS_HI);
+	read_data_from_hw(frame);
+	while(!is_done());
+
+	for (i = 0; i < 8; i++) {
+		stats->cmd_cycles[8+i] = frame[16+i];
+		stats->cmd_count[8+i]  = frame[24+i];
+	}
+}
+
+// Names of the wrapper commands, indexed by the command code
+static const char *cmd_names[16] = {
+	"READ", "COMPUTE_INIT", "COMPUTE_NEXT", "COMPUTE_FINAL",
+	"WRITE", "COMPUTE_ENCRYPT", NULL, "READ_STATS",
+	"RESTORE_CTX", "SAVE_CTX", NULL, "COMPUTE_BATCH",
+	"WRITE_PREV", NULL, NULL, "READ_STATS_HI"
+};
+
+void print_HW_stats(hw_stats_t *stats)
+{
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		if (stats->state_cycles[i]) xil_printf("    state %d: %u cycles\n\r", i, stats->state_cycles[i]);
+	}
+	for (i = 0; i < 16; i++) {
+		if (!stats->cmd_count[i]) continue;
+		if (cmd_names[i]) xil_printf("    %s: %u times, %u cycles\n\r", cmd_names[i], stats->cmd_count[i], stats->cmd_cycles[i]);
+		else xil_printf("    cmd %d: %u times, %u cycles\n\r", i, stats->cmd_count[i], stats->cmd_cycles[i]);
+	}
+}
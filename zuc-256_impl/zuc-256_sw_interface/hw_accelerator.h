@@ -1,11 +1,69 @@
 #ifndef _HW_ACCEL_H_
 #define _HW_ACCEL_H_
 
+#include "hw_queue.h"
+
+// Maximum number of 32-bit words in one encrypt frame,
+// same as BURST_WORDS in zuc256_ctr_ext.v
+#define ENCRYPT_WORDS 24
+
+// State of one message that is encrypted by the accelerator
+typedef struct {
+	uint8_t  ks[4];         // Keystream bytes left over from the last word
+	uint32_t ks_len;
+	uint32_t frame_in[32];
+	uint32_t frame_out[32];
+} zuc256_ctx_t;
+
+// Number of on-chip message contexts, 2**CTX_BITS in zuc256_tot_wrapper.v.
+// Context 0 is used by the frames that don't name a context.
+#define ZUC256_TOT_CTX_SLOTS 4
+
+// On-chip message context, see zuc256_tot_HW_ctx_alloc()
+typedef struct {
+	uint32_t id;
+} zuc256_ctx_handle_t;
+
+// Lanes of zuc256_tot_array_wrapper.v, its NUM_CORES. A lane is named by
+// the ctx_id of a frame, lane 0 also by the frames that don't name a
+// context. zuc256_tot_HW_batch_add() takes the lane itself,
+// 0..ZUC256_TOT_BATCH_LANES-1.
+#define ZUC256_TOT_BATCH_LANES 4
+
+// Descriptor opcodes for hw_submit(), the compute commands of the wrapper
+#define ZUC256_TOT_HW_OP_INIT  1  // CMD_COMPUTE_INIT
+#define ZUC256_TOT_HW_OP_NEXT  2  // CMD_COMPUTE_NEXT
+#define ZUC256_TOT_HW_OP_FINAL 3  // CMD_COMPUTE_FINAL
+
+// Cycle counters of the wrapper, as returned by CMD_READ_STATS and, for
+// the commands 8 to 15, CMD_READ_STATS_HI. cmd_cycles and cmd_count are
+// indexed by the command code. The counters wrap around and are only
+// cleared by a reset of the FPGA.
+typedef struct {
+	uint32_t state_cycles[16];  // Cycles spent in every state of the wrapper FSM
+	uint32_t cmd_cycles[16];    // Cycles between accepting a command and returning to idle
+	uint32_t cmd_count[16];     // Number of times every command was accepted
+} hw_stats_t;
+
 void init_HW_access(void);
 void customprint(uint32_t *large_number, char *str, int size);
 int check_correctness(uint32_t *expected, uint32_t *calculated, int size);
 void zuc256_tot_HW_init(uint32_t *input);
 void zuc256_tot_HW_next(uint32_t *input, uint32_t *output);
+void zuc256_tot_HW_next_pipelined(uint32_t *input, uint32_t *output, int nblocks);
 void zuc256_tot_HW_finalize(uint32_t *output);
+void zuc256_tot_HW_start(zuc256_ctx_t *ctx, uint32_t *input);
+void zuc256_tot_HW_encrypt(zuc256_ctx_t *ctx, const uint8_t *in, uint8_t *out, uint32_t nbytes);
+int zuc256_tot_HW_ctx_alloc(zuc256_ctx_handle_t *ctx);
+void zuc256_tot_HW_ctx_free(zuc256_ctx_handle_t *ctx);
+void zuc256_tot_HW_set_ctx(const zuc256_ctx_handle_t *ctx, uint32_t *input);
+void zuc256_tot_HW_ctx_save(const zuc256_ctx_handle_t *ctx, uint32_t *state);
+void zuc256_tot_HW_ctx_restore(const zuc256_ctx_handle_t *ctx, uint32_t *state);
+void zuc256_tot_HW_batch_clear(uint32_t *frame);
+int zuc256_tot_HW_batch_add(uint32_t *frame, int lane, const uint32_t *block, int final, uint8_t i_len);
+void zuc256_tot_HW_batch(uint32_t *frame, uint32_t *output);
+void zuc256_tot_HW_queue_init(hw_queue_t *q, uint32_t *mem);
+void zuc256_tot_HW_read_stats(hw_stats_t *stats);
+void print_HW_stats(hw_stats_t *stats);
 
 #endif
@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "common.h"
 
 #include "hw_accelerator.h"
@@ -15,8 +17,16 @@ extern uint32_t ctr0[32],
                 mac0[32],
                 mac1[32],
                 mac_expected[4];
+extern uint8_t  ctr_payload[16],
+                ctr_expected_payload[16];
 
 uint32_t output[32];
+uint32_t mac_blocks[32*32], mac_outputs[32*32];
+uint8_t payload_out[16];
+zuc256_ctx_t ctx;
+zuc256_ctx_handle_t ctx_a, ctx_b, ctx_c;
+uint32_t ctx_ctr[4*32], ctx_mac[2*32], ctx_state[32];
+hw_stats_t stats;
 
 int main()
 {
@@ -53,6 +63,15 @@ int main()
   if (check_correctness(output, &ctr3_expected, 1) != 1) xil_printf("    encryption test: fourth block for ZUC-256 TOT correct!\n\r\n\r");
   else xil_printf("    encryption test: fourth block for ZUC-256 TOT incorrect :(\n\r\n\r");
 
+  // All words through the encrypt frames, split at an odd byte offset
+  xil_printf("Test encryption (encrypt frames)...\n\r");
+START_TIMING
+  zuc256_tot_HW_start(&ctx, ctr0);
+  zuc256_tot_HW_encrypt(&ctx, ctr_payload, payload_out, 6);
+  zuc256_tot_HW_encrypt(&ctx, ctr_payload + 6, payload_out + 6, 10);
+STOP_TIMING
+  if (memcmp(payload_out, ctr_expected_payload, 16) == 0) xil_printf("    encryption test: encrypt frames for ZUC-256 TOT correct!\n\r\n\r");
+  else xil_printf("    encryption test: encrypt frames for ZUC-256 TOT incorrect :(\n\r\n\r");
 
 	// tc6 test
 	xil_printf("Test MAC...\n\r");
@@ -65,6 +84,60 @@ int main()
 	if (check_correctness(output, mac_expected, 4) != 1) xil_printf("    MAC test: tag for ZUC-256 TOT correct!\n\r\n\r");
 	else xil_printf("    MAC test: tag for ZUC-256 TOT incorrect :(\n\r\n\r");
 
+	// tc6 test with the pipelined call sequence
+	xil_printf("Test pipelined MAC...\n\r");
+  for (int i = 0; i < 32; i++)
+    memcpy(mac_blocks + 32*i, (i < 31) ? mac0 : mac1, sizeof(mac0));
+  zuc256_tot_HW_init(mac0);
+  zuc256_tot_HW_next_pipelined(mac_blocks, mac_outputs, 32);
+  zuc256_tot_HW_finalize(output);
+  customprint(output, "    Output", 32);
+	if (check_correctness(output, mac_expected, 4) != 1) xil_printf("    pipelined MAC test: tag for ZUC-256 TOT correct!\n\r\n\r");
+	else xil_printf("    pipelined MAC test: tag for ZUC-256 TOT incorrect :(\n\r\n\r");
+
+	// -- Test an encryption and a MAC interleaved in two contexts, with the
+	//    MAC moved to a third context halfway
+	xil_printf("Test contexts...\n\r");
+	memcpy(ctx_ctr, ctr0, sizeof(ctr0));
+	memcpy(ctx_ctr + 32, ctr1, sizeof(ctr1));
+	memcpy(ctx_ctr + 64, ctr2, sizeof(ctr2));
+	memcpy(ctx_ctr + 96, ctr3, sizeof(ctr3));
+	memcpy(ctx_mac, mac0, sizeof(mac0));
+	memcpy(ctx_mac + 32, mac1, sizeof(mac1));
+	if ((zuc256_tot_HW_ctx_alloc(&ctx_a) != 0) || (zuc256_tot_HW_ctx_alloc(&ctx_b) != 0) || (zuc256_tot_HW_ctx_alloc(&ctx_c) != 0))
+		xil_printf("    context test: out of contexts :(\n\r\n\r");
+	for (int i = 0; i < 4; i++)
+		zuc256_tot_HW_set_ctx(&ctx_a, ctx_ctr + 32*i);
+	zuc256_tot_HW_set_ctx(&ctx_b, ctx_mac);
+	zuc256_tot_HW_init(ctx_ctr);
+	zuc256_tot_HW_init(ctx_mac);
+	for (int i = 0; i < 4; i++) {
+		zuc256_tot_HW_next(ctx_ctr + 32*i, output);
+		if (output[0] != ((i == 0) ? ctr0_expected : (i == 1) ? ctr1_expected : (i == 2) ? ctr2_expected : ctr3_expected))
+			xil_printf("    context test: word %d for ZUC-256 TOT incorrect :(\n\r", i);
+		zuc256_tot_HW_next(ctx_mac, output);
+	}
+	zuc256_tot_HW_ctx_save(&ctx_b, ctx_state);
+	zuc256_tot_HW_ctx_restore(&ctx_c, ctx_state);
+	zuc256_tot_HW_set_ctx(&ctx_c, ctx_mac);
+	zuc256_tot_HW_set_ctx(&ctx_c, ctx_mac + 32);
+	for (int i = 4; i < 31; i++)
+		zuc256_tot_HW_next(ctx_mac, output);
+	zuc256_tot_HW_next(ctx_mac + 32, output);
+	zuc256_tot_HW_finalize(output);
+	customprint(output, "    Output", 32);
+	if (check_correctness(output, mac_expected, 4) != 1) xil_printf("    context test: tag for ZUC-256 TOT correct!\n\r\n\r");
+	else xil_printf("    context test: tag for ZUC-256 TOT incorrect :(\n\r\n\r");
+	zuc256_tot_HW_ctx_free(&ctx_a);
+	zuc256_tot_HW_ctx_free(&ctx_b);
+	zuc256_tot_HW_ctx_free(&ctx_c);
+
+	// -- Read the cycle counters of the wrapper
+	xil_printf("Cycle counters...\n\r");
+	zuc256_tot_HW_read_stats(&stats);
+	print_HW_stats(&stats);
+	xil_printf("\n\r");
+
 	xil_printf("----------- End ZUC-256 TOT test -----------\n\r");
 
 	cleanup_platform();
@@ -12,6 +12,8 @@ uint32_t ctr2[32] = { 0x0b0c0000, 0x0000090a, 0x00000000, 0x00000000, 0xffff0000
 uint32_t ctr2_expected = 0x3a8f8bfc;
 uint32_t ctr3[32] = { 0x0f000000, 0x00000d0e, 0x00000000, 0x00000000, 0xffff0000, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0x0000ffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000 };
 uint32_t ctr3_expected = 0xedd603e9;
+uint8_t ctr_payload[16] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x00 };
+uint8_t ctr_expected_payload[16] = { 0x38, 0x87, 0xe1, 0xab, 0x30, 0x35, 0xd3, 0x21, 0x3a, 0x8f, 0x8b, 0xfc, 0xed, 0xd6, 0x03, 0xe9 };
 // Test MAC
 uint32_t mac0[32] = { 0x11112080, 0x11111111, 0x11111111, 0x11111111, 0xffff1111, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0x0001ffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000 };
 uint32_t mac1[32] = { 0x00002080, 0x00000000, 0x00000000, 0x11110000, 0xffff1111, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0x0001ffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000 };
@@ -41,6 +41,9 @@ for i in range(len(ctr_blocks)):
     print(f"uint32_t ctr{i}[32] = {{ {converted_hex_str(ctr_enc_auth, ctr_key, ctr_iv, ctr_blocks[i], ctr_i_len, ctr_tag_len)} }};")
     print(f"uint32_t ctr{i}_expected = {convert_string(ctr_expected_blocks[i])};")
 
+print(f"uint8_t ctr_payload[{4*len(ctr_blocks)}] = {{ {', '.join('0x' + block[-8:][2*j:2*j+2] for block in ctr_blocks for j in range(4))} }};")
+print(f"uint8_t ctr_expected_payload[{4*len(ctr_blocks)}] = {{ {', '.join('0x' + block[2*j:2*j+2] for block in ctr_expected_blocks for j in range(4))} }};")
+
 print("// Test MAC")
 for i in range(len(mac_blocks)):
     print(f"uint32_t mac{i}[32] = {{ {converted_hex_str(mac_enc_auth, mac_key, mac_iv, mac_blocks[i], mac_i_len, mac_tag_len)} }};")